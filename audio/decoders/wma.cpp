@@ -559,7 +559,8 @@ Common::SeekableReadStream *WMACodec::decodeSuperFrame(Common::SeekableReadStrea
 	if (_blockAlign)
 		size = _blockAlign;
 
-	Common::BitStream8MSB bits(data);
+	// Decode from memory, which is a lot faster to read bits from
+	Common::BitStreamMemory8MSB bits(Common::BitStreamMemoryStream::createFromStream(data, data.size() - data.pos()), DisposeAfterUse::YES);
 
 	int    outputDataSize = 0;
 	int16 *outputData     = nullptr;
@@ -617,8 +618,8 @@ Common::SeekableReadStream *WMACodec::decodeSuperFrame(Common::SeekableReadStrea
 				_lastSuperframeLen += 1;
 			}
 
-			Common::MemoryReadStream lastSuperframe(_lastSuperframe, _lastSuperframeLen);
-			Common::BitStream8MSB lastBits(lastSuperframe);
+			Common::BitStreamMemoryStream lastSuperframe(_lastSuperframe, _lastSuperframeLen);
+			Common::BitStreamMemory8MSB lastBits(lastSuperframe);
 
 			lastBits.skip(_lastBitoffset);
 
@@ -683,7 +684,7 @@ Common::SeekableReadStream *WMACodec::decodeSuperFrame(Common::SeekableReadStrea
 	return new Common::MemoryReadStream((byte *) outputData, outputDataSize * 2, DisposeAfterUse::YES);
 }
 
-bool WMACodec::decodeFrame(Common::BitStream8MSB &bits, int16 *outputData) {
+bool WMACodec::decodeFrame(Common::BitStreamMemory8MSB &bits, int16 *outputData) {
 	_framePos = 0;
 	_curBlock = 0;
 
@@ -713,7 +714,7 @@ bool WMACodec::decodeFrame(Common::BitStream8MSB &bits, int16 *outputData) {
 	return true;
 }
 
-int WMACodec::decodeBlock(Common::BitStream8MSB &bits) {
+int WMACodec::decodeBlock(Common::BitStreamMemory8MSB &bits) {
 	// Computer new block length
 	if (!evalBlockLength(bits))
 		return -1;
@@ -766,7 +767,7 @@ int WMACodec::decodeBlock(Common::BitStream8MSB &bits) {
 	return 0;
 }
 
-bool WMACodec::decodeChannels(Common::BitStream8MSB &bits, int bSize,
+bool WMACodec::decodeChannels(Common::BitStreamMemory8MSB &bits, int bSize,
 							  bool msStereo, bool *hasChannel) {
 
 	int totalGain    = readTotalGain(bits);
@@ -822,7 +823,7 @@ bool WMACodec::calculateIMDCT(int bSize, bool msStereo, bool *hasChannel) {
 	return true;
 }
 
-bool WMACodec::evalBlockLength(Common::BitStream8MSB &bits) {
+bool WMACodec::evalBlockLength(Common::BitStreamMemory8MSB &bits) {
 	if (_useVariableBlockLen) {
 		// Variable block lengths
 
@@ -898,7 +899,7 @@ void WMACodec::calculateCoefCount(int *coefCount, int bSize) const {
 		coefCount[i] = coefN;
 }
 
-bool WMACodec::decodeNoise(Common::BitStream8MSB &bits, int bSize,
+bool WMACodec::decodeNoise(Common::BitStreamMemory8MSB &bits, int bSize,
 						   bool *hasChannel, int *coefCount) {
 	if (!_useNoiseCoding)
 		return true;
@@ -949,7 +950,7 @@ bool WMACodec::decodeNoise(Common::BitStream8MSB &bits, int bSize,
 	return true;
 }
 
-bool WMACodec::decodeExponents(Common::BitStream8MSB &bits, int bSize, bool *hasChannel) {
+bool WMACodec::decodeExponents(Common::BitStreamMemory8MSB &bits, int bSize, bool *hasChannel) {
 	// Exponents can be reused in short blocks
 	if (!((_blockLenBits == _frameLenBits) || bits.getBit()))
 		return true;
@@ -972,7 +973,7 @@ bool WMACodec::decodeExponents(Common::BitStream8MSB &bits, int bSize, bool *has
 	return true;
 }
 
-bool WMACodec::decodeSpectralCoef(Common::BitStream8MSB &bits, bool msStereo, bool *hasChannel,
+bool WMACodec::decodeSpectralCoef(Common::BitStreamMemory8MSB &bits, bool msStereo, bool *hasChannel,
 								  int *coefCount, int coefBitCount) {
 	// Simple RLE encoding
 
@@ -1212,7 +1213,7 @@ static const float powTab[] = {
 	7.4989420933246e+05f, 8.6596432336007e+05f,
 };
 
-bool WMACodec::decodeExpHuffman(Common::BitStream8MSB &bits, int ch) {
+bool WMACodec::decodeExpHuffman(Common::BitStreamMemory8MSB &bits, int ch) {
 	const float  *ptab  = powTab + 60;
 	const uint32 *iptab = (const uint32 *) ptab;
 
@@ -1310,7 +1311,7 @@ void WMACodec::lspToCurve(float *out, float *val_max_ptr, int n, float *lsp) {
 }
 
 // Decode exponents coded with LSP coefficients (same idea as Vorbis)
-bool WMACodec::decodeExpLSP(Common::BitStream8MSB &bits, int ch) {
+bool WMACodec::decodeExpLSP(Common::BitStreamMemory8MSB &bits, int ch) {
 	float lspCoefs[kLSPCoefCount];
 
 	for (int i = 0; i < kLSPCoefCount; i++) {
@@ -1328,7 +1329,7 @@ bool WMACodec::decodeExpLSP(Common::BitStream8MSB &bits, int ch) {
 	return true;
 }
 
-bool WMACodec::decodeRunLevel(Common::BitStream8MSB &bits, const HuffmanDecoder &huffman,
+bool WMACodec::decodeRunLevel(Common::BitStreamMemory8MSB &bits, const HuffmanDecoder &huffman,
 	const float *levelTable, const uint16 *runTable, int version, float *ptr,
 	int offset, int numCoefs, int blockLen, int frameLenBits, int coefNbBits) {
 
@@ -1470,7 +1471,7 @@ float WMACodec::pow_m1_4(float x) const {
 	return _lspPowETable[e] * (a + b * t.f);
 }
 
-int WMACodec::readTotalGain(Common::BitStream8MSB &bits) {
+int WMACodec::readTotalGain(Common::BitStreamMemory8MSB &bits) {
 	int totalGain = 1;
 
 	int v = 127;
@@ -1491,7 +1492,7 @@ int WMACodec::totalGainToBits(int totalGain) {
 	else                     return  9;
 }
 
-uint32 WMACodec::getLargeVal(Common::BitStream8MSB &bits) {
+uint32 WMACodec::getLargeVal(Common::BitStreamMemory8MSB &bits) {
 	// Consumes up to 34 bits
 
 	if (bits.getBit()) {
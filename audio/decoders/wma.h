@@ -112,7 +112,7 @@ private:
 	int    _exponentHighSizes[kBlockNBSizes];
 	int    _exponentHighBands[kBlockNBSizes][kHighBandSizeMax];
 
-	typedef Common::Huffman<Common::BitStream8MSB> HuffmanDecoder;
+	typedef Common::Huffman<Common::BitStreamMemory8MSB> HuffmanDecoder;
 	HuffmanDecoder *_coefHuffman[2];                ///< Coefficients Huffman codes.
 	const WMACoefHuffmanParam *_coefHuffmanParam[2]; ///< Params for coef Huffman codes.
 
@@ -185,27 +185,27 @@ private:
 	// Decoding
 
 	Common::SeekableReadStream *decodeSuperFrame(Common::SeekableReadStream &data);
-	bool decodeFrame(Common::BitStream8MSB &bits, int16 *outputData);
-	int decodeBlock(Common::BitStream8MSB &bits);
+	bool decodeFrame(Common::BitStreamMemory8MSB &bits, int16 *outputData);
+	int decodeBlock(Common::BitStreamMemory8MSB &bits);
 
 	// Decoding helpers
 
-	bool evalBlockLength(Common::BitStream8MSB &bits);
-	bool decodeChannels(Common::BitStream8MSB &bits, int bSize, bool msStereo, bool *hasChannel);
+	bool evalBlockLength(Common::BitStreamMemory8MSB &bits);
+	bool decodeChannels(Common::BitStreamMemory8MSB &bits, int bSize, bool msStereo, bool *hasChannel);
 	bool calculateIMDCT(int bSize, bool msStereo, bool *hasChannel);
 
 	void calculateCoefCount(int *coefCount, int bSize) const;
-	bool decodeNoise(Common::BitStream8MSB &bits, int bSize, bool *hasChannel, int *coefCount);
-	bool decodeExponents(Common::BitStream8MSB &bits, int bSize, bool *hasChannel);
-	bool decodeSpectralCoef(Common::BitStream8MSB &bits, bool msStereo, bool *hasChannel,
+	bool decodeNoise(Common::BitStreamMemory8MSB &bits, int bSize, bool *hasChannel, int *coefCount);
+	bool decodeExponents(Common::BitStreamMemory8MSB &bits, int bSize, bool *hasChannel);
+	bool decodeSpectralCoef(Common::BitStreamMemory8MSB &bits, bool msStereo, bool *hasChannel,
 	                        int *coefCount, int coefBitCount);
 	float getNormalizedMDCTLength() const;
 	void calculateMDCTCoefficients(int bSize, bool *hasChannel,
 	                               int *coefCount, int totalGain, float mdctNorm);
 
-	bool decodeExpHuffman(Common::BitStream8MSB &bits, int ch);
-	bool decodeExpLSP(Common::BitStream8MSB &bits, int ch);
-	bool decodeRunLevel(Common::BitStream8MSB &bits, const HuffmanDecoder &huffman,
+	bool decodeExpHuffman(Common::BitStreamMemory8MSB &bits, int ch);
+	bool decodeExpLSP(Common::BitStreamMemory8MSB &bits, int ch);
+	bool decodeRunLevel(Common::BitStreamMemory8MSB &bits, const HuffmanDecoder &huffman,
 		const float *levelTable, const uint16 *runTable, int version, float *ptr,
 		int offset, int numCoefs, int blockLen, int frameLenBits, int coefNbBits);
 
@@ -215,9 +215,9 @@ private:
 
 	float pow_m1_4(float x) const;
 
-	static int readTotalGain(Common::BitStream8MSB &bits);
+	static int readTotalGain(Common::BitStreamMemory8MSB &bits);
 	static int totalGainToBits(int totalGain);
-	static uint32 getLargeVal(Common::BitStream8MSB &bits);
+	static uint32 getLargeVal(Common::BitStreamMemory8MSB &bits);
 };
 
 } // End of namespace Audio
@@ -23,6 +23,7 @@
 #include "backends/cloud/downloadrequest.h"
 #include "backends/cloud/id/iddownloadrequest.h"
 #include "common/debug.h"
+#include "common/system.h"
 #include "gui/downloaddialog.h"
 #include "backends/networking/curl/connectionmanager.h"
 #include "cloudmanager.h"
@@ -55,6 +56,7 @@ void FolderDownloadRequest::start() {
 	_ignoreCallback = false;
 	_totalFiles = 0;
 	_downloadedBytes = _totalBytes = _wasDownloadedBytes = _currentDownloadSpeed = 0;
+	_speedMeasureTime = g_system->getMillis();
 
 	//list directory first
 	_workingRequest = _storage->listDirectory(
@@ -149,11 +151,18 @@ void FolderDownloadRequest::downloadNextFile() {
 }
 
 void FolderDownloadRequest::handle() {
-	uint32 microsecondsPassed = Networking::ConnectionManager::getCloudRequestsPeriodInMicroseconds();
+	// handle() is called whenever a transfer makes progress, so measure
+	// the real time passed instead of assuming a fixed period
+	uint32 now = g_system->getMillis();
+	uint32 millisecondsPassed = now - _speedMeasureTime;
+	if (millisecondsPassed < SPEED_MEASURE_PERIOD)
+		return;
+
 	uint64 currentDownloadedBytes = getDownloadedBytes();
 	uint64 downloadedThisPeriod = currentDownloadedBytes - _wasDownloadedBytes;
-	_currentDownloadSpeed = downloadedThisPeriod * (1000000L / microsecondsPassed);
+	_currentDownloadSpeed = downloadedThisPeriod * 1000 / millisecondsPassed;
 	_wasDownloadedBytes = currentDownloadedBytes;
+	_speedMeasureTime = now;
 }
 
 void FolderDownloadRequest::restart() { start(); }
@@ -29,6 +29,8 @@
 namespace Cloud {
 
 class FolderDownloadRequest: public Networking::Request, public GUI::CommandSender {
+	static const uint32 SPEED_MEASURE_PERIOD = 250; // milliseconds
+
 	Storage *_storage;
 	Storage::FileArrayCallback _fileArrayCallback;
 	Common::String _remoteDirectoryPath;
@@ -40,6 +42,7 @@ class FolderDownloadRequest: public Networking::Request, public GUI::CommandSend
 	bool _ignoreCallback;
 	uint32 _totalFiles;
 	uint64 _downloadedBytes, _totalBytes, _wasDownloadedBytes, _currentDownloadSpeed;
+	uint32 _speedMeasureTime;
 
 	void start();
 	void directoryListedCallback(const Storage::ListDirectoryResponse &response);
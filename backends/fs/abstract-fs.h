@@ -201,6 +201,18 @@ public:
 	 */
 	virtual Common::SeekableWriteStream *createWriteStream() = 0;
 
+	/**
+	 * Creates a WriteStream instance which writes to a temporary file, and
+	 * replaces the file referred by this node with it in a single step when
+	 * the stream is deleted. An interrupted write never leaves a truncated
+	 * file behind.
+	 *
+	 * The default implementation writes to the file directly.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::SeekableWriteStream *createAtomicWriteStream() { return createWriteStream(); }
+
 	/**
 	* Creates a directory referred by this node.
 	*
@@ -266,6 +266,21 @@ AbstractFSNode *POSIXFilesystemNode::getParent() const {
 }
 
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
+#ifdef HAS_MMAP
+	// Big data files are mapped into memory. Engines mostly open them as
+	// archives (LAB, ZIP, resource forks) whose members are sub-streams, or
+	// as videos and audio banks that are read packet by packet. A mapping
+	// lets readStream() and borrowData() hand out that data without a copy,
+	// which stdio cannot do. The pages are only read in when touched, so
+	// mapping a big archive to read a single member does not cost more than
+	// an fopen(). For small files, setting up and tearing down the mapping
+	// costs more than a buffered read. The mapping is read-only and private,
+	// and when it fails (e.g. out of address space) stdio is used instead.
+	Common::SeekableReadStream *mappedStream = PosixMmapStream::makeFromPath(getPath(), 1024 * 1024);
+	if (mappedStream)
+		return mappedStream;
+#endif
+
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
@@ -284,6 +299,10 @@ Common::SeekableWriteStream *POSIXFilesystemNode::createWriteStream() {
 	return PosixIoStream::makeFromPath(getPath(), true);
 }
 
+Common::SeekableWriteStream *POSIXFilesystemNode::createAtomicWriteStream() {
+	return PosixIoStream::makeAtomicFromPath(getPath());
+}
+
 bool POSIXFilesystemNode::createDirectory() {
 	if (mkdir(_path.c_str(), 0755) == 0)
 		setFlags();
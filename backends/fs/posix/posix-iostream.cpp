@@ -23,7 +23,19 @@
 
 #include "backends/fs/posix/posix-iostream.h"
 
+#include "common/textconsole.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef HAS_MMAP
+#include <sys/mman.h>
+#include <fcntl.h>
+#endif
 
 PosixIoStream *PosixIoStream::makeFromPath(const Common::String &path, bool writeMode) {
 #if defined(HAS_FOPEN64)
@@ -39,8 +51,85 @@ PosixIoStream *PosixIoStream::makeFromPath(const Common::String &path, bool writ
 }
 
 
+PosixIoStream *PosixIoStream::makeAtomicFromPath(const Common::String &path) {
+	// Replace the target of a symbolic link rather than the link itself
+	Common::String targetPath = path;
+	char *resolved = realpath(path.c_str(), nullptr);
+	if (resolved) {
+		targetPath = resolved;
+		free(resolved);
+	}
+
+	// A unique name keeps concurrent writers from sharing a temporary file
+	char *tempName = scumm_strdup((targetPath + ".XXXXXX").c_str());
+	int fd = mkstemp(tempName);
+	Common::String tempPath = tempName;
+	free(tempName);
+	if (fd == -1)
+		return nullptr;
+
+	FILE *handle = fdopen(fd, "wb");
+	if (!handle) {
+		close(fd);
+		remove(tempPath.c_str());
+		return nullptr;
+	}
+
+	// Keep the permissions of the file being replaced
+	struct stat st;
+	if (stat(targetPath.c_str(), &st) == 0)
+		fchmod(fd, st.st_mode & 07777);
+
+	PosixIoStream *stream = new PosixIoStream(handle);
+	stream->_tempPath = tempPath;
+	stream->_targetPath = targetPath;
+	return stream;
+}
+
 PosixIoStream::PosixIoStream(void *handle) :
-		StdioStream(handle) {
+		StdioStream(handle), _failed(false) {
+}
+
+PosixIoStream::~PosixIoStream() {
+	if (!_targetPath.empty())
+		finalize();
+}
+
+bool PosixIoStream::err() const {
+	if (!_handle)
+		return _failed;
+
+	return StdioStream::err();
+}
+
+void PosixIoStream::clearErr() {
+	if (_handle)
+		StdioStream::clearErr();
+}
+
+void PosixIoStream::finalize() {
+	if (_targetPath.empty()) {
+		StdioStream::finalize();
+		return;
+	}
+
+	if (!_handle)
+		return;
+
+	bool success = flush() && !err();
+	if (fclose((FILE *)_handle) != 0)
+		success = false;
+	_handle = nullptr;
+
+	if (success && rename(_tempPath.c_str(), _targetPath.c_str()) != 0) {
+		warning("Failed to replace '%s': %s", _targetPath.c_str(), strerror(errno));
+		success = false;
+	}
+
+	if (!success) {
+		remove(_tempPath.c_str());
+		_failed = true;
+	}
 }
 
 int64 PosixIoStream::size() const {
@@ -58,3 +147,93 @@ int64 PosixIoStream::size() const {
 
 	return st.st_size;
 }
+
+#ifdef HAS_MMAP
+
+PosixMmapStream::Mapping::~Mapping() {
+	munmap(_address, _length);
+}
+
+PosixMmapStream *PosixMmapStream::makeFromPath(const Common::String &path, int64 minSize) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st;
+	if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode) || st.st_size <= 0 || st.st_size < minSize ||
+	    (uint64)st.st_size > (uint64)(size_t)-1) {
+		close(fd);
+		return nullptr;
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	size_t length = (size_t)st.st_size;
+	void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (address == MAP_FAILED)
+		return nullptr;
+
+	Common::SharedPtr<Mapping> mapping(new Mapping(address, length));
+	return new PosixMmapStream(mapping, (const byte *)address, st.st_size);
+}
+
+PosixMmapStream::PosixMmapStream(const Common::SharedPtr<Mapping> &mapping, const byte *data, int64 size) :
+		_mapping(mapping), _data(data), _size(size), _pos(0), _eos(false) {
+}
+
+bool PosixMmapStream::seek(int64 offset, int whence) {
+	switch (whence) {
+	case SEEK_END:
+		offset += _size;
+		break;
+	case SEEK_CUR:
+		offset += _pos;
+		break;
+	case SEEK_SET:
+	default:
+		break;
+	}
+
+	if (offset < 0 || offset > _size)
+		return false;
+
+	_pos = offset;
+	_eos = false;
+	return true;
+}
+
+uint32 PosixMmapStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = (uint32)(_size - _pos);
+		_eos = true;
+	}
+
+	memcpy(dataPtr, _data + _pos, dataSize);
+	_pos += dataSize;
+
+	return dataSize;
+}
+
+const byte *PosixMmapStream::borrowData(int64 offset, uint32 size) const {
+	if (offset < 0 || offset > _size || size > _size - offset)
+		return nullptr;
+
+	return _data + offset;
+}
+
+Common::SeekableReadStream *PosixMmapStream::readStream(uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = (uint32)(_size - _pos);
+		_eos = true;
+	}
+	assert(dataSize > 0);
+
+	// Share the mapping instead of copying the data
+	PosixMmapStream *stream = new PosixMmapStream(_mapping, _data + _pos, dataSize);
+	_pos += dataSize;
+
+	return stream;
+}
+
+#endif
@@ -30,9 +30,82 @@
 class PosixIoStream final : public StdioStream {
 public:
 	static PosixIoStream *makeFromPath(const Common::String &path, bool writeMode);
+
+	/**
+	 * Open a temporary file next to @p path for writing. It is renamed over
+	 * the file at @p path by finalize() or when the stream is deleted, unless
+	 * writing failed. After finalize(), err() reports whether it succeeded.
+	 */
+	static PosixIoStream *makeAtomicFromPath(const Common::String &path);
+
 	PosixIoStream(void *handle);
+	~PosixIoStream() override;
+
+	bool err() const override;
+	void clearErr() override;
+	void finalize() override;
 
 	int64 size() const override;
+
+private:
+	Common::String _tempPath;	///< Temporary file of an atomic write stream
+	Common::String _targetPath;	///< File replaced by the temporary file
+	bool _failed;				///< Replacing the file failed in finalize()
+};
+
+#ifdef HAS_MMAP
+
+#include "common/ptr.h"
+
+/**
+ * A read-only file stream backed by a memory mapping of the whole file.
+ *
+ * Reads are plain memory copies and the contents can be borrowed without
+ * copying at all. Streams returned by readStream() share the mapping,
+ * which stays alive until the last stream using it is deleted.
+ */
+class PosixMmapStream final : public Common::SeekableReadStream, public Common::NonCopyable {
+public:
+	/**
+	 * Map the file at the given path.
+	 *
+	 * @param path		Path of the file to map.
+	 * @param minSize	Files smaller than this are not mapped.
+	 *
+	 * @return The new stream, or nullptr if the file could not be mapped.
+	 */
+	static PosixMmapStream *makeFromPath(const Common::String &path, int64 minSize = 1);
+
+	bool eos() const override { return _eos; }
+	void clearErr() override { _eos = false; }
+
+	int64 pos() const override { return _pos; }
+	int64 size() const override { return _size; }
+	bool seek(int64 offset, int whence = SEEK_SET) override;
+
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	const byte *borrowData(int64 offset, uint32 size) const override;
+	Common::SeekableReadStream *readStream(uint32 dataSize) override;
+
+private:
+	struct Mapping {
+		Mapping(void *address, size_t length) : _address(address), _length(length) {}
+		~Mapping();
+
+		void *_address;
+		size_t _length;
+	};
+
+	PosixMmapStream(const Common::SharedPtr<Mapping> &mapping, const byte *data, int64 size);
+
+	Common::SharedPtr<Mapping> _mapping;
+	const byte *_data;
+	int64 _size;
+	int64 _pos;
+	bool _eos;
 };
 
 #endif
+
+#endif
@@ -192,6 +192,7 @@ MODULE_OBJS += \
 	mixer/sdl/sdl-mixer.o \
 	mixer/null/null-mixer.o \
 	mutex/sdl/sdl-mutex.o \
+	threads/sdl/sdl-threads.o \
 	timer/sdl/sdl-timer.o
 
 ifndef RISCOS
@@ -424,7 +425,9 @@ endif
 
 ifeq ($(BACKEND),null)
 MODULE_OBJS += \
-	mixer/null/null-mixer.o
+	mixer/null/null-mixer.o \
+	mutex/pthread/pthread-mutex.o \
+	threads/pthread/pthread-threads.o
 endif
 
 ifdef MIYOO
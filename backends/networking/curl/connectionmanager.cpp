@@ -33,6 +33,16 @@
 #include "backends/platform/android/jni-android.h"
 #endif
 
+// The network thread sleeps in poll() on the sockets libcurl reports
+// through its socket callback (added in libcurl 7.16.0)
+#if defined(POSIX) && LIBCURL_VERSION_NUM >= 0x071000
+#define USE_CURL_SOCKET_EVENTS
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
 namespace Common {
 
 DECLARE_SINGLETON(Networking::ConnectionManager);
@@ -41,12 +51,15 @@ DECLARE_SINGLETON(Networking::ConnectionManager);
 
 namespace Networking {
 
-ConnectionManager::ConnectionManager(): _multi(nullptr), _timerStarted(false), _frame(0) {
+ConnectionManager::ConnectionManager(): _multi(nullptr), _timerStarted(false), _frame(0),
+	_thread(nullptr), _quitThread(false), _curlTimeout(-1), _curlTimeoutStart(0), _lastIdleHandle(0), _lastRetryHandle(0) {
+	_wakeUpPipe[0] = _wakeUpPipe[1] = -1;
 	curl_global_init(CURL_GLOBAL_ALL);
 	_multi = curl_multi_init();
 }
 
 ConnectionManager::~ConnectionManager() {
+	stopThread();
 	stopTimer();
 
 	//terminate all added requests which haven't been processed yet
@@ -88,15 +101,18 @@ ConnectionManager::~ConnectionManager() {
 }
 
 void ConnectionManager::registerEasyHandle(CURL *easy) const {
+	Common::StackLock lock(_handleMutex);
 	curl_multi_add_handle(_multi, easy);
+	wakeUpThread();
 }
 
 Request *ConnectionManager::addRequest(Request *request, RequestCallback callback) {
 	_addedRequestsMutex.lock();
 	_addedRequests.push_back(RequestWithCallback(request, callback));
-	if (!_timerStarted)
+	if (!_thread && !_timerStarted && !startThread())
 		startTimer();
 	_addedRequestsMutex.unlock();
+	wakeUpThread();
 	return request;
 }
 
@@ -120,6 +136,11 @@ uint32 ConnectionManager::getCloudRequestsPeriodInMicroseconds() {
 	return TIMER_INTERVAL * CLOUD_PERIOD;
 }
 
+ConnectionManager::LoopStats ConnectionManager::getLoopStats() {
+	Common::StackLock lock(_handleMutex);
+	return _loopStats;
+}
+
 Common::String ConnectionManager::getCaCertPath() {
 #if defined(__ANDROID__)
 	// cacert path must exist on filesystem and be reachable by standard open syscall
@@ -191,7 +212,7 @@ void ConnectionManager::handle() {
 	_handleMutex.unlock();
 }
 
-void ConnectionManager::interateRequests() {
+bool ConnectionManager::interateRequests(bool tick) {
 	//add new requests
 	_addedRequestsMutex.lock();
 	for (Common::Array<RequestWithCallback>::iterator i = _addedRequests.begin(); i != _addedRequests.end(); ++i) {
@@ -203,13 +224,15 @@ void ConnectionManager::interateRequests() {
 	//call handle() of all running requests (so they can do their work)
 	if (_frame % DEBUG_PRINT_PERIOD == 0)
 		debug(9, "handling %d request(s)", _requests.size());
+	bool hasRetries = false;
 	for (Common::Array<RequestWithCallback>::iterator i = _requests.begin(); i != _requests.end();) {
 		Request *request = i->request;
 		if (request) {
 			if (request->state() == PROCESSING)
 				request->handle();
-			else if (request->state() == RETRY)
+			else if (request->state() == RETRY && tick)
 				request->handleRetry();
+			hasRetries |= (request->state() == RETRY);
 		}
 
 		if (!request || request->state() == FINISHED) {
@@ -224,6 +247,8 @@ void ConnectionManager::interateRequests() {
 
 		++i;
 	}
+
+	return hasRetries;
 }
 
 void ConnectionManager::processTransfers() {
@@ -232,10 +257,15 @@ void ConnectionManager::processTransfers() {
 	//check libcurl's transfers and notify requests of messages from queue (transfer completion or failure)
 	int transfersRunning;
 	curl_multi_perform(_multi, &transfersRunning);
+	readTransferMessages();
+}
 
+bool ConnectionManager::readTransferMessages() {
+	bool hasMessages = false;
 	int messagesInQueue;
 	CURLMsg *curlMsg;
 	while ((curlMsg = curl_multi_info_read(_multi, &messagesInQueue))) {
+		hasMessages = true;
 		if (curlMsg->msg == CURLMSG_DONE) {
 			CURL *easyHandle = curlMsg->easy_handle;
 
@@ -250,6 +280,192 @@ void ConnectionManager::processTransfers() {
 			warning("Unknown libcurl message type %d", curlMsg->msg);
 		}
 	}
+	return hasMessages;
+}
+
+bool ConnectionManager::startThread() {
+#ifdef USE_CURL_SOCKET_EVENTS
+	if (!_multi || pipe(_wakeUpPipe) != 0)
+		return false;
+	for (int i = 0; i < 2; i++) {
+		fcntl(_wakeUpPipe[i], F_SETFL, fcntl(_wakeUpPipe[i], F_GETFL) | O_NONBLOCK);
+		fcntl(_wakeUpPipe[i], F_SETFD, FD_CLOEXEC);
+	}
+
+	curl_multi_setopt(_multi, CURLMOPT_SOCKETFUNCTION, curlSocketCallback);
+	curl_multi_setopt(_multi, CURLMOPT_SOCKETDATA, this);
+	curl_multi_setopt(_multi, CURLMOPT_TIMERFUNCTION, curlTimerCallback);
+	curl_multi_setopt(_multi, CURLMOPT_TIMERDATA, this);
+
+	_quitThread = false;
+	_thread = g_system->createThread(threadProc, this);
+	if (_thread)
+		return true;
+
+	curl_multi_setopt(_multi, CURLMOPT_SOCKETFUNCTION, nullptr);
+	curl_multi_setopt(_multi, CURLMOPT_TIMERFUNCTION, nullptr);
+	close(_wakeUpPipe[0]);
+	close(_wakeUpPipe[1]);
+	_wakeUpPipe[0] = _wakeUpPipe[1] = -1;
+#endif
+	return false;
+}
+
+void ConnectionManager::stopThread() {
+#ifdef USE_CURL_SOCKET_EVENTS
+	if (!_thread)
+		return;
+
+	_handleMutex.lock();
+	_quitThread = true;
+	_handleMutex.unlock();
+	wakeUpThread();
+
+	delete _thread;
+	_thread = nullptr;
+	close(_wakeUpPipe[0]);
+	close(_wakeUpPipe[1]);
+	_wakeUpPipe[0] = _wakeUpPipe[1] = -1;
+#endif
+}
+
+void ConnectionManager::wakeUpThread() const {
+#ifdef USE_CURL_SOCKET_EVENTS
+	if (_wakeUpPipe[1] < 0)
+		return;
+
+	// The pipe is non-blocking, so a full pipe just means a wake up is pending
+	const char byte = 0;
+	if (write(_wakeUpPipe[1], &byte, 1) < 0 && errno != EAGAIN)
+		warning("ConnectionManager: failed to wake up the network thread");
+#endif
+}
+
+void ConnectionManager::threadProc(void *data) {
+	((ConnectionManager *)data)->runThread();
+}
+
+int32 ConnectionManager::getPollTimeout(uint32 now, bool hasRetries) const {
+	int32 timeout = -1;
+	if (_curlTimeout >= 0) {
+		const uint32 passed = now - _curlTimeoutStart;
+		timeout = passed >= (uint32)_curlTimeout ? 0 : _curlTimeout - passed;
+	}
+
+	if (!_requests.empty()) {
+		uint32 interval = IDLE_HANDLE_INTERVAL;
+		uint32 passed = now - _lastIdleHandle;
+		if (hasRetries) {
+			interval = TIMER_INTERVAL / 1000;
+			passed = now - _lastRetryHandle;
+		}
+		const int32 handleTimeout = passed >= interval ? 0 : interval - passed;
+		if (timeout < 0 || handleTimeout < timeout)
+			timeout = handleTimeout;
+	}
+
+	return timeout;
+}
+
+void ConnectionManager::runThread() {
+#ifdef USE_CURL_SOCKET_EVENTS
+	Common::Array<struct pollfd> fds;
+	bool hasRetries = false;
+
+	_handleMutex.lock();
+	_lastIdleHandle = _lastRetryHandle = g_system->getMillis(true);
+
+	while (!_quitThread) {
+		fds.resize(_sockets.size() + 1);
+		fds[0].fd = _wakeUpPipe[0];
+		fds[0].events = POLLIN;
+		uint count = 1;
+		for (Common::HashMap<int, int>::const_iterator i = _sockets.begin(); i != _sockets.end(); ++i) {
+			fds[count].fd = i->_key;
+			fds[count].events = ((i->_value & CURL_POLL_IN) ? POLLIN : 0) | ((i->_value & CURL_POLL_OUT) ? POLLOUT : 0);
+			count++;
+		}
+		for (uint i = 0; i < count; i++)
+			fds[i].revents = 0;
+
+		const int timeout = getPollTimeout(g_system->getMillis(true), hasRetries);
+
+		_handleMutex.unlock();
+		int ready = poll(fds.begin(), count, timeout);
+		_handleMutex.lock();
+
+		++_loopStats.wakeups;
+		if (_quitThread)
+			break;
+		if (ready < 0 && errno != EINTR) {
+			warning("ConnectionManager: poll() failed with error %d", errno);
+			ready = 0;
+		}
+
+		if (fds[0].revents & POLLIN) {
+			char buffer[64];
+			while (read(_wakeUpPipe[0], buffer, sizeof(buffer)) > 0) {}
+		}
+
+		// let libcurl do the work on the sockets that are ready
+		bool transfersProgressed = false;
+		int transfersRunning;
+		for (uint i = 1; i < count && ready > 0; i++) {
+			if (!fds[i].revents)
+				continue;
+			int mask = 0;
+			if (fds[i].revents & (POLLIN | POLLHUP))
+				mask |= CURL_CSELECT_IN;
+			if (fds[i].revents & POLLOUT)
+				mask |= CURL_CSELECT_OUT;
+			if (fds[i].revents & (POLLERR | POLLNVAL))
+				mask |= CURL_CSELECT_ERR;
+			curl_multi_socket_action(_multi, fds[i].fd, mask, &transfersRunning);
+			++_loopStats.socketEvents;
+			transfersProgressed = true;
+		}
+
+		uint32 now = g_system->getMillis(true);
+		if (_curlTimeout >= 0 && now - _curlTimeoutStart >= (uint32)_curlTimeout) {
+			_curlTimeout = -1;
+			curl_multi_socket_action(_multi, CURL_SOCKET_TIMEOUT, 0, &transfersRunning);
+			++_loopStats.curlTimeouts;
+			transfersProgressed = true;
+		}
+		transfersProgressed |= readTransferMessages();
+
+		// handle Requests right after their transfers got new data, so
+		// bodies are streamed out of NetworkReadStream as they arrive
+		const bool retryTick = hasRetries && now - _lastRetryHandle >= TIMER_INTERVAL / 1000;
+		const bool idleTick = !_requests.empty() && now - _lastIdleHandle >= IDLE_HANDLE_INTERVAL;
+		if (transfersProgressed || retryTick || idleTick || hasAddedRequests()) {
+			++_frame;
+			++_loopStats.handlePasses;
+			hasRetries = interateRequests(retryTick);
+			_lastIdleHandle = now;
+			if (retryTick || !hasRetries)
+				_lastRetryHandle = now;
+		}
+	}
+
+	_handleMutex.unlock();
+#endif
+}
+
+int ConnectionManager::curlSocketCallback(CURL *easy, int socket, int what, void *userp, void *socketp) {
+	ConnectionManager *manager = (ConnectionManager *)userp;
+	if (what == CURL_POLL_REMOVE)
+		manager->_sockets.erase(socket);
+	else
+		manager->_sockets[socket] = what;
+	return 0;
+}
+
+int ConnectionManager::curlTimerCallback(CURLM *multi, long timeoutMs, void *userp) {
+	ConnectionManager *manager = (ConnectionManager *)userp;
+	manager->_curlTimeout = timeoutMs;
+	manager->_curlTimeoutStart = g_system->getMillis(true);
+	return 0;
 }
 
 } // End of namespace Cloud
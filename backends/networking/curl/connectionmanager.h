@@ -27,6 +27,7 @@
 #include "common/singleton.h"
 #include "common/hashmap.h"
 #include "common/mutex.h"
+#include "common/thread.h"
 
 typedef void CURL;
 typedef void CURLM;
@@ -42,6 +43,7 @@ class ConnectionManager : public Common::Singleton<ConnectionManager> {
 	static const uint32 CLOUD_PERIOD = 1; //every frame
 	static const uint32 CURL_PERIOD = 1; //every frame
 	static const uint32 DEBUG_PRINT_PERIOD = FRAMES_PER_SECOND; // once per second
+	static const uint32 IDLE_HANDLE_INTERVAL = 100; // milliseconds
 
 	friend void connectionsThread(void *); //calls handle()
 
@@ -74,19 +76,61 @@ class ConnectionManager : public Common::Singleton<ConnectionManager> {
 		RequestWithCallback(Request *rq = nullptr, RequestCallback cb = nullptr): request(rq), onDeleteCallback(cb) {}
 	};
 
+public:
+	/** Counters of the event-driven network thread. */
+	struct LoopStats {
+		uint32 wakeups;       ///< how many times the thread returned from poll()
+		uint32 socketEvents;  ///< how many ready sockets were passed to libcurl
+		uint32 curlTimeouts;  ///< how many libcurl timeouts have expired
+		uint32 handlePasses;  ///< how many times the Requests were handled
+
+		LoopStats(): wakeups(0), socketEvents(0), curlTimeouts(0), handlePasses(0) {}
+	};
+
+private:
 	CURLM *_multi;
 	bool _timerStarted;
 	Common::Array<RequestWithCallback> _requests, _addedRequests;
 	Common::Mutex _handleMutex, _addedRequestsMutex;
 	uint32 _frame;
 
+	/**
+	 * Event-driven mode: a network thread sleeps in poll() on the sockets
+	 * libcurl asked to watch, and wakes up only when one of them is ready,
+	 * when libcurl's timeout expires or when a new Request is added.
+	 *
+	 * Requests are handled right after their transfers made progress.
+	 * Otherwise they are handled every TIMER_INTERVAL while one of them
+	 * waits to retry, and every IDLE_HANDLE_INTERVAL while any is running.
+	 *
+	 * If the backend can't create threads, the timer is used instead.
+	 */
+	Common::ThreadInternal *_thread;
+	bool _quitThread;
+	int _wakeUpPipe[2];
+	Common::HashMap<int, int> _sockets; // socket -> CURL_POLL_* events
+	int32 _curlTimeout;                 // milliseconds, -1 if there is none
+	uint32 _curlTimeoutStart;
+	uint32 _lastIdleHandle, _lastRetryHandle;
+	LoopStats _loopStats;
+
 	void startTimer(int interval = TIMER_INTERVAL);
 	void stopTimer();
 	void handle();
-	void interateRequests();
+	bool interateRequests(bool tick = true);
 	void processTransfers();
+	bool readTransferMessages();
 	bool hasAddedRequests();
 
+	bool startThread();
+	void stopThread();
+	void wakeUpThread() const;
+	void runThread();
+	int32 getPollTimeout(uint32 now, bool hasRetries) const;
+	static void threadProc(void *data);
+	static int curlSocketCallback(CURL *easy, int socket, int what, void *userp, void *socketp);
+	static int curlTimerCallback(CURLM *multi, long timeoutMs, void *userp);
+
 public:
 	ConnectionManager();
 	~ConnectionManager() override;
@@ -118,6 +162,9 @@ public:
 
 	static uint32 getCloudRequestsPeriodInMicroseconds();
 
+	/** Return the counters of the network thread (all zero in timer mode). */
+	LoopStats getLoopStats();
+
 	/** Return the path to the CA certificates bundle. */
 	static Common::String getCaCertPath();
 };
@@ -30,17 +30,16 @@ namespace Networking {
 
 Client::Client():
 	_state(INVALID), _set(nullptr), _socket(nullptr), _handler(nullptr),
-	_previousHandler(nullptr), _stream(nullptr), _buffer(new byte[CLIENT_BUFFER_SIZE]) {}
+	_previousHandler(nullptr), _stream(nullptr), _buffer(nullptr) {}
 
 Client::Client(SDLNet_SocketSet set, TCPsocket socket):
 	_state(INVALID), _set(nullptr), _socket(nullptr), _handler(nullptr),
-	_previousHandler(nullptr), _stream(nullptr), _buffer(new byte[CLIENT_BUFFER_SIZE]) {
+	_previousHandler(nullptr), _stream(nullptr), _buffer(nullptr) {
 	open(set, socket);
 }
 
 Client::~Client() {
 	close();
-	delete[] _buffer;
 }
 
 void Client::open(SDLNet_SocketSet set, TCPsocket socket) {
@@ -58,6 +57,9 @@ void Client::open(SDLNet_SocketSet set, TCPsocket socket) {
 		delete _previousHandler;
 	_previousHandler = nullptr;
 	_stream = new Common::MemoryReadWriteStream(DisposeAfterUse::YES);
+	// only connected clients keep a receive buffer
+	if (!_buffer)
+		_buffer = new byte[CLIENT_BUFFER_SIZE];
 	if (set) {
 		int numused = SDLNet_TCP_AddSocket(set, socket);
 		if (numused == -1) {
@@ -169,6 +171,9 @@ void Client::close() {
 		_stream = nullptr;
 	}
 
+	delete[] _buffer;
+	_buffer = nullptr;
+
 	_state = INVALID;
 }
 
@@ -189,6 +194,18 @@ Common::String Client::anchor() const { return _reader.anchor(); }
 
 bool Client::noMoreContent() const { return _reader.noMoreContent(); }
 
+bool Client::hasWork() const {
+	switch (_state) {
+	case READ_HEADERS:
+	case BAD_REQUEST:
+		return true;
+	case BEING_HANDLED:
+		return _handler && _handler->hasWork();
+	default:
+		return false;
+	}
+}
+
 bool Client::socketIsReady() { return SDLNet_SocketReady(_socket); }
 
 int Client::recv(void *data, int maxlen) { return SDLNet_TCP_Recv(_socket, data, maxlen); }
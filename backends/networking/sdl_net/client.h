@@ -50,6 +50,12 @@ class ClientHandler {
 public:
 	virtual ~ClientHandler() {};
 	virtual void handle(Client *client) = 0;
+
+	/**
+	 * Return true if handle() can do some work without waiting
+	 * for the client to send more data (e.g. send the response).
+	 */
+	virtual bool hasWork() const { return false; }
 };
 
 /**
@@ -108,6 +114,13 @@ public:
 
 	bool noMoreContent() const;
 
+	/**
+	 * Return true if the Client should be handled again even though
+	 * its socket has nothing new to read, i.e. it's sending a response
+	 * or its request has been read and needs a handler.
+	 */
+	bool hasWork() const;
+
 	/**
 	 * Return SDLNet_SocketReady(_socket).
 	 *
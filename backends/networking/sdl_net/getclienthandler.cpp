@@ -109,7 +109,7 @@ void GetClientHandler::prepareHeaders() {
 		setHeader("Content-Type", "text/html; charset=UTF-8");
 
 	if (!_specialHeaders.contains("Content-Length") && _stream)
-		setHeader("Content-Length", Common::String::format("%u", unsigned(_stream->size())));
+		setHeader("Content-Length", Common::String::format("%llu", (unsigned long long)_stream->size()));
 
 	_headers = Common::String::format("HTTP/1.1 %ld %s\r\n", _responseCode, responseMessage(_responseCode));
 	for (Common::HashMap<Common::String, Common::String>::iterator i = _specialHeaders.begin(); i != _specialHeaders.end(); ++i)
@@ -125,7 +125,7 @@ void GetClientHandler::handle(Client *client) {
 	if (!_headersPrepared)
 		prepareHeaders();
 
-	uint32 readBytes;
+	uint32 readBytes = 0;
 
 	// send headers first
 	if (_headers.size() > 0) {
@@ -134,15 +134,13 @@ void GetClientHandler::handle(Client *client) {
 			readBytes = CLIENT_HANDLER_BUFFER_SIZE;
 		memcpy(_buffer, _headers.c_str(), readBytes);
 		_headers.erase(0, readBytes);
-	} else {
-		if (!_stream) {
-			client->close();
-			return;
-		}
-
-		readBytes = _stream->read(_buffer, CLIENT_HANDLER_BUFFER_SIZE);
 	}
 
+	// fill the rest of the buffer straight from the stream, so
+	// the headers go out together with the first chunk of data
+	if (_headers.empty() && _stream)
+		readBytes += _stream->read(_buffer + readBytes, CLIENT_HANDLER_BUFFER_SIZE - readBytes);
+
 	if (readBytes != 0)
 		if (client->send(_buffer, readBytes) != (int)readBytes) {
 			warning("GetClientHandler: unable to send all bytes to the client");
@@ -151,7 +149,7 @@ void GetClientHandler::handle(Client *client) {
 		}
 
 	// we're done here!
-	if (_stream->eos())
+	if (_headers.empty() && (!_stream || _stream->eos() || _stream->pos() >= _stream->size()))
 		client->close();
 }
 
@@ -47,6 +47,7 @@ public:
 	~GetClientHandler() override;
 
 	void handle(Client *client) override;
+	bool hasWork() const override { return true; }
 	void setHeader(const Common::String &name, const Common::String &value);
 	void setResponseCode(long code);
 };
@@ -66,7 +66,8 @@ DECLARE_SINGLETON(Networking::LocalWebserver);
 namespace Networking {
 
 LocalWebserver::LocalWebserver(): _set(nullptr), _serverSocket(nullptr), _timerStarted(false),
-	_stopOnIdle(false), _minimalMode(false), _clients(0), _idlingFrames(0), _serverPort(DEFAULT_SERVER_PORT) {
+	_stopOnIdle(false), _minimalMode(false), _clients(0), _idleStart(0), _serverPort(DEFAULT_SERVER_PORT),
+	_thread(nullptr), _threadRunning(false), _quitThread(false) {
 	addPathHandler("/", &_indexPageHandler);
 	addPathHandler("/files", &_filesPageHandler);
 	addPathHandler("/create", &_createDirectoryHandler);
@@ -105,16 +106,67 @@ void LocalWebserver::stopTimer() {
 	_timerStarted = false;
 }
 
+bool LocalWebserver::startThread() {
+	_quitThread = false;
+	_threadRunning = true;
+	_thread = g_system->createThread(threadProc, this);
+	if (!_thread) {
+		_threadRunning = false;
+		return false;
+	}
+	return true;
+}
+
+void LocalWebserver::stopThread() {
+	if (!_thread)
+		return;
+
+	_handleMutex.lock();
+	_quitThread = true;
+	_handleMutex.unlock();
+
+	delete _thread;
+	_thread = nullptr;
+}
+
+void LocalWebserver::threadProc(void *data) {
+	((LocalWebserver *)data)->runThread();
+}
+
+void LocalWebserver::runThread() {
+	_handleMutex.lock();
+	while (!_quitThread) {
+		// don't wait for the sockets while there is something to send
+		if (!hasBusyClients()) {
+			SDLNet_SocketSet set = _set;
+			_handleMutex.unlock();
+			if (SDLNet_CheckSockets(set, IDLE_WAIT_TIME) == -1)
+				g_system->delayMillis(IDLE_WAIT_TIME);
+			_handleMutex.lock();
+			if (_quitThread)
+				break;
+		}
+
+		handle();
+	}
+	_handleMutex.unlock();
+}
+
 void LocalWebserver::start(bool useMinimalMode) {
 	_handleMutex.lock();
 	_serverPort = getPort();
 	_stopOnIdle = false;
-	if (_timerStarted) {
+	if (_timerStarted || _threadRunning) {
 		_handleMutex.unlock();
 		return;
 	}
+	_handleMutex.unlock();
+
+	// the thread might have ended on its own after stopOnIdle()
+	stopThread();
+
+	_handleMutex.lock();
 	_minimalMode = useMinimalMode;
-	startTimer();
 
 	// Create a listening TCP socket
 	IPaddress ip;
@@ -127,7 +179,6 @@ void LocalWebserver::start(bool useMinimalMode) {
 	_serverSocket = SDLNet_TCP_Open(&ip);
 	if (!_serverSocket) {
 		warning("LocalWebserver: SDLNet_TCP_Open: %s", SDLNet_GetError());
-		stopTimer();
 		g_system->displayMessageOnOSD(_("Failed to start local webserver.\nCheck whether selected port is not used by another application and try again."));
 		_handleMutex.unlock();
 		return;
@@ -144,18 +195,30 @@ void LocalWebserver::start(bool useMinimalMode) {
 		error("LocalWebserver: SDLNet_AddSocket: %s\n", SDLNet_GetError());
 	}
 
-	if (_timerStarted)
+	_idleStart = g_system->getMillis(true);
+	if (!startThread())
+		startTimer();
+
+	if (_timerStarted || _threadRunning)
 		g_system->taskStarted(OSystem::kLocalServer);
 
 	_handleMutex.unlock();
 }
 
 void LocalWebserver::stop() {
+	stopThread();
+
 	_handleMutex.lock();
-	if (_timerStarted) {
-		stopTimer();
+	closeServer();
+	_handleMutex.unlock();
+}
+
+void LocalWebserver::closeServer() {
+	if (_timerStarted || _threadRunning)
 		g_system->taskFinished(OSystem::kLocalServer);
-	}
+	if (_timerStarted)
+		stopTimer();
+	_threadRunning = false;
 
 	if (_serverSocket) {
 		SDLNet_TCP_Close(_serverSocket);
@@ -171,7 +234,6 @@ void LocalWebserver::stop() {
 		SDLNet_FreeSocketSet(_set);
 		_set = nullptr;
 	}
-	_handleMutex.unlock();
 }
 
 void LocalWebserver::stopOnIdle() { _stopOnIdle = true; }
@@ -189,7 +251,7 @@ IndexPageHandler &LocalWebserver::indexPageHandler() { return _indexPageHandler;
 bool LocalWebserver::isRunning() {
 	bool result = false;
 	_handleMutex.lock();
-	result = _timerStarted;
+	result = _timerStarted || _threadRunning;
 	_handleMutex.unlock();
 	return result;
 }
@@ -219,20 +281,25 @@ void LocalWebserver::handle() {
 		if (_client[i].state() != INVALID)
 			++_clients;
 
-	if (_clients == 0)
-		++_idlingFrames;
-	else
-		_idlingFrames = 0;
+	uint32 now = g_system->getMillis(true);
+	if (_clients != 0)
+		_idleStart = now;
 
-	if (_idlingFrames > FRAMES_PER_SECOND && _stopOnIdle) {
-		_handleMutex.unlock();
-		stop();
-		return;
+	if (now - _idleStart > STOP_ON_IDLE_DELAY && _stopOnIdle) {
+		closeServer();
+		_quitThread = true; // the thread, if any, can't join itself
 	}
 
 	_handleMutex.unlock();
 }
 
+bool LocalWebserver::hasBusyClients() const {
+	for (uint32 i = 0; i < MAX_CONNECTIONS; ++i)
+		if (_client[i].hasWork())
+			return true;
+	return false;
+}
+
 void LocalWebserver::handleClient(uint32 i) {
 	switch (_client[i].state()) {
 	case INVALID:
@@ -275,21 +342,25 @@ void LocalWebserver::acceptClient() {
 	if (!SDLNet_SocketReady(_serverSocket))
 		return;
 
-	TCPsocket client = SDLNet_TCP_Accept(_serverSocket);
-	if (!client)
-		return;
-
-	if (_clients == MAX_CONNECTIONS) { //drop the connection
-		SDLNet_TCP_Close(client);
-		return;
-	}
+	// Take all pending connections at once, so that a burst of clients
+	// does not overflow the listen backlog. Server sockets don't block.
+	for (;;) {
+		TCPsocket client = SDLNet_TCP_Accept(_serverSocket);
+		if (!client)
+			return;
 
-	++_clients;
-	for (uint32 i = 0; i < MAX_CONNECTIONS; ++i)
-		if (_client[i].state() == INVALID) {
-			_client[i].open(_set, client);
-			break;
+		if (_clients == MAX_CONNECTIONS) { //drop the connection
+			SDLNet_TCP_Close(client);
+			return;
 		}
+
+		++_clients;
+		for (uint32 i = 0; i < MAX_CONNECTIONS; ++i)
+			if (_client[i].state() == INVALID) {
+				_client[i].open(_set, client);
+				break;
+			}
+	}
 }
 
 void LocalWebserver::resolveAddress(void *ipAddress) {
@@ -45,6 +45,7 @@
 
 namespace Common {
 class SeekableReadStream;
+class ThreadInternal;
 }
 
 typedef struct _SDLNet_SocketSet *SDLNet_SocketSet;
@@ -57,7 +58,9 @@ namespace Networking {
 class LocalWebserver : public Common::Singleton<LocalWebserver> {
 	static const uint32 FRAMES_PER_SECOND = 20;
 	static const uint32 TIMER_INTERVAL = 1000000 / FRAMES_PER_SECOND;
-	static const uint32 MAX_CONNECTIONS = 10;
+	static const uint32 MAX_CONNECTIONS = 32;
+	static const uint32 IDLE_WAIT_TIME = 100; // milliseconds
+	static const uint32 STOP_ON_IDLE_DELAY = 1000; // milliseconds
 
 	friend void localWebserverTimer(void *); //calls handle()
 
@@ -81,13 +84,28 @@ class LocalWebserver : public Common::Singleton<LocalWebserver> {
 #endif // USE_LIBCURL
 #endif // USE_CLOUD
 	ResourceHandler _resourceHandler;
-	uint32 _idlingFrames;
+	uint32 _idleStart;
 	Common::Mutex _handleMutex;
 	Common::String _address;
 	uint32 _serverPort;
 
+	/**
+	 * The server runs on its own thread if the backend supports it.
+	 * The thread waits until a socket has something to read and only
+	 * spins without waiting while some client is sending a response.
+	 * Otherwise, handle() is called by a timer FRAMES_PER_SECOND times.
+	 */
+	Common::ThreadInternal *_thread;
+	bool _threadRunning, _quitThread;
+
 	void startTimer(int interval = TIMER_INTERVAL);
 	void stopTimer();
+	bool startThread();
+	void stopThread();
+	static void threadProc(void *data);
+	void runThread();
+	void closeServer();
+	bool hasBusyClients() const;
 	void handle();
 	void handleClient(uint32 i);
 	void acceptClient();
@@ -296,17 +296,64 @@ void Reader::parseQueryParameters() {
 	}
 }
 
+namespace {
+const byte *findBoundary(const byte *data, uint32 size, const Common::String &boundary) {
+	const uint32 boundarySize = boundary.size();
+	if (size < boundarySize)
+		return nullptr;
+
+	const byte *last = data + size - boundarySize;
+	for (const byte *i = data; i <= last; ++i) {
+		i = (const byte *)memchr(i, boundary[0], last - i + 1);
+		if (i == nullptr)
+			break;
+		if (memcmp(i, boundary.c_str(), boundarySize) == 0)
+			return i;
+	}
+	return nullptr;
+}
+}
+
 bool Reader::readContentIntoStream(Common::WriteStream *stream) {
 	Common::String boundary = "--" + _boundary;
 	if (!_firstBlock)
 		boundary = "\r\n" + boundary;
 	if (_boundary.empty())
 		boundary = "\r\n";
+
+	// Content is scanned in big chunks: the window holds the bytes read
+	// from the content stream which weren't passed to <stream> yet
+	const uint32 boundarySize = boundary.size();
 	if (_window == nullptr)
-		makeWindow(boundary.size());
+		makeWindow(CONTENT_WINDOW_SIZE + boundarySize);
+
+	while (true) {
+		uint32 bytesToRead = MIN(_windowSize - _windowUsed, _bytesLeft);
+		uint32 bytesRead = _content->read(_window + _windowUsed, bytesToRead);
+		_windowUsed += bytesRead;
+		_availableBytes -= bytesRead;
+		_bytesLeft -= bytesRead;
+
+		const byte *found = findBoundary(_window, _windowUsed, boundary);
+		if (found) {
+			uint32 contentSize = found - _window;
+			if (stream && stream->write(_window, contentSize) != contentSize)
+				warning("Reader::readContentIntoStream(): failed to write buffer to stream");
+
+			// whatever follows the boundary is not ours to read
+			unreadBytes(found + boundarySize, _windowUsed - contentSize - boundarySize);
+			break;
+		}
+
+		// only the last bytes could be the beginning of the boundary
+		if (_windowUsed >= boundarySize) {
+			uint32 contentSize = _windowUsed - (boundarySize - 1);
+			if (stream && stream->write(_window, contentSize) != contentSize)
+				warning("Reader::readContentIntoStream(): failed to write buffer to stream");
+			memmove(_window, _window + contentSize, _windowUsed - contentSize);
+			_windowUsed -= contentSize;
+		}
 
-	uint32 boundaryHash = calculateHash(boundary);
-	while (readOneByteInStream(stream, boundary, boundaryHash)) {
 		if (!bytesLeft())
 			return false;
 	}
@@ -320,6 +367,22 @@ bool Reader::readContentIntoStream(Common::WriteStream *stream) {
 	return true;
 }
 
+void Reader::unreadBytes(const byte *data, uint32 size) {
+	if (size == 0)
+		return;
+
+	// the content stream is a queue, so the bytes still
+	// waiting in it have to go after the returned ones
+	byte *buffer = new byte[size + _bytesLeft];
+	memcpy(buffer, data, size);
+	uint32 bytesRead = _content->read(buffer + size, _bytesLeft);
+	_content->write(buffer, size + bytesRead);
+	delete[] buffer;
+
+	_availableBytes += size;
+	_bytesLeft = size + bytesRead;
+}
+
 void Reader::makeWindow(uint32 size) {
 	freeWindow();
 
@@ -529,15 +592,11 @@ Common::String Reader::queryParameter(const Common::String &name) const { return
 Common::String Reader::anchor() const { return _anchor; }
 
 Common::String Reader::readEverythingFromMemoryStream(Common::MemoryReadWriteStream *stream) {
-	Common::String result;
-	char buf[1024];
-	uint32 readBytes;
-	while (true) {
-		readBytes = stream->read(buf, 1024);
-		if (readBytes == 0)
-			break;
-		result += Common::String(buf, readBytes);
-	}
+	uint32 size = stream->size() - stream->pos();
+	char *buffer = new char[size];
+	uint32 readBytes = stream->read(buffer, size);
+	Common::String result(buffer, readBytes);
+	delete[] buffer;
 	return result;
 }
 
@@ -91,9 +91,9 @@ class Reader {
 	Common::String _headers;
 	Common::String _method, _path, _query, _anchor;
 	Common::HashMap<Common::String, Common::String> _queryParameters;
-	uint32 _contentLength;
+	uint64 _contentLength;
 	Common::String _boundary;
-	uint32 _availableBytes;
+	uint64 _availableBytes;
 	bool _firstBlock;
 	bool _isBadRequest;
 	bool _allContentRead;
@@ -112,12 +112,14 @@ class Reader {
 	void makeWindow(uint32 size);
 	void freeWindow();
 	bool readOneByteInStream(Common::WriteStream *stream, const Common::String &boundary, const uint32 boundaryHash);
+	void unreadBytes(const byte *data, uint32 size);
 
 	byte readOne();
 	uint32 bytesLeft() const;
 
 public:
 	static const int32 SUSPICIOUS_HEADERS_SIZE = 1024 * 1024; // 1 MB is really a lot
+	static const uint32 CONTENT_WINDOW_SIZE = 256 * 1024;
 
 	Reader();
 	~Reader();
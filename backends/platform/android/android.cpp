@@ -810,6 +810,7 @@ Common::MutexInternal *OSystem_Android::createMutex() {
 void OSystem_Android::quit() {
 	ENTER();
 
+	Common::ConfigManager::flushBeforeExit();
 	_audio_thread_exit = true;
 	_timer_thread_exit = true;
 
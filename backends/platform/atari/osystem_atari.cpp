@@ -367,6 +367,7 @@ Common::HardwareInputSet *OSystem_Atari::getHardwareInputSet() {
 }
 
 void OSystem_Atari::quit() {
+	Common::ConfigManager::flushBeforeExit();
 	debug("OSystem_Atari::quit()");
 
 	g_system->destroy();
@@ -197,6 +197,7 @@ void OSystem_GPH::addSysArchivesToSearchSet(Common::SearchSet &s, int priority)
 }
 
 void OSystem_GPH::quit() {
+	Common::ConfigManager::flushBeforeExit();
 
 	WIZ_HW::deviceDeinit();
 
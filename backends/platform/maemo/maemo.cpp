@@ -79,10 +79,12 @@ void OSystem_SDL_Maemo::initBackend() {
 }
 
 void OSystem_SDL_Maemo::quit() {
+	Common::ConfigManager::flushBeforeExit();
 	delete this;
 }
 
 void OSystem_SDL_Maemo::fatalError() {
+	Common::ConfigManager::flushBeforeExit();
 	delete this;
 }
 
@@ -49,7 +49,12 @@ typedef void (*sighandler_t)(int);
 #if defined(USE_NULL_DRIVER)
 #include "backends/modular-backend.h"
 #include "backends/mutex/null/null-mutex.h"
+#ifdef HAS_PTHREADS
+#include "backends/mutex/pthread/pthread-mutex.h"
+#include "backends/threads/pthread/pthread-threads.h"
+#endif
 #include "base/main.h"
+#include "common/config-manager.h"
 
 #ifndef NULL_DRIVER_USE_FOR_TEST
 #include "backends/saves/default/default-saves.h"
@@ -84,7 +89,14 @@ public:
 
 	virtual bool pollEvent(Common::Event &event);
 
+	virtual bool hasFeature(Feature f);
+
 	virtual Common::MutexInternal *createMutex();
+#ifdef HAS_PTHREADS
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *data);
+	virtual Common::SemaphoreInternal *createSemaphore(uint initialCount);
+	virtual uint getCPUCount();
+#endif
 	virtual uint32 getMillis(bool skipRecord = false);
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &td, bool skipRecord = false) const;
@@ -186,9 +198,39 @@ bool OSystem_NULL::pollEvent(Common::Event &event) {
 	return false;
 }
 
+bool OSystem_NULL::hasFeature(Feature f) {
+#ifdef HAS_PTHREADS
+	if (f == kFeatureThreads)
+		return true;
+#endif
+	// The test runner uses this backend without calling initBackend()
+	if (!_graphicsManager)
+		return false;
+	return ModularGraphicsBackend::hasFeature(f);
+}
+
 Common::MutexInternal *OSystem_NULL::createMutex() {
+#ifdef HAS_PTHREADS
+	// Worker threads need real locking
+	return createPthreadMutexInternal();
+#else
 	return new NullMutexInternal();
+#endif
+}
+
+#ifdef HAS_PTHREADS
+Common::ThreadInternal *OSystem_NULL::createThread(Common::ThreadProc proc, void *data) {
+	return createPthreadThreadInternal(proc, data);
+}
+
+Common::SemaphoreInternal *OSystem_NULL::createSemaphore(uint initialCount) {
+	return createPthreadSemaphoreInternal(initialCount);
+}
+
+uint OSystem_NULL::getCPUCount() {
+	return getPthreadCPUCount();
 }
+#endif
 
 uint32 OSystem_NULL::getMillis(bool skipRecord) {
 #ifdef POSIX
@@ -226,6 +268,7 @@ void OSystem_NULL::getTimeAndDate(TimeDate &td, bool skipRecord) const {
 }
 
 void OSystem_NULL::quit() {
+	Common::ConfigManager::flushBeforeExit();
 	exit(0);
 }
 
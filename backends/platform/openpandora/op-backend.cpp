@@ -176,6 +176,7 @@ void OSystem_OP::addSysArchivesToSearchSet(Common::SearchSet &s, int priority) {
 }
 
 void OSystem_OP::quit() {
+	Common::ConfigManager::flushBeforeExit();
 
 #ifdef DUMP_STDOUT
 	printf("%s\n", "Debug: STDOUT and STDERR text files closed.");
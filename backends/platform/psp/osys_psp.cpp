@@ -407,6 +407,7 @@ void OSystem_PSP::setupMixer(void) {
 }
 
 void OSystem_PSP::quit() {
+	Common::ConfigManager::flushBeforeExit();
 	_audio.close();
 	sceKernelExitGame();
 }
@@ -27,6 +27,7 @@
 #include "backends/events/samsungtvsdl/samsungtvsdl-events.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/fs/posix/posix-fs.h"
+#include "common/config-manager.h"
 #include "common/textconsole.h"
 
 void OSystem_SDL_SamsungTV::initBackend() {
@@ -44,10 +45,12 @@ void OSystem_SDL_SamsungTV::initBackend() {
 }
 
 void OSystem_SDL_SamsungTV::quit() {
+	Common::ConfigManager::flushBeforeExit();
 	delete this;
 }
 
 void OSystem_SDL_SamsungTV::fatalError() {
+	Common::ConfigManager::flushBeforeExit();
 	delete this;
 	warning("ScummVM: Fatal internal error.");
 	for (;;) {}
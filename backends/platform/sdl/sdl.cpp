@@ -46,6 +46,7 @@
 #include "backends/events/sdl/legacy-sdl-events.h"
 #include "backends/keymapper/hardware-input.h"
 #include "backends/mutex/sdl/sdl-mutex.h"
+#include "backends/threads/sdl/sdl-threads.h"
 #include "backends/timer/sdl/sdl-timer.h"
 #include "backends/graphics/surfacesdl/surfacesdl-graphics.h"
 #ifdef USE_OPENGL
@@ -198,6 +199,7 @@ bool OSystem_SDL::hasFeature(Feature f) {
 #if SDL_VERSION_ATLEAST(2, 0, 14)
 	if (f == kFeatureOpenUrl) return true;
 #endif
+	if (f == kFeatureThreads) return true;
 	if (f == kFeatureJoystickDeadzone || f == kFeatureKbdMouseSpeed) {
 		return _eventSource->isJoystickConnected();
 	}
@@ -561,11 +563,13 @@ void *OSystem_SDL::getOpenGLProcAddress(const char *name) const {
 #endif
 
 void OSystem_SDL::quit() {
+	Common::ConfigManager::flushBeforeExit();
 	destroy();
 	exit(0);
 }
 
 void OSystem_SDL::fatalError() {
+	Common::ConfigManager::flushBeforeExit();
 	destroy();
 	exit(1);
 }
@@ -724,6 +728,18 @@ Common::MutexInternal *OSystem_SDL::createMutex() {
 	return createSdlMutexInternal();
 }
 
+Common::ThreadInternal *OSystem_SDL::createThread(Common::ThreadProc proc, void *data) {
+	return createSdlThreadInternal(proc, data);
+}
+
+Common::SemaphoreInternal *OSystem_SDL::createSemaphore(uint initialCount) {
+	return createSdlSemaphoreInternal(initialCount);
+}
+
+uint OSystem_SDL::getCPUCount() {
+	return getSdlCPUCount();
+}
+
 uint32 OSystem_SDL::getMillis(bool skipRecord) {
 	uint32 millis = SDL_GetTicks();
 
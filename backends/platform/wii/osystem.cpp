@@ -145,6 +145,7 @@ void OSystem_Wii::initBackend() {
 }
 
 void OSystem_Wii::quit() {
+	Common::ConfigManager::flushBeforeExit();
 	/* Delete _timerManager before deinitializing events as it's tied */
 	delete _timerManager;
 	_timerManager = nullptr;
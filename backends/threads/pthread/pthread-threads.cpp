@@ -0,0 +1,183 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(HAS_PTHREADS)
+
+#include "backends/threads/pthread/pthread-threads.h"
+#include "common/textconsole.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * pthreads thread implementation
+ */
+class PthreadThreadInternal final : public Common::ThreadInternal {
+public:
+	PthreadThreadInternal(Common::ThreadProc proc, void *data);
+	~PthreadThreadInternal() override;
+
+	bool start();
+	bool join() override;
+
+private:
+	static void *threadFunc(void *arg);
+
+	Common::ThreadProc _proc;
+	void *_data;
+	pthread_t _thread;
+	bool _joinable;
+};
+
+PthreadThreadInternal::PthreadThreadInternal(Common::ThreadProc proc, void *data)
+	: _proc(proc), _data(data), _joinable(false) {
+}
+
+PthreadThreadInternal::~PthreadThreadInternal() {
+	join();
+}
+
+bool PthreadThreadInternal::start() {
+	if (pthread_create(&_thread, nullptr, threadFunc, this) != 0) {
+		warning("pthread_create() failed");
+		return false;
+	}
+	_joinable = true;
+	return true;
+}
+
+bool PthreadThreadInternal::join() {
+	if (!_joinable)
+		return true;
+
+	_joinable = false;
+	if (pthread_join(_thread, nullptr) != 0) {
+		warning("pthread_join() failed");
+		return false;
+	}
+	return true;
+}
+
+void *PthreadThreadInternal::threadFunc(void *arg) {
+	PthreadThreadInternal *thread = (PthreadThreadInternal *)arg;
+	thread->_proc(thread->_data);
+	return nullptr;
+}
+
+/**
+ * Counting semaphore built on a pthreads mutex and condition variable,
+ * since unnamed POSIX semaphores are not available everywhere.
+ */
+class PthreadSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	PthreadSemaphoreInternal(uint initialCount);
+	~PthreadSemaphoreInternal() override;
+
+	void post() override;
+	void wait() override;
+	bool timedWait(uint32 usecs) override;
+
+private:
+	pthread_mutex_t _mutex;
+	pthread_cond_t _cond;
+	uint _count;
+};
+
+PthreadSemaphoreInternal::PthreadSemaphoreInternal(uint initialCount) : _count(initialCount) {
+	if (pthread_mutex_init(&_mutex, nullptr) != 0)
+		warning("pthread_mutex_init() failed");
+	if (pthread_cond_init(&_cond, nullptr) != 0)
+		warning("pthread_cond_init() failed");
+}
+
+PthreadSemaphoreInternal::~PthreadSemaphoreInternal() {
+	pthread_cond_destroy(&_cond);
+	pthread_mutex_destroy(&_mutex);
+}
+
+void PthreadSemaphoreInternal::post() {
+	pthread_mutex_lock(&_mutex);
+	_count++;
+	pthread_cond_signal(&_cond);
+	pthread_mutex_unlock(&_mutex);
+}
+
+void PthreadSemaphoreInternal::wait() {
+	pthread_mutex_lock(&_mutex);
+	while (_count == 0)
+		pthread_cond_wait(&_cond, &_mutex);
+	_count--;
+	pthread_mutex_unlock(&_mutex);
+}
+
+bool PthreadSemaphoreInternal::timedWait(uint32 usecs) {
+	// pthread_cond_timedwait() wants an absolute time on the realtime clock
+	struct timespec deadline;
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	deadline.tv_sec += usecs / 1000000;
+	deadline.tv_nsec += (usecs % 1000000) * 1000;
+	if (deadline.tv_nsec >= 1000000000) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= 1000000000;
+	}
+
+	pthread_mutex_lock(&_mutex);
+	while (_count == 0) {
+		if (pthread_cond_timedwait(&_cond, &_mutex, &deadline) != 0)
+			break;
+	}
+
+	const bool acquired = _count > 0;
+	if (acquired)
+		_count--;
+	pthread_mutex_unlock(&_mutex);
+	return acquired;
+}
+
+Common::ThreadInternal *createPthreadThreadInternal(Common::ThreadProc proc, void *data) {
+	PthreadThreadInternal *thread = new PthreadThreadInternal(proc, data);
+	if (!thread->start()) {
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createPthreadSemaphoreInternal(uint initialCount) {
+	return new PthreadSemaphoreInternal(initialCount);
+}
+
+uint getPthreadCPUCount() {
+#ifdef _SC_NPROCESSORS_ONLN
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	if (count > 0)
+		return (uint)count;
+#endif
+	return 1;
+}
+
+#endif
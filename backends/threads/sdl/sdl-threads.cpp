@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/threads/sdl/sdl-threads.h"
+#include "backends/platform/sdl/sdl-sys.h"
+#include "common/textconsole.h"
+
+/**
+ * SDL thread implementation
+ */
+class SdlThreadInternal final : public Common::ThreadInternal {
+public:
+	SdlThreadInternal(Common::ThreadProc proc, void *data) : _proc(proc), _data(data), _thread(nullptr) {}
+	~SdlThreadInternal() override { join(); }
+
+	bool start();
+	bool join() override;
+
+private:
+	static int SDLCALL threadFunc(void *arg);
+
+	Common::ThreadProc _proc;
+	void *_data;
+	SDL_Thread *_thread;
+};
+
+bool SdlThreadInternal::start() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	_thread = SDL_CreateThread(threadFunc, "ScummVM worker", this);
+#else
+	_thread = SDL_CreateThread(threadFunc, this);
+#endif
+	if (!_thread) {
+		warning("SDL_CreateThread() failed: %s", SDL_GetError());
+		return false;
+	}
+	return true;
+}
+
+bool SdlThreadInternal::join() {
+	if (_thread) {
+		SDL_WaitThread(_thread, nullptr);
+		_thread = nullptr;
+	}
+	return true;
+}
+
+int SDLCALL SdlThreadInternal::threadFunc(void *arg) {
+	SdlThreadInternal *thread = (SdlThreadInternal *)arg;
+	thread->_proc(thread->_data);
+	return 0;
+}
+
+/**
+ * SDL semaphore implementation
+ */
+class SdlSemaphoreInternal final : public Common::SemaphoreInternal {
+public:
+	SdlSemaphoreInternal(uint initialCount) { _sem = SDL_CreateSemaphore(initialCount); }
+	~SdlSemaphoreInternal() override { SDL_DestroySemaphore(_sem); }
+
+	void post() override { SDL_SemPost(_sem); }
+	void wait() override { SDL_SemWait(_sem); }
+	// SDL only waits whole milliseconds, so round up to never wake early
+	bool timedWait(uint32 usecs) override { return SDL_SemWaitTimeout(_sem, (usecs + 999) / 1000) == 0; }
+
+private:
+	SDL_sem *_sem;
+};
+
+Common::ThreadInternal *createSdlThreadInternal(Common::ThreadProc proc, void *data) {
+	SdlThreadInternal *thread = new SdlThreadInternal(proc, data);
+	if (!thread->start()) {
+		delete thread;
+		return nullptr;
+	}
+	return thread;
+}
+
+Common::SemaphoreInternal *createSdlSemaphoreInternal(uint initialCount) {
+	return new SdlSemaphoreInternal(initialCount);
+}
+
+uint getSdlCPUCount() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	int count = SDL_GetCPUCount();
+	if (count > 0)
+		return (uint)count;
+#endif
+	return 1;
+}
+
+#endif
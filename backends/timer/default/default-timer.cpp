@@ -30,88 +30,192 @@ struct TimerSlot {
 	Common::String id;
 	uint32 interval;	// in microseconds
 
-	uint32 nextFireTime;	// in milliseconds
-	uint32 nextFireTimeMicro;	// microseconds part of nextFire
+	uint64 nextFireTime;	// in microseconds
+	uint32 sequence;	// keeps slots with the same fire time in scheduling order
+
+	uint32 invocations;
+	uint64 totalLateness;	// in microseconds
+	uint32 maxLateness;	// in microseconds
+	uint32 latenessHistogram[Common::TimerManager::kLatenessBuckets];
+
+	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), sequence(0),
+		invocations(0), totalLateness(0), maxLateness(0) {
+		for (int i = 0; i < Common::TimerManager::kLatenessBuckets; i++)
+			latenessHistogram[i] = 0;
+	}
 
-	TimerSlot *next;
+	bool firesBefore(const TimerSlot *other) const {
+		if (nextFireTime != other->nextFireTime)
+			return nextFireTime < other->nextFireTime;
+		return (int32)(sequence - other->sequence) < 0;
+	}
 
-	TimerSlot() : callback(nullptr), refCon(nullptr), interval(0), nextFireTime(0), nextFireTimeMicro(0), next(nullptr) {}
-};
+	void recordLateness(uint64 lateness) {
+		const uint32 late = (uint32)MIN<uint64>(lateness, 0xFFFFFFFF);
+		int bucket = 0;
+		while (late > Common::TimerManager::getLatenessBucketLimit(bucket))
+			bucket++;
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
-
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = nullptr;
-
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == nullptr || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
+		invocations++;
+		totalLateness += late;
+		maxLateness = MAX(maxLateness, late);
+		latenessHistogram[bucket]++;
 	}
-}
+};
 
 
 DefaultTimerManager::DefaultTimerManager() :
+	_nextSequence(0),
 	_timerCallbackNext(0),
-	_head(nullptr) {
-
-	_head = new TimerSlot();
+	_thread(nullptr),
+	_wakeUp(nullptr),
+	_quitThread(false) {
 }
 
 DefaultTimerManager::~DefaultTimerManager() {
+	stopThread();
+
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
-		delete slot;
-		slot = next;
+	for (uint i = 0; i < _slots.size(); i++)
+		delete _slots[i];
+	_slots.clear();
+}
+
+void DefaultTimerManager::siftUp(uint index) {
+	TimerSlot *slot = _slots[index];
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (!slot->firesBefore(_slots[parent]))
+			break;
+		_slots[index] = _slots[parent];
+		index = parent;
 	}
-	_head = nullptr;
+	_slots[index] = slot;
 }
 
-void DefaultTimerManager::handler() {
-	Common::StackLock lock(_mutex);
+void DefaultTimerManager::siftDown(uint index) {
+	TimerSlot *slot = _slots[index];
+	const uint size = _slots.size();
+	while (2 * index + 1 < size) {
+		uint child = 2 * index + 1;
+		if (child + 1 < size && _slots[child + 1]->firesBefore(_slots[child]))
+			child++;
+		if (!_slots[child]->firesBefore(slot))
+			break;
+		_slots[index] = _slots[child];
+		index = child;
+	}
+	_slots[index] = slot;
+}
 
-	uint32 curTime = g_system->getMillis(true);
+void DefaultTimerManager::removeSlot(uint index) {
+	delete _slots[index];
 
-	// On slow systems this could still be run after destructor
-	if (!_head)
-		return;
+	// Move the last slot into the hole, and restore the heap order around it
+	_slots[index] = _slots.back();
+	_slots.pop_back();
+	if (index < _slots.size()) {
+		siftUp(index);
+		siftDown(index);
+	}
+}
 
+void DefaultTimerManager::runDueTimers(uint64 now) {
 	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
+	while (!_slots.empty() && _slots[0]->nextFireTime < now) {
+		TimerSlot *slot = _slots[0];
+		const uint64 scheduledTime = slot->nextFireTime;
 
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
+		// Update the fire time, and move the slot behind all the others
+		// scheduled for the same time. The fire time is only ever advanced
+		// by the interval, so the callback does not drift.
 		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
-		}
-		insertPrioQueue(_head, slot);
+		slot->nextFireTime += slot->interval;
+		slot->sequence = _nextSequence++;
+		siftDown(0);
+
+		slot->recordLateness(getMicros(true) - scheduledTime);
 
 		// Invoke the timer callback
 		assert(slot->callback);
 		slot->callback(slot->refCon);
+	}
+}
+
+void DefaultTimerManager::handler() {
+	Common::StackLock lock(_mutex);
+
+	runDueTimers(getMicros(true));
+}
+
+uint64 DefaultTimerManager::getMicros(bool skipRecord) {
+	return (uint64)g_system->getMillis(skipRecord) * 1000;
+}
+
+bool DefaultTimerManager::startThread() {
+	assert(!_thread);
 
-		// Look at the next scheduled timer
-		slot = _head->next;
+	_wakeUp = g_system->createSemaphore(0);
+	if (!_wakeUp)
+		return false;
+
+	_quitThread = false;
+	_thread = g_system->createThread(threadProc, this);
+	if (!_thread) {
+		delete _wakeUp;
+		_wakeUp = nullptr;
+		return false;
 	}
+
+	return true;
+}
+
+void DefaultTimerManager::stopThread() {
+	if (!_thread)
+		return;
+
+	_mutex.lock();
+	_quitThread = true;
+	_mutex.unlock();
+	_wakeUp->post();
+
+	delete _thread;
+	_thread = nullptr;
+	delete _wakeUp;
+	_wakeUp = nullptr;
+}
+
+void DefaultTimerManager::threadProc(void *data) {
+	((DefaultTimerManager *)data)->runThread();
+}
+
+void DefaultTimerManager::runThread() {
+	_mutex.lock();
+
+	while (!_quitThread) {
+		runDueTimers(getMicros(true));
+
+		// Sleep until just past the next fire time, or until a timer is
+		// installed which fires sooner than that
+		uint64 sleepTime = 0;
+		if (!_slots.empty()) {
+			const uint64 now = getMicros(true);
+			if (_slots[0]->nextFireTime >= now)
+				sleepTime = _slots[0]->nextFireTime - now + 1;
+			else
+				continue;
+		}
+
+		_mutex.unlock();
+		if (sleepTime)
+			_wakeUp->timedWait((uint32)MIN<uint64>(sleepTime, 0xFFFFFFFF));
+		else
+			_wakeUp->wait();
+		_mutex.lock();
+	}
+
+	_mutex.unlock();
 }
 
 void DefaultTimerManager::checkTimers(uint32 interval) {
@@ -147,11 +251,15 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	slot->refCon = refCon;
 	slot->id = id;
 	slot->interval = interval;
-	slot->nextFireTime = g_system->getMillis() + interval / 1000;
-	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = nullptr;
+	slot->nextFireTime = getMicros() + interval;
+	slot->sequence = _nextSequence++;
 
-	insertPrioQueue(_head, slot);
+	_slots.push_back(slot);
+	siftUp(_slots.size() - 1);
+
+	// Let the thread sleep for a shorter time if this timer fires first
+	if (_thread && _slots[0] == slot)
+		_wakeUp->post();
 
 	return true;
 }
@@ -159,18 +267,12 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 	Common::StackLock lock(_mutex);
 
-	TimerSlot *slot = _head;
-
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
-		} else {
-			slot = slot->next;
-		}
+	for (uint i = 0; i < _slots.size();) {
+		if (_slots[i]->callback == callback)
+			removeSlot(i);
+		else
+			i++;
 	}
-
 	// We need to remove all names referencing the timer proc here.
 	//
 	// Else we run into troubles, when the client code removes and readds timer
@@ -188,3 +290,20 @@ void DefaultTimerManager::removeTimerProc(TimerProc callback) {
 			_callbacks.erase(i);
 	}
 }
+
+void DefaultTimerManager::getTimerStats(Common::Array<TimerStats> &stats) const {
+	Common::StackLock lock(_mutex);
+
+	stats.resize(_slots.size());
+	for (uint i = 0; i < _slots.size(); i++) {
+		const TimerSlot *slot = _slots[i];
+		TimerStats &timer = stats[i];
+		timer.id = slot->id;
+		timer.interval = slot->interval;
+		timer.invocations = slot->invocations;
+		timer.totalLateness = slot->totalLateness;
+		timer.maxLateness = slot->maxLateness;
+		for (int j = 0; j < kLatenessBuckets; j++)
+			timer.latenessHistogram[j] = slot->latenessHistogram[j];
+	}
+}
@@ -23,9 +23,11 @@
 #define BACKENDS_TIMER_DEFAULT_H
 
 #include "common/str.h"
+#include "common/array.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
 #include "common/mutex.h"
+#include "common/thread.h"
 
 struct TimerSlot;
 
@@ -34,16 +36,32 @@ private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
 	Common::Mutex _mutex;
-	TimerSlot *_head;
+	Common::Array<TimerSlot *> _slots;	// Min-heap ordered by next fire time
+	uint32 _nextSequence;
 	TimerSlotMap _callbacks;
 
 	uint32 _timerCallbackNext;
 
+	Common::ThreadInternal *_thread;
+	Common::SemaphoreInternal *_wakeUp;
+	bool _quitThread;
+
+	void siftUp(uint index);
+	void siftDown(uint index);
+	void removeSlot(uint index);
+
+	/** Invoke the callbacks scheduled before @p now, in microseconds. */
+	void runDueTimers(uint64 now);
+
+	static void threadProc(void *data);
+	void runThread();
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
 	virtual bool installTimerProc(TimerProc proc, int32 interval, void *refCon, const Common::String &id);
 	virtual void removeTimerProc(TimerProc proc);
+	virtual void getTimerStats(Common::Array<TimerStats> &stats) const;
 
 	/**
 	 * Timer callback, to be invoked at regular time intervals by the backend.
@@ -55,6 +73,27 @@ public:
 	 * Should be called from pollEvents() on backends without threads.
 	 */
 	void checkTimers(uint32 interval = 10);
+
+protected:
+	/**
+	 * Return the current time in microseconds, which the timer slots are
+	 * scheduled against. Backends with a finer clock than getMillis()
+	 * should override this.
+	 */
+	virtual uint64 getMicros(bool skipRecord = false);
+
+	/**
+	 * Start a thread which sleeps until the next callback is due and
+	 * invokes it, instead of relying on regular calls to handler().
+	 * Returns false if the backend cannot create threads.
+	 */
+	bool startThread();
+
+	/**
+	 * Stop the thread started by startThread(). Derived classes overriding
+	 * getMicros() must call this in their destructor.
+	 */
+	void stopThread();
 };
 
 #endif
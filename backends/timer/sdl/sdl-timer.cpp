@@ -33,21 +33,36 @@ static Uint32 timer_handler(Uint32 interval, void *param) {
 	return interval;
 }
 
-SdlTimerManager::SdlTimerManager() {
+SdlTimerManager::SdlTimerManager() : _timerID(0) {
 	// Initializes the SDL timer subsystem
 	if (SDL_InitSubSystem(SDL_INIT_TIMER) == -1) {
 		error("Could not initialize SDL: %s", SDL_GetError());
 	}
 
-	// Creates the timer callback
-	_timerID = SDL_AddTimer(10, &timer_handler, this);
+	// Prefer a thread sleeping until each callback is due. Otherwise
+	// fall back to checking the timers on a fixed SDL timer tick.
+	if (!startThread())
+		_timerID = SDL_AddTimer(10, &timer_handler, this);
 }
 
 SdlTimerManager::~SdlTimerManager() {
+	stopThread();
+
 	// Removes the timer callback
-	SDL_RemoveTimer(_timerID);
+	if (_timerID)
+		SDL_RemoveTimer(_timerID);
 
 	SDL_QuitSubSystem(SDL_INIT_TIMER);
 }
 
+uint64 SdlTimerManager::getMicros(bool skipRecord) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	const uint64 counter = SDL_GetPerformanceCounter();
+	const uint64 frequency = SDL_GetPerformanceFrequency();
+	return (counter / frequency) * 1000000 + (counter % frequency) * 1000000 / frequency;
+#else
+	return DefaultTimerManager::getMicros(skipRecord);
+#endif
+}
+
 #endif
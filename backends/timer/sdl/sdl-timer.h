@@ -27,8 +27,9 @@
 #include "backends/platform/sdl/sdl-sys.h"
 
 /**
- * SDL timer manager. Setups the timer callback for
- * DefaultTimerManager.
+ * SDL timer manager. Runs the DefaultTimerManager scheduler thread
+ * against the SDL performance counter, or sets up a timer callback
+ * where threads are not available.
  */
 class SdlTimerManager : public DefaultTimerManager {
 public:
@@ -36,6 +37,8 @@ public:
 	virtual ~SdlTimerManager();
 
 protected:
+	uint64 getMicros(bool skipRecord = false) override;
+
 	SDL_TimerID _timerID;
 };
 
@@ -48,6 +48,7 @@
 #endif
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/threadpool.h"
 #include "common/tokenizer.h"
 #include "common/translation.h"
 #include "common/text-to-speech.h"
@@ -322,6 +323,9 @@ static Common::Error runGame(const Plugin *plugin, const Plugin *enginePlugin, O
 	system.getEventManager()->purgeKeyboardEvents();
 	system.getEventManager()->purgeMouseEvents();
 
+	// Do not lose the configuration written from the launcher if the game crashes
+	ConfMan.waitForFlush();
+
 	// Run the engine
 	Common::Error result = engine->run();
 
@@ -791,6 +795,8 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderUpdate);
 			} else if (recordMode == "playback") {
 				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderPlayback);
+			} else if (recordMode == "benchmark") {
+				g_eventRec.init(recordFileName, GUI::EventRecorder::kRecorderPlayback, true);
 			} else if ((recordMode == "info") && (!recordFileName.empty())) {
 				Common::PlaybackFile record;
 				record.openRead(recordFileName);
@@ -896,6 +902,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Cloud::CloudManager::destroy();
 #endif
 #endif
+	Common::ThreadPool::destroy();
 	PluginManager::instance().unloadDetectionPlugin();
 	PluginManager::instance().unloadAllPlugins();
 	PluginManager::destroy();
@@ -357,6 +357,33 @@ public:
 			free(const_cast<byte *>(_ptrOrig));
 	}
 
+	/**
+	 * Create a memory stream of the next @p dataSize bytes of @p stream,
+	 * and skip them in @p stream.
+	 *
+	 * The data is borrowed when @p stream supports borrowData(), so
+	 * @p stream must then outlive the returned stream. Otherwise, the data
+	 * is copied, and data missing at the end of @p stream reads as zeros.
+	 */
+	static BitStreamMemoryStream *createFromStream(SeekableReadStream &stream, uint32 dataSize) {
+		const int64 start = stream.pos();
+		const byte *borrowed = stream.borrowData(start, dataSize);
+		if (borrowed) {
+			stream.seek(start + dataSize);
+			return new BitStreamMemoryStream(borrowed, dataSize);
+		}
+
+		byte *data = (byte *)malloc(dataSize);
+		if (!data && dataSize)
+			error("BitStreamMemoryStream::createFromStream(): Out of memory for %u bytes", dataSize);
+
+		const uint32 readSize = stream.read(data, dataSize);
+		if (readSize != dataSize)
+			memset(data + readSize, 0, dataSize - readSize);
+
+		return new BitStreamMemoryStream(data, dataSize, DisposeAfterUse::YES);
+	}
+
 	bool eos() const {
 		return _eos;
 	}
@@ -373,6 +400,11 @@ public:
 		return _size;
 	}
 
+	/** Return the start of the memory buffer. */
+	const byte *getData() const {
+		return _ptrOrig;
+	}
+
 	bool seek(uint32 offset) {
 		assert(offset <= _size);
 
@@ -422,7 +454,7 @@ public:
 			}
 		}
 
-		uint16 val = READ_LE_UINT16(_ptr);
+		uint16 val = READ_BE_UINT16(_ptr);
 
 		_pos += 2;
 		_ptr += 2;
@@ -468,6 +500,229 @@ public:
 
 };
 
+/**
+ * Bit stream specialization for data already in memory.
+ *
+ * Instead of filling a bit container one data value at a time, every read
+ * loads the 64 bits starting at the data value holding the current position
+ * straight from the buffer, and byte swaps the values where needed. Only
+ * reads close to the end of the buffer go through a slower path, which pads
+ * the data with zero bits.
+ *
+ * The API and the out-of-bounds behavior are the same as for other streams.
+ */
+template<typename CONTAINER, int valueBits, bool isLE, bool MSB2LSB>
+class BitStreamImpl<BitStreamMemoryStream, CONTAINER, valueBits, isLE, MSB2LSB> {
+private:
+	BitStreamMemoryStream *_stream;         //!< The input stream.
+	DisposeAfterUse::Flag _disposeAfterUse; //!< Whether to delete the stream on destruction.
+
+	const byte *_data;                      //!< The data of the input stream.
+	uint32 _dataSize;                       //!< Number of bytes holding bit stream data.
+	uint32 _size;                           //!< Total bit stream size (in bits).
+	uint32 _pos;                            //!< Current bit stream position (in bits).
+
+	void init() {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
+			error("BitStreamImpl: Invalid memory layout %d, %d, %d", valueBits, int(isLE), int(MSB2LSB));
+
+		_data = _stream->getData();
+		_dataSize = _stream->size() & ~((uint32) ((valueBits >> 3) - 1));
+		_size = _dataSize * 8;
+		_pos = 0;
+	}
+
+	/** Swap the bytes of every data value in a 64-bit word. */
+	FORCEINLINE static uint64 swapValues(uint64 x) {
+		if (valueBits >= 16)
+			x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+		if (valueBits == 32)
+			x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+		return x;
+	}
+
+	/** Read 64 bits at @p offset, past the end of the data, padding them with zero bits. */
+	uint64 readTail(uint32 offset) const {
+		byte buffer[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		if (offset < _dataSize)
+			memcpy(buffer, _data + offset, MIN<uint32>(_dataSize - offset, 8));
+
+		return MSB2LSB ? READ_BE_UINT64(buffer) : READ_LE_UINT64(buffer);
+	}
+
+	/**
+	 * Read the 64 bits starting at the data value holding the current
+	 * position. The first bit of the stream is the MSB of the result for
+	 * MSB2LSB streams, and its LSB otherwise.
+	 */
+	FORCEINLINE uint64 readWindow() const {
+		const uint32 offset = (_pos / valueBits) * (valueBits / 8);
+
+		uint64 window;
+		if (offset + 8 <= _dataSize)
+			window = MSB2LSB ? READ_BE_UINT64(_data + offset) : READ_LE_UINT64(_data + offset);
+		else
+			window = readTail(offset);
+
+		// Values stored in the other byte order than the one of the read
+		if (valueBits > 8 && isLE == MSB2LSB)
+			window = swapValues(window);
+
+		return window;
+	}
+
+	/** Get @p n bits, at most 32, starting at the current position. */
+	FORCEINLINE uint32 peekNBits(size_t n) const {
+		if (n == 0)
+			return 0;
+
+		// At least 64 - (valueBits - 1) bits of the window are left after the shift
+		const uint64 window = readWindow();
+		const uint32 shift = _pos % valueBits;
+
+		if (MSB2LSB)
+			return (uint32)((window << shift) >> (64 - n));
+		else
+			return (uint32)((window >> shift) & (((uint64)1 << n) - 1));
+	}
+
+public:
+	/** Create a bit stream using this input data stream and optionally delete it on destruction. */
+	BitStreamImpl(BitStreamMemoryStream *stream, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::NO) :
+	    _stream(stream), _disposeAfterUse(disposeAfterUse) {
+		init();
+	}
+
+	/** Create a bit stream using this input data stream. */
+	BitStreamImpl(BitStreamMemoryStream &stream) :
+	    _stream(&stream), _disposeAfterUse(DisposeAfterUse::NO) {
+		init();
+	}
+
+	~BitStreamImpl() {
+		if (_disposeAfterUse == DisposeAfterUse::YES)
+			delete _stream;
+	}
+
+	/** Read a bit from the bit stream, without changing the stream's position. */
+	uint peekBit() {
+		return peekNBits(1);
+	}
+
+	/** Read a bit from the bit stream. */
+	uint getBit() {
+		const uint b = peekNBits(1);
+		_pos++;
+		return b;
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream, without changing the stream's position.
+	 *
+	 * The bit order is the same as in @ref getBits().
+	 */
+	template<int n>
+	uint32 peekBits() {
+		if (n > 32)
+			error("BitStreamImpl::peekBits(): Too many bits requested to be peeked");
+
+		return peekNBits(n);
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream.
+	 *
+	 * The value is read as if just taken as a whole from the bit stream.
+	 */
+	template<int n>
+	uint32 getBits() {
+		if (n > 32)
+			error("BitStreamImpl::getBits(): Too many bits requested to be read");
+
+		const uint32 b = peekNBits(n);
+		_pos += n;
+		return b;
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream, without changing the stream's position.
+	 *
+	 * The bit order is the same as in @ref getBits().
+	 */
+	uint32 peekBits(size_t n) {
+		if (n > 32)
+			error("BitStreamImpl::peekBits(): Too many bits requested to be peeked");
+
+		return peekNBits(n);
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream.
+	 *
+	 * The value is read as if just taken as a whole from the bit stream.
+	 */
+	uint32 getBits(size_t n) {
+		if (n > 32)
+			error("BitStreamImpl::getBits(): Too many bits requested to be read");
+
+		const uint32 b = peekNBits(n);
+		_pos += n;
+		return b;
+	}
+
+	/**
+	 * Add a bit to the value x, making it an n+1-bit value.
+	 *
+	 * The current value is shifted and the bit is added to the
+	 * appropriate place, depending on the stream's bit order.
+	 */
+	void addBit(uint32 &x, uint32 n) {
+		if (n >= 32)
+			error("BitStreamImpl::addBit(): Too many bits requested to be read");
+
+		if (MSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	/** Rewind the bit stream back to the start. */
+	void rewind() {
+		_pos = 0;
+	}
+
+	/** Skip the specified number of bits. */
+	void skip(uint32 n) {
+		_pos += n;
+	}
+
+	/** Skip the bits to closest data value border. */
+	void align() {
+		uint32 bitsAfterBoundary = _pos % valueBits;
+		if (bitsAfterBoundary) {
+			skip(valueBits - bitsAfterBoundary);
+		}
+	}
+
+	/** Return the stream position in bits. */
+	uint32 pos() const {
+		return _pos;
+	}
+
+	/** Return the stream size in bits. */
+	uint32 size() const {
+		return _size;
+	}
+
+	bool eos() const {
+		return _pos >= _size;
+	}
+
+	static bool isMSB2LSB() {
+		return MSB2LSB;
+	}
+};
+
 /**
  * @name Typedefs for various memory layouts
  * @{
@@ -95,6 +95,9 @@ typedef Byte Bytef;
 #include "common/compression/deflate.h"
 #include "common/compression/unzip.h"
 #include "common/memstream.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/textconsole.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -237,6 +240,13 @@ Common::SharedArchiveContents unzOpenCurrentFile(unzFile file
   If there is no error, the return value is UNZ_OK.
 */
 
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file);
+/*
+  Open the current file in the zipfile as a stream that decompresses on demand.
+  The stream reads from the zipfile, which must stay open while it is in use.
+  Return nullptr in case of error.
+*/
+
 int unzCloseCurrentFile(unzFile file);
 /*
   Close the file in zip opened with unzOpenCurrentFile
@@ -325,6 +335,7 @@ typedef Common::HashMap<Common::Path, cached_file_in_zip, Common::Path::IgnoreCa
 */
 typedef struct {
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
+	Common::SharedPtr<Common::SeekableReadStream> _sharedStream;	/* owns _stream, shared with streamed members */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
 	uLong num_file;					/* number of the current file in the zipfile*/
@@ -459,6 +470,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 	int err = UNZ_OK;
 
 	us->_stream = stream;
+	us->_sharedStream.reset(stream);
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
 	if (central_pos == 0)
@@ -510,7 +522,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream, bool flattenTree) {
 		err = UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return nullptr;
 	}
@@ -600,7 +611,6 @@ int unzClose(unzFile file) {
 		return UNZ_PARAMERROR;
 	s = (unz_s *)file;
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -1018,11 +1028,152 @@ Common::SharedArchiveContents unzOpenCurrentFile (unzFile file
 	return Common::SharedArchiveContents(uncompressedBuffer, s->cur_file_info.uncompressed_size);
 }
 
+namespace {
+
+/*
+  A sub stream of the zipfile which keeps the zipfile stream alive, so that
+  it stays usable after the archive has been closed.
+*/
+class ZipMemberSubReadStream : public Common::SafeSeekableSubReadStream {
+public:
+	ZipMemberSubReadStream(const Common::SharedPtr<Common::SeekableReadStream> &parentStream, uint32 begin, uint32 end)
+		: Common::SafeSeekableSubReadStream(parentStream.get(), begin, end, DisposeAfterUse::NO), _sharedParentStream(parentStream) {
+	}
+
+private:
+	Common::SharedPtr<Common::SeekableReadStream> _sharedParentStream;
+};
+
+/*
+  Checks the CRC32 of the uncompressed data of a member while it is read.
+  The data is checked once it has been read up to the end, err() reports a
+  mismatch. Data skipped by seeking forward is never checked.
+*/
+class ZipCrcCheckingReadStream : public Common::SeekableReadStream {
+public:
+	ZipCrcCheckingReadStream(Common::SeekableReadStream *parentStream, uint32 expectedCrc)
+		: _parentStream(parentStream), _expectedCrc(expectedCrc), _checkedSize(0), _mismatch(false) {
+#ifndef USE_ZLIB
+		_crc = _crcTable.getInitRemainder();
+#else
+		_crc = crc32(0, nullptr, 0);
+#endif
+	}
+
+	bool err() const override { return _mismatch || _parentStream->err(); }
+	void clearErr() override { _parentStream->clearErr(); }
+	bool eos() const override { return _parentStream->eos(); }
+
+	int64 pos() const override { return _parentStream->pos(); }
+	int64 size() const override { return _parentStream->size(); }
+	bool seek(int64 offset, int whence = SEEK_SET) override { return _parentStream->seek(offset, whence); }
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		const int64 start = _parentStream->pos();
+		const uint32 actualSize = _parentStream->read(dataPtr, dataSize);
+
+		// Only data continuing the checked part extends the checksum
+		if (start <= _checkedSize && start + actualSize > _checkedSize) {
+			const uint32 skip = (uint32)(_checkedSize - start);
+			update((const byte *)dataPtr + skip, actualSize - skip);
+			_checkedSize = start + actualSize;
+
+			if (_checkedSize == _parentStream->size())
+				verify();
+		}
+
+		return actualSize;
+	}
+
+private:
+	void update(const byte *data, uint32 dataSize) {
+#ifndef USE_ZLIB
+		for (uint32 i = 0; i < dataSize; ++i)
+			_crc = _crcTable.processByte(data[i], _crc);
+#else
+		_crc = crc32(_crc, data, dataSize);
+#endif
+	}
+
+	void verify() {
+#ifndef USE_ZLIB
+		const uint32 crc = _crcTable.finalize(_crc);
+#else
+		const uint32 crc = _crc;
+#endif
+		if (crc != _expectedCrc) {
+			warning("CRC32 mismatch: %08x, %08x", crc, _expectedCrc);
+			_mismatch = true;
+		}
+	}
+
+	Common::ScopedPtr<Common::SeekableReadStream> _parentStream;
+#ifndef USE_ZLIB
+	Common::CRC32 _crcTable;
+#endif
+	uint32 _crc;
+	const uint32 _expectedCrc;
+	int64 _checkedSize;
+	bool _mismatch;
+};
+
+} // End of anonymous namespace
+
+/*
+  Open the current file in the zipfile as a stream instead of reading it into
+  memory. Deflated data is inflated on demand and the CRC32 is checked once
+  the stream has been read to the end. The stream may outlive the zipfile.
+*/
+Common::SeekableReadStream *unzOpenCurrentFileStream(unzFile file) {
+	uInt iSizeVar;
+	unz_s *s;
+	uLong offset_local_extrafield;  /* offset of the local extra field */
+	uInt  size_local_extrafield;    /* size of the local extra field */
+
+	if (file == nullptr)
+		return nullptr;
+	s = (unz_s *)file;
+	if (!s->current_file_ok)
+		return nullptr;
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar,
+				&offset_local_extrafield, &size_local_extrafield) != UNZ_OK)
+		return nullptr;
+
+	uint32 begin = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar;
+	uint32 end = begin + s->cur_file_info.compressed_size;
+	if (end > s->_stream->size())
+		return nullptr;
+
+	// Several members may be open at the same time, so every read has
+	// to reposition the shared zipfile stream
+	Common::SeekableReadStream *member = new ZipMemberSubReadStream(s->_sharedStream, begin, end);
+
+	switch (s->cur_file_info.compression_method) {
+	case 0: // Store
+		break;
+	case Z_DEFLATED:
+		member = Common::wrapDeflateReadStream(member, DisposeAfterUse::YES, s->cur_file_info.uncompressed_size);
+		break;
+	default:
+		warning("Unknown compression algoritthm %d", (int)s->cur_file_info.compression_method);
+		delete member;
+		return nullptr;
+	}
+
+	if (!member)
+		return nullptr;
+
+	return new ZipCrcCheckingReadStream(member, s->cur_file_info.crc);
+}
 
 namespace Common {
 
 
 class ZipArchive : public MemcachingCaseInsensitiveArchive {
+	/** Members at least this big are decompressed on demand */
+	static const uint32 kMinStreamedMemberSize = 1024 * 1024;
+
 	unzFile _zipFile;
 #ifndef USE_ZLIB
 	Common::CRC32 _crc;
@@ -1109,6 +1260,17 @@ const ArchiveMemberPtr ZipArchive::getMember(const Path &path) const {
 Common::SharedArchiveContents ZipArchive::readContentsForPath(const Common::Path &path) const {
 	if (unzLocateFile(_zipFile, path, 2) != UNZ_OK)
 		return Common::SharedArchiveContents();
+
+	// Large members, like videos or audio banks, are streamed rather than
+	// being decompressed into memory up front
+	unz_file_info fileInfo;
+	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, nullptr, 0, nullptr, 0, nullptr, 0) == UNZ_OK &&
+	    fileInfo.uncompressed_size >= kMinStreamedMemberSize) {
+		Common::SeekableReadStream *stream = unzOpenCurrentFileStream(_zipFile);
+		if (stream)
+			return Common::SharedArchiveContents::bypass(stream);
+	}
+
 #ifndef USE_ZLIB
 	return unzOpenCurrentFile(_zipFile, _crc);
 #else
@@ -33,6 +33,7 @@
 
 #include "common/compression/deflate.h"
 
+#include "common/array.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
@@ -91,11 +92,24 @@ static bool _shownBackwardSeekingWarning = false;
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
  * Assumes the compressed data to be in gzip format.
+ *
+ * While decompressing, copies of the inflate state are stored at regular
+ * intervals of the output. Seeking then resumes from the nearest of these
+ * checkpoints instead of restarting the decompression from the beginning.
  */
 class GZipReadStream : public SeekableReadStream {
 protected:
 	enum {
-		BUFSIZE = 16384		// 1 << MAX_WBITS
+		BUFSIZE = 16384,		// 1 << MAX_WBITS
+		CHECKPOINT_SPACING = 1024 * 1024,
+		// Each checkpoint holds a copy of the 32KB window
+		MAX_CHECKPOINTS = 64
+	};
+
+	struct Checkpoint {
+		z_stream state;
+		uint64 inPos;	// Position of the next compressed byte in the wrapped stream
+		uint32 outPos;
 	};
 
 	byte	_buf[BUFSIZE];
@@ -108,6 +122,67 @@ protected:
 	uint32 _origSize;
 	bool _eos;
 
+	Array<Checkpoint *> _checkpoints;
+	uint32 _checkpointSpacing;
+	uint32 _nextCheckpoint;
+
+	void initCheckpoints() {
+		_checkpointSpacing = MAX<uint32>(CHECKPOINT_SPACING, _origSize / MAX_CHECKPOINTS);
+		_nextCheckpoint = _checkpointSpacing;
+	}
+
+	void freeCheckpoint(Checkpoint *checkpoint) {
+		inflateEnd(&checkpoint->state);
+		delete checkpoint;
+	}
+
+	void addCheckpoint() {
+		Checkpoint *checkpoint = new Checkpoint();
+		if (inflateCopy(&checkpoint->state, &_stream) != Z_OK) {
+			delete checkpoint;
+			_nextCheckpoint = 0xFFFFFFFF;
+			return;
+		}
+		checkpoint->inPos = _wrapped->pos() - _stream.avail_in;
+		checkpoint->outPos = _pos;
+		_checkpoints.push_back(checkpoint);
+
+		if (_checkpoints.size() > MAX_CHECKPOINTS) {
+			// Out of room: drop every other checkpoint and space them wider
+			uint kept = 0;
+			for (uint i = 0; i < _checkpoints.size(); i++) {
+				if (i & 1)
+					freeCheckpoint(_checkpoints[i]);
+				else
+					_checkpoints[kept++] = _checkpoints[i];
+			}
+			_checkpoints.resize(kept);
+			_checkpointSpacing *= 2;
+		}
+
+		_nextCheckpoint = _checkpoints.back()->outPos + _checkpointSpacing;
+	}
+
+	bool restoreCheckpoint(const Checkpoint *checkpoint) {
+		inflateEnd(&_stream);
+		_zlibErr = inflateCopy(&_stream, const_cast<z_stream *>(&checkpoint->state));
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_wrapped->seek(checkpoint->inPos, SEEK_SET);
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		_pos = checkpoint->outPos;
+		return true;
+	}
+
+	const Checkpoint *findCheckpoint(uint32 pos) const {
+		const Checkpoint *found = nullptr;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i]->outPos <= pos; i++)
+			found = _checkpoints[i];
+		return found;
+	}
+
 public:
 
 	GZipReadStream(SeekableReadStream *w, DisposeAfterUse::Flag disposeParent, uint32 knownSize) : _wrapped(w, disposeParent), _stream() {
@@ -131,6 +206,7 @@ public:
 		w->seek(_parentPos, SEEK_SET);
 		_pos = 0;
 		_eos = false;
+		initCheckpoints();
 
 		// Adding 32 to windowBits indicates to zlib that it is supposed to
 		// automatically detect whether gzip or zlib headers are used for
@@ -156,6 +232,7 @@ public:
 		_origSize = knownSize;
 		_pos = 0;
 		_eos = false;
+		initCheckpoints();
 
 		_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
 		if (_zlibErr != Z_OK)
@@ -174,6 +251,8 @@ public:
 	}
 
 	~GZipReadStream() {
+		for (uint i = 0; i < _checkpoints.size(); i++)
+			freeCheckpoint(_checkpoints[i]);
 		inflateEnd(&_stream);
 	}
 
@@ -203,6 +282,9 @@ public:
 		if (_zlibErr == Z_STREAM_END && _stream.avail_out > 0)
 			_eos = true;
 
+		if (_zlibErr == Z_OK && _pos >= _nextCheckpoint)
+			addCheckpoint();
+
 		return dataSize - _stream.avail_out;
 	}
 
@@ -234,10 +316,16 @@ public:
 
 		assert(newPos >= 0);
 
-		if ((uint32)newPos < _pos) {
-			// To search backward, we have to restart the whole decompression
-			// from the start of the file. A rather wasteful operation, best
-			// to avoid it. :/
+		// Resume from the closest checkpoint when seeking backward, or
+		// when one lies between the current and the new position
+		const Checkpoint *checkpoint = findCheckpoint(newPos);
+		if (checkpoint && ((uint32)newPos < _pos || checkpoint->outPos > _pos)) {
+			if (!restoreCheckpoint(checkpoint))
+				return false;
+		} else if ((uint32)newPos < _pos) {
+			// To search backward without a checkpoint, we have to restart the
+			// whole decompression from the start of the file. A rather wasteful
+			// operation, best to avoid it. :/
 
 #ifndef RELEASE_BUILD
 			if (!_shownBackwardSeekingWarning) {
@@ -23,8 +23,10 @@
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/mutex.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/thread.h"
 
 static bool isValidDomainName(const Common::String &domName) {
 	const char *p = domName.c_str();
@@ -50,7 +52,27 @@ char const *const ConfigManager::kCloudDomain = "cloud";
 #pragma mark -
 
 
-ConfigManager::ConfigManager() : _activeDomain(nullptr) {
+ConfigManager::ConfigManager() : _activeDomain(nullptr), _dirty(true),
+	_flushMutex(nullptr), _writeMutex(nullptr), _flushThread(nullptr), _flushSemaphore(nullptr),
+	_flushQuit(false), _flushPending(false), _flushFailed(false), _flushDeadline(0) {
+}
+
+ConfigManager::~ConfigManager() {
+	if (_flushThread) {
+		_flushMutex->lock();
+		_flushQuit = true;
+		_flushMutex->unlock();
+		_flushSemaphore->post();
+
+		// Joins the thread, which writes the pending flush before quitting
+		delete _flushThread;
+	}
+
+	writePendingFlush();
+
+	delete _flushSemaphore;
+	delete _flushMutex;
+	delete _writeMutex;
 }
 
 void ConfigManager::defragment() {
@@ -75,10 +97,14 @@ void ConfigManager::copyFrom(ConfigManager &source) {
 	_activeDomainName = source._activeDomainName;
 	_activeDomain = &_gameDomains[_activeDomainName];
 	_filename = source._filename;
+	_dirty = source._dirty;
 }
 
 
 bool ConfigManager::loadDefaultConfigFile(const Path &fallbackFilename) {
+	// Make sure we do not read back a file which is about to be replaced
+	waitForFlush();
+
 	// Open the default config file
 	assert(g_system);
 	SeekableReadStream *stream = g_system->createConfigReadStream();
@@ -88,6 +114,8 @@ bool ConfigManager::loadDefaultConfigFile(const Path &fallbackFilename) {
 	// ... load it, if available ...
 	if (stream) {
 		loadResult = loadFromStream(*stream);
+		if (loadResult)
+			clearDirty();
 
 		// ... and close it again.
 		delete stream;
@@ -104,7 +132,10 @@ bool ConfigManager::loadDefaultConfigFile(const Path &fallbackFilename) {
 }
 
 bool ConfigManager::loadConfigFile(const Path &filename, const Path &fallbackFilename) {
+	waitForFlush();
+
 	_filename = filename;
+	_dirty = true;
 
 	FSNode node(filename);
 	File cfg_file;
@@ -113,7 +144,11 @@ bool ConfigManager::loadConfigFile(const Path &filename, const Path &fallbackFil
 			debug("Creating configuration file: %s", filename.toString(Common::Path::kNativeSeparator).c_str());
 	} else {
 		debug("Using configuration file: %s", _filename.toString(Common::Path::kNativeSeparator).c_str());
-		return loadFromStream(cfg_file);
+		if (!loadFromStream(cfg_file))
+			return false;
+
+		clearDirty();
+		return true;
 	}
 	return true;
 }
@@ -174,7 +209,8 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 	static const byte UTF8_BOM[] = {0xEF, 0xBB, 0xBF};
 	String domainName;
 	String comment;
-	Domain domain;
+	Domain pending;
+	Domain *domain = nullptr;
 	int lineno = 0;
 
 	_appDomain.clear();
@@ -189,41 +225,63 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 	_cloudDomain.clear();
 #endif
 
+	_dirty = true;
+
+	// Read the whole file at once and parse it in place. Configurations
+	// with thousands of games are slow to read line by line.
+	int64 size = stream.size() - stream.pos();
+	if (size < 0)
+		size = 0;
+
+	Array<char> buffer((uint32)size + 1);
+	const uint32 bytesRead = stream.read(buffer.data(), (uint32)size);
+	buffer[bytesRead] = '\0';
+
+	const char *line = buffer.data();
+	const char *bufferEnd = line + bytesRead;
+
+	// Skip UTF-8 byte-order mark if added by a text editor.
+	if (bytesRead >= 3 && memcmp(line, UTF8_BOM, 3) == 0)
+		line += 3;
+
 	// TODO: Detect if a domain occurs multiple times (or likewise, if
 	// a key occurs multiple times inside one domain).
 
-	while (!stream.eos() && !stream.err()) {
+	while (line < bufferEnd) {
 		lineno++;
 
-		// Read a line
-		String line = stream.readLine();
+		// Find the end of the line, treating CR, LF and CR/LF as line breaks
+		const char *lineEnd = line;
+		while (lineEnd < bufferEnd && *lineEnd != '\n' && *lineEnd != '\r')
+			lineEnd++;
 
-		// Skip UTF-8 byte-order mark if added by a text editor.
-		if (lineno == 1 && memcmp(line.c_str(), UTF8_BOM, 3) == 0) {
-			line.erase(0, 3);
+		const char *nextLine = lineEnd;
+		if (nextLine < bufferEnd) {
+			if (*nextLine == '\r' && nextLine + 1 < bufferEnd && nextLine[1] == '\n')
+				nextLine++;
+			nextLine++;
 		}
 
-		if (line.size() == 0) {
+		if (line == lineEnd) {
 			// Do nothing
 		} else if (line[0] == '#') {
 			// Accumulate comments here. Once we encounter either the start
 			// of a new domain, or a key-value-pair, we associate the value
 			// of the 'comment' variable with that entity.
-			comment += line;
+			comment += String(line, lineEnd);
 			comment += "\n";
 		} else if (line[0] == '[') {
 			// It's a new domain which begins here.
 			// Determine where the previously accumulated domain goes, if we accumulated anything.
-			addDomain(domainName, domain);
-			domain.clear();
-			const char *p = line.c_str() + 1;
+			endLoadedDomain(domainName, domain, pending);
+			const char *p = line + 1;
 			// Get the domain name, and check whether it's valid (that
 			// is, verify that it only consists of alphanumerics,
 			// dashes and underscores).
-			while (*p && (isAlnum(*p) || *p == '-' || *p == '_'))
+			while (p < lineEnd && (isAlnum(*p) || *p == '-' || *p == '_'))
 				p++;
 
-			if (*p == '\0') {
+			if (p == lineEnd) {
 				warning("Config file buggy: missing ] in line %d", lineno);
 				return false;
 			} else if (*p != ']') {
@@ -231,22 +289,25 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 				return false;
 			}
 
-			domainName = String(line.c_str() + 1, p);
+			domainName = String(line + 1, p);
 
-			domain.setDomainComment(comment);
+			domain = beginLoadedDomain(domainName, pending);
+			domain->setDomainComment(comment);
 			comment.clear();
 
 		} else {
 			// This line should be a line with a 'key=value' pair, or an empty one.
 
 			// Skip leading whitespaces
-			const char *t = line.c_str();
-			while (isSpace(*t))
+			const char *t = line;
+			while (t < lineEnd && isSpace(*t))
 				t++;
 
 			// Skip empty lines / lines with only whitespace
-			if (*t == 0)
+			if (t == lineEnd) {
+				line = nextLine;
 				continue;
+			}
 
 			// If no domain has been set, this config file is invalid!
 			if (domainName.empty()) {
@@ -255,96 +316,287 @@ bool ConfigManager::loadFromStream(SeekableReadStream &stream) {
 			}
 
 			// Split string at '=' into 'key' and 'value'. First, find the "=" delimeter.
-			const char *p = strchr(t, '=');
+			const char *p = (const char *)memchr(t, '=', lineEnd - t);
 			if (!p) {
-				warning("Config file buggy: Junk found in line %d: '%s'", lineno, t);
+				warning("Config file buggy: Junk found in line %d: '%s'", lineno, String(t, lineEnd).c_str());
 				return false;
 			}
 
-			// Extract the key/value pair
-			String key(t, p);
-			String value(p + 1);
+			// Trim spaces off the key/value pair
+			const char *keyEnd = p;
+			while (keyEnd > t && isSpace(keyEnd[-1]))
+				keyEnd--;
 
-			// Trim of spaces
-			key.trim();
-			value.trim();
+			const char *value = p + 1;
+			const char *valueEnd = lineEnd;
+			while (value < valueEnd && isSpace(*value))
+				value++;
+			while (valueEnd > value && isSpace(valueEnd[-1]))
+				valueEnd--;
 
 			// Finally, store the key/value pair in the active domain
-			domain.setVal(key, value);
+			const String key(t, keyEnd);
+			domain->setVal(key, String(value, valueEnd));
 
 			// Store comment
-			domain.setKVComment(key, comment);
-			comment.clear();
+			if (!comment.empty() || domain->hasKVComment(key)) {
+				domain->setKVComment(key, comment);
+				comment.clear();
+			}
 		}
+
+		line = nextLine;
 	}
 
-	addDomain(domainName, domain); // Add the last domain found
+	endLoadedDomain(domainName, domain, pending); // Add the last domain found
 
 	return true;
 }
 
-void ConfigManager::flushToDisk() {
-#ifndef __DC__
-	WriteStream *stream;
+/**
+ * Return the domain a section of the config file gets loaded into. New
+ * game domains are loaded in place, as copying them is slow for large
+ * configurations. Everything else goes through addDomain().
+ **/
+ConfigManager::Domain *ConfigManager::beginLoadedDomain(const String &domainName, Domain &pending) {
+	if (!domainName.empty() && domainName != kApplicationDomain && domainName != kKeymapperDomain
+#ifdef USE_CLOUD
+	    && domainName != kCloudDomain
+#endif
+	    && !_gameDomains.contains(domainName) && !_miscDomains.contains(domainName))
+		return &_gameDomains[domainName];
 
-	if (_filename.empty()) {
-		// Write to the default config file
-		assert(g_system);
-		stream = g_system->createConfigWriteStream();
-		if (!stream)    // If writing to the config file is not possible, do nothing
-			return;
+	pending = Domain();
+	return &pending;
+}
+
+void ConfigManager::endLoadedDomain(const String &domainName, Domain *domain, Domain &pending) {
+	if (!domain)
+		return;
+
+	if (domain == &pending) {
+		addDomain(domainName, pending);
+		return;
+	}
+
+	// Domains without "gameid" are miscellaneous domains, see addDomain()
+	if (domain->contains("gameid")) {
+		_domainSaveOrder.push_back(domainName);
 	} else {
-		DumpFile *dump = new DumpFile();
-		assert(dump);
+		_miscDomains[domainName] = *domain;
+		_gameDomains.erase(domainName);
+	}
+}
 
-		if (!dump->open(_filename)) {
-			warning("Unable to write configuration file: %s", _filename.toString(Common::Path::kNativeSeparator).c_str());
-			delete dump;
-			return;
-		}
+bool ConfigManager::isDirty() const {
+	if (_dirty || _appDomain._changed || _keymapperDomain._changed)
+		return true;
+	if (_flushMutex) {
+		StackLock lock(*_flushMutex);
+		if (_flushFailed)
+			return true;
+	}
+#ifdef USE_CLOUD
+	if (_cloudDomain._changed)
+		return true;
+#endif
 
-		stream = dump;
+	DomainMap::const_iterator d;
+	for (d = _miscDomains.begin(); d != _miscDomains.end(); ++d) {
+		if (d->_value._changed)
+			return true;
+	}
+	for (d = _gameDomains.begin(); d != _gameDomains.end(); ++d) {
+		if (d->_value._changed)
+			return true;
 	}
 
+	return false;
+}
+
+void ConfigManager::clearDirty() {
+	_dirty = false;
+	_appDomain._changed = false;
+	_keymapperDomain._changed = false;
+#ifdef USE_CLOUD
+	_cloudDomain._changed = false;
+#endif
+
+	DomainMap::iterator d;
+	for (d = _miscDomains.begin(); d != _miscDomains.end(); ++d)
+		d->_value._changed = false;
+	for (d = _gameDomains.begin(); d != _gameDomains.end(); ++d)
+		d->_value._changed = false;
+}
+
+void ConfigManager::flushToDisk() {
+#ifndef __DC__
+	if (!isDirty())
+		return;
+
+	String data;
+
 	// Write the application domain
-	writeDomain(*stream, kApplicationDomain, _appDomain);
+	writeDomain(data, kApplicationDomain, _appDomain);
 
 	// Write the keymapper domain
-	writeDomain(*stream, kKeymapperDomain, _keymapperDomain);
+	writeDomain(data, kKeymapperDomain, _keymapperDomain);
 #ifdef USE_CLOUD
 	// Write the cloud domain
-	writeDomain(*stream, kCloudDomain, _cloudDomain);
+	writeDomain(data, kCloudDomain, _cloudDomain);
 #endif
 
 	DomainMap::const_iterator d;
 
 	// Write the miscellaneous domains next
 	for (d = _miscDomains.begin(); d != _miscDomains.end(); ++d) {
-		writeDomain(*stream, d->_key, d->_value);
+		writeDomain(data, d->_key, d->_value);
 	}
 
 	// First write the domains in _domainSaveOrder, in that order.
 	// Note: It's possible for _domainSaveOrder to list domains which
 	// are not present anymore, so we validate each name.
+	HashMap<String, bool> ordered;
 	Array<String>::const_iterator i;
 	for (i = _domainSaveOrder.begin(); i != _domainSaveOrder.end(); ++i) {
-		if (_gameDomains.contains(*i)) {
-			writeDomain(*stream, *i, _gameDomains[*i]);
+		ordered.setVal(*i, true);
+		d = _gameDomains.find(*i);
+		if (d != _gameDomains.end()) {
+			writeDomain(data, *i, d->_value);
 		}
 	}
 
 	// Now write the domains which haven't been written yet
 	for (d = _gameDomains.begin(); d != _gameDomains.end(); ++d) {
-		if (find(_domainSaveOrder.begin(), _domainSaveOrder.end(), d->_key) == _domainSaveOrder.end())
-			writeDomain(*stream, d->_key, d->_value);
+		if (!ordered.contains(d->_key))
+			writeDomain(data, d->_key, d->_value);
 	}
 
-	delete stream;
+	clearDirty();
 
+	if (!_flushMutex) {
+		_flushMutex = new Mutex();
+		_writeMutex = new Mutex();
+		_flushSemaphore = g_system->createSemaphore();
+		if (_flushSemaphore)
+			_flushThread = g_system->createThread(flushThreadProc, this);
+	}
+
+	_flushMutex->lock();
+	_flushData = data;
+	_flushFilename = _filename;
+	_flushPending = true;
+	_flushFailed = false;
+	_flushDeadline = g_system->getMillis(true) + FLUSH_DELAY;
+	_flushMutex->unlock();
+
+	if (_flushThread)
+		_flushSemaphore->post();
+	else
+		writePendingFlush();
 #endif // !__DC__
 }
 
-void ConfigManager::writeDomain(WriteStream &stream, const String &name, const Domain &domain) {
+void ConfigManager::waitForFlush() {
+	if (_flushMutex)
+		writePendingFlush();
+}
+
+void ConfigManager::flushBeforeExit() {
+	if (hasInstance())
+		ConfMan.waitForFlush();
+}
+
+void ConfigManager::writePendingFlush() {
+	if (!_flushMutex)
+		return;
+
+	// Holding the write mutex while taking the data makes sure that
+	// the most recent configuration always gets written last.
+	StackLock writeLock(*_writeMutex);
+
+	_flushMutex->lock();
+	const bool pending = _flushPending;
+	String data;
+	Path filename;
+	if (pending) {
+		data = _flushData;
+		filename = _flushFilename;
+		_flushData.clear();
+		_flushPending = false;
+	}
+	_flushMutex->unlock();
+
+	if (pending && !writeConfigFile(filename, data)) {
+		// Write everything again with the next flush
+		StackLock lock(*_flushMutex);
+		_flushFailed = true;
+	}
+}
+
+void ConfigManager::flushThreadProc(void *data) {
+	((ConfigManager *)data)->runFlushThread();
+}
+
+void ConfigManager::runFlushThread() {
+	while (true) {
+		_flushSemaphore->wait();
+
+		// Wait until no new flush came in for FLUSH_DELAY ms
+		while (true) {
+			_flushMutex->lock();
+			const bool pending = _flushPending;
+			const bool quit = _flushQuit;
+			const int32 remaining = (int32)(_flushDeadline - g_system->getMillis(true));
+			_flushMutex->unlock();
+
+			if (!pending) {
+				if (quit)
+					return;
+				break;
+			}
+
+			if (quit || remaining <= 0) {
+				writePendingFlush();
+			} else {
+				// Another flushToDisk() call wakes us up early and moves the deadline
+				_flushSemaphore->timedWait(remaining * 1000);
+			}
+		}
+	}
+}
+
+bool ConfigManager::writeConfigFile(const Path &filename, const String &data) {
+	WriteStream *stream;
+
+	if (filename.empty()) {
+		// Write to the default config file
+		assert(g_system);
+		stream = g_system->createConfigWriteStream();
+		if (!stream)    // If writing to the config file is not possible, do nothing
+			return false;
+	} else {
+		// Write to a temporary file first, so that the old configuration
+		// is kept if anything goes wrong
+		stream = FSNode(filename).createWriteStream(true);
+		if (!stream) {
+			warning("Unable to write configuration file: %s", filename.toString(Common::Path::kNativeSeparator).c_str());
+			return false;
+		}
+	}
+
+	stream->write(data.c_str(), data.size());
+	stream->finalize();
+	const bool success = !stream->err();
+	delete stream;
+
+	if (!success)
+		warning("Failed to write configuration file");
+
+	return success;
+}
+
+void ConfigManager::writeDomain(String &out, const String &name, const Domain &domain) {
 	if (domain.empty())
 		return; // Don't bother writing empty domains.
 
@@ -354,36 +606,39 @@ void ConfigManager::writeDomain(WriteStream &stream, const String &name, const D
 	if (domain.contains("id_came_from_command_line"))
 		return;
 
-	String comment;
-
 	// Write domain comment (if any)
-	comment = domain.getDomainComment();
-	if (!comment.empty())
-		stream.writeString(comment);
+	out += domain.getDomainComment();
 
 	// Write domain start
-	stream.writeByte('[');
-	stream.writeString(name);
-	stream.writeByte(']');
-	stream.writeByte('\n');
-
-	// Write all key/value pairs in this domain, including comments
-	Domain::const_iterator x;
-	for (x = domain.begin(); x != domain.end(); ++x) {
-		if (!x->_value.empty()) {
-			// Write comment (if any)
-			if (domain.hasKVComment(x->_key)) {
-				comment = domain.getKVComment(x->_key);
-				stream.writeString(comment);
+	out += '[';
+	out += name;
+	out += "]\n";
+
+	// The key/value pairs are only formatted again when the domain changed
+	if (!domain._textValid) {
+		domain._text.clear();
+
+		// Write all key/value pairs in this domain, including comments
+		Domain::const_iterator x;
+		for (x = domain.begin(); x != domain.end(); ++x) {
+			if (!x->_value.empty()) {
+				// Write comment (if any)
+				if (domain.hasKVComment(x->_key))
+					domain._text += domain.getKVComment(x->_key);
+
+				// Write the key/value pair
+				domain._text += x->_key;
+				domain._text += '=';
+				domain._text += x->_value;
+				domain._text += '\n';
 			}
-			// Write the key/value pair
-			stream.writeString(x->_key);
-			stream.writeByte('=');
-			stream.writeString(x->_value);
-			stream.writeByte('\n');
 		}
+
+		domain._textValid = true;
 	}
-	stream.writeByte('\n');
+
+	out += domain._text;
+	out += '\n';
 }
 
 
@@ -728,12 +983,14 @@ void ConfigManager::removeGameDomain(const String &domName) {
 		_activeDomain = nullptr;
 	}
 	_gameDomains.erase(domName);
+	_dirty = true;
 }
 
 void ConfigManager::removeMiscDomain(const String &domName) {
 	assert(!domName.empty());
 	assert(isValidDomainName(domName));
 	_miscDomains.erase(domName);
+	_dirty = true;
 }
 
 
@@ -769,6 +1026,7 @@ void ConfigManager::renameDomain(const String &oldName, const String &newName, D
 		newDom.setVal(iter->_key, iter->_value);
 
 	map.erase(oldName);
+	_dirty = true;
 }
 
 bool ConfigManager::hasGameDomain(const String &domName) const {
@@ -787,8 +1045,29 @@ bool ConfigManager::isKeyTemporary(const String &key) const {
 
 #pragma mark -
 
+void ConfigManager::Domain::setVal(const String &key, const String &value) {
+	// Setting the same value again does not require the config file to be written
+	StringMap::iterator i = _entries.find(key);
+	if (i != _entries.end()) {
+		if (i->_value == value)
+			return;
+		i->_value = value;
+	} else {
+		_entries.setVal(key, value);
+	}
+	touch();
+}
+
+void ConfigManager::Domain::erase(const String &key) {
+	if (_entries.contains(key)) {
+		_entries.erase(key);
+		touch();
+	}
+}
+
 void ConfigManager::Domain::setDomainComment(const String &comment) {
 	_domainComment = comment;
+	touch();
 }
 const String &ConfigManager::Domain::getDomainComment() const {
 	return _domainComment;
@@ -796,6 +1075,7 @@ const String &ConfigManager::Domain::getDomainComment() const {
 
 void ConfigManager::Domain::setKVComment(const String &key, const String &comment) {
 	_keyValueComments[key] = comment;
+	touch();
 }
 const String &ConfigManager::Domain::getKVComment(const String &key) const {
 	return _keyValueComments[key];
@@ -41,8 +41,10 @@ namespace Common {
  * @{
  */
 
-class WriteStream;
+class Mutex;
 class SeekableReadStream;
+class SemaphoreInternal;
+class ThreadInternal;
 
 /**
  * The (singleton) configuration manager, used to query & set configuration
@@ -57,12 +59,22 @@ class ConfigManager : public Singleton<ConfigManager> {
 public:
 
 	class Domain {
+		friend class ConfigManager;
+
 	private:
 		StringMap _entries;
 		StringMap _keyValueComments;
 		String _domainComment;
 
+		bool _changed;			///< Modified since the configuration was last loaded or flushed.
+		mutable String _text;		///< The key/value lines of the domain as written to the config file.
+		mutable bool _textValid;
+
+		void touch() { _changed = true; _textValid = false; }
+
 	public:
+		Domain() : _changed(true), _textValid(false) {}
+
 		typedef StringMap::const_iterator const_iterator;
 		const_iterator begin() const { return _entries.begin(); } /*!< Return the beginning position of configuration entries. */
 		const_iterator end()   const { return _entries.end(); }   /*!< Return the ending position of configuration entries. */
@@ -79,11 +91,11 @@ public:
 		 */
 		const String &operator[](const String &key) const { return _entries[key]; }
 
-		void           setVal(const String &key, const String &value) { _entries.setVal(key, value); } /*!< Assign a @p value to a @p key. */
+		void           setVal(const String &key, const String &value); /*!< Assign a @p value to a @p key. */
 
-		String &getOrCreateVal(const String &key) { return _entries.getOrCreateVal(key); }
-		String        &getVal(const String &key) { return _entries.getVal(key); } /*!< Retrieve the value of a @p key. */
-		const String  &getVal(const String &key) const { return _entries.getVal(key); } /*!< @overload */
+		String &getOrCreateVal(const String &key) { touch(); return _entries.getOrCreateVal(key); }
+		/** Retrieve the value of a @p key. Use setVal() to change it, so that the change gets written. */
+		const String  &getVal(const String &key) const { return _entries.getVal(key); }
 		 /**
 		  * Retrieve the value of @p key if it exists and leave the referenced variable unchanged if the key does not exist.
 		  * @return True if the key exists, false otherwise.
@@ -92,9 +104,9 @@ public:
 		const String &getValOrDefault(const String &key) const { return _entries.getValOrDefault(key); }
 		bool tryGetVal(const String &key, String &out) const { return _entries.tryGetVal(key, out); }
 
-		void           clear() { _entries.clear(); } /*!< Clear all configuration entries in the domain. */
+		void           clear() { _entries.clear(); touch(); } /*!< Clear all configuration entries in the domain. */
 
-		void           erase(const String &key) { _entries.erase(key); } /*!< Remove a key from the domain. */
+		void           erase(const String &key); /*!< Remove a key from the domain. */
 
 		void           setDomainComment(const String &comment); /*!< Add a @p comment for this configuration domain. */
 		const String  &getDomainComment() const; /*!< Retrieve the comment of this configuration domain. */
@@ -198,7 +210,22 @@ public:
 	void                     registerDefault(const String &key, bool value); /*!< @overload */
 	void                     registerDefault(const String &key, const Path &value); /*!< @overload */
 
-	void                     flushToDisk(); /*!< Flush configuration to disk. */
+	/**
+	 * Flush configuration to disk.
+	 *
+	 * Nothing is written if the configuration did not change since it was
+	 * loaded or last flushed. Otherwise the file is replaced shortly after
+	 * in the background, so that a series of changes results in a single
+	 * write. Use waitForFlush() to make sure the file has been written.
+	 */
+	void                     flushToDisk();
+	void                     waitForFlush(); /*!< Wait until the configuration passed to flushToDisk() has been written. */
+
+	/**
+	 * Write the configuration passed to flushToDisk() if that did not
+	 * happen yet. Backends call this before they exit the process.
+	 */
+	static void              flushBeforeExit();
 
 	void                     setActiveDomain(const String &domName); /*!< Set the given domain as active. */
 	Domain                  *getActiveDomain() { return _activeDomain; } /*!< Get the active domain. */
@@ -230,13 +257,26 @@ public:
 private:
 	friend class Singleton<SingletonBaseType>;
 	ConfigManager();
+	~ConfigManager();
+
+	/** Delay after flushToDisk() before the config file gets written, in milliseconds. */
+	static const uint32 FLUSH_DELAY = 250;
 
 	bool			loadFallbackConfigFile(const Path &filename);
 	bool			loadFromStream(SeekableReadStream &stream);
 	void			addDomain(const String &domainName, const Domain &domain);
-	void			writeDomain(WriteStream &stream, const String &name, const Domain &domain);
+	Domain			*beginLoadedDomain(const String &domainName, Domain &pending);
+	void			endLoadedDomain(const String &domainName, Domain *domain, Domain &pending);
+	void			writeDomain(String &out, const String &name, const Domain &domain);
 	void			renameDomain(const String &oldName, const String &newName, DomainMap &map);
 
+	bool			isDirty() const;
+	void			clearDirty();
+	void			writePendingFlush();
+	static void		flushThreadProc(void *data);
+	void			runFlushThread();
+	static bool		writeConfigFile(const Path &filename, const String &data);
+
 	Domain			_transientDomain;
 	DomainMap		_gameDomains;
 	DomainMap		_miscDomains; // Any other domains
@@ -257,6 +297,21 @@ private:
 	Domain *		_activeDomain;
 
 	Path			_filename;
+
+	/** Set when domains were removed or replaced since the configuration was last loaded or flushed. */
+	bool			_dirty;
+
+	// The config file is written by a background thread, see flushToDisk()
+	Mutex			*_flushMutex;	///< Guards the pending flush below.
+	Mutex			*_writeMutex;	///< Held while writing the config file.
+	ThreadInternal	*_flushThread;
+	SemaphoreInternal *_flushSemaphore;
+	bool			_flushQuit;
+	bool			_flushPending;
+	bool			_flushFailed;	///< The last write failed, the next flush writes everything.
+	uint32			_flushDeadline;
+	String			_flushData;
+	Path			_flushFilename;
 };
 
 /** @} */
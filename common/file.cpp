@@ -142,6 +142,16 @@ uint32 File::read(void *ptr, uint32 len) {
 	return _handle->read(ptr, len);
 }
 
+const byte *File::borrowData(int64 offset, uint32 size) const {
+	assert(_handle);
+	return _handle->borrowData(offset, size);
+}
+
+SeekableReadStream *File::readStream(uint32 dataSize) {
+	assert(_handle);
+	return _handle->readStream(dataSize);
+}
+
 
 DumpFile::DumpFile() : _handle(nullptr) {
 }
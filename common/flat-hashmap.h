@@ -0,0 +1,626 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The flat hash map stores its nodes inline in the probe array and keeps
+// a separate array of one byte control tags per slot, in the spirit of
+// SwissTable. Probing is linear, so a lookup usually touches a single
+// cache line of tags before it ever compares a key.
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/hashmap.h"
+#include "common/util.h"
+
+namespace Common {
+
+/**
+ * @addtogroup common_hashmap
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> has the same interface as HashMap<Key,Val> and can be
+ * used as a drop-in replacement for it, with one important difference: the
+ * key/value pairs are stored directly in the hash table instead of in
+ * separately allocated nodes. This saves a pointer dereference on every
+ * lookup and makes iteration walk contiguous memory, but it means that
+ * inserting a new key may move all existing entries around.
+ *
+ * Hence references, pointers and iterators to elements of a FlatHashMap are
+ * invalidated by any operation that inserts a key (operator[] on a missing
+ * key, getOrCreateVal(), setVal(), reserve()). Erasing does not move other
+ * elements. If your code holds on to values across insertions, use HashMap.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		const Key _key;
+		Val _value;
+		explicit Node(const Key &key) : _key(key), _value() {}
+		Node(const Key &key, const Val &value) : _key(key), _value(value) {}
+		Node(const Key &key, Val &&value) : _key(key), _value(Common::move(value)) {}
+	};
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> HM_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage of the hashmap may fill up (including erased
+		// slots) before it is rehashed. Linear probing degrades quickly
+		// when the table gets too full, so this is kept fairly low.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	/**
+	 * Control tags. A used slot stores the top seven bits of the (mixed)
+	 * hash of its key, so most mismatches are rejected without calling
+	 * EqualFunc. Free slots have the high bit set.
+	 */
+	enum {
+		CTRL_EMPTY = 0x80,
+		CTRL_DELETED = 0xFE
+	};
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	byte *_ctrl;		///< Control tag for each slot, arrsize entries.
+	Node *_nodes;		///< Uninitialized storage for arrsize nodes.
+	size_type _mask;	///< Capacity of the FlatHashMap minus one; must be a power of two minus one
+	size_type _size;
+	size_type _deleted; ///< Number of slots tagged CTRL_DELETED
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	static bool isFull(byte ctrl) { return (ctrl & 0x80) == 0; }
+
+	/**
+	 * Many of the hash functions in func.h are the identity, which interacts
+	 * badly with linear probing. Scramble the bits before using them.
+	 */
+	static uint32 mixHash(uint32 hash) {
+		hash ^= hash >> 16;
+		hash *= 0x7FEB352DU;
+		hash ^= hash >> 15;
+		hash *= 0x846CA68BU;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	static byte hashTag(uint32 hash) { return (byte)(hash >> 25); }
+
+	void allocStorage(size_type capacity) {
+		_mask = capacity - 1;
+		_ctrl = new byte[capacity];
+		memset(_ctrl, CTRL_EMPTY, capacity);
+		_nodes = (Node *)malloc(capacity * sizeof(Node));
+		assert(_nodes != nullptr);
+	}
+
+	void freeStorage() {
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				_nodes[ctr].~Node();
+		}
+		delete[] _ctrl;
+		free(_nodes);
+	}
+
+	size_type findFreeSlot(uint32 hash) const {
+		size_type ctr = hash & _mask;
+		while (isFull(_ctrl[ctr]))
+			ctr = (ctr + 1) & _mask;
+		return ctr;
+	}
+
+	void assign(const HM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void rehash(size_type newCapacity);
+	void eraseSlot(size_type ctr);
+
+	template<class T> friend class IteratorImpl;
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+#if defined(__INTEL_COMPILER)
+		template<class T> friend class Common::IteratorImpl;
+#else
+		template<class T> friend class IteratorImpl;
+#endif
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(isFull(_hashmap->_ctrl[_idx]));
+			return &_hashmap->_nodes[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !isFull(_hashmap->_ctrl[_idx]));
+			if (_idx > _hashmap->_mask)
+				_idx = (size_type)-1;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const HM_t &map);
+	~FlatHashMap();
+
+	HM_t &operator=(const HM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+	void reserve(size_type count);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		return iterator(lookup(key), this);
+	}
+
+	const_iterator	find(const Key &key) const {
+		return const_iterator(lookup(key), this);
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const HM_t &map) :
+	_defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one. The layout of the source table, including erased slots,
+ * is copied verbatim.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const HM_t &map) {
+	allocStorage(map._mask + 1);
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+
+	_size = 0;
+	_deleted = map._deleted;
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr])) {
+			new (&_nodes[ctr]) Node(map._nodes[ctr]._key, map._nodes[ctr]._value);
+			_size++;
+		}
+	}
+	// Perform a sanity check (to help track down hashmap corruption)
+	assert(_size == map._size);
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				_nodes[ctr].~Node();
+		}
+		memset(_ctrl, CTRL_EMPTY, _mask + 1);
+	}
+
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Make sure that at least @p count elements can be stored without
+ * rehashing the table.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::reserve(size_type count) {
+	size_type capacity = _mask + 1;
+	while (count * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+		capacity *= 2;
+	if (capacity > _mask + 1)
+		rehash(capacity);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	assert(newCapacity >= _mask + 1);
+
+#ifndef NDEBUG
+	const size_type old_size = _size;
+#endif
+	const size_type old_mask = _mask;
+	byte *old_ctrl = _ctrl;
+	Node *old_nodes = _nodes;
+
+	allocStorage(newCapacity);
+	_size = 0;
+	_deleted = 0;
+
+	// Move all the old elements over. Since we know that no key exists
+	// twice in the old table, we only need to look for a free slot and
+	// don't have to call _equal().
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (!isFull(old_ctrl[ctr]))
+			continue;
+
+		Node &node = old_nodes[ctr];
+		const uint32 hash = mixHash(_hash(node._key));
+		const size_type idx = findFreeSlot(hash);
+
+		new (&_nodes[idx]) Node(node._key, Common::move(node._value));
+		_ctrl[idx] = hashTag(hash);
+		node.~Node();
+		_size++;
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	// This check will fail if some previous operation corrupted this hashmap.
+	assert(_size == old_size);
+
+	delete[] old_ctrl;
+	free(old_nodes);
+}
+
+/**
+ * Return the slot holding @p key, or (size_type)-1 if it is not present.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const uint32 hash = mixHash(_hash(key));
+	const byte tag = hashTag(hash);
+	for (size_type ctr = hash & _mask; ; ctr = (ctr + 1) & _mask) {
+		const byte ctrl = _ctrl[ctr];
+		if (ctrl == tag && _equal(_nodes[ctr]._key, key))
+			return ctr;
+		if (ctrl == CTRL_EMPTY)
+			return (size_type)-1;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const uint32 hash = mixHash(_hash(key));
+	const byte tag = hashTag(hash);
+	const size_type NONE_FOUND = (size_type)-1;
+	size_type first_free = NONE_FOUND;
+	size_type ctr;
+	for (ctr = hash & _mask; ; ctr = (ctr + 1) & _mask) {
+		const byte ctrl = _ctrl[ctr];
+		if (ctrl == tag && _equal(_nodes[ctr]._key, key))
+			return ctr;
+		if (ctrl == CTRL_EMPTY)
+			break;
+		if (ctrl == CTRL_DELETED && first_free == NONE_FOUND)
+			first_free = ctr;
+	}
+
+	if (first_free != NONE_FOUND) {
+		// Reusing an erased slot does not change the load of the table.
+		ctr = first_free;
+		_deleted--;
+	} else {
+		// Keep the load factor below a certain threshold.
+		// Deleted slots are also counted, since they lengthen probe chains.
+		size_type capacity = _mask + 1;
+		if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+		        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+			// If most of the load comes from erased slots, cleaning those
+			// up is enough; otherwise grow the table.
+			if (_size * 2 >= capacity)
+				capacity = capacity < 500 ? (capacity * 4) : (capacity * 2);
+			rehash(capacity);
+			ctr = findFreeSlot(hash);
+		}
+	}
+
+	new (&_nodes[ctr]) Node(key);
+	_ctrl[ctr] = tag;
+	_size++;
+
+	return ctr;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type ctr) {
+	assert(ctr <= _mask);
+	assert(isFull(_ctrl[ctr]));
+
+	_nodes[ctr].~Node();
+	_size--;
+
+	// With linear probing, a chain passing through this slot would have
+	// to continue into the next one. If that is empty, no chain does, and
+	// the slot can be freed outright instead of leaving a tombstone.
+	if (_ctrl[(ctr + 1) & _mask] == CTRL_EMPTY) {
+		_ctrl[ctr] = CTRL_EMPTY;
+	} else {
+		_ctrl[ctr] = CTRL_DELETED;
+		_deleted++;
+	}
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) != (size_type)-1;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap, creating it if it does not exist yet.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// Look up first: creating the key may reallocate _nodes.
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _nodes[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _nodes[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _nodes[ctr]._value;
+	else
+		// See comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		return _nodes[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1) {
+		out = _nodes[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	// val may refer to a value stored in this map, which inserting can move
+	if ((const void *)&val >= (const void *)_nodes && (const void *)&val < (const void *)(_nodes + _mask + 1)) {
+		const Val copy(val);
+		size_type ctr = lookupAndCreateIfMissing(key);
+		_nodes[ctr]._value = copy;
+		return;
+	}
+
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_nodes[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	eraseSlot(entry._idx);
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr != (size_type)-1)
+		eraseSlot(ctr);
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -276,9 +276,13 @@ public:
 	 * referred by this node. This assumes that the node actually refers
 	 * to a readable file. If this is not the case, 0 is returned.
 	 *
+	 * @param atomic	Write to a temporary file which replaces the file once
+	 *              the stream is deleted, keeping the old contents if writing
+	 *              fails. Backends which do not support this write directly.
+	 *
 	 * @return Pointer to the stream object, 0 in case of a failure.
 	 */
-	SeekableWriteStream *createWriteStream() const;
+	SeekableWriteStream *createWriteStream(bool atomic = false) const;
 
 	/**
 	 * Create a directory referred by this node. This assumes that this
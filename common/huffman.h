@@ -25,7 +25,6 @@
 #define COMMON_HUFFMAN_H
 
 #include "common/array.h"
-#include "common/list.h"
 #include "common/types.h"
 
 namespace Common {
@@ -54,6 +53,10 @@ inline uint32 REVERSEBITS(uint32 x) {
 /**
  * Huffman bit stream decoding.
  *
+ * Codes are decoded with lookup tables. The first table is indexed by the
+ * next _prefixTableBits bits of the stream. Longer codes continue in sub
+ * tables, sized for the longest code sharing their prefix, so that codes of
+ * up to _prefixTableBits + kMaxSubTableBits bits take at most two lookups.
  */
 template<class BITSTREAM>
 class Huffman {
@@ -72,29 +75,40 @@ public:
 	uint32 getSymbol(BITSTREAM &bits) const;
 
 private:
-	struct Symbol {
+	/** A code, relative to the table it is stored in. */
+	struct Code {
 		uint32 code;
 		uint32 symbol;
+		uint8  length;
 
-		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {}
+		Code(uint32 c, uint8 l, uint32 s) : code(c), symbol(s), length(l) {}
 	};
 
-	typedef List<Symbol> CodeList;
-	typedef Array<CodeList> CodeLists;
-
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
-
-	/** Prefix lookup table used to speed up the decoding of short codes. */
-	struct PrefixEntry {
-		uint32 symbol;
-		uint8  length;
+	/**
+	 * An entry of a lookup table. Either a code, with its symbol and its
+	 * total length, or a link to the sub table for the following bits.
+	 * Entries that are neither do not start any valid code.
+	 */
+	struct TableEntry {
+		uint32 symbol;       ///< The symbol, or the offset of the sub table
+		uint8  length;       ///< The total code length, 0 if not a code
+		uint8  subTableBits; ///< The number of bits indexing the sub table, 0 if not a link
 
-		PrefixEntry() : length(0xFF) {}
+		TableEntry() : symbol(0), length(0), subTableBits(0) {}
 	};
 
 	static const uint8 _prefixTableBits = 8;
-	PrefixEntry _prefixTable[1 << _prefixTableBits];
+	static const uint8 kMaxSubTableBits = 16;
+
+	/** All the lookup tables, starting with the prefix table. */
+	Array<TableEntry> _tables;
+
+	/** Return the index of the entry for the @p bits bits long value @p code, as read from the stream. */
+	static uint32 tableIndex(uint32 code, uint8 bits) {
+		return BITSTREAM::isMSB2LSB() ? code : REVERSEBITS(code) >> (32 - bits);
+	}
+
+	void buildTable(uint32 offset, uint8 tableBits, uint8 consumedBits, const Array<Code> &codes);
 };
 
 template <class BITSTREAM>
@@ -110,58 +124,84 @@ Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *cod
 
 	assert(maxLength <= 32);
 
-	// Codes that do not fit in the prefix table are stored in the _codes array.
-	_codes.resize(MAX(maxLength - _prefixTableBits, 0));
+	Array<Code> allCodes;
+	allCodes.reserve(codeCount);
+	for (uint32 i = 0; i < codeCount; i++) {
+		// The symbol. If none was specified, assume it is identical to the code index.
+		allCodes.push_back(Code(codes[i], lengths[i], symbols ? symbols[i] : i));
+	}
 
-	for (uint i = 0; i < codeCount; i++) {
-		uint8 length = lengths[i];
+	_tables.resize(1 << _prefixTableBits);
+	buildTable(0, _prefixTableBits, 0, allCodes);
+}
 
-		// The symbol. If none was specified, assume it is identical to the code index.
-		uint32 symbol = symbols ? symbols[i] : i;
-
-		if (length <= _prefixTableBits) {
-			// Short codes go in the prefix lookup table. Set all the entries in the table
-			// with an index starting with the code to the symbol value.
-			uint32 startIndex;
-			if (BITSTREAM::isMSB2LSB()) {
-				startIndex = codes[i] << (_prefixTableBits - length);
-			} else {
-				startIndex = REVERSEBITS(codes[i]) >> (32 - _prefixTableBits);
-			}
+template <class BITSTREAM>
+void Huffman<BITSTREAM>::buildTable(uint32 offset, uint8 tableBits, uint8 consumedBits, const Array<Code> &codes) {
+	// Codes too long for this table, grouped by their first tableBits bits
+	Array<Array<Code> > longCodes;
+
+	for (uint i = 0; i < codes.size(); i++) {
+		const Code &code = codes[i];
 
-			uint32 endIndex = startIndex | ((1 << (_prefixTableBits - length)) - 1);
+		if (code.length <= tableBits) {
+			// Set all the entries with an index starting with the code to the symbol
+			uint32 startIndex = code.code << (tableBits - code.length);
+			uint32 endIndex = startIndex | ((1 << (tableBits - code.length)) - 1);
 
 			for (uint32 j = startIndex; j <= endIndex; j++) {
-				uint32 index = BITSTREAM::isMSB2LSB() ? j : REVERSEBITS(j) >> (32 - _prefixTableBits);
-				_prefixTable[index].symbol = symbol;
-				_prefixTable[index].length = length;
+				TableEntry &entry = _tables[offset + tableIndex(j, tableBits)];
+				entry.symbol = code.symbol;
+				entry.length = consumedBits + code.length;
 			}
 		} else {
-			// Put the code and symbol into the correct list for the length.
-			_codes[lengths[i] - 1 - _prefixTableBits].push_back(Symbol(codes[i], symbol));
+			uint8 remainingLength = code.length - tableBits;
+			uint32 prefix = code.code >> remainingLength;
+
+			if (longCodes.empty())
+				longCodes.resize(1 << tableBits);
+			longCodes[prefix].push_back(Code(code.code & ((1 << remainingLength) - 1), remainingLength, code.symbol));
 		}
 	}
-}
 
-template <class BITSTREAM>
-uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
-	uint32 code = bits.peekBits(_prefixTableBits);
+	for (uint32 prefix = 0; prefix < longCodes.size(); prefix++) {
+		const Array<Code> &subCodes = longCodes[prefix];
+		if (subCodes.empty())
+			continue;
 
-	uint8 length = _prefixTable[code].length;
+		// Size the sub table for the longest code continuing this prefix
+		uint8 subTableBits = 0;
+		for (uint i = 0; i < subCodes.size(); i++)
+			subTableBits = MAX(subTableBits, subCodes[i].length);
+		subTableBits = MIN(subTableBits, kMaxSubTableBits);
 
-	if (length != 0xFF) {
-		bits.skip(length);
-		return _prefixTable[code].symbol;
-	} else {
-		bits.skip(_prefixTableBits);
+		uint32 subTableOffset = _tables.size();
+		_tables.resize(subTableOffset + (1 << subTableBits));
 
-		for (uint32 i = 0; i < _codes.size(); i++) {
-			bits.addBit(code, i + _prefixTableBits);
+		TableEntry &link = _tables[offset + tableIndex(prefix, tableBits)];
+		link.symbol = subTableOffset;
+		link.subTableBits = subTableBits;
 
-			for (typename CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-				if (code == cCode->code)
-					return cCode->symbol;
-		}
+		buildTable(subTableOffset, subTableBits, consumedBits + tableBits, subCodes);
+	}
+}
+
+template <class BITSTREAM>
+uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
+	const TableEntry *entry = &_tables[bits.peekBits(_prefixTableBits)];
+
+	uint8 tableBits = _prefixTableBits;
+	uint8 consumedBits = 0;
+	while (entry->subTableBits) {
+		// Continue with the following bits in the sub table
+		bits.skip(tableBits);
+		consumedBits += tableBits;
+		tableBits = entry->subTableBits;
+		entry = &_tables[entry->symbol + bits.peekBits(tableBits)];
+	}
+
+	if (entry->length) {
+		bits.skip(entry->length - consumedBits);
+		return entry->symbol;
 	}
 
 	error("Unknown Huffman code");
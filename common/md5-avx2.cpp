@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "common/md5-kernels.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Common {
+
+static inline __m256i rotateLeft(__m256i x, int shift) {
+	return _mm256_or_si256(_mm256_sll_epi32(x, _mm_cvtsi32_si128(shift)), _mm256_srl_epi32(x, _mm_cvtsi32_si128(32 - shift)));
+}
+
+/**
+ * Load four message words of eight lanes, and transpose them to one word
+ * per register. Both 128-bit halves are transposed like in the SSE2 kernel.
+ */
+static inline void loadWords(const uint8 *const *blocks, int offset, __m256i *words) {
+	__m256i r[4];
+	for (int i = 0; i < 4; i++) {
+		const __m128i low = _mm_loadu_si128((const __m128i *)(blocks[i] + offset));
+		const __m128i high = _mm_loadu_si128((const __m128i *)(blocks[i + 4] + offset));
+		r[i] = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+	}
+
+	const __m256i t0 = _mm256_unpacklo_epi32(r[0], r[1]);
+	const __m256i t1 = _mm256_unpackhi_epi32(r[0], r[1]);
+	const __m256i t2 = _mm256_unpacklo_epi32(r[2], r[3]);
+	const __m256i t3 = _mm256_unpackhi_epi32(r[2], r[3]);
+
+	words[0] = _mm256_unpacklo_epi64(t0, t2);
+	words[1] = _mm256_unpackhi_epi64(t0, t2);
+	words[2] = _mm256_unpacklo_epi64(t1, t3);
+	words[3] = _mm256_unpackhi_epi64(t1, t3);
+}
+
+static inline __m256i step(__m256i a, __m256i b, __m256i f, __m256i word, int i) {
+	f = _mm256_add_epi32(_mm256_add_epi32(f, a), _mm256_add_epi32(word, _mm256_set1_epi32(md5StepConstants[i])));
+	return _mm256_add_epi32(b, rotateLeft(f, md5StepShifts[i >> 4][i & 3]));
+}
+
+void md5ProcessAVX2(MD5Lanes &lanes, const uint8 *const *blocks) {
+	__m256i x[16];
+	for (int i = 0; i < 16; i += 4)
+		loadWords(blocks, i * 4, x + i);
+
+	const __m256i a0 = _mm256_loadu_si256((const __m256i *)lanes.state[0]);
+	const __m256i b0 = _mm256_loadu_si256((const __m256i *)lanes.state[1]);
+	const __m256i c0 = _mm256_loadu_si256((const __m256i *)lanes.state[2]);
+	const __m256i d0 = _mm256_loadu_si256((const __m256i *)lanes.state[3]);
+	const __m256i ones = _mm256_set1_epi32(-1);
+	__m256i a = a0, b = b0, c = c0, d = d0, t;
+
+	for (int i = 0; i < 16; i++) {
+		t = step(a, b, _mm256_xor_si256(d, _mm256_and_si256(b, _mm256_xor_si256(c, d))), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+	for (int i = 16; i < 32; i++) {
+		t = step(a, b, _mm256_xor_si256(c, _mm256_and_si256(d, _mm256_xor_si256(b, c))), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+	for (int i = 32; i < 48; i++) {
+		t = step(a, b, _mm256_xor_si256(_mm256_xor_si256(b, c), d), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+	for (int i = 48; i < 64; i++) {
+		t = step(a, b, _mm256_xor_si256(c, _mm256_or_si256(b, _mm256_xor_si256(d, ones))), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+
+	_mm256_storeu_si256((__m256i *)lanes.state[0], _mm256_add_epi32(a, a0));
+	_mm256_storeu_si256((__m256i *)lanes.state[1], _mm256_add_epi32(b, b0));
+	_mm256_storeu_si256((__m256i *)lanes.state[2], _mm256_add_epi32(c, c0));
+	_mm256_storeu_si256((__m256i *)lanes.state[3], _mm256_add_epi32(d, d0));
+}
+
+} // End of namespace Common
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
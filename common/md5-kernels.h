@@ -0,0 +1,87 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef COMMON_MD5_KERNELS_H
+#define COMMON_MD5_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * Multi-buffer MD5: the kernels run the compression function of several
+ * independent streams (lanes) at once, one stream per SIMD lane. This is
+ * only used internally by computeStreamsMD5().
+ */
+
+enum {
+	/** The most lanes a kernel processes at once. */
+	kMD5MaxLanes = 8
+};
+
+/**
+ * The MD5 state of all lanes, stored word by word, so that the kernels can
+ * load the same word of all the lanes with one instruction.
+ */
+struct MD5Lanes {
+	uint32 state[4][kMD5MaxLanes];
+};
+
+/**
+ * Run the compression function over one 64 byte block of each lane. The
+ * blocks do not have to be aligned.
+ */
+typedef void (*MD5LanesProc)(MD5Lanes &lanes, const uint8 *const *blocks);
+
+/** The sine derived constants added in each of the 64 steps. */
+extern const uint32 md5StepConstants[64];
+
+/** The rotation of each step, indexed by round and step % 4. */
+extern const uint8 md5StepShifts[4][4];
+
+/** Return the message word used by step @p i. */
+inline int md5StepWord(int i) {
+	switch (i >> 4) {
+	case 0:
+		return i;
+	case 1:
+		return (5 * i + 1) & 15;
+	case 2:
+		return (3 * i + 5) & 15;
+	default:
+		return (7 * i) & 15;
+	}
+}
+
+#ifdef SCUMMVM_NEON
+void md5ProcessNEON(MD5Lanes &lanes, const uint8 *const *blocks);
+#endif
+#ifdef SCUMMVM_SSE2
+void md5ProcessSSE2(MD5Lanes &lanes, const uint8 *const *blocks);
+#endif
+#ifdef SCUMMVM_AVX2
+void md5ProcessAVX2(MD5Lanes &lanes, const uint8 *const *blocks);
+#endif
+
+} // End of namespace Common
+
+#endif
@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "common/endian.h"
+#include "common/md5-kernels.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Common {
+
+static inline uint32x4_t rotateLeft(uint32x4_t x, int shift) {
+	// Shifting left by a negative amount shifts right
+	return vorrq_u32(vshlq_u32(x, vdupq_n_s32(shift)), vshlq_u32(x, vdupq_n_s32(shift - 32)));
+}
+
+static inline uint32x4_t step(uint32x4_t a, uint32x4_t b, uint32x4_t f, uint32x4_t word, int i) {
+	f = vaddq_u32(vaddq_u32(f, a), vaddq_u32(word, vdupq_n_u32(md5StepConstants[i])));
+	return vaddq_u32(b, rotateLeft(f, md5StepShifts[i >> 4][i & 3]));
+}
+
+void md5ProcessNEON(MD5Lanes &lanes, const uint8 *const *blocks) {
+	// Interleave the message words of the four lanes
+	uint32 words[16][4];
+	for (int lane = 0; lane < 4; lane++) {
+		for (int i = 0; i < 16; i++)
+			words[i][lane] = READ_LE_UINT32(blocks[lane] + i * 4);
+	}
+
+	uint32x4_t x[16];
+	for (int i = 0; i < 16; i++)
+		x[i] = vld1q_u32(words[i]);
+
+	const uint32x4_t a0 = vld1q_u32(lanes.state[0]);
+	const uint32x4_t b0 = vld1q_u32(lanes.state[1]);
+	const uint32x4_t c0 = vld1q_u32(lanes.state[2]);
+	const uint32x4_t d0 = vld1q_u32(lanes.state[3]);
+	uint32x4_t a = a0, b = b0, c = c0, d = d0, t;
+
+	for (int i = 0; i < 16; i++) {
+		t = step(a, b, vbslq_u32(b, c, d), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+	for (int i = 16; i < 32; i++) {
+		t = step(a, b, vbslq_u32(d, b, c), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+	for (int i = 32; i < 48; i++) {
+		t = step(a, b, veorq_u32(veorq_u32(b, c), d), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+	for (int i = 48; i < 64; i++) {
+		t = step(a, b, veorq_u32(c, vornq_u32(b, d)), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+
+	vst1q_u32(lanes.state[0], vaddq_u32(a, a0));
+	vst1q_u32(lanes.state[1], vaddq_u32(b, b0));
+	vst1q_u32(lanes.state[2], vaddq_u32(c, c0));
+	vst1q_u32(lanes.state[3], vaddq_u32(d, d0));
+}
+
+} // End of namespace Common
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "common/scummsys.h"
+
+#include "common/md5-kernels.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Common {
+
+static inline __m128i rotateLeft(__m128i x, int shift) {
+	return _mm_or_si128(_mm_sll_epi32(x, _mm_cvtsi32_si128(shift)), _mm_srl_epi32(x, _mm_cvtsi32_si128(32 - shift)));
+}
+
+/** Load four message words of four lanes, and transpose them to one word per register. */
+static inline void loadWords(const uint8 *const *blocks, int offset, __m128i *words) {
+	const __m128i r0 = _mm_loadu_si128((const __m128i *)(blocks[0] + offset));
+	const __m128i r1 = _mm_loadu_si128((const __m128i *)(blocks[1] + offset));
+	const __m128i r2 = _mm_loadu_si128((const __m128i *)(blocks[2] + offset));
+	const __m128i r3 = _mm_loadu_si128((const __m128i *)(blocks[3] + offset));
+
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t2 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+	words[0] = _mm_unpacklo_epi64(t0, t2);
+	words[1] = _mm_unpackhi_epi64(t0, t2);
+	words[2] = _mm_unpacklo_epi64(t1, t3);
+	words[3] = _mm_unpackhi_epi64(t1, t3);
+}
+
+static inline __m128i step(__m128i a, __m128i b, __m128i f, __m128i word, int i) {
+	f = _mm_add_epi32(_mm_add_epi32(f, a), _mm_add_epi32(word, _mm_set1_epi32(md5StepConstants[i])));
+	return _mm_add_epi32(b, rotateLeft(f, md5StepShifts[i >> 4][i & 3]));
+}
+
+void md5ProcessSSE2(MD5Lanes &lanes, const uint8 *const *blocks) {
+	// x86 is little endian, so the words can be used as loaded
+	__m128i x[16];
+	for (int i = 0; i < 16; i += 4)
+		loadWords(blocks, i * 4, x + i);
+
+	const __m128i a0 = _mm_loadu_si128((const __m128i *)lanes.state[0]);
+	const __m128i b0 = _mm_loadu_si128((const __m128i *)lanes.state[1]);
+	const __m128i c0 = _mm_loadu_si128((const __m128i *)lanes.state[2]);
+	const __m128i d0 = _mm_loadu_si128((const __m128i *)lanes.state[3]);
+	const __m128i ones = _mm_set1_epi32(-1);
+	__m128i a = a0, b = b0, c = c0, d = d0, t;
+
+	for (int i = 0; i < 16; i++) {
+		t = step(a, b, _mm_xor_si128(d, _mm_and_si128(b, _mm_xor_si128(c, d))), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+	for (int i = 16; i < 32; i++) {
+		t = step(a, b, _mm_xor_si128(c, _mm_and_si128(d, _mm_xor_si128(b, c))), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+	for (int i = 32; i < 48; i++) {
+		t = step(a, b, _mm_xor_si128(_mm_xor_si128(b, c), d), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+	for (int i = 48; i < 64; i++) {
+		t = step(a, b, _mm_xor_si128(c, _mm_or_si128(b, _mm_xor_si128(d, ones))), x[md5StepWord(i)], i);
+		a = d; d = c; c = b; b = t;
+	}
+
+	_mm_storeu_si128((__m128i *)lanes.state[0], _mm_add_epi32(a, a0));
+	_mm_storeu_si128((__m128i *)lanes.state[1], _mm_add_epi32(b, b0));
+	_mm_storeu_si128((__m128i *)lanes.state[2], _mm_add_epi32(c, c0));
+	_mm_storeu_si128((__m128i *)lanes.state[3], _mm_add_epi32(d, d0));
+}
+
+} // End of namespace Common
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
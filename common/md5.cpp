@@ -26,9 +26,12 @@
  */
 
 #include "common/md5.h"
+#include "common/md5-kernels.h"
 #include "common/endian.h"
 #include "common/str.h"
 #include "common/stream.h"
+#include "common/system.h"
+#include "common/threadpool.h"
 
 namespace Common {
 
@@ -243,6 +246,223 @@ void md5_finish(md5_context *ctx, uint8 digest[16]) {
 }
 
 
+const uint32 md5StepConstants[64] = {
+	0xD76AA478, 0xE8C7B756, 0x242070DB, 0xC1BDCEEE,
+	0xF57C0FAF, 0x4787C62A, 0xA8304613, 0xFD469501,
+	0x698098D8, 0x8B44F7AF, 0xFFFF5BB1, 0x895CD7BE,
+	0x6B901122, 0xFD987193, 0xA679438E, 0x49B40821,
+	0xF61E2562, 0xC040B340, 0x265E5A51, 0xE9B6C7AA,
+	0xD62F105D, 0x02441453, 0xD8A1E681, 0xE7D3FBC8,
+	0x21E1CDE6, 0xC33707D6, 0xF4D50D87, 0x455A14ED,
+	0xA9E3E905, 0xFCEFA3F8, 0x676F02D9, 0x8D2A4C8A,
+	0xFFFA3942, 0x8771F681, 0x6D9D6122, 0xFDE5380C,
+	0xA4BEEA44, 0x4BDECFA9, 0xF6BB4B60, 0xBEBFBC70,
+	0x289B7EC6, 0xEAA127FA, 0xD4EF3085, 0x04881D05,
+	0xD9D4D039, 0xE6DB99E5, 0x1FA27CF8, 0xC4AC5665,
+	0xF4292244, 0x432AFF97, 0xAB9423A7, 0xFC93A039,
+	0x655B59C3, 0x8F0CCC92, 0xFFEFF47D, 0x85845DD1,
+	0x6FA87E4F, 0xFE2CE6E0, 0xA3014314, 0x4E0811A1,
+	0xF7537E82, 0xBD3AF235, 0x2AD7D2BB, 0xEB86D391
+};
+
+const uint8 md5StepShifts[4][4] = {
+	{ 7, 12, 17, 22 },
+	{ 5,  9, 14, 20 },
+	{ 4, 11, 16, 23 },
+	{ 6, 10, 15, 21 }
+};
+
+static void md5ProcessGeneric(MD5Lanes &lanes, const uint8 *const *blocks) {
+	md5_context ctx;
+	for (int i = 0; i < 4; i++)
+		ctx.state[i] = lanes.state[i][0];
+
+	md5_process(&ctx, blocks[0]);
+
+	for (int i = 0; i < 4; i++)
+		lanes.state[i][0] = ctx.state[i];
+}
+
+enum {
+	/** Bytes read from a stream at once by computeStreamsMD5(), a multiple of the block size */
+	kMD5ChunkSize = 16384
+};
+
+/** Passed to the kernel for the lanes without a stream */
+static const uint8 md5ZeroBlock[64] = { 0 };
+
+struct MD5Batch {
+	ReadStream *const *streams;
+	uint8 (*digests)[16];
+	uint count;
+	uint32 length;
+
+	MD5LanesProc proc;
+	uint numLanes;
+
+	MutexInternal *mutex;	// Only set when several jobs share the batch
+	uint next;
+};
+
+struct MD5Lane {
+	ReadStream *stream;
+	uint8 *digest;
+	uint8 *buffer;
+	uint32 pos;
+	uint32 fill;
+	uint32 left;	// Bytes still to read, when the length is restricted
+	uint64 hashed;	// Bytes already passed to the kernel
+	bool ended;
+};
+
+static bool md5NextStream(MD5Batch &batch, MD5Lanes &state, uint index, MD5Lane &lane) {
+	if (batch.mutex)
+		batch.mutex->lock();
+
+	while (batch.next < batch.count && !batch.streams[batch.next]) {
+		memset(batch.digests[batch.next], 0, 16);
+		batch.next++;
+	}
+
+	uint next = batch.next;
+	if (next < batch.count)
+		batch.next++;
+
+	if (batch.mutex)
+		batch.mutex->unlock();
+
+	if (next == batch.count)
+		return false;
+
+	lane.stream = batch.streams[next];
+	lane.digest = batch.digests[next];
+	lane.pos = lane.fill = 0;
+	lane.left = batch.length;
+	lane.hashed = 0;
+	lane.ended = false;
+
+	md5_context ctx;
+	md5_starts(&ctx);
+	for (int i = 0; i < 4; i++)
+		state.state[i][index] = ctx.state[i];
+
+	return true;
+}
+
+/**
+ * Make sure that the lane has a full block buffered. Returns false when
+ * the stream ended before.
+ */
+static bool md5FillLane(MD5Lane &lane, bool restricted) {
+	if (lane.fill - lane.pos >= 64)
+		return true;
+	if (lane.ended)
+		return false;
+
+	lane.fill -= lane.pos;
+	memmove(lane.buffer, lane.buffer + lane.pos, lane.fill);
+	lane.pos = 0;
+
+	while (lane.fill < kMD5ChunkSize) {
+		uint32 readlen = kMD5ChunkSize - lane.fill;
+		if (restricted)
+			readlen = MIN(readlen, lane.left);
+
+		uint32 i = readlen ? lane.stream->read(lane.buffer + lane.fill, readlen) : 0;
+		if (i == 0) {
+			lane.ended = true;
+			break;
+		}
+
+		lane.fill += i;
+		if (restricted)
+			lane.left -= i;
+	}
+
+	return lane.fill >= 64;
+}
+
+/** Hash the last partial block of the lane, and free it for the next stream */
+static void md5FinishLane(const MD5Lanes &state, uint index, MD5Lane &lane) {
+	md5_context ctx;
+	for (int i = 0; i < 4; i++)
+		ctx.state[i] = state.state[i][index];
+	ctx.total[0] = (uint32)lane.hashed;
+	ctx.total[1] = (uint32)(lane.hashed >> 32);
+
+	md5_update(&ctx, lane.buffer + lane.pos, lane.fill - lane.pos);
+	md5_finish(&ctx, lane.digest);
+	lane.stream = nullptr;
+}
+
+/**
+ * Job of computeStreamsMD5(): hash streams from the batch until there are
+ * none left. A lane takes the next stream as soon as its own one ended.
+ */
+static void md5HashStreams(void *data) {
+	MD5Batch &batch = *(MD5Batch *)data;
+	const bool restricted = (batch.length != 0);
+
+	MD5Lanes state;
+	MD5Lane lanes[kMD5MaxLanes];
+	const uint8 *blocks[kMD5MaxLanes];
+
+	uint8 *buffer = (uint8 *)malloc(batch.numLanes * kMD5ChunkSize);
+	for (uint i = 0; i < batch.numLanes; i++) {
+		lanes[i].stream = nullptr;
+		lanes[i].buffer = buffer + i * kMD5ChunkSize;
+	}
+
+	bool moreStreams = true;
+	for (;;) {
+		uint active = 0;
+		for (uint i = 0; i < batch.numLanes; i++) {
+			MD5Lane &lane = lanes[i];
+
+			// Streams shorter than a block are finished right away
+			for (;;) {
+				if (!lane.stream && (!moreStreams || !md5NextStream(batch, state, i, lane))) {
+					moreStreams = false;
+					break;
+				}
+				if (md5FillLane(lane, restricted))
+					break;
+				md5FinishLane(state, i, lane);
+			}
+
+			if (lane.stream) {
+				blocks[i] = lane.buffer + lane.pos;
+				active++;
+			} else {
+				blocks[i] = md5ZeroBlock;
+			}
+		}
+
+		if (!active)
+			break;
+
+		batch.proc(state, blocks);
+
+		for (uint i = 0; i < batch.numLanes; i++) {
+			if (lanes[i].stream) {
+				lanes[i].pos += 64;
+				lanes[i].hashed += 64;
+			}
+		}
+	}
+
+	free(buffer);
+}
+
+static String md5ToString(const uint8 digest[16]) {
+	String md5;
+	for (int i = 0; i < 16; i++) {
+		md5 += String::format("%02x", (int)digest[i]);
+	}
+
+	return md5;
+}
+
 bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length) {
 
 #ifdef DISABLE_MD5
@@ -280,15 +500,84 @@ bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length) {
 }
 
 String computeStreamMD5AsString(ReadStream &stream, uint32 length) {
-	String md5;
 	uint8 digest[16];
-	if (computeStreamMD5(stream, digest, length)) {
-		for (int i = 0; i < 16; i++) {
-			md5 += String::format("%02x", (int)digest[i]);
+	if (computeStreamMD5(stream, digest, length))
+		return md5ToString(digest);
+
+	return String();
+}
+
+void computeStreamsMD5(ReadStream *const *streams, uint8 (*digests)[16], uint count, uint32 length) {
+#ifdef DISABLE_MD5
+	memset(digests, 0, count * 16);
+#else
+	MD5Batch batch;
+	batch.streams = streams;
+	batch.digests = digests;
+	batch.count = count;
+	batch.length = length;
+	batch.proc = md5ProcessGeneric;
+	batch.numLanes = 1;
+	batch.mutex = nullptr;
+	batch.next = 0;
+
+	// Without a backend, e.g. in the tests, use the portable code serially
+	if (g_system) {
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			batch.proc = md5ProcessNEON;
+			batch.numLanes = 4;
+		}
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			batch.proc = md5ProcessSSE2;
+			batch.numLanes = 4;
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+			batch.proc = md5ProcessAVX2;
+			batch.numLanes = 8;
 		}
+#endif
 	}
 
-	return md5;
+	// Each job keeps all its lanes busy, only start as many as there are
+	// groups of streams
+	uint numJobs = (count + batch.numLanes - 1) / batch.numLanes;
+	if (numJobs > 1 && g_system) {
+		numJobs = MIN(numJobs, ThreadPool::instance().getConcurrency());
+		if (numJobs > 1)
+			batch.mutex = g_system->createMutex();
+	}
+
+	if (!batch.mutex) {
+		md5HashStreams(&batch);
+		return;
+	}
+
+	JobGroup group;
+	for (uint i = 0; i < numJobs; i++)
+		group.add(md5HashStreams, &batch);
+	group.wait();
+
+	delete batch.mutex;
+#endif
+}
+
+void computeStreamsMD5AsString(ReadStream *const *streams, String *md5s, uint count, uint32 length) {
+	uint8 (*digests)[16] = new uint8[count][16];
+	computeStreamsMD5(streams, digests, count, length);
+
+	for (uint i = 0; i < count; i++) {
+		if (streams[i])
+			md5s[i] = md5ToString(digests[i]);
+		else
+			md5s[i].clear();
+	}
+
+	delete[] digests;
 }
 
 } // End of namespace Common
@@ -62,6 +62,36 @@ bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length = 0);
  */
 String computeStreamMD5AsString(ReadStream &stream, uint32 length = 0);
 
+/**
+ * Compute the MD5 checksums of several streams at once.
+ *
+ * The streams are hashed in groups of four or eight by one SIMD kernel,
+ * when the CPU has one, and the groups are read and hashed in parallel on
+ * the worker thread pool. This is much faster than computeStreamMD5() for
+ * many streams, or a few large ones.
+ *
+ * The streams are read on worker threads, so they must not be used by
+ * anything else until the call returns. They must not share an underlying
+ * stream either, like two members of one ZIP archive do; hash such streams
+ * one at a time with computeStreamMD5(). Entries may be null, their digests
+ * are set to zero.
+ *
+ * @param[in] streams	the streams of whose data the MD5s are computed
+ * @param[out] digests	the computed MD5 checksums, one per stream
+ * @param[in] count	the number of streams
+ * @param[in] length	the number of bytes of each stream for which to compute the checksum; 0 means all
+ */
+void computeStreamsMD5(ReadStream *const *streams, uint8 (*digests)[16], uint count, uint32 length = 0);
+
+/**
+ * Compute the MD5 checksums of several streams at once, as lowercase hex
+ * strings of length 32. The entries of null streams are set to an empty
+ * string.
+ *
+ * @see computeStreamsMD5()
+ */
+void computeStreamsMD5AsString(ReadStream *const *streams, String *md5s, uint count, uint32 length = 0);
+
 /** @} */
 
 } // End of namespace Common
@@ -37,6 +37,7 @@ MODULE_OBJS := \
 	system.o \
 	textconsole.o \
 	text-to-speech.o \
+	threadpool.o \
 	tokenizer.o \
 	translation.o \
 	unicode-bidi.o \
@@ -50,6 +51,20 @@ MODULE_OBJS += \
 	recorderfile.o
 endif
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	md5-neon.o
+$(MODULE)/md5-neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	md5-sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	md5-avx2.o
+endif
+
 ifdef USE_UPDATES
 MODULE_OBJS += \
 	updates.o
@@ -159,6 +159,11 @@ public:
 	void addSaveFile(const String &fileName, InSaveFile *saveStream);
 
 	uint32 getVersion() const {return _version;}
+
+	/** Number of recorded screen checksums that were verified during playback */
+	uint getCheckedScreenshotsCount() const {return _checkedScreenshots;}
+	/** Number of recorded screen checksums that did not match the replayed screen */
+	uint getMismatchedScreenshotsCount() const {return _mismatchedScreenshots;}
 private:
 	Array<byte> _tmpBuffer;
 	WriteStream *_recordFile;
@@ -175,6 +180,8 @@ private:
 	PlaybackFileHeader _header;
 	PlaybackFileState _playbackParseState;
 	uint32 _version;
+	uint _checkedScreenshots;
+	uint _mismatchedScreenshots;
 
 	void skipHeader();
 	bool parseHeader();
@@ -22,46 +22,70 @@
 #include "common/str-base.h"
 #include "common/hash-str.h"
 #include "common/list.h"
-#include "common/memorypool.h"
 #include "common/textconsole.h"
 #include "common/util.h"
-#include "common/mutex.h"
 
 namespace Common {
 
 #define TEMPLATE template<class T>
 #define BASESTRING BaseString<T>
 
-MemoryPool *g_refCountPool = nullptr; // FIXME: This is never freed right now
-#ifndef SCUMMVM_UTIL
-Mutex *g_refCountPoolMutex = nullptr;
-
-void lockMemoryPoolMutex() {
-	// The Mutex class can only be used once g_system is set and initialized,
-	// but we may use the String class earlier than that (it is for example
-	// used in the OSystem_POSIX constructor). However in those early stages
-	// we can hope we don't have multiple threads either.
-	if (!g_system || !g_system->backendInitialized())
-		return;
-	if (!g_refCountPoolMutex)
-		g_refCountPoolMutex = new Mutex();
-	g_refCountPoolMutex->lock();
+/**
+ * Strings stored on the heap keep their reference count in a header right
+ * in front of the string data. Both are allocated in one block, so sharing
+ * and freeing strings never has to go through a global, locked pool.
+ */
+union RefCountHeader {
+	int refCount;
+	void *align; // Keep the string data pointer aligned
+};
+
+#if !defined(SCUMMVM_UTIL) && defined(__GCC_ATOMIC_INT_LOCK_FREE) && __GCC_ATOMIC_INT_LOCK_FREE == 2
+// Strings are shared between the main, timer, mixer and other threads
+static inline int loadRefCount(const int *refCount) {
+	return __atomic_load_n(refCount, __ATOMIC_RELAXED);
 }
 
-void unlockMemoryPoolMutex() {
-	if (g_refCountPoolMutex)
-		g_refCountPoolMutex->unlock();
+static inline void incRefCountValue(int *refCount) {
+	__atomic_add_fetch(refCount, 1, __ATOMIC_RELAXED);
 }
 
-TEMPLATE void BASESTRING::releaseMemoryPoolMutex() {
-	if (g_refCountPoolMutex){
-		delete g_refCountPoolMutex;
-		g_refCountPoolMutex = nullptr;
-	}
+static inline int decRefCountValue(int *refCount) {
+	return __atomic_sub_fetch(refCount, 1, __ATOMIC_ACQ_REL);
+}
+#else
+static inline int loadRefCount(const int *refCount) {
+	return *refCount;
+}
+
+static inline void incRefCountValue(int *refCount) {
+	++(*refCount);
 }
 
+static inline int decRefCountValue(int *refCount) {
+	return --(*refCount);
+}
 #endif
 
+/**
+ * Allocate heap storage for capacity characters of the given size,
+ * preceded by a reference count initialized to one.
+ */
+static void *allocStorage(uint32 capacity, uint32 charSize, int *&refCount) {
+	byte *block = new byte[sizeof(RefCountHeader) + capacity * charSize];
+	assert(block);
+
+	RefCountHeader *header = (RefCountHeader *)block;
+	header->refCount = 1;
+	refCount = &header->refCount;
+
+	return block + sizeof(RefCountHeader);
+}
+
+static void freeStorage(int *refCount) {
+	delete[] (byte *)refCount;
+}
+
 static uint32 computeCapacity(uint32 len) {
 	// By default, for the capacity we use the next multiple of 32
 	return ((len + 32 - 1) & ~0x1F);
@@ -128,12 +152,13 @@ TEMPLATE void BASESTRING::ensureCapacity(uint32 new_size, bool keep_old) {
 	uint32 curCapacity, newCapacity;
 	value_type *newStorage;
 	int *oldRefCount = _extern._refCount;
+	int *newRefCount = nullptr;
 
 	if (isStorageIntern()) {
 		isShared = false;
 		curCapacity = _builtinCapacity;
 	} else {
-		isShared = (oldRefCount && *oldRefCount > 1);
+		isShared = (loadRefCount(oldRefCount) > 1);
 		curCapacity = _extern._capacity;
 	}
 
@@ -157,8 +182,7 @@ TEMPLATE void BASESTRING::ensureCapacity(uint32 new_size, bool keep_old) {
 			newCapacity = MAX(curCapacity * 2, computeCapacity(new_size + 1));
 
 		// Allocate new storage
-		newStorage = new value_type[newCapacity];
-		assert(newStorage);
+		newStorage = (value_type *)allocStorage(newCapacity, sizeof(value_type), newRefCount);
 	}
 
 	// Copy old data if needed, elsewise reset the new storage.
@@ -180,7 +204,7 @@ TEMPLATE void BASESTRING::ensureCapacity(uint32 new_size, bool keep_old) {
 		// Set the ref count & capacity if we use an external storage.
 		// It is important to do this *after* copying any old content,
 		// else we would override data that has not yet been copied!
-		_extern._refCount = nullptr;
+		_extern._refCount = newRefCount;
 		_extern._capacity = newCapacity;
 	}
 }
@@ -188,23 +212,7 @@ TEMPLATE void BASESTRING::ensureCapacity(uint32 new_size, bool keep_old) {
 TEMPLATE
 void BASESTRING::incRefCount() const {
 	assert(!isStorageIntern());
-	if (_extern._refCount == nullptr) {
-#ifndef SCUMMVM_UTIL
-		lockMemoryPoolMutex();
-#endif
-		if (g_refCountPool == nullptr) {
-			g_refCountPool = new MemoryPool(sizeof(int));
-			assert(g_refCountPool);
-		}
-
-		_extern._refCount = (int *)g_refCountPool->allocChunk();
-#ifndef SCUMMVM_UTIL
-		unlockMemoryPoolMutex();
-#endif
-		*_extern._refCount = 2;
-	} else {
-		++(*_extern._refCount);
-	}
+	incRefCountValue(_extern._refCount);
 }
 
 TEMPLATE
@@ -212,28 +220,11 @@ void BASESTRING::decRefCount(int *oldRefCount) {
 	if (isStorageIntern())
 		return;
 
-	if (oldRefCount) {
-		--(*oldRefCount);
-	}
-	if (!oldRefCount || *oldRefCount <= 0) {
+	assert(oldRefCount);
+	if (decRefCountValue(oldRefCount) <= 0) {
 		// The ref count reached zero, so we free the string storage
-		// and the ref count storage.
-		if (oldRefCount) {
-#ifndef SCUMMVM_UTIL
-			lockMemoryPoolMutex();
-#endif
-			assert(g_refCountPool);
-			g_refCountPool->freeChunk(oldRefCount);
-#ifndef SCUMMVM_UTIL
-			unlockMemoryPoolMutex();
-#endif
-		}
-		// Coverity thinks that we always free memory, as it assumes
-		// (correctly) that there are cases when oldRefCount == 0
-		// Thus, DO NOT COMPILE, trick it and shut tons of false positives
-#ifndef __COVERITY__
-		delete[] _str;
-#endif
+		// together with the ref count in front of it.
+		freeStorage(oldRefCount);
 
 		// Even though _str points to a freed memory block now,
 		// we do not change its value, because any code that calls
@@ -251,9 +242,7 @@ TEMPLATE void BASESTRING::initWithValueTypeStr(const value_type *str, uint32 len
 	if (len >= _builtinCapacity) {
 		// Not enough internal storage, so allocate more
 		_extern._capacity = computeCapacity(len + 1);
-		_extern._refCount = nullptr;
-		_str = new value_type[_extern._capacity];
-		assert(_str != nullptr);
+		_str = (value_type *)allocStorage(_extern._capacity, sizeof(value_type), _extern._refCount);
 	}
 
 	// Copy the string into the storage area
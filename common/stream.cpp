@@ -287,6 +287,26 @@ bool SeekableSubReadStream::seek(int64 offset, int whence) {
 	return ret;
 }
 
+const byte *SeekableSubReadStream::borrowData(int64 offset, uint32 size) const {
+	if (offset < 0 || offset > this->size() || size > this->size() - offset)
+		return nullptr;
+
+	return _parentStream->borrowData(_begin + offset, size);
+}
+
+SeekableReadStream *SeekableSubReadStream::readStream(uint32 dataSize) {
+	if (dataSize > _end - _pos) {
+		dataSize = _end - _pos;
+		_eos = true;
+	}
+
+	// Let the parent stream share its data if it is able to
+	SeekableReadStream *stream = _parentStream->readStream(dataSize);
+	_pos += stream->size();
+
+	return stream;
+}
+
 uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	// Make sure the parent stream is at the right position
 	seek(0, SEEK_CUR);
@@ -294,6 +314,13 @@ uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return SeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+SeekableReadStream *SafeSeekableSubReadStream::readStream(uint32 dataSize) {
+	// Make sure the parent stream is at the right position
+	seek(0, SEEK_CUR);
+
+	return SeekableSubReadStream::readStream(dataSize);
+}
+
 void SeekableReadStream::hexdump(int len, int bytesPerLine, int startOffset) {
 	uint pos_ = pos();
 	uint size_ = size();
@@ -603,4 +630,9 @@ uint32 SafeMutexedSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 	return Common::SafeSeekableSubReadStream::read(dataPtr, dataSize);
 }
 
+SeekableReadStream *SafeMutexedSeekableSubReadStream::readStream(uint32 dataSize) {
+	Common::StackLock lock(_mutex);
+	return Common::SafeSeekableSubReadStream::readStream(dataSize);
+}
+
 } // End of namespace Common
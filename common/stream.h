@@ -714,8 +714,11 @@ public:
 	 * if reading more data failed. This is because of an I/O error or because
 	 * the end of the stream was reached. It can be determined by
 	 * calling err() and eos().
+	 *
+	 * Streams which are backed by memory that can be shared, such as
+	 * memory-mapped files, may override this to avoid the copy.
 	 */
-	SeekableReadStream *readStream(uint32 dataSize);
+	virtual SeekableReadStream *readStream(uint32 dataSize);
 
 	/**
 	 * Reads in a terminated string. Upon successful completion,
@@ -792,6 +795,23 @@ public:
 	 */
 	virtual bool skip(uint32 offset) { return seek(offset, SEEK_CUR); }
 
+	/**
+	 * Borrow a pointer to a contiguous range of the stream data without
+	 * copying it.
+	 *
+	 * Only streams which keep their whole contents in memory (or mapped
+	 * into memory) can provide this. The returned pointer stays valid for
+	 * as long as the stream exists. The stream position indicator is not
+	 * affected.
+	 *
+	 * @param offset	Offset of the range from the start of the stream.
+	 * @param size		Size of the range in bytes.
+	 *
+	 * @return Pointer to the data, or nullptr if the stream cannot provide
+	 *         direct access to the requested range.
+	 */
+	virtual const byte *borrowData(int64 offset, uint32 size) const { return nullptr; }
+
 	/**
 	 * Read at most one less than the number of characters specified
 	 * by @p bufSize from the stream and store them in the string buffer.
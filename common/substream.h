@@ -86,6 +86,9 @@ public:
 	virtual int64 size() const { return _end - _begin; }
 
 	virtual bool seek(int64 offset, int whence = SEEK_SET);
+
+	const byte *borrowData(int64 offset, uint32 size) const override;
+	SeekableReadStream *readStream(uint32 dataSize) override;
 };
 
 /**
@@ -132,6 +135,7 @@ public:
 	}
 
 	virtual uint32 read(void *dataPtr, uint32 dataSize);
+	SeekableReadStream *readStream(uint32 dataSize) override;
 };
 
 /**
@@ -148,6 +152,7 @@ public:
 		: SafeSeekableSubReadStream(parentStream, begin, end, disposeParentStream), _mutex(mutex) {
 	}
 	uint32 read(void *dataPtr, uint32 dataSize) override;
+	SeekableReadStream *readStream(uint32 dataSize) override;
 protected:
 	Common::Mutex &_mutex;
 };
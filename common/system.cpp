@@ -22,6 +22,7 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_exit
 
 #include "common/system.h"
+#include "common/config-manager.h"
 #include "common/events.h"
 #include "common/fs.h"
 #include "common/file.h"
@@ -121,7 +122,6 @@ void OSystem::initBackend() {
 
 void OSystem::destroy() {
 	_backendInitialized = false;
-	Common::String::releaseMemoryPoolMutex();
 	Common::releaseCJKTables();
 	delete this;
 }
@@ -219,6 +219,7 @@ bool OSystem::setStretchMode(const char *name) {
 }
 
 void OSystem::fatalError() {
+	Common::ConfigManager::flushBeforeExit();
 	quit();
 	exit(1);
 }
@@ -238,7 +239,7 @@ Common::WriteStream *OSystem::createConfigWriteStream() {
 	return nullptr;
 #else
 	Common::FSNode file(getDefaultConfigFileName());
-	return file.createWriteStream();
+	return file.createWriteStream(true);
 #endif
 }
 
@@ -30,6 +30,7 @@
 #include "common/str-array.h" // For OSystem::updateStartSettings()
 #include "common/hash-str.h" // For OSystem::updateStartSettings()
 #include "common/path.h"
+#include "common/thread.h" // For OSystem::createThread()
 #include "graphics/pixelformat.h"
 #include "graphics/mode.h"
 #include "graphics/opengl/context.h"
@@ -54,6 +55,8 @@ class Store;
 namespace Common {
 class EventManager;
 class MutexInternal;
+class SemaphoreInternal;
+class ThreadInternal;
 struct Rect;
 class SaveFileManager;
 class SearchSet;
@@ -634,6 +637,14 @@ public:
 		* Covers a wide range of platforms, Apple Macs, XBox 360, PS3, and more
 		*/
 		kFeatureCpuAltivec,
+
+		/**
+		 * The backend can run code on additional threads, see createThread().
+		 * Without it, Common::ThreadPool runs all jobs on the calling thread.
+		 *
+		 * This feature has no associated state.
+		 */
+		kFeatureThreads,
 	};
 
 	/**
@@ -1581,6 +1592,12 @@ public:
 	 *
 	 * Hence, backends that do not use threads to implement the timers can simply
 	 * use dummy implementations for these methods.
+	 *
+	 * Backends that can run code on multiple cores may additionally implement
+	 * the thread methods below and report kFeatureThreads. They are meant as
+	 * the foundation for Common::ThreadPool, which engines should use instead
+	 * of creating threads on their own. A backend providing threads must
+	 * return real (not dummy) mutexes from createMutex().
 	 */
 
 	/**
@@ -1590,6 +1607,27 @@ public:
 	 */
 	virtual Common::MutexInternal *createMutex() = 0;
 
+	/**
+	 * Start a new thread running @p proc with @p data.
+	 *
+	 * @return The newly created thread, or nullptr if the backend does not
+	 *         support threads or an error occurred.
+	 */
+	virtual Common::ThreadInternal *createThread(Common::ThreadProc proc, void *data) { return nullptr; }
+
+	/**
+	 * Create a new counting semaphore with the given initial count.
+	 *
+	 * @return The newly created semaphore, or nullptr if the backend does not
+	 *         support threads or an error occurred.
+	 */
+	virtual Common::SemaphoreInternal *createSemaphore(uint initialCount = 0) { return nullptr; }
+
+	/**
+	 * Return the number of logical CPU cores available to the application.
+	 */
+	virtual uint getCPUCount() { return 1; }
+
 	/** @} */
 
 
@@ -1794,6 +1832,8 @@ public:
 	 * It is the callers responsiblity to delete the stream after use.
 	 *
 	 * May return 0 to indicate that writing to the config file is not possible.
+	 *
+	 * The stream may be used from a different thread than the main thread.
 	 */
 	virtual Common::WriteStream *createConfigWriteStream();
 
@@ -0,0 +1,81 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREAD_H
+#define COMMON_THREAD_H
+
+#include "common/scummsys.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_thread Threads
+ * @ingroup common
+ *
+ * @brief Backend interfaces for worker threads.
+ *
+ * Engine code should not use these directly, but go through
+ * Common::ThreadPool instead.
+ * @{
+ */
+
+/** Entry point of a thread created with OSystem::createThread(). */
+typedef void (*ThreadProc)(void *data);
+
+/**
+ * A thread created by OSystem::createThread(). Deleting the object joins
+ * the thread if that has not happened yet.
+ */
+class ThreadInternal {
+public:
+	virtual ~ThreadInternal() {}
+
+	/** Wait for the thread procedure to return. */
+	virtual bool join() = 0;
+};
+
+/**
+ * A counting semaphore, created by OSystem::createSemaphore().
+ */
+class SemaphoreInternal {
+public:
+	virtual ~SemaphoreInternal() {}
+
+	/** Increment the count, waking up one waiting thread if there is any. */
+	virtual void post() = 0;
+
+	/** Block until the count is non-zero, then decrement it. */
+	virtual void wait() = 0;
+
+	/**
+	 * Block until the count is non-zero, then decrement it, or until
+	 * @p usecs microseconds have passed.
+	 *
+	 * @return True if the count was decremented, false on timeout.
+	 */
+	virtual bool timedWait(uint32 usecs) = 0;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
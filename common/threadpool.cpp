@@ -0,0 +1,228 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/threadpool.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(ThreadPool);
+
+enum {
+	/**
+	 * parallelFor() splits ranges into this many chunks per thread, so that
+	 * uneven chunks and busy workers are balanced out by the others.
+	 */
+	kChunksPerThread = 4,
+
+	/** Upper bound for the automatic number of workers. */
+	kMaxAutoWorkers = 31
+};
+
+ThreadPool::ThreadPool(int numWorkers) : _jobsAvailable(nullptr), _quit(false) {
+	assert(g_system);
+
+	if (!g_system->hasFeature(OSystem::kFeatureThreads))
+		return;
+
+	if (numWorkers < 0)
+		numWorkers = MIN<int>(g_system->getCPUCount() - 1, kMaxAutoWorkers);
+	if (numWorkers <= 0)
+		return;
+
+	_jobsAvailable = g_system->createSemaphore(0);
+	if (!_jobsAvailable)
+		return;
+
+	for (int i = 0; i < numWorkers; i++) {
+		ThreadInternal *thread = g_system->createThread(workerProc, this);
+		if (!thread) {
+			warning("ThreadPool: Could only start %d of %d worker threads", i, numWorkers);
+			break;
+		}
+		_workers.push_back(thread);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	_mutex.lock();
+	assert(_jobs.empty());
+	_quit = true;
+	_mutex.unlock();
+
+	for (uint i = 0; i < _workers.size(); i++)
+		_jobsAvailable->post();
+	for (uint i = 0; i < _workers.size(); i++)
+		delete _workers[i];
+
+	delete _jobsAvailable;
+}
+
+void ThreadPool::workerProc(void *data) {
+	((ThreadPool *)data)->workerLoop();
+}
+
+void ThreadPool::workerLoop() {
+	for (;;) {
+		_jobsAvailable->wait();
+
+		Job job;
+		_mutex.lock();
+		if (_quit) {
+			_mutex.unlock();
+			return;
+		}
+		// A thread waiting on a group may have taken the job already
+		if (!_jobs.empty()) {
+			job = _jobs.front();
+			_jobs.pop_front();
+		}
+		_mutex.unlock();
+
+		if (job.proc)
+			runJob(job);
+	}
+}
+
+void ThreadPool::submit(const Job &job) {
+	_mutex.lock();
+	job.group->_pending++;
+	_jobs.push_back(job);
+	_mutex.unlock();
+
+	if (_jobsAvailable)
+		_jobsAvailable->post();
+}
+
+void ThreadPool::runJob(const Job &job) {
+	job.proc(job.data);
+
+	StackLock lock(_mutex);
+	job.group->jobFinished();
+}
+
+namespace {
+
+struct ParallelForChunk {
+	ParallelForProc proc;
+	void *data;
+	uint begin;
+	uint end;
+};
+
+void runParallelForChunk(void *data) {
+	const ParallelForChunk *chunk = (const ParallelForChunk *)data;
+	chunk->proc(chunk->data, chunk->begin, chunk->end);
+}
+
+} // End of anonymous namespace
+
+void ThreadPool::parallelFor(uint begin, uint end, uint grainSize, ParallelForProc proc, void *data) {
+	if (begin >= end)
+		return;
+
+	const uint count = end - begin;
+	uint numChunks = _workers.empty() ? 1 : getConcurrency() * kChunksPerThread;
+	if (grainSize > 1)
+		numChunks = MIN(numChunks, (count + grainSize - 1) / grainSize);
+	numChunks = MIN(numChunks, count);
+
+	if (numChunks <= 1) {
+		proc(data, begin, end);
+		return;
+	}
+
+	Array<ParallelForChunk> chunks;
+	chunks.resize(numChunks);
+
+	JobGroup group(*this);
+	for (uint i = 0; i < numChunks; i++) {
+		ParallelForChunk &chunk = chunks[i];
+		chunk.proc = proc;
+		chunk.data = data;
+		chunk.begin = begin + (uint)((uint64)count * i / numChunks);
+		chunk.end = begin + (uint)((uint64)count * (i + 1) / numChunks);
+		group.add(runParallelForChunk, &chunk);
+	}
+	group.wait();
+}
+
+
+#pragma mark -
+
+
+JobGroup::JobGroup(ThreadPool &pool) : _pool(pool), _done(nullptr), _pending(0), _waiting(false) {
+	if (pool.getNumWorkers() > 0)
+		_done = g_system->createSemaphore(0);
+}
+
+JobGroup::~JobGroup() {
+	wait();
+	delete _done;
+}
+
+void JobGroup::add(JobProc proc, void *data) {
+	_pool.submit(ThreadPool::Job(proc, data, this));
+}
+
+void JobGroup::jobFinished() {
+	// Called with the pool mutex held
+	assert(_pending > 0);
+	if (--_pending == 0 && _waiting) {
+		_waiting = false;
+		_done->post();
+	}
+}
+
+void JobGroup::wait() {
+	for (;;) {
+		ThreadPool::Job job;
+
+		_pool._mutex.lock();
+		if (_pending == 0) {
+			_pool._mutex.unlock();
+			return;
+		}
+		for (List<ThreadPool::Job>::iterator i = _pool._jobs.begin(); i != _pool._jobs.end(); ++i) {
+			if (i->group == this) {
+				job = *i;
+				_pool._jobs.erase(i);
+				break;
+			}
+		}
+		if (!job.proc)
+			_waiting = true;
+		_pool._mutex.unlock();
+
+		// Help out with the jobs of this group that are still queued, and
+		// only sleep once all of them are running on workers.
+		if (job.proc) {
+			_pool.runJob(job);
+		} else {
+			// Without workers, every pending job is still in the queue
+			assert(_done);
+			_done->wait();
+		}
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,164 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/thread.h"
+
+namespace Common {
+
+/**
+ * @defgroup common_threadpool Thread pool
+ * @ingroup common
+ *
+ * @brief API for running jobs on worker threads.
+ *
+ * The pool keeps one worker thread per additional CPU core. Work is split
+ * into jobs which are collected in a JobGroup; waiting on the group lets the
+ * calling thread run the group's queued jobs as well, so nested groups cannot
+ * deadlock.
+ *
+ * On backends without kFeatureThreads the pool has no workers, and all jobs
+ * run serially on the thread that waits for them. Code using the pool thus
+ * works everywhere, it just does not get faster.
+ *
+ * Jobs run concurrently with the main thread and with each other: they must
+ * not call into OSystem (graphics, events, audio) and must only touch data
+ * that no other job is writing.
+ * @{
+ */
+
+class JobGroup;
+
+/** A job run by the thread pool. */
+typedef void (*JobProc)(void *data);
+
+/** Processes the indices [begin, end) of a parallelFor() range. */
+typedef void (*ParallelForProc)(void *data, uint begin, uint end);
+
+class ThreadPool : public Singleton<ThreadPool> {
+public:
+	/**
+	 * Create a thread pool with @p numWorkers worker threads. By default,
+	 * one worker is started for each CPU core beyond the first.
+	 */
+	explicit ThreadPool(int numWorkers = -1);
+	~ThreadPool();
+
+	/** Return the number of worker threads, which may be zero. */
+	uint getNumWorkers() const { return _workers.size(); }
+
+	/** Return how many jobs can run at the same time, including the caller. */
+	uint getConcurrency() const { return _workers.size() + 1; }
+
+	/**
+	 * Call @p proc for the range [begin, end), split into chunks that are
+	 * run in parallel. Returns once the whole range has been processed.
+	 *
+	 * @param grainSize  Minimum number of indices per chunk, or 0 to let
+	 *                   the pool decide. Use it to keep per-chunk overhead
+	 *                   small when the work per index is tiny.
+	 */
+	void parallelFor(uint begin, uint end, uint grainSize, ParallelForProc proc, void *data);
+
+	/**
+	 * @overload
+	 *
+	 * @p func is called as func(uint begin, uint end) and may be a lambda.
+	 */
+	template<class F>
+	void parallelFor(uint begin, uint end, uint grainSize, const F &func) {
+		parallelFor(begin, end, grainSize, &callRange<F>, const_cast<F *>(&func));
+	}
+
+private:
+	friend class JobGroup;
+
+	struct Job {
+		JobProc proc;
+		void *data;
+		JobGroup *group;
+
+		Job() : proc(nullptr), data(nullptr), group(nullptr) {}
+		Job(JobProc p, void *d, JobGroup *g) : proc(p), data(d), group(g) {}
+	};
+
+	template<class F>
+	static void callRange(void *data, uint begin, uint end) {
+		(*(const F *)data)(begin, end);
+	}
+
+	static void workerProc(void *data);
+	void workerLoop();
+
+	void submit(const Job &job);
+	void runJob(const Job &job);
+
+	Mutex _mutex;
+	List<Job> _jobs;		///< Queued jobs of all groups, oldest first
+	SemaphoreInternal *_jobsAvailable;
+	Array<ThreadInternal *> _workers;
+	bool _quit;
+};
+
+/**
+ * A set of jobs that can be waited on together (fork/join).
+ *
+ * The destructor waits for all jobs that are still pending, so jobs may
+ * safely reference data living on the stack next to the group.
+ */
+class JobGroup : NonCopyable {
+public:
+	explicit JobGroup(ThreadPool &pool = ThreadPool::instance());
+	~JobGroup();
+
+	/** Queue a job. It may start running right away on a worker thread. */
+	void add(JobProc proc, void *data);
+
+	/**
+	 * Block until all jobs added to this group have finished. While
+	 * waiting, the calling thread runs the group's queued jobs itself.
+	 * Jobs of other groups are left to the workers, so waiting never
+	 * takes longer because of unrelated work.
+	 */
+	void wait();
+
+private:
+	friend class ThreadPool;
+
+	void jobFinished();
+
+	ThreadPool &_pool;
+	SemaphoreInternal *_done;
+	uint _pending;
+	bool _waiting;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -23,6 +23,7 @@
 #define COMMON_TIMER_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/str.h"
 #include "common/noncopyable.h"
 
@@ -41,6 +42,22 @@ class TimerManager : NonCopyable {
 public:
 	typedef void (*TimerProc)(void *refCon); /*!< Type definition of a timer instance. */
 
+	/** Number of buckets in TimerStats::latenessHistogram. */
+	static const int kLatenessBuckets = 8;
+
+	/**
+	 * How late the invocations of a timer callback were, compared to the
+	 * time they were scheduled for.
+	 */
+	struct TimerStats {
+		String id;                                  /*!< ID the timer was installed with. */
+		int32 interval;                             /*!< Interval in microseconds. */
+		uint32 invocations;                         /*!< Number of invocations measured. */
+		uint64 totalLateness;                       /*!< Sum of the lateness of all invocations, in microseconds. */
+		uint32 maxLateness;                         /*!< Highest lateness of an invocation, in microseconds. */
+		uint32 latenessHistogram[kLatenessBuckets]; /*!< Invocations by lateness, see getLatenessBucketLimit(). */
+	};
+
 	virtual ~TimerManager() {}
 
 	/**
@@ -51,7 +68,7 @@ public:
 	 * written following the same safety guidelines as any other threaded code.
 	 *
 	 * @note Although the interval is specified in microseconds, the actual timer resolution
-	 *       may be lower. In particular, with the SDL backend the timer resolution is 10 ms.
+	 *       may be lower, depending on how precisely the backend can sleep.
 	 *
 	 * @param proc		Callback.
 	 * @param interval	Interval in which the timer shall be invoked (in microseconds).
@@ -69,6 +86,21 @@ public:
 	 * of this callback will be running anymore.
 	 */
 	virtual void removeTimerProc(TimerProc proc) = 0;
+
+	/**
+	 * Return the lateness statistics of the installed timer callbacks, if
+	 * the timer manager keeps them.
+	 */
+	virtual void getTimerStats(Array<TimerStats> &stats) const { stats.clear(); }
+
+	/**
+	 * Return the lateness, in microseconds, up to which invocations are
+	 * counted in the given histogram bucket. The last bucket has no limit.
+	 */
+	static uint32 getLatenessBucketLimit(int bucket) {
+		static const uint32 limits[kLatenessBuckets] = { 100, 250, 500, 1000, 2000, 5000, 10000, 0xFFFFFFFF };
+		return limits[bucket];
+	}
 };
 
 /** @} */
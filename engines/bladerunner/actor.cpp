@@ -748,6 +748,9 @@ bool Actor::tick(bool forceDraw, Common::Rect *screenRect) {
 		_animationId = newAnimation;
 		_animationFrame = newFrame;
 
+		// Read the next frames in the background, so they are there when needed
+		_vm->_sliceAnimations->prefetchFrames(_animationId, _animationFrame + 1, SliceAnimations::kLookaheadFrames);
+
 		Vector3 positionChange = _vm->_sliceAnimations->getPositionChange(_animationId);
 		float angleChange = _vm->_sliceAnimations->getFacingChange(_animationId);
 
@@ -43,6 +43,7 @@
 #include "bladerunner/item_pickup.h"
 #include "bladerunner/screen_effects.h"
 #include "bladerunner/settings.h"
+#include "bladerunner/slice_animations.h"
 #include "bladerunner/set.h"
 #include "bladerunner/set_effects.h"
 #include "bladerunner/text_resource.h"
@@ -145,6 +146,7 @@ Debugger::Debugger(BladeRunnerEngine *vm) : GUI::Debugger() {
 	registerCmd("outtake", WRAP_METHOD(Debugger, cmdOuttake));
 	registerCmd("playvqa", WRAP_METHOD(Debugger, cmdPlayVqa));
 	registerCmd("ammo", WRAP_METHOD(Debugger, cmdAmmo));
+	registerCmd("slicecache", WRAP_METHOD(Debugger, cmdSliceCache));
 #if BLADERUNNER_ORIGINAL_BUGS
 #else
 	registerCmd("effect", WRAP_METHOD(Debugger, cmdEffect));
@@ -3262,4 +3264,21 @@ bool Debugger::cmdAmmo(int argc, const char** argv) {
 	return true;
 }
 
+bool Debugger::cmdSliceCache(int argc, const char **argv) {
+	if (argc != 1) {
+		debugPrintf("Show statistics of the slice animation page cache\n");
+		debugPrintf("Usage: %s\n", argv[0]);
+		return true;
+	}
+
+	const SliceAnimations *sliceAnimations = _vm->_sliceAnimations;
+	const SliceAnimations::CacheStats &stats = sliceAnimations->getCacheStats();
+	uint32 pageSizeKB = sliceAnimations->getPageSize() / 1024;
+
+	debugPrintf("Resident pages: %u of %u (%u KB each)\n", sliceAnimations->getResidentPageCount(), sliceAnimations->getPageBudget(), pageSizeKB);
+	debugPrintf("Render path: %u hits, %u misses, %u waits for prefetch\n", stats.hits, stats.misses, stats.stalls);
+	debugPrintf("Prefetched pages: %u, evicted pages: %u\n", stats.prefetches, stats.evictions);
+	return true;
+}
+
 } // End of namespace BladeRunner
@@ -22,14 +22,40 @@
 #include "bladerunner/slice_animations.h"
 
 #include "bladerunner/bladerunner.h"
-#include "bladerunner/time.h"
 
+#include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/threadpool.h"
 
 namespace BladeRunner {
 
+enum {
+	// Never cache fewer pages than this, whatever the configured budget
+	kMinPageBudget = 16
+};
+
+SliceAnimations::SliceAnimations(BladeRunnerEngine *vm)
+	: _vm(vm)
+	, _timestamp(0)
+	, _pageSize(0)
+	, _pageCount(0)
+	, _paletteCount(0)
+	, _coreAnimPageFile(this)
+	, _framesPageFile(this)
+	, _prefetchGroup(nullptr)
+	, _lruHead(-1)
+	, _lruTail(-1)
+	, _residentPageCount(0)
+	, _pageBudget(0) {
+	memset(&_stats, 0, sizeof(_stats));
+
+	Common::ThreadPool &pool = Common::ThreadPool::instance();
+	if (pool.getNumWorkers() > 0)
+		_prefetchGroup = new Common::JobGroup(pool);
+}
+
 bool SliceAnimations::open(const Common::String &name) {
 	Common::File file;
 	if (!file.open(_vm->getResourceStream(name), name))
@@ -80,10 +106,16 @@ bool SliceAnimations::open(const Common::String &name) {
 	for (uint32 i = 0; i != _pageCount; ++i)
 		_pages[i]._data = nullptr;
 
+	// The budget for cached pages is configured in megabytes
+	_pageBudget = MAX<uint32>(kMinPageBudget, (uint32)((uint64)MAX(ConfMan.getInt("slice_cache_size"), 0) * 1024 * 1024 / _pageSize));
+
 	return true;
 }
 
 SliceAnimations::~SliceAnimations() {
+	waitForPrefetches();
+	delete _prefetchGroup;
+
 	for (uint32 i = 0; i != _pages.size(); ++i)
 		free(_pages[i]._data);
 
@@ -103,6 +135,8 @@ bool SliceAnimations::openCoreAnim() {
 }
 
 bool SliceAnimations::openFrames(int fileNumber) {
+	// Prefetch jobs must not read while the page files change
+	waitForPrefetches();
 
 	if (_framesPageFile._fileNumber == -1) { // Running for the first time, need to probe
 		// First, try HDFRAMES.DAT
@@ -226,16 +260,166 @@ void *SliceAnimations::PageFile::loadPage(uint32 pageNumber) {
 
 	uint32 pageSize = _sliceAnimations->_pageSize;
 
-	// TODO: Retire oldest pages if we exceed some memory limit
-
 	void *data = malloc(pageSize);
+	Common::StackLock lock(_sliceAnimations->_fileMutex);
 	_files[_pageOffsetsFileIdx[pageNumber]].seek(_pageOffsets[pageNumber], SEEK_SET);
 	uint32 r = _files[_pageOffsetsFileIdx[pageNumber]].read(data, pageSize);
-	assert(r == pageSize);
+	if (r != pageSize) {
+		free(data);
+		return nullptr;
+	}
+
+	return data;
+}
 
+void *SliceAnimations::loadPage(uint32 page) {
+	void *data = _coreAnimPageFile.loadPage(page); // look in COREANIM first
+	if (data == nullptr)                           // if not in COREAMIM
+		data = _framesPageFile.loadPage(page);     // Look in CDFRAMES or HDFRAMES loaded data
 	return data;
 }
 
+// The following helpers expect _pageMutex to be held
+
+void SliceAnimations::storePage(uint32 page, void *data) {
+	_pages[page]._data = data;
+	_pages[page]._state = kPageReady;
+	_residentPageCount++;
+	touchPage(page);
+}
+
+void SliceAnimations::unlinkPage(uint32 page) {
+	Page &p = _pages[page];
+	if (p._lruPrev != -1)
+		_pages[p._lruPrev]._lruNext = p._lruNext;
+	else if (_lruHead == (int32)page)
+		_lruHead = p._lruNext;
+	if (p._lruNext != -1)
+		_pages[p._lruNext]._lruPrev = p._lruPrev;
+	else if (_lruTail == (int32)page)
+		_lruTail = p._lruPrev;
+	p._lruPrev = -1;
+	p._lruNext = -1;
+}
+
+void SliceAnimations::touchPage(uint32 page) {
+	if (_lruHead == (int32)page)
+		return;
+
+	unlinkPage(page);
+	_pages[page]._lruNext = _lruHead;
+	if (_lruHead != -1)
+		_pages[_lruHead]._lruPrev = page;
+	_lruHead = page;
+	if (_lruTail == -1)
+		_lruTail = page;
+}
+
+void SliceAnimations::evictPages(uint32 keepPage) {
+	while (_residentPageCount > _pageBudget && _lruTail != -1 && _lruTail != (int32)keepPage) {
+		uint32 page = _lruTail;
+		unlinkPage(page);
+		free(_pages[page]._data);
+		_pages[page]._data = nullptr;
+		_pages[page]._state = kPageEmpty;
+		_residentPageCount--;
+		_stats.evictions++;
+	}
+}
+
+void SliceAnimations::requestPage(uint32 page, bool async) {
+	_pageMutex.lock();
+	if (_pages[page]._state != kPageEmpty) {
+		_pageMutex.unlock();
+		return;
+	}
+
+	if (async) {
+		_pages[page]._state = kPageLoading;
+		_pageMutex.unlock();
+
+		PrefetchJob *job = new PrefetchJob();
+		job->_sliceAnimations = this;
+		job->_page = page;
+		_prefetchGroup->add(prefetchJobProc, job);
+		return;
+	}
+	_pageMutex.unlock();
+
+	void *data = loadPage(page);
+	if (data == nullptr)
+		return;
+
+	Common::StackLock lock(_pageMutex);
+	storePage(page, data);
+	evictPages(page);
+}
+
+void SliceAnimations::prefetchJobProc(void *data) {
+	PrefetchJob *job = (PrefetchJob *)data;
+	SliceAnimations *sliceAnimations = job->_sliceAnimations;
+	uint32 page = job->_page;
+	delete job;
+
+	{
+		Common::StackLock lock(sliceAnimations->_pageMutex);
+		// The main thread may have read the page itself in the meantime
+		if (sliceAnimations->_pages[page]._state != kPageLoading)
+			return;
+		sliceAnimations->_pages[page]._state = kPageReading;
+	}
+
+	void *pageData = sliceAnimations->loadPage(page);
+
+	Common::StackLock lock(sliceAnimations->_pageMutex);
+	if (pageData == nullptr) {
+		// Leave it to the main thread to report the error
+		sliceAnimations->_pages[page]._state = kPageEmpty;
+		return;
+	}
+	// Eviction is left to the main thread, which may still be using
+	// the least recently used pages.
+	sliceAnimations->storePage(page, pageData);
+	sliceAnimations->_stats.prefetches++;
+}
+
+void SliceAnimations::waitForPrefetches() {
+	if (_prefetchGroup)
+		_prefetchGroup->wait();
+}
+
+void SliceAnimations::prefetchFrames(uint32 animation, uint32 firstFrame, uint32 count) {
+	if (_prefetchGroup == nullptr || animation >= _animations.size())
+		return;
+
+	const Animation &anim = _animations[animation];
+	if (anim.frameCount == 0)
+		return;
+
+	count = MIN(count, anim.frameCount);
+	uint32 lastPage = 0xffffffff;
+	for (uint32 i = 0; i != count; ++i) {
+		uint32 frame = (firstFrame + i) % anim.frameCount;
+		uint32 page  = (anim.offset + frame * anim.frameSize) / _pageSize;
+		if (page != lastPage) {
+			requestPage(page, true);
+			lastPage = page;
+		}
+	}
+}
+
+void SliceAnimations::preload(uint32 animation) {
+	const Animation &anim = _animations[animation];
+	uint32 lastPage = 0xffffffff;
+	for (uint32 frame = 0; frame != anim.frameCount; ++frame) {
+		uint32 page = (anim.offset + frame * anim.frameSize) / _pageSize;
+		if (page != lastPage) {
+			requestPage(page, _prefetchGroup != nullptr);
+			lastPage = page;
+		}
+	}
+}
+
 void *SliceAnimations::getFramePtr(uint32 animation, uint32 frame) {
 #if BLADERUNNER_ORIGINAL_BUGS
 #else
@@ -264,21 +448,42 @@ void *SliceAnimations::getFramePtr(uint32 animation, uint32 frame) {
 	uint32 page        = frameOffset / _pageSize;
 	uint32 pageOffset  = frameOffset % _pageSize;
 
-	if (_pages[page]._data == nullptr) {                          // if not cached already
-		_pages[page]._data = _coreAnimPageFile.loadPage(page);    // look in COREANIM first
+	_pageMutex.lock();
+
+	if (_pages[page]._state == kPageReading) {
+		// A prefetch job is reading this very page. Wait for that single
+		// read only, not for the rest of the queued pages.
+		_stats.stalls++;
+		do {
+			_pageMutex.unlock();
+			g_system->delayMillis(1);
+			_pageMutex.lock();
+		} while (_pages[page]._state == kPageReading);
+	}
 
-		if (_pages[page]._data == nullptr) {                      // if not in COREAMIM
-			_pages[page]._data = _framesPageFile.loadPage(page);  // Look in CDFRAMES or HDFRAMES loaded data
+	if (_pages[page]._state != kPageReady) {                      // if not cached already
+		// A queued prefetch job for the page skips it once it is read here
+		_stats.misses++;
+		_pages[page]._state = kPageReading;
+		_pageMutex.unlock();
 
-			if (_pages[page]._data == nullptr) {
-				error("Unable to locate page %d for animation %d frame %d", page, animation, frame);
-			}
+		void *data = loadPage(page);
+		if (data == nullptr) {
+			error("Unable to locate page %d for animation %d frame %d", page, animation, frame);
 		}
+
+		_pageMutex.lock();
+		storePage(page, data);
+	} else {
+		_stats.hits++;
+		touchPage(page);
 	}
 
-	_pages[page]._lastAccess = _vm->_time->currentSystem();
+	evictPages(page);
+	void *pagePtr = _pages[page]._data;
+	_pageMutex.unlock();
 
-	return (byte *)_pages[page]._data + pageOffset;
+	return (byte *)pagePtr + pageOffset;
 }
 
 Vector3 SliceAnimations::getPositionChange(int animation) const {
@@ -24,6 +24,7 @@
 
 #include "common/array.h"
 #include "common/file.h"
+#include "common/mutex.h"
 #include "common/str.h"
 #include "common/types.h"
 
@@ -31,6 +32,10 @@
 #include "bladerunner/vector.h"
 
 
+namespace Common {
+class JobGroup;
+}
+
 namespace BladeRunner {
 
 class BladeRunnerEngine;
@@ -55,11 +60,30 @@ class SliceAnimations {
 	//	uint16 &operator[](size_t i) { return color555[i]; }
 	};
 
+	enum PageState {
+		kPageEmpty,
+		kPageLoading, // queued for a prefetch job
+		kPageReading, // being read, by a prefetch job or the main thread
+		kPageReady
+	};
+
+	/**
+	 * Loaded pages are kept in a doubly linked list, most recently used
+	 * first, linked by page index. Pages beyond the cache budget are
+	 * evicted from the tail.
+	 */
 	struct Page {
 		void   *_data;
-		uint32 _lastAccess;
+		int32   _lruPrev;
+		int32   _lruNext;
+		byte    _state;
 
-		Page() : _data(nullptr), _lastAccess(0) {}
+		Page() : _data(nullptr), _lruPrev(-1), _lruNext(-1), _state(kPageEmpty) {}
+	};
+
+	struct PrefetchJob {
+		SliceAnimations *_sliceAnimations;
+		uint32           _page;
 	};
 
 	struct PageFile {
@@ -90,15 +114,45 @@ class SliceAnimations {
 	PageFile _coreAnimPageFile;
 	PageFile _framesPageFile;
 
+	// Pages may be loaded by prefetch jobs on worker threads. _pageMutex
+	// guards the page states, the LRU list and the statistics, _fileMutex
+	// the page files. Only the main thread frees pages.
+	Common::Mutex     _pageMutex;
+	Common::Mutex     _fileMutex;
+	Common::JobGroup *_prefetchGroup;
+
+	int32  _lruHead;
+	int32  _lruTail;
+	uint32 _residentPageCount;
+	uint32 _pageBudget;
+
 public:
-	SliceAnimations(BladeRunnerEngine *vm)
-		: _vm(vm)
-		, _coreAnimPageFile(this)
-		, _framesPageFile(this)
-		, _timestamp(0)
-		, _pageSize(0)
-		, _pageCount(0)
-		, _paletteCount(0) {}
+	/** How many frames actors read ahead of the one they are showing. */
+	static const uint32 kLookaheadFrames = 15;
+
+	struct CacheStats {
+		uint32 hits;        // page was resident when rendering
+		uint32 misses;      // rendering had to read the page itself
+		uint32 stalls;      // rendering had to wait for a prefetch
+		uint32 prefetches;  // pages read ahead by prefetch jobs
+		uint32 evictions;
+	};
+
+private:
+	CacheStats _stats;
+
+	void *loadPage(uint32 page);
+	void  storePage(uint32 page, void *data);
+	void  touchPage(uint32 page);
+	void  unlinkPage(uint32 page);
+	void  evictPages(uint32 keepPage);
+	void  requestPage(uint32 page, bool async);
+	void  waitForPrefetches();
+
+	static void prefetchJobProc(void *data);
+
+public:
+	SliceAnimations(BladeRunnerEngine *vm);
 	~SliceAnimations();
 
 	bool open(const Common::String &name);
@@ -109,6 +163,24 @@ public:
 	Palette &getPalette(int i) { return _palettes[i]; };
 	void    *getFramePtr(uint32 animation, uint32 frame);
 
+	/**
+	 * Start reading the pages for @p count frames of @p animation from
+	 * @p firstFrame on in the background, wrapping around at the end of the
+	 * animation. Does nothing if there are no worker threads.
+	 */
+	void prefetchFrames(uint32 animation, uint32 firstFrame, uint32 count);
+
+	/**
+	 * Make sure all frames of @p animation get loaded, in the background
+	 * if possible.
+	 */
+	void preload(uint32 animation);
+
+	const CacheStats &getCacheStats() const { return _stats; }
+	uint32 getResidentPageCount() const { return _residentPageCount; }
+	uint32 getPageBudget() const { return _pageBudget; }
+	uint32 getPageSize() const { return _pageSize; }
+
 	int   getFrameCount(int animation) const { return _animations[animation].frameCount; }
 	float getFPS(int animation) const { return _animations[animation].fps; }
 
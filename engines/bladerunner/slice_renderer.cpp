@@ -746,10 +746,7 @@ void SliceRenderer::drawShadowPolygon(int transparency, Graphics::Surface &surfa
 }
 
 void SliceRenderer::preload(int animationId) {
-	int frameCount = _vm->_sliceAnimations->getFrameCount(animationId);
-	for (int i = 0; i < frameCount; ++i) {
-		_vm->_sliceAnimations->getFramePtr(animationId, i);
-	}
+	_vm->_sliceAnimations->preload(animationId);
 }
 
 void SliceRenderer::disableShadows(int animationsIdsList[], int listSize) {
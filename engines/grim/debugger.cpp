@@ -27,6 +27,8 @@
 #include "engines/grim/md5check.h"
 #include "engines/grim/grim.h"
 
+#include "engines/grim/lua/lgc.h"
+
 namespace Grim {
 
 Debugger::Debugger() :
@@ -39,6 +41,7 @@ Debugger::Debugger() :
 	registerCmd("renderer_get", WRAP_METHOD(Debugger, cmd_renderer_get));
 	registerCmd("save", WRAP_METHOD(Debugger, cmd_save));
 	registerCmd("load", WRAP_METHOD(Debugger, cmd_load));
+	registerCmd("lua_gc", WRAP_METHOD(Debugger, cmd_lua_gc));
 }
 
 Debugger::~Debugger() {
@@ -134,4 +137,24 @@ bool Debugger::cmd_load(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_lua_gc(int argc, const char **argv) {
+	if (argc > 1) {
+		if (strcmp(argv[1], "full") != 0) {
+			debugPrintf("Usage: lua_gc [full]\n");
+			return true;
+		}
+		debugPrintf("Recovered %d blocks\n", lua_collectgarbage(0));
+	}
+
+	static const char *const phaseNames[] = { "pause", "propagate", "sweep", "finalize" };
+	const GCStats &stats = luaC_getstats();
+	debugPrintf("Phase: %s, %d objects left to traverse\n", phaseNames[stats.phase], stats.grayCount);
+	debugPrintf("Blocks: %d, threshold: %d\n", stats.blocks, stats.threshold);
+	debugPrintf("Cycles: %d (%d full collections), the last one freed %d blocks\n",
+		stats.cycles, stats.fullCollections, stats.lastRecovered);
+	debugPrintf("Steps: %d (%d in this cycle), most work in one step: %d\n",
+		stats.steps, stats.cycleSteps, stats.maxStepWork);
+	return true;
+}
+
 }
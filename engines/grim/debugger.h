@@ -40,6 +40,7 @@ public:
 	bool cmd_renderer_set(int argc, const char **argv);
 	bool cmd_save(int argc, const char **argv);
 	bool cmd_load(int argc, const char **argv);
+	bool cmd_lua_gc(int argc, const char **argv);
 };
 
 }
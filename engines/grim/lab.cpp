@@ -62,10 +62,9 @@ bool Lab::open(const Common::Path &filename, bool keepStream) {
 			parseMonkey4FileTable(file);
 	}
 	if (result && keepStream) {
+		// Memory-mapped files are shared instead of being copied
 		file->seek(0, SEEK_SET);
-		byte *data = static_cast<byte*>(malloc(sizeof(byte) * file->size()));
-		file->read(data, file->size());
-		_stream = new Common::MemoryReadStream(data, file->size(), DisposeAfterUse::YES);
+		_stream = file->readStream(file->size());
 	}
 	delete file;
 
@@ -171,15 +170,17 @@ Common::SeekableReadStream *Lab::createReadStreamForMember(const Common::Path &p
 
 	LabEntryPtr i = _entries[path];
 
+	// Streams cannot hand out empty sub-streams
+	if (i->_len == 0)
+		return new Common::MemoryReadStream(nullptr, 0);
+
 	if (!_stream) {
 		Common::File *file = new Common::File();
 		file->open(_labFileName);
 		return new Common::SeekableSubReadStream(file, i->_offset, i->_offset + i->_len, DisposeAfterUse::YES);
 	} else {
-		byte *data = static_cast<byte*>(malloc(sizeof(byte) * i->_len));
 		_stream->seek(i->_offset, SEEK_SET);
-		_stream->read(data, i->_len);
-		return new Common::MemoryReadStream(data, i->_len, DisposeAfterUse::YES);
+		return _stream->readStream(i->_len);
 	}
 }
 
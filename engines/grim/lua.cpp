@@ -261,11 +261,13 @@ void LuaBase::boot() {
 }
 
 void LuaBase::update(int frameTime, int movieTime) {
+	// Collect a little every frame, and start a new cycle every ten seconds
+	// even when the allocation threshold was not reached
 	_frameTimeCollection += frameTime;
-	if (_frameTimeCollection > 10000) {
+	bool startCycle = _frameTimeCollection > 10000;
+	if (startCycle)
 		_frameTimeCollection = 0;
-		lua_collectgarbage(0);
-	}
+	lua_stepgarbage(startCycle);
 
 	lua_beginblock();
 	setFrameTime(frameTime);
@@ -19,8 +19,28 @@
 
 namespace Grim {
 
+#define GC_STEPSIZE 50   // blocks allocated between two steps of a cycle
+#define GC_STEPWORK 1000 // work done by one step
+
 static int32 markobject (TObject *o);
 
+static struct {
+	GCPhase phase;
+	bool running;      // prevents steps from the gc tag methods
+	TObject *gray;     // stack of the gray objects
+	int32 graySize;
+	int32 grayCount;
+	int32 sweepList;   // list being swept, index in sweepRoots
+	GCnode *sweepPrev; // node before the next one to sweep
+	GCnode *sweepStart[3]; // first node of each list when marking finished
+	GCnode *frees[3];  // white tables, prototypes and closures
+	TaggedString *freeStrings;
+	int32 cycleBlocks; // nblocks when the cycle finished marking
+	GCStats stats;
+} gcState;
+
+static GCnode *const sweepRoots[3] = { &roottable, &rootproto, &rootcl };
+
 /*
 ** =======================================================
 ** REF mechanism
@@ -128,63 +148,48 @@ void luaC_strcallIM(TaggedString *l) {
 	}
 }
 
-static GCnode *listcollect(GCnode *l) {
-	GCnode *frees = nullptr;
-	while (l) {
-		GCnode *next = l->next;
-		l->marked = 0;
-		while (next && !next->marked) {
-			l->next = next->next;
-			next->next = frees;
-			frees = next;
-			next = l->next;
-		}
-		l = next;
-	}
-	return frees;
-}
-
 static void strmark(TaggedString *s) {
 	if (!s->head.marked)
 		s->head.marked = 1;
 }
 
-static void protomark(TProtoFunc *f) {
-	if (!f->head.marked) {
-		LocVar *v = f->locvars;
-		f->head.marked = 1;
-		if (f->fileName)
-			strmark(f->fileName);
-		for (int32 i = 0; i < f->nconsts; i++)
-			markobject(&f->consts[i]);
-		if (v) {
-			for (; v->line != -1; v++) {
-				if (v->varname)
-					strmark(v->varname);
-			}
+static void pushgray(GCnode *node, TObject *o) {
+	if (gcState.grayCount == gcState.graySize)
+		gcState.graySize = luaM_growvector(&gcState.gray, gcState.graySize, TObject, "gc stack overflow", MAX_INT);
+	node->marked = GC_GRAY;
+	gcState.gray[gcState.grayCount++] = *o;
+}
+
+static int32 traverseproto(TProtoFunc *f) {
+	LocVar *v = f->locvars;
+	if (f->fileName)
+		strmark(f->fileName);
+	for (int32 i = 0; i < f->nconsts; i++)
+		markobject(&f->consts[i]);
+	if (v) {
+		for (; v->line != -1; v++) {
+			if (v->varname)
+				strmark(v->varname);
 		}
 	}
+	return 1 + f->nconsts;
 }
 
-static void closuremark(Closure *f) {
-	if (!f->head.marked) {
-		f->head.marked = 1;
-		for (int32 i = f->nelems; i >= 0; i--)
-			markobject(&f->consts[i]);
-	}
+static int32 traverseclosure(Closure *f) {
+	for (int32 i = f->nelems; i >= 0; i--)
+		markobject(&f->consts[i]);
+	return 1 + f->nelems;
 }
 
-static void hashmark(Hash *h) {
-	if (!h->head.marked) {
-		h->head.marked = 1;
-		for (int32 i = 0; i < nhash(h); i++) {
-			Node *n = node(h, i);
-			if (ttype(ref(n)) != LUA_T_NIL) {
-				markobject(&n->ref);
-				markobject(&n->val);
-			}
+static int32 traversehash(Hash *h) {
+	for (int32 i = 0; i < nhash(h); i++) {
+		Node *n = node(h, i);
+		if (ttype(ref(n)) != LUA_T_NIL) {
+			markobject(&n->ref);
+			markobject(&n->val);
 		}
 	}
+	return 1 + nhash(h);
 }
 
 static void globalmark() {
@@ -203,15 +208,18 @@ static int32 markobject(TObject *o) {
 		strmark(tsvalue(o));
 		break;
 	case LUA_T_ARRAY:
-		hashmark(avalue(o));
+		if (avalue(o)->head.marked == GC_WHITE)
+			pushgray(&avalue(o)->head, o);
 		break;
 	case LUA_T_CLOSURE:
 	case LUA_T_CLMARK:
-		closuremark(o->value.cl);
+		if (o->value.cl->head.marked == GC_WHITE)
+			pushgray(&o->value.cl->head, o);
 		break;
 	case LUA_T_PROTO:
 	case LUA_T_PMARK:
-		protomark(o->value.tf);
+		if (o->value.tf->head.marked == GC_WHITE)
+			pushgray(&o->value.tf->head, o);
 		break;
 	default:
 		break;  // numbers, cprotos, etc
@@ -226,34 +234,240 @@ static void markall() {
 	luaT_travtagmethods(markobject);  // mark fallbacks
 }
 
-int32 lua_collectgarbage(int32 limit) {
-	int32 recovered = nblocks;  // to subtract nblocks after gc
-	Hash *freetable;
-	TaggedString *freestr;
-	TProtoFunc *freefunc;
-	Closure *freeclos;
+/*
+** Traverse gray objects until at least 'limit' work was done
+*/
+static int32 propagate(int32 limit) {
+	int32 work = 0;
+	while (gcState.grayCount > 0 && work < limit) {
+		TObject *o = &gcState.gray[--gcState.grayCount];
+		switch (ttype(o)) {
+		case LUA_T_ARRAY:
+			avalue(o)->head.marked = GC_BLACK;
+			work += traversehash(avalue(o));
+			break;
+		case LUA_T_CLOSURE:
+		case LUA_T_CLMARK:
+			o->value.cl->head.marked = GC_BLACK;
+			work += traverseclosure(o->value.cl);
+			break;
+		default:
+			o->value.tf->head.marked = GC_BLACK;
+			work += traverseproto(o->value.tf);
+			break;
+		}
+	}
+	return work;
+}
+
+void luaC_barrierback(Hash *t) {
+	// The table was already traversed, traverse it again with the new value.
+	// Once marking is finished, the black tables just wait to be swept.
+	if (gcState.phase == GCSpropagate) {
+		TObject o;
+		ttype(&o) = LUA_T_ARRAY;
+		avalue(&o) = t;
+		pushgray(&t->head, &o);
+	}
+}
+
+/*
+** End of the mark phase, without interruption: mark the roots again, as
+** they are modified without barriers, and finish the traversal.
+*/
+static void atomic() {
 	markall();
+
+	// Objects are added to the front of the lists, so sweeping starts after
+	// the first object of each list, which has to be kept alive. Objects
+	// created later are in front of it and are never swept in this cycle.
+	for (int32 i = 0; i < 3; i++) {
+		GCnode *first = sweepRoots[i]->next;
+		gcState.sweepStart[i] = first;
+		if (first && first->marked == GC_WHITE) {
+			TObject o;
+			ttype(&o) = (i == 0) ? LUA_T_ARRAY : (i == 1) ? LUA_T_PROTO : LUA_T_CLOSURE;
+			o.value.a = (Hash *)first;
+			pushgray(first, &o);
+		}
+	}
+	propagate(MAX_INT);
+
 	invalidaterefs();
-	freestr = luaS_collector();
-	freetable = (Hash *)listcollect(&roottable);
-	freefunc = (TProtoFunc *)listcollect(&rootproto);
-	freeclos = (Closure *)listcollect(&rootcl);
-	GCthreshold *= 4;  // to avoid GC during GC
+	// Strings are swept at once, a string created by a later step could
+	// otherwise end up in the part of the string table already swept
+	gcState.freeStrings = luaS_collector();
+
+	gcState.cycleBlocks = nblocks;
+	gcState.sweepList = 0;
+	gcState.sweepPrev = gcState.sweepStart[0];
+	gcState.phase = GCSsweep;
+}
+
+/*
+** Sweep at most 'limit' objects, moving the white ones to the free lists
+*/
+static int32 sweep(int32 limit) {
+	int32 work = 0;
+	while (work < limit) {
+		GCnode *next = gcState.sweepPrev ? gcState.sweepPrev->next : nullptr;
+		if (!next) {
+			if (gcState.sweepPrev)
+				gcState.sweepPrev->marked = GC_WHITE;
+			if (++gcState.sweepList == 3) {
+				gcState.phase = GCSfinalize;
+				break;
+			}
+			gcState.sweepPrev = gcState.sweepStart[gcState.sweepList];
+			continue;
+		}
+		if (next->marked) {
+			gcState.sweepPrev->marked = GC_WHITE;
+			gcState.sweepPrev = next;
+		} else {
+			gcState.sweepPrev->next = next->next;
+			next->next = gcState.frees[gcState.sweepList];
+			gcState.frees[gcState.sweepList] = next;
+		}
+		work++;
+	}
+	return work;
+}
+
+static void finalize() {
+	Hash *freetable = (Hash *)gcState.frees[0];
+	TProtoFunc *freefunc = (TProtoFunc *)gcState.frees[1];
+	Closure *freeclos = (Closure *)gcState.frees[2];
+	TaggedString *freestr = gcState.freeStrings;
+	gcState.frees[0] = gcState.frees[1] = gcState.frees[2] = nullptr;
+	gcState.freeStrings = nullptr;
+
 	luaC_hashcallIM(freetable);  // GC tag methods for tables
 	luaC_strcallIM(freestr);  // GC tag methods for userdata
 	luaD_gcIM(&luaO_nilobject);  // GC tag method for nil (signal end of GC)
+
+	int32 blocks = nblocks;
 	luaH_free(freetable);
 	luaS_free(freestr);
 	luaF_freeproto(freefunc);
 	luaF_freeclosure(freeclos);
+
+	gcState.stats.lastRecovered = blocks - nblocks;
+	gcState.stats.cycles++;
+	gcState.phase = GCSpause;
+	GCthreshold = 2 * nblocks;
+}
+
+static int32 singlestep(int32 limit) {
+	switch (gcState.phase) {
+	case GCSpause:
+		gcState.stats.cycleSteps = 0;
+		gcState.phase = GCSpropagate;
+		markall();
+		return 1;
+	case GCSpropagate:
+		if (gcState.grayCount > 0)
+			return propagate(limit);
+		atomic();
+		return 1;
+	case GCSsweep:
+		return sweep(limit) + 1;
+	case GCSfinalize:
+		finalize();
+		return 1;
+	}
+	return 1;
+}
+
+/*
+** Do a bounded amount of work. The gc tag methods may run Lua code,
+** which must not start collecting again.
+*/
+void luaC_step() {
+	if (gcState.running)
+		return;
+
+	gcState.running = true;
+	int32 work = 0;
+	do {
+		work += singlestep(GC_STEPWORK - work);
+	} while (work < GC_STEPWORK && gcState.phase != GCSpause);
+	gcState.running = false;
+
+	if (gcState.phase != GCSpause)
+		GCthreshold = nblocks + GC_STEPSIZE;
+
+	gcState.stats.steps++;
+	gcState.stats.cycleSteps++;
+	gcState.stats.maxStepWork = MAX(gcState.stats.maxStepWork, work);
+}
+
+/*
+** Run the current cycle to its end, or a complete one if 'start' is set
+*/
+static void runcycle(bool start) {
+	if (gcState.phase == GCSpause && !start)
+		return;
+
+	gcState.running = true;
+	do {
+		singlestep(MAX_INT);
+	} while (gcState.phase != GCSpause);
+	gcState.running = false;
+}
+
+void luaC_finishgc() {
+	if (!gcState.running)
+		runcycle(false);
+}
+
+void luaC_resetgc() {
+	luaM_free(gcState.gray);
+	gcState.gray = nullptr;
+	gcState.graySize = 0;
+	gcState.grayCount = 0;
+	gcState.phase = GCSpause;
+	gcState.running = false;
+	gcState.sweepList = 0;
+	gcState.sweepPrev = nullptr;
+	gcState.sweepStart[0] = gcState.sweepStart[1] = gcState.sweepStart[2] = nullptr;
+	gcState.frees[0] = gcState.frees[1] = gcState.frees[2] = nullptr;
+	gcState.freeStrings = nullptr;
+	gcState.cycleBlocks = 0;
+	memset(&gcState.stats, 0, sizeof(gcState.stats));
+}
+
+const GCStats &luaC_getstats() {
+	gcState.stats.phase = gcState.phase;
+	gcState.stats.grayCount = gcState.grayCount;
+	gcState.stats.blocks = nblocks;
+	gcState.stats.threshold = GCthreshold;
+	return gcState.stats;
+}
+
+int32 lua_collectgarbage(int32 limit) {
+	if (gcState.running)
+		return 0;
+
+	int32 recovered = nblocks;  // to subtract nblocks after gc
+	// A running cycle keeps everything that was reachable when it started,
+	// finish it and collect again
+	runcycle(false);
+	runcycle(true);
 	recovered = recovered - nblocks;
 	GCthreshold = (limit == 0) ? 2 * nblocks : nblocks + limit;
+	gcState.stats.fullCollections++;
 	return recovered;
 }
 
+void lua_stepgarbage(int32 startcycle) {
+	if (gcState.phase != GCSpause || startcycle)
+		luaC_step();
+}
+
 void luaC_checkGC() {
 	if (nblocks >= GCthreshold)
-		lua_collectgarbage(0);
+		luaC_step();
 }
 
 } // end of namespace Grim
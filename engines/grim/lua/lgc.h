@@ -11,11 +11,56 @@
 
 namespace Grim {
 
+/*
+** The collector is an incremental tri-color mark and sweep. Tables,
+** closures and prototypes are white (not reached yet), gray (reached, but
+** their references still have to be traversed) or black (done). Strings
+** cannot hold references, so they are only ever white or marked.
+*/
+#define GC_WHITE 0
+#define GC_BLACK 1
+#define GC_GRAY  2
+
+enum GCPhase {
+	GCSpause,     // no cycle running
+	GCSpropagate, // traversing the gray objects
+	GCSsweep,     // freeing the white objects
+	GCSfinalize   // calling the gc tag methods
+};
+
+struct GCStats {
+	GCPhase phase;
+	int32 cycles;          // completed cycles
+	int32 fullCollections; // cycles completed by lua_collectgarbage
+	int32 steps;           // incremental steps
+	int32 cycleSteps;      // steps taken by the current cycle
+	int32 maxStepWork;     // most work done by one step
+	int32 lastRecovered;   // blocks freed by the last cycle
+	int32 grayCount;       // objects left to traverse
+	int32 blocks;          // allocated blocks
+	int32 threshold;       // blocks at which the next step runs
+};
+
 void luaC_checkGC();
+void luaC_step();
+void luaC_finishgc();
+void luaC_resetgc();
+const GCStats &luaC_getstats();
 TObject* luaC_getref(int32 r);
 int32 luaC_ref(TObject *o, int32 lock);
 void luaC_hashcallIM(Hash *l);
 void luaC_strcallIM(TaggedString *l);
+void luaC_barrierback(Hash *t);
+
+/*
+** Must be called before a reference is stored in the table t. Stacks,
+** globals, refs and tag methods are traversed again at the end of the
+** mark phase, so they do not need a barrier.
+*/
+inline void luaC_tablebarrier(Hash *t) {
+	if (t->head.marked == GC_BLACK)
+		luaC_barrierback(t);
+}
 
 } // end of namespace Grim
 
@@ -132,6 +132,7 @@ void lua_resetglobals() {
 	refSize = 0;
 	GCthreshold = GARBAGE_BLOCK;
 	nblocks = 0;
+	luaC_resetgc();
 
 	luaD_init();
 	luaS_init();
@@ -218,6 +219,8 @@ void lua_open() {
 }
 
 void lua_close() {
+	luaC_finishgc();
+
 	TaggedString *alludata = luaS_collectudata();
 	GCthreshold = MAX_INT;  // to avoid GC during GC
 	luaC_hashcallIM((Hash *)roottable.next);  // GC t.methods for tables
@@ -244,6 +247,7 @@ void lua_close() {
 	IMtable = nullptr;
 	refArray = nullptr;
 	lua_rootState = lua_state = nullptr;
+	luaC_resetgc();
 
 #ifdef LUA_DEBUG
 	printf("total de blocos: %ld\n", numblocks);
@@ -127,7 +127,7 @@ TaggedString *luaS_new(const char *str) {
 
 TaggedString *luaS_newfixedstring(const char *str) {
 	TaggedString *ts = luaS_new(str);
-	if (ts->head.marked == 0)
+	if (ts->head.marked < 2)
 		ts->head.marked = 2;  // avoid GC
 	return ts;
 }
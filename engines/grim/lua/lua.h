@@ -129,6 +129,7 @@ void lua_unref(int32 ref);
 
 lua_Object lua_createtable();
 int32 lua_collectgarbage(int32 limit);
+void lua_stepgarbage(int32 startcycle);
 
 void lua_runtasks();
 void current_script();
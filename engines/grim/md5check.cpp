@@ -19,7 +19,9 @@
  *
  */
 
+#include "common/archive.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/md5.h"
 #include "common/translation.h"
 
@@ -585,7 +587,10 @@ bool MD5Check::advanceCheck(int *pos, int *total) {
 		return false;
 	}
 
-	const MD5Sum &sum = (*_files)[_iterator++];
+	// A few files are checked at once, they are read and hashed in parallel
+	const int first = _iterator;
+	const int count = MIN<int>(kFilesPerAdvance, _files->size() - first);
+	_iterator += count;
 	if (pos) {
 		*pos = _iterator;
 	}
@@ -596,27 +601,59 @@ bool MD5Check::advanceCheck(int *pos, int *total) {
 		_iterator = -1;
 	}
 
-	Common::File file;
-	if (file.open(sum.filename)) {
-		Common::String md5 = Common::computeStreamMD5AsString(file);
-		if (!checkMD5(sum, md5.c_str())) {
-			warning("'%s' may be corrupted. MD5: '%s'", sum.filename, md5.c_str());
-			GUI::displayErrorDialog(Common::U32String::format(_("The game data file %s may be corrupted.\nIf you are sure it is "
-									"not please provide the ScummVM team the following code, along with the file name, the language and a "
-									"description of your game version (i.e. dvd-box or jewelcase):\n%s"), sum.filename, md5.c_str()));
-			return false;
+	// Only plain files have a handle of their own. Members of an archive, like
+	// the EMI Mac installer, share its stream and are hashed one at a time.
+	Common::File files[kFilesPerAdvance];
+	Common::ReadStream *streams[kFilesPerAdvance];
+	bool opened[kFilesPerAdvance];
+	for (int i = 0; i < count; i++) {
+		const char *filename = (*_files)[first + i].filename;
+		opened[i] = files[i].open(filename);
+		Common::Archive *container = nullptr;
+		if (opened[i]) {
+			SearchMan.getMember(filename, &container);
+		}
+		streams[i] = dynamic_cast<Common::FSDirectory *>(container) ? &files[i] : nullptr;
+	}
+
+	Common::String md5s[kFilesPerAdvance];
+	Common::computeStreamsMD5AsString(streams, md5s, count);
+	for (int i = 0; i < count; i++) {
+		if (opened[i] && !streams[i]) {
+			md5s[i] = Common::computeStreamMD5AsString(files[i]);
+		}
+	}
+
+	// Every failure is logged, but only the first one gets a dialog, like
+	// when the files were checked one per call
+	bool ok = true;
+	for (int i = 0; i < count; i++) {
+		const MD5Sum &sum = (*_files)[first + i];
+		if (opened[i]) {
+			const Common::String &md5 = md5s[i];
+			if (!checkMD5(sum, md5.c_str())) {
+				warning("'%s' may be corrupted. MD5: '%s'", sum.filename, md5.c_str());
+				if (ok) {
+					GUI::displayErrorDialog(Common::U32String::format(_("The game data file %s may be corrupted.\nIf you are sure it is "
+											"not please provide the ScummVM team the following code, along with the file name, the language and a "
+											"description of your game version (i.e. dvd-box or jewelcase):\n%s"), sum.filename, md5.c_str()));
+				}
+				ok = false;
+			}
+		} else {
+			warning("Could not open %s for checking", sum.filename);
+			if (ok) {
+				Common::String urlForRequiredDataFiles = Common::String::format("https://wiki.scummvm.org/index.php?title=%s#Required_data_files",
+				                                                                (g_grim->getGameType() == GType_GRIM)? "Grim_Fandango" : "Escape_from_Monkey_Island");
+				GUIErrorMessageWithURL(Common::U32String::format(_("Could not open the file %s for checking.\nIt may be missing or "
+				                       "you may not have the rights to open it.\nGo to %s to see a list "
+				                       "of the needed files."), sum.filename, urlForRequiredDataFiles.c_str()), urlForRequiredDataFiles.c_str());
+			}
+			ok = false;
 		}
-	} else {
-		Common::String urlForRequiredDataFiles = Common::String::format("https://wiki.scummvm.org/index.php?title=%s#Required_data_files",
-		                                                                (g_grim->getGameType() == GType_GRIM)? "Grim_Fandango" : "Escape_from_Monkey_Island");
-		warning("Could not open %s for checking", sum.filename);
-		GUIErrorMessageWithURL(Common::U32String::format(_("Could not open the file %s for checking.\nIt may be missing or "
-		                       "you may not have the rights to open it.\nGo to %s to see a list "
-		                       "of the needed files."), sum.filename, urlForRequiredDataFiles.c_str()), urlForRequiredDataFiles.c_str());
-		return false;
 	}
 
-	return true;
+	return ok;
 }
 
 }
@@ -35,6 +35,11 @@ public:
 	static void clear();
 
 private:
+	enum {
+		/** Files read and hashed together by one advanceCheck() call */
+		kFilesPerAdvance = 8
+	};
+
 	static void init();
 
 	struct MD5Sum {
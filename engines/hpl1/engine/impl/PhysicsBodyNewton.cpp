@@ -417,6 +417,7 @@ void cPhysicsBodyNewton::ClearForces() {
 
 void cPhysicsBodyNewton::OnTransformCallback(const NewtonBody *apBody, const dFloat *apMatrix, int32) {
 	cPhysicsBodyNewton *pRigidBody = (cPhysicsBodyNewton *)NewtonBodyGetUserData(apBody);
+	cNewtonCallbackLock lock(NewtonBodyGetWorld(apBody));
 
 	pRigidBody->m_mtxLocalTransform.FromTranspose(apMatrix);
 
@@ -124,6 +124,7 @@ float cPhysicsJointHingeNewton::GetAngle() {
 
 unsigned cPhysicsJointHingeNewton::LimitCallback(const NewtonJoint *pHinge, NewtonHingeSliderUpdateDesc *pDesc) {
 	cPhysicsJointHingeNewton *pHingeJoint = (cPhysicsJointHingeNewton *)NewtonJointGetUserData(pHinge);
+	cNewtonCallbackLock lock(pHingeJoint->mpNewtonWorld);
 
 	// pHingeJoint->OnPhysicsUpdate();
 
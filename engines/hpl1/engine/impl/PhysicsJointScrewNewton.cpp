@@ -120,6 +120,7 @@ float cPhysicsJointScrewNewton::GetAngle() {
 
 unsigned cPhysicsJointScrewNewton::LimitCallback(const NewtonJoint *pScrew, NewtonHingeSliderUpdateDesc *pDesc) {
 	cPhysicsJointScrewNewton *pScrewJoint = (cPhysicsJointScrewNewton *)NewtonJointGetUserData(pScrew);
+	cNewtonCallbackLock lock(pScrewJoint->mpNewtonWorld);
 
 	// pScrewJoint->OnPhysicsUpdate();
 
@@ -126,6 +126,7 @@ float cPhysicsJointSliderNewton::GetAngle() {
 
 unsigned cPhysicsJointSliderNewton::LimitCallback(const NewtonJoint *pSlider, NewtonHingeSliderUpdateDesc *pDesc) {
 	cPhysicsJointSliderNewton *pSliderJoint = (cPhysicsJointSliderNewton *)NewtonJointGetUserData(pSlider);
+	cNewtonCallbackLock lock(pSliderJoint->mpNewtonWorld);
 
 	// pSliderJoint->OnPhysicsUpdate();
 
@@ -208,6 +208,7 @@ float cPhysicsMaterialNewton::Combine(ePhysicsMaterialCombMode aMode, float afX,
 //-----------------------------------------------------------------------
 int cPhysicsMaterialNewton::BeginContactCallback(const NewtonMaterial *material,
 												 const NewtonBody *body0, const NewtonBody *body1, int32) {
+	cNewtonCallbackLock lock(NewtonBodyGetWorld(body0));
 	iPhysicsBody *contactBody0 = (cPhysicsBodyNewton *)NewtonBodyGetUserData(body0);
 	iPhysicsBody *contactBody1 = (cPhysicsBodyNewton *)NewtonBodyGetUserData(body1);
 
@@ -348,6 +349,7 @@ void ContactProcessor::endProcessing() {
 }
 
 void cPhysicsMaterialNewton::ProcessContactCallback(const NewtonJoint *joint, float, int32) {
+	cNewtonCallbackLock lock(NewtonBodyGetWorld(NewtonJointGetBody0(joint)));
 	ContactProcessor processor(joint);
 
 	while (processor.processNext()) {
@@ -50,6 +50,8 @@
 #include "hpl1/engine/math/Math.h"
 #include "hpl1/engine/system/low_level_system.h"
 
+#include "common/threadpool.h"
+
 namespace hpl {
 
 //////////////////////////////////////////////////////////////////////////
@@ -66,6 +68,11 @@ cPhysicsWorldNewton::cPhysicsWorldNewton()
 		Warning("Couldn't create newton world!\n");
 	}
 
+	// Step the simulation on the thread pool. Deterministic threading keeps
+	// the results independent of the number of threads.
+	NewtonSetDeterministicThreading(mpNewtonWorld, 1);
+	NewtonSetThreadsCount(mpNewtonWorld, Common::ThreadPool::instance().getConcurrency());
+
 	/////////////////////////////////
 	// Set default values to properties
 	mvWorldSizeMin = cVector3f(0, 0, 0);
@@ -33,6 +33,25 @@
 #include "hpl1/engine/libraries/newton/Newton.h"
 
 namespace hpl {
+
+/**
+ * Serializes a Newton callback against the other physics threads. The
+ * callbacks that reach game code (collisions, transforms, joint limits)
+ * are not thread safe and have to hold this while they run.
+ */
+class cNewtonCallbackLock {
+public:
+	cNewtonCallbackLock(const NewtonWorld *apWorld) : mpWorld(const_cast<NewtonWorld *>(apWorld)) {
+		NewtonWorldCriticalSectionLock(mpWorld);
+	}
+	~cNewtonCallbackLock() {
+		NewtonWorldCriticalSectionUnlock(mpWorld);
+	}
+
+private:
+	NewtonWorld *mpWorld;
+};
+
 class cPhysicsWorldNewton : public iPhysicsWorld {
 public:
 	cPhysicsWorldNewton();
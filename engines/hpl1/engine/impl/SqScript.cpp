@@ -26,8 +26,12 @@
  */
 
 #include "hpl1/engine/impl/SqScript.h"
+#include "base/version.h"
+#include "common/crc.h"
 #include "common/file.h"
+#include "common/savefile.h"
 #include "hpl1/debug.h"
+#include "hpl1/hpl1.h"
 #include "hpl1/engine/libraries/angelscript/add-ons/scripthelper.h"
 #include "hpl1/engine/libraries/angelscript/angelscript.h"
 #include "hpl1/engine/math/Math.h"
@@ -36,6 +40,67 @@
 
 namespace hpl {
 
+enum {
+	kByteCodeCacheTag = MKTAG('H', 'P', 'S', 'C'),
+	kByteCodeCacheVersion = 2
+};
+
+class ByteCodeReader : public asIBinaryStream {
+public:
+	ByteCodeReader(Common::ReadStream &stream) : _stream(stream) {}
+
+	int Read(void *ptr, asUINT size) override {
+		return _stream.read(ptr, size) == size ? 0 : -1;
+	}
+	int Write(const void *ptr, asUINT size) override {
+		return -1;
+	}
+
+private:
+	Common::ReadStream &_stream;
+};
+
+class ByteCodeWriter : public asIBinaryStream {
+public:
+	ByteCodeWriter(Common::WriteStream &stream) : _stream(stream) {}
+
+	int Read(void *ptr, asUINT size) override {
+		return -1;
+	}
+	int Write(const void *ptr, asUINT size) override {
+		return _stream.write(ptr, size) == size ? 0 : -1;
+	}
+
+private:
+	Common::WriteStream &_stream;
+};
+
+/**
+ * The byte code refers to the functions and types registered by the engine,
+ * so it has to be rebuilt for every other build of ScummVM.
+ */
+static uint32 getByteCodeEngineKey() {
+	const Common::String key = Common::String(gScummVMFullVersion) + " " + ANGELSCRIPT_VERSION_STRING;
+	return Common::CRC32().crcFast((const byte *)key.c_str(), key.size());
+}
+
+/**
+ * Scripts in different directories may share a name, so entries are keyed on
+ * the whole path. Files are looked up regardless of case.
+ */
+static Common::String getByteCodeCacheKey(const tString &asFileName) {
+	Common::String key = Common::Path(asFileName).normalize().toString('/');
+	key.toLowercase();
+	return key;
+}
+
+static Common::String getByteCodeCacheName(const tString &asFileName) {
+	const Common::String key = getByteCodeCacheKey(asFileName);
+	return Common::String::format("%s-%s-%08x.cache", Hpl1::g_engine->getGameId().c_str(),
+								  Common::Path(asFileName).baseName().c_str(),
+								  Common::CRC32().crcFast((const byte *)key.c_str(), key.size()));
+}
+
 //////////////////////////////////////////////////////////////////////////
 // CONSTRUCTORS
 //////////////////////////////////////////////////////////////////////////
@@ -75,6 +140,12 @@ bool cSqScript::CreateFromFile(const tString &asFileName) {
 		return false;
 	}
 
+	const uint32 checksum = Common::CRC32().crcFast((const byte *)pCharBuffer, lLength);
+	if (LoadByteCode(asFileName, checksum)) {
+		hplDeleteArray(pCharBuffer);
+		return true;
+	}
+
 	_module = mpScriptEngine->GetModule(msModuleName.c_str(), asGM_ALWAYS_CREATE);
 	if (_module->AddScriptSection(msModuleName.c_str(), pCharBuffer, lLength) < 0) {
 		Error("Couldn't add script '%s'!\n", asFileName.c_str());
@@ -88,6 +159,8 @@ bool cSqScript::CreateFromFile(const tString &asFileName) {
 		return false;
 	}
 
+	SaveByteCode(asFileName, checksum);
+
 	hplDeleteArray(pCharBuffer);
 	return true;
 }
@@ -124,6 +197,55 @@ bool cSqScript::Run(int alHandle) {
 
 //-----------------------------------------------------------------------
 
+bool cSqScript::LoadByteCode(const tString &asFileName, uint32 alChecksum) {
+	const Common::String cacheName = getByteCodeCacheName(asFileName);
+	Common::ScopedPtr<Common::InSaveFile> cacheFile(Hpl1::g_engine->getSaveFileManager()->openForLoading(cacheName));
+	if (!cacheFile)
+		return false;
+
+	if (cacheFile->readUint32BE() != kByteCodeCacheTag || cacheFile->readUint32LE() != kByteCodeCacheVersion ||
+		cacheFile->readUint32LE() != getByteCodeEngineKey() || cacheFile->readUint32LE() != alChecksum ||
+		cacheFile->readString(0, cacheFile->readUint16LE()) != getByteCodeCacheKey(asFileName)) {
+		Hpl1::logInfo(Hpl1::kDebugScripts, "byte code cache %s is outdated\n", cacheName.c_str());
+		return false;
+	}
+
+	_module = mpScriptEngine->GetModule(msModuleName.c_str(), asGM_ALWAYS_CREATE);
+	ByteCodeReader reader(*cacheFile);
+	if (_module->LoadByteCode(&reader) < 0) {
+		Hpl1::logWarning(Hpl1::kDebugScripts, "couldn't load byte code cache %s\n", cacheName.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------
+
+void cSqScript::SaveByteCode(const tString &asFileName, uint32 alChecksum) {
+	const Common::String cacheName = getByteCodeCacheName(asFileName);
+	Common::ScopedPtr<Common::OutSaveFile> cacheFile(Hpl1::g_engine->getSaveFileManager()->openForSaving(cacheName, false));
+	if (!cacheFile)
+		return;
+
+	cacheFile->writeUint32BE(kByteCodeCacheTag);
+	cacheFile->writeUint32LE(kByteCodeCacheVersion);
+	cacheFile->writeUint32LE(getByteCodeEngineKey());
+	cacheFile->writeUint32LE(alChecksum);
+	const Common::String key = getByteCodeCacheKey(asFileName);
+	cacheFile->writeUint16LE(key.size());
+	cacheFile->writeString(key);
+
+	ByteCodeWriter writer(*cacheFile);
+	if (_module->SaveByteCode(&writer) < 0)
+		Hpl1::logWarning(Hpl1::kDebugScripts, "couldn't save byte code of script %s\n", asFileName.c_str());
+	cacheFile->finalize();
+	if (cacheFile->err())
+		Hpl1::logWarning(Hpl1::kDebugScripts, "couldn't write byte code cache %s\n", cacheName.c_str());
+}
+
+//-----------------------------------------------------------------------
+
 char *cSqScript::LoadCharBuffer(const tString &asFileName, int &alLength) {
 	Common::File file;
 	file.open(Common::Path(asFileName));
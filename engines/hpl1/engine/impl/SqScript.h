@@ -56,6 +56,14 @@ private:
 	tString msModuleName;
 
 	char *LoadCharBuffer(const tString &asFileName, int &alLength);
+
+	/**
+	 * Compiling the scripts takes a good part of the level load time, so
+	 * the byte code of every script is kept in a cache file in the save
+	 * path, next to the checksum of the source it was compiled from.
+	 */
+	bool LoadByteCode(const tString &asFileName, uint32 alChecksum);
+	void SaveByteCode(const tString &asFileName, uint32 alChecksum);
 };
 
 } // namespace hpl
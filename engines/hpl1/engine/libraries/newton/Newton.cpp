@@ -361,12 +361,11 @@ void NewtonWorldCriticalSectionUnlock(NewtonWorld *const newtonWorld) {
 //
 // Return: Nothing
 //
-// Remarks: The maximum number of threaded is set on initialization to the maximum number of CPU in the system.
-//
-// Remarks: The engine will only allow a maximum number of thread equal are lower to the maximum number of cores visible in the system.
-// if *threads* is set to a value larger that then number of logical CPUs in the system, the *threads* will be clamped to the number of logical CPUs.
+// Remarks: The jobs of the engine are run on the ScummVM thread pool. *NewtonGetMaxThreadsCount* returns the number of
+// jobs the pool can run at the same time, using more threads than that is allowed but will not make the update faster.
 //
-// Remarks: the function is only only have effect on the multi core version of the engine.
+// Remarks: callbacks are called from several threads at the same time when more than one thread is used,
+// see *NewtonWorldCriticalSectionLock* and *NewtonSetDeterministicThreading*.
 //
 // See also: NewtonGetThreadNumber, NewtonGetThreadsCount
 void NewtonSetThreadsCount(NewtonWorld *const newtonWorld, int threads) {
@@ -477,6 +476,34 @@ int NewtonGetMultiThreadSolverOnSingleIsland(
 	return world->GetThreadOnSingleIsland();
 }
 
+// Name: NewtonSetDeterministicThreading
+// Make the simulation results independent of the number of threads and of the order the threads run in. Mode is disabled by default.
+//
+// Parameters:
+// *const NewtonWorld* *newtonWorld - is the pointer to the Newton world
+// *int* mode - 1 enable deterministic mode, 0 disable deterministic mode, default
+//
+// Return: Nothing
+//
+// Remarks: In deterministic mode the colliding pairs are sorted before the contacts are calculated, the contact joints are
+// created and the material callbacks are called on a single thread, and large islands are not solved in parallel.
+// Force and torque callbacks, collision and the solving of separate islands still run in parallel.
+//
+// See also: NewtonSetThreadsCount, NewtonSetMultiThreadSolverOnSingleIsland
+void NewtonSetDeterministicThreading(NewtonWorld *const newtonWorld, int mode) {
+	TRACE_FUNTION(__FUNCTION__);
+
+	Newton *const world = (Newton *)newtonWorld;
+	world->SetDeterministicThreading(mode);
+}
+
+int NewtonGetDeterministicThreading(const NewtonWorld *const newtonWorld) {
+	TRACE_FUNTION(__FUNCTION__);
+
+	const Newton *const world = (const Newton *)newtonWorld;
+	return world->GetDeterministicThreading();
+}
+
 // Name: NewtonSetSolverModel
 // Set the solver precision mode.
 //
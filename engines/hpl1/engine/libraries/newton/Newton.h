@@ -350,6 +350,8 @@ NEWTON_API void NewtonSetPlatformArchitecture(NewtonWorld *const newtonWorld, in
 NEWTON_API int NewtonGetPlatformArchitecture(const NewtonWorld *const newtonWorld, char *description);
 NEWTON_API void NewtonSetMultiThreadSolverOnSingleIsland(NewtonWorld *const newtonWorld, int mode);
 NEWTON_API int NewtonGetMultiThreadSolverOnSingleIsland(const NewtonWorld *const newtonWorld);
+NEWTON_API void NewtonSetDeterministicThreading(NewtonWorld *const newtonWorld, int mode);
+NEWTON_API int NewtonGetDeterministicThreading(const NewtonWorld *const newtonWorld);
 
 NEWTON_API void NewtonSetPerformanceClock(NewtonWorld *const newtonWorld, NewtonGetTicksCountCallback callback);
 NEWTON_API unsigned NewtonReadPerformanceTicks(const NewtonWorld *const newtonWorld, unsigned performanceEntry);
@@ -24,11 +24,35 @@
 #include "dgDebug.h"
 #include "dgMemory.h"
 
+#include "common/mutex.h"
+
+// Locks an allocator while it is shared by several threads
+class dgAllocatorLock {
+public:
+	dgAllocatorLock(Common::Mutex *const mutex) : m_mutex(mutex) {
+		if (m_mutex) {
+			m_mutex->lock();
+		}
+	}
+
+	~dgAllocatorLock() {
+		if (m_mutex) {
+			m_mutex->unlock();
+		}
+	}
+
+private:
+	Common::Mutex *const m_mutex;
+};
+
 class dgGlobalAllocator: public dgMemoryAllocator, public dgList<dgMemoryAllocator *> {
 public:
 	dgGlobalAllocator()
 		: dgMemoryAllocator(__malloc__, __free__), dgList<dgMemoryAllocator*> (NULL) {
 		SetAllocator(this);
+
+		// Temporary buffers are allocated by the jobs of all worlds
+		SetThreadSafe(true);
 	}
 
 	~dgGlobalAllocator() {
@@ -75,6 +99,7 @@ void dgDestroyMemoryGlobals() {
 dgMemoryAllocator::dgMemoryAllocator() {
 	m_memoryUsed = 0;
 	m_emumerator = 0;
+	m_lock = NULL;
 	SetAllocatorsCallback(dgGlobalAllocator::m_globalAllocator->m_malloc, dgGlobalAllocator::m_globalAllocator->m_free);
 	memset(m_memoryDirectory, 0, sizeof(m_memoryDirectory));
 	dgGlobalAllocator::m_globalAllocator->Append(this);
@@ -83,6 +108,7 @@ dgMemoryAllocator::dgMemoryAllocator() {
 dgMemoryAllocator::dgMemoryAllocator(dgMemAlloc memAlloc, dgMemFree memFree) {
 	m_memoryUsed = 0;
 	m_emumerator = 0;
+	m_lock = NULL;
 	SetAllocatorsCallback(memAlloc, memFree);
 	memset(m_memoryDirectory, 0, sizeof(m_memoryDirectory));
 }
@@ -90,6 +116,7 @@ dgMemoryAllocator::dgMemoryAllocator(dgMemAlloc memAlloc, dgMemFree memFree) {
 dgMemoryAllocator::~dgMemoryAllocator() {
 	dgGlobalAllocator::m_globalAllocator->Remove(this);
 	NEWTON_ASSERT(m_memoryUsed == 0);
+	delete m_lock;
 }
 
 void *dgMemoryAllocator::operator new (size_t size) {
@@ -104,6 +131,15 @@ dgInt32 dgMemoryAllocator::GetMemoryUsed() const {
 	return m_memoryUsed;
 }
 
+void dgMemoryAllocator::SetThreadSafe(bool threadSafe) {
+	if (threadSafe && !m_lock) {
+		m_lock = new Common::Mutex();
+	} else if (!threadSafe && m_lock) {
+		delete m_lock;
+		m_lock = NULL;
+	}
+}
+
 void dgMemoryAllocator::SetAllocatorsCallback(dgMemAlloc memAlloc, dgMemFree memFree) {
 	m_free = memFree;
 	m_malloc = memAlloc;
@@ -112,6 +148,7 @@ void dgMemoryAllocator::SetAllocatorsCallback(dgMemAlloc memAlloc, dgMemFree mem
 void *dgMemoryAllocator::MallocLow(dgInt32 workingSize, dgInt32 alignment) {
 	NEWTON_ASSERT(alignment >= memoryGranularity);
 	NEWTON_ASSERT(((-alignment) & (alignment - 1)) == 0);
+	dgAllocatorLock lock(m_lock);
 	dgInt32 size = workingSize + alignment * 2;
 	void *const ptr = m_malloc(dgUnsigned32(size));
 	dgUnsigned64 val = dgUnsigned64(PointerToInt(ptr));
@@ -130,6 +167,7 @@ void dgMemoryAllocator::FreeLow(void *const retPtr) {
 	info = ((dgMemoryInfo *)(retPtr)) - 1;
 	NEWTON_ASSERT(info->m_allocator == this);
 
+	dgAllocatorLock lock(m_lock);
 	dgAtomicAdd(&m_memoryUsed, -info->m_size);
 
 #ifdef _DEBUG
@@ -144,6 +182,7 @@ void dgMemoryAllocator::FreeLow(void *const retPtr) {
 void *dgMemoryAllocator::Malloc(dgInt32 memsize) {
 	NEWTON_ASSERT(dgInt32(sizeof(dgMemoryCacheEntry) + sizeof(dgInt32) + sizeof(dgInt32)) <= memoryGranularity);
 
+	dgAllocatorLock lock(m_lock);
 	dgInt32 size = memsize + memoryGranularity - 1;
 	size &= -memoryGranularity;
 
@@ -217,6 +256,7 @@ void dgMemoryAllocator::Free(void *const retPtr) {
 	dgMemoryInfo *const info = ((dgMemoryInfo *)(retPtr)) - 1;
 	NEWTON_ASSERT(info->m_allocator == this);
 
+	dgAllocatorLock lock(m_lock);
 	dgInt32 entry = info->m_size;
 
 	if (entry >= memoryBinEntries) {
@@ -30,6 +30,10 @@
 
 class dgMemoryAllocator;
 
+namespace Common {
+class Mutex;
+}
+
 void dgInitMemoryGlobals();
 
 void dgDestroyMemoryGlobals();
@@ -172,6 +176,8 @@ public:
 	void *Malloc(dgInt32 memsize);
 	void Free(void *const retPtr);
 
+	// Serialize all allocations, for worlds which run jobs on several threads
+	void SetThreadSafe(bool threadSafe);
 
 protected:
 	dgMemoryAllocator(dgMemAlloc memAlloc, dgMemFree memFree);
@@ -181,6 +187,7 @@ protected:
 	dgMemFree m_free;
 	dgMemAlloc m_malloc;
 	dgMemDirectory m_memoryDirectory[memoryBinEntries + 1];
+	Common::Mutex *m_lock;
 
 #ifdef __TRACK_MEMORY_LEAKS__
 	dgMemoryLeaksTracker m_leaklTracker;
@@ -23,32 +23,30 @@
 #include "dgTypes.h"
 #include "dgThreads.h"
 
-inline void dgSpinUnlock(dgInt32 *spin) {
-	*spin = 0;
-}
+#include "common/mutex.h"
+#include "common/threadpool.h"
 
 dgThreads::dgThreads() {
-	m_numberOfCPUCores = 0;
-
 	m_numOfThreads = 0;
-	m_exit = false;
-
-	m_topIndex = 0;
-	m_bottomIndex = 0;
-	m_workInProgress = 0;
-	m_globalSpinLock = 0;
-	m_workToDoSpinLock = 0;
+	m_jobs = NULL;
+	m_globalLock = NULL;
+	m_indirectLock = NULL;
 
 	m_getPerformanceCount = NULL;
 	for (dgInt32 i = 0; i < DG_MAXIMUN_THREADS; i++) {
 		m_localData[i].m_ticks = 0;
 		m_localData[i].m_threadIndex = i;
+		m_localData[i].m_job = NULL;
 		m_localData[i].m_manager = this;
 	}
 }
 
 dgThreads::~dgThreads() {
+	DestroydgThreads();
+}
 
+dgInt32 dgThreads::GetMaxThreadCount() {
+	return GetMin(dgInt32(Common::ThreadPool::instance().getConcurrency()), dgInt32(DG_MAXIMUN_THREADS));
 }
 
 dgInt32 dgThreads::GetThreadCount() const {
@@ -56,7 +54,9 @@ dgInt32 dgThreads::GetThreadCount() const {
 }
 
 void dgThreads::ClearTimers() {
-
+	for (dgInt32 i = 0; i < DG_MAXIMUN_THREADS; i++) {
+		m_localData[i].m_ticks = 0;
+	}
 }
 
 void dgThreads::SetPerfomanceCounter(OnGetPerformanceCountCallback callback) {
@@ -65,7 +65,7 @@ void dgThreads::SetPerfomanceCounter(OnGetPerformanceCountCallback callback) {
 
 dgUnsigned32 dgThreads::GetPerfomanceTicks(dgUnsigned32 threadIndex) const {
 
-	if (dgInt32(threadIndex) <= m_numOfThreads) {
+	if (dgInt32(threadIndex) < GetThreadCount()) {
 		return dgUnsigned32(m_localData[threadIndex].m_ticks);
 	} else {
 		return 0;
@@ -73,40 +73,65 @@ dgUnsigned32 dgThreads::GetPerfomanceTicks(dgUnsigned32 threadIndex) const {
 }
 
 void dgThreads::CreateThreaded(dgInt32 threads) {
-
+	DestroydgThreads();
+
+	// Jobs beyond the concurrency of the pool simply wait for a free thread
+	threads = GetMin(threads, dgInt32(DG_MAXIMUN_THREADS));
+	if (threads > 1) {
+		m_numOfThreads = threads;
+		m_jobs = new Common::JobGroup();
+		m_globalLock = new Common::Mutex();
+		m_indirectLock = new Common::Mutex();
+	}
 }
 
 void dgThreads::DestroydgThreads() {
+	if (m_jobs) {
+		SynchronizationBarrier();
+	}
 
+	delete m_jobs;
+	delete m_globalLock;
+	delete m_indirectLock;
+	m_jobs = NULL;
+	m_globalLock = NULL;
+	m_indirectLock = NULL;
+	m_numOfThreads = 0;
 }
 
 //Queues up another to work
 dgInt32 dgThreads::SubmitJob(dgWorkerThread *const job) {
 	NEWTON_ASSERT(job->m_threadIndex != -1);
-	job->ThreadExecute();
-	return 1;
-}
 
-void *dgThreads::ThreadExecute(void *param) {
-	dgLocadData &data = *(dgLocadData *) param;
-	data.m_manager->DoWork(data.m_threadIndex);
-	return 0;
-}
+	dgLocadData &data = m_localData[job->m_threadIndex];
+	if (!m_jobs) {
+		data.m_job = job;
+		ThreadExecute(&data);
+		return 1;
+	}
 
-dgInt32 dgThreads::GetWork(dgWorkerThread **job) {
-	dgWorkerThread *cWorker = m_queue[m_bottomIndex];
-	*job = cWorker;
+	NEWTON_ASSERT(!data.m_job);
+	data.m_job = job;
+	m_jobs->add(ThreadExecute, &data);
 	return 1;
 }
 
-void dgThreads::DoWork(dgInt32 mythreadIndex) {
-//	dgWorkerThread *job;
+void dgThreads::ThreadExecute(void *param) {
+	dgLocadData &data = *(dgLocadData *) param;
+	OnGetPerformanceCountCallback getPerformanceCount = data.m_manager->m_getPerformanceCount;
 
-//	job->ThreadExecute();
+	dgUnsigned32 ticks = getPerformanceCount ? getPerformanceCount() : 0;
+	data.m_job->ThreadExecute();
+	data.m_job = NULL;
+	if (getPerformanceCount) {
+		data.m_ticks += dgInt32(getPerformanceCount() - ticks);
+	}
 }
 
 void dgThreads::SynchronizationBarrier() {
-
+	if (m_jobs) {
+		m_jobs->wait();
+	}
 }
 
 void dgThreads::CalculateChunkSizes(dgInt32 elements,
@@ -127,24 +152,28 @@ void dgThreads::CalculateChunkSizes(dgInt32 elements,
 }
 
 void dgThreads::dgGetLock() const {
-	NEWTON_ASSERT(sizeof(dgInt32) == sizeof(long));
-
-	//spinLock( &m_globalSpinLock );
-// linux and mac may need to yeald time
-//	while(! __sync_bool_compare_and_swap(&m_globalSpinLock, 0, 1) ) {
-//		ThreadYield();
-//	}
+	if (m_globalLock) {
+		m_globalLock->lock();
+	}
 }
 
 void dgThreads::dgReleaseLock() const {
-	dgSpinUnlock(&m_globalSpinLock);
+	if (m_globalLock) {
+		m_globalLock->unlock();
+	}
 }
 
+// The parallel solver holds the locks of both bodies of a joint at the same
+// time, in no particular order. A single mutex for all lock variables keeps
+// that from deadlocking.
 void dgThreads::dgGetIndirectLock(dgInt32 *lockVar) {
-	NEWTON_ASSERT(sizeof(dgInt32) == sizeof(long));
+	if (m_indirectLock) {
+		m_indirectLock->lock();
+	}
 }
 
 void dgThreads::dgReleaseIndirectLock(dgInt32 *lockVar) {
-	NEWTON_ASSERT(sizeof(dgInt32) == sizeof(long));
-	dgSpinUnlock(lockVar);
+	if (m_indirectLock) {
+		m_indirectLock->unlock();
+	}
 }
@@ -22,8 +22,10 @@
 #if !defined(AFX_DG_THREADS_42YH_HY78GT_YHJ63Y__INCLUDED_)
 #define AFX_DG_THREADS_42YH_HY78GT_YHJ63Y__INCLUDED_
 
-#define DG_MAXQUEUE     16
-
+namespace Common {
+class JobGroup;
+class Mutex;
+}
 
 class dgWorkerThread {
 public:
@@ -37,6 +39,9 @@ public:
 };
 
 
+// Runs the jobs of the world on the worker threads of Common::ThreadPool.
+// The jobs submitted between two barriers are one batch, with at most one
+// job per thread index.
 class dgThreads {
 public:
 	dgThreads();
@@ -49,6 +54,7 @@ public:
 	void SetPerfomanceCounter(OnGetPerformanceCountCallback callback);
 	dgUnsigned32 GetPerfomanceTicks(dgUnsigned32 threadIndex) const;
 
+	static dgInt32 GetMaxThreadCount();
 	dgInt32 GetThreadCount() const ;
 	dgInt32 SubmitJob(dgWorkerThread *const job);
 	void SynchronizationBarrier();
@@ -64,29 +70,16 @@ private:
 	struct dgLocadData {
 		dgInt32 m_ticks;
 		dgInt32 m_threadIndex;
+		dgWorkerThread *m_job;
 		dgThreads *m_manager;
 	};
 
-	void DoWork(dgInt32 threadIndex);
-	dgInt32 GetWork(dgWorkerThread **cWork);
-
-
-	static void *ThreadExecute(void *Param);
+	static void ThreadExecute(void *param);
 
 	dgInt32 m_numOfThreads;
-	dgInt32 m_numberOfCPUCores;
-	dgInt32 m_topIndex;
-	dgInt32 m_bottomIndex;
-	dgInt32 m_workInProgress;
-	mutable dgInt32 m_globalSpinLock;
-
-	bool m_exit;
-	//dgInt32 m_emptySlot;
-	//dgInt32 m_workToDo;
-	//dgInt32 m_criticalSection;
-	dgInt32 m_workToDoSpinLock;
-	dgWorkerThread *m_queue[DG_MAXQUEUE];
-	//pthread_t m_threadhandles[DG_MAXIMUN_THREADS];
+	Common::JobGroup *m_jobs;
+	Common::Mutex *m_globalLock;
+	Common::Mutex *m_indirectLock;
 
 	OnGetPerformanceCountCallback m_getPerformanceCount;
 	dgLocadData m_localData[DG_MAXIMUN_THREADS];
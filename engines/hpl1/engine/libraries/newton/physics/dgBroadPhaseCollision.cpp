@@ -1182,6 +1182,21 @@ void dgBroadPhaseCollision::UpdateBodyBroadphase(dgBody *const body,
  }
  */
 
+static dgInt32 ComparePairs(const dgCollidingPairCollector::dgPair *const pairA,
+                            const dgCollidingPairCollector::dgPair *const pairB, void *const context) {
+	const dgInt32 idA0 = GetMin(pairA->m_body0->GetUniqueID(), pairA->m_body1->GetUniqueID());
+	const dgInt32 idB0 = GetMin(pairB->m_body0->GetUniqueID(), pairB->m_body1->GetUniqueID());
+	if (idA0 != idB0) {
+		return (idA0 < idB0) ? -1 : 1;
+	}
+	const dgInt32 idA1 = GetMax(pairA->m_body0->GetUniqueID(), pairA->m_body1->GetUniqueID());
+	const dgInt32 idB1 = GetMax(pairB->m_body0->GetUniqueID(), pairB->m_body1->GetUniqueID());
+	if (idA1 != idB1) {
+		return (idA1 < idB1) ? -1 : 1;
+	}
+	return 0;
+}
+
 dgUnsigned32 dgBroadPhaseCollision::UpdateContactsBroadPhaseBegin(
     dgFloat32 timestep, bool collisioUpdateOnly, dgUnsigned32 ticksBase) {
 	union {
@@ -1425,6 +1440,12 @@ dgUnsigned32 dgBroadPhaseCollision::UpdateContactsBroadPhaseBegin(
 		}
 	}
 
+	// the worker threads find the pairs in any order, sort them so that the
+	// contacts are created and solved in the same order on every run
+	if (me->m_deterministicThreading && (contactPair.m_count > 1)) {
+		dgSort(contactPair.m_pairs, contactPair.m_count, ComparePairs);
+	}
+
 	ticksBase = me->m_getPerformanceCount();
 	me->m_perfomanceCounters[m_broadPhaceTicks] = ticksBase - ticks;
 	return ticksBase;
@@ -1493,21 +1514,33 @@ void dgBroadPhaseCollision::UpdateContactsSimd(dgFloat32 timestep,
 		me->m_threadsManager.SynchronizationBarrier();
 
 		// material callback and create contact joints
-		for (dgInt32 threadIndex = 0; threadIndex < threadCounts; threadIndex++) {
-			m_materialCallbackWorkerThreads[threadIndex].m_step = threadCounts;
-			m_materialCallbackWorkerThreads[threadIndex].m_useSimd = 0;
-			m_materialCallbackWorkerThreads[threadIndex].m_count =
-			    chunkSizes[threadIndex] * threadCounts;
-			;
-			m_materialCallbackWorkerThreads[threadIndex].m_pairs =
-			    &pairs[threadIndex];
-			m_materialCallbackWorkerThreads[threadIndex].m_threadIndex = threadIndex;
-			m_materialCallbackWorkerThreads[threadIndex].m_timestep = timestep;
-			m_materialCallbackWorkerThreads[threadIndex].m_world = me;
-			me->m_threadsManager.SubmitJob(
-			    &m_materialCallbackWorkerThreads[threadIndex]);
+		if (me->m_deterministicThreading) {
+			// contact joints are added to the world in the order of the pairs
+			m_materialCallbackWorkerThreads[0].m_step = 1;
+			m_materialCallbackWorkerThreads[0].m_useSimd = 0;
+			m_materialCallbackWorkerThreads[0].m_count = count;
+			m_materialCallbackWorkerThreads[0].m_pairs = &pairs[0];
+			m_materialCallbackWorkerThreads[0].m_threadIndex = 0;
+			m_materialCallbackWorkerThreads[0].m_timestep = timestep;
+			m_materialCallbackWorkerThreads[0].m_world = me;
+			m_materialCallbackWorkerThreads[0].ThreadExecute();
+		} else {
+			for (dgInt32 threadIndex = 0; threadIndex < threadCounts; threadIndex++) {
+				m_materialCallbackWorkerThreads[threadIndex].m_step = threadCounts;
+				m_materialCallbackWorkerThreads[threadIndex].m_useSimd = 0;
+				m_materialCallbackWorkerThreads[threadIndex].m_count =
+				    chunkSizes[threadIndex] * threadCounts;
+				;
+				m_materialCallbackWorkerThreads[threadIndex].m_pairs =
+				    &pairs[threadIndex];
+				m_materialCallbackWorkerThreads[threadIndex].m_threadIndex = threadIndex;
+				m_materialCallbackWorkerThreads[threadIndex].m_timestep = timestep;
+				m_materialCallbackWorkerThreads[threadIndex].m_world = me;
+				me->m_threadsManager.SubmitJob(
+				    &m_materialCallbackWorkerThreads[threadIndex]);
+			}
+			me->m_threadsManager.SynchronizationBarrier();
 		}
-		me->m_threadsManager.SynchronizationBarrier();
 
 	} else {
 		m_calculateContactsWorkerThreads[0].m_step = 1;
@@ -1569,21 +1602,33 @@ void dgBroadPhaseCollision::UpdateContacts(dgFloat32 timestep,
 		}
 		me->m_threadsManager.SynchronizationBarrier();
 
-		for (dgInt32 threadIndex = 0; threadIndex < threadCounts; threadIndex++) {
-			m_materialCallbackWorkerThreads[threadIndex].m_step = threadCounts;
-			m_materialCallbackWorkerThreads[threadIndex].m_useSimd = 0;
-			m_materialCallbackWorkerThreads[threadIndex].m_count =
-			    chunkSizes[threadIndex] * threadCounts;
-			;
-			m_materialCallbackWorkerThreads[threadIndex].m_pairs =
-			    &pairs[threadIndex];
-			m_materialCallbackWorkerThreads[threadIndex].m_threadIndex = threadIndex;
-			m_materialCallbackWorkerThreads[threadIndex].m_timestep = timestep;
-			m_materialCallbackWorkerThreads[threadIndex].m_world = me;
-			me->m_threadsManager.SubmitJob(
-			    &m_materialCallbackWorkerThreads[threadIndex]);
+		if (me->m_deterministicThreading) {
+			// contact joints are added to the world in the order of the pairs
+			m_materialCallbackWorkerThreads[0].m_step = 1;
+			m_materialCallbackWorkerThreads[0].m_useSimd = 0;
+			m_materialCallbackWorkerThreads[0].m_count = count;
+			m_materialCallbackWorkerThreads[0].m_pairs = &pairs[0];
+			m_materialCallbackWorkerThreads[0].m_threadIndex = 0;
+			m_materialCallbackWorkerThreads[0].m_timestep = timestep;
+			m_materialCallbackWorkerThreads[0].m_world = me;
+			m_materialCallbackWorkerThreads[0].ThreadExecute();
+		} else {
+			for (dgInt32 threadIndex = 0; threadIndex < threadCounts; threadIndex++) {
+				m_materialCallbackWorkerThreads[threadIndex].m_step = threadCounts;
+				m_materialCallbackWorkerThreads[threadIndex].m_useSimd = 0;
+				m_materialCallbackWorkerThreads[threadIndex].m_count =
+				    chunkSizes[threadIndex] * threadCounts;
+				;
+				m_materialCallbackWorkerThreads[threadIndex].m_pairs =
+				    &pairs[threadIndex];
+				m_materialCallbackWorkerThreads[threadIndex].m_threadIndex = threadIndex;
+				m_materialCallbackWorkerThreads[threadIndex].m_timestep = timestep;
+				m_materialCallbackWorkerThreads[threadIndex].m_world = me;
+				me->m_threadsManager.SubmitJob(
+				    &m_materialCallbackWorkerThreads[threadIndex]);
+			}
+			me->m_threadsManager.SynchronizationBarrier();
 		}
-		me->m_threadsManager.SynchronizationBarrier();
 
 	} else {
 
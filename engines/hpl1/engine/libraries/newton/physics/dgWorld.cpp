@@ -240,6 +240,7 @@ dgWorld::dgWorld(dgMemoryAllocator *allocator) : // dgThreadHive(),
 
 	m_genericLRUMark = 0;
 	m_singleIslandMultithreading = 1;
+	m_deterministicThreading = 0;
 
 	m_solverMode = 0;
 	m_frictionMode = 0;
@@ -288,7 +289,7 @@ dgWorld::dgWorld(dgMemoryAllocator *allocator) : // dgThreadHive(),
 
 	m_cpu = dgNoSimdPresent;
 	m_numberOfTheads = 1;
-	m_maxTheads = 1;
+	m_maxTheads = dgUnsigned32(dgThreads::GetMaxThreadCount());
 
 	dgBroadPhaseCollision::Init();
 	dgCollidingPairCollector::Init();
@@ -372,6 +373,9 @@ void dgWorld::SetThreadsCount(dgInt32 count) {
 
 	m_threadsManager.CreateThreaded(count);
 	m_numberOfTheads = dgUnsigned32(m_threadsManager.GetThreadCount());
+
+	// The jobs allocate contacts and buffers concurrently
+	m_allocator->SetThreadSafe(m_numberOfTheads > 1);
 }
 
 dgInt32 dgWorld::GetThreadsCount() const {
@@ -392,6 +396,14 @@ dgInt32 dgWorld::GetThreadOnSingleIsland() const {
 	return m_singleIslandMultithreading ? 1 : 0;
 }
 
+void dgWorld::SetDeterministicThreading(dgInt32 mode) {
+	m_deterministicThreading = mode ? 1 : 0;
+}
+
+dgInt32 dgWorld::GetDeterministicThreading() const {
+	return m_deterministicThreading ? 1 : 0;
+}
+
 void dgWorld::SetFrictionThreshold(dgFloat32 acceleration) {
 	m_frictiomTheshold = GetMax(dgFloat32(1.0e-2f), acceleration);
 }
@@ -155,6 +155,8 @@ public:
 //	dgInt32 GetThreadNumber() const;
 	void EnableThreadOnSingleIsland(dgInt32 mode);
 	dgInt32 GetThreadOnSingleIsland() const;
+	void SetDeterministicThreading(dgInt32 mode);
+	dgInt32 GetDeterministicThreading() const;
 
 	void FlushCache();
 
@@ -400,6 +402,7 @@ private:
 
 
 	dgInt32 m_singleIslandMultithreading;
+	dgInt32 m_deterministicThreading;
 	dgInt32 m_contactBuffersSizeInBytes[DG_MAXIMUN_THREADS];
 	dgInt32 m_jacobiansMemorySizeInBytes[DG_MAXIMUN_THREADS];
 	dgInt32 m_internalForcesMemorySizeInBytes[DG_MAXIMUN_THREADS];
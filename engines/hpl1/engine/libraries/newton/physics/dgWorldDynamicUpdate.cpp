@@ -178,7 +178,8 @@ void dgWorldDynamicUpdate::UpdateDynamics(dgWorld *const world,
 	if (threadCounts > 1) {
 		dgInt32 chunkSizes[DG_MAXIMUN_THREADS];
 
-		if (m_world->m_singleIslandMultithreading) {
+		// The parallel solver sums up the forces in whichever order the threads run
+		if (m_world->m_singleIslandMultithreading && !m_world->m_deterministicThreading) {
 			const dgJacobianMemory &system = m_solverMemory[0];
 			while (m_islands && (m_islandArray[m_islands - 1].m_jointCount >= DG_PARALLEL_JOINT_COUNT)) {
 				m_islands--;
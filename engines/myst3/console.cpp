@@ -24,6 +24,7 @@
 #include "engines/myst3/archive.h"
 #include "engines/myst3/database.h"
 #include "engines/myst3/effects.h"
+#include "engines/myst3/facecache.h"
 #include "engines/myst3/inventory.h"
 #include "engines/myst3/script.h"
 #include "engines/myst3/state.h"
@@ -43,6 +44,7 @@ Console::Console(Myst3Engine *vm) : GUI::Debugger(), _vm(vm) {
 	registerCmd("fillInventory",			WRAP_METHOD(Console, Cmd_FillInventory));
 	registerCmd("dumpArchive",			WRAP_METHOD(Console, Cmd_DumpArchive));
 	registerCmd("dumpMasks",			WRAP_METHOD(Console, Cmd_DumpMasks));
+	registerCmd("faceCache",			WRAP_METHOD(Console, Cmd_FaceCache));
 }
 
 Console::~Console() {
@@ -454,6 +456,18 @@ bool Console::Cmd_DumpMasks(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_FaceCache(int argc, const char **argv) {
+	const CubeFaceCache *cache = _vm->_faceCache;
+	const CubeFaceCache::Stats &stats = cache->getStats();
+
+	debugPrintf("Prefetched nodes: %d, %d KB of %d KB\n", cache->getNodeCount(),
+	            cache->getResidentSize() / 1024, cache->getBudget() / 1024);
+	debugPrintf("Hits: %d, stalls: %d, misses: %d\n", stats.hits, stats.stalls, stats.misses);
+	debugPrintf("Prefetches: %d, evictions: %d, cancelled: %d\n", stats.prefetches, stats.evictions, stats.cancelled);
+
+	return true;
+}
+
 bool Console::dumpFaceMask(uint16 index, int face, Archive::ResourceType type) {
 	ResourceDescription maskDesc = _vm->getFileDescription("", index, face, type);
 
@@ -0,0 +1,306 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engines/myst3/facecache.h"
+#include "engines/myst3/archive.h"
+#include "engines/myst3/database.h"
+#include "engines/myst3/myst3.h"
+#include "engines/myst3/state.h"
+
+#include "common/algorithm.h"
+#include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/threadpool.h"
+
+#include "graphics/surface.h"
+
+namespace Myst3 {
+
+CubeFaceCache::CubeFaceCache(Myst3Engine *vm) :
+		_vm(vm),
+		// A node with 640x640 RGBA faces
+		_entrySizeEstimate(6 * 640 * 640 * 4) {
+	memset(&_stats, 0, sizeof(_stats));
+
+	// The budget is configured in megabytes
+	_budget = (uint32)MIN<int64>((int64)MAX(ConfMan.getInt("cube_face_cache_size"), 0) * 1024 * 1024, 0x7FFFFFFF);
+}
+
+CubeFaceCache::~CubeFaceCache() {
+	for (uint i = 0; i < _entries.size(); i++) {
+		_mutex.lock();
+		_entries[i]->cancelled = true;
+		_mutex.unlock();
+
+		finishDecoding(_entries[i]);
+		freeEntry(_entries[i]);
+	}
+
+	reapRetired(true);
+}
+
+Common::String CubeFaceCache::getCurrentRoom() const {
+	return _vm->_db->getRoomName(_vm->_state->getLocationRoom(), _vm->_state->getLocationAge());
+}
+
+int CubeFaceCache::findEntry(const Common::String &room, uint16 nodeID) const {
+	for (uint i = 0; i < _entries.size(); i++) {
+		if (_entries[i]->nodeID == nodeID && _entries[i]->room == room)
+			return i;
+	}
+
+	return -1;
+}
+
+CubeFaceCache::Entry *CubeFaceCache::startDecoding(const Common::String &room, uint16 nodeID) {
+	ResourceDescription descs[6];
+	for (uint i = 0; i < 6; i++) {
+		descs[i] = _vm->getFileDescription(room, nodeID, i + 1, Archive::kCubeFace);
+		if (!descs[i].isValid())
+			return nullptr;
+	}
+
+	Entry *entry = new Entry();
+	entry->room = room;
+	entry->nodeID = nodeID;
+	entry->size = 0;
+	entry->pendingFaces = 6;
+	entry->cancelled = false;
+	entry->group = new Common::JobGroup();
+
+	// Reading from the archives is not thread safe, only the decoding is
+	// done by the jobs
+	for (uint i = 0; i < 6; i++) {
+		entry->faces[i] = nullptr;
+		entry->jobs[i].cache = this;
+		entry->jobs[i].entry = entry;
+		entry->jobs[i].face = i;
+		entry->jobs[i].jpegStream = descs[i].getData();
+	}
+
+	for (uint i = 0; i < 6; i++) {
+		entry->group->add(decodeFaceProc, &entry->jobs[i]);
+	}
+
+	return entry;
+}
+
+void CubeFaceCache::decodeFaceProc(void *data) {
+	FaceJob *job = (FaceJob *)data;
+	CubeFaceCache *cache = job->cache;
+
+	cache->_mutex.lock();
+	bool cancelled = job->entry->cancelled;
+	cache->_mutex.unlock();
+
+	if (!cancelled)
+		job->entry->faces[job->face] = Myst3Engine::decodeJpeg(*job->jpegStream);
+
+	delete job->jpegStream;
+	job->jpegStream = nullptr;
+
+	Common::StackLock lock(cache->_mutex);
+	job->entry->pendingFaces--;
+}
+
+bool CubeFaceCache::isDecoded(Entry *entry) {
+	Common::StackLock lock(_mutex);
+	return entry->pendingFaces == 0;
+}
+
+void CubeFaceCache::finishDecoding(Entry *entry) {
+	if (!entry->group)
+		return;
+
+	entry->group->wait();
+	delete entry->group;
+	entry->group = nullptr;
+
+	for (uint i = 0; i < 6; i++) {
+		if (entry->faces[i])
+			entry->size += entry->faces[i]->pitch * entry->faces[i]->h;
+	}
+
+	if (!entry->cancelled)
+		_entrySizeEstimate = entry->size;
+}
+
+void CubeFaceCache::freeEntry(Entry *entry) {
+	assert(!entry->group);
+
+	for (uint i = 0; i < 6; i++) {
+		if (entry->faces[i]) {
+			entry->faces[i]->free();
+			delete entry->faces[i];
+		}
+	}
+
+	delete entry;
+}
+
+void CubeFaceCache::cancelEntry(uint index) {
+	Entry *entry = _entries[index];
+	_entries.remove_at(index);
+
+	if (!entry->group) {
+		freeEntry(entry);
+		return;
+	}
+
+	// The jobs still in the queue return right away. There is no need to
+	// wait for them now.
+	_mutex.lock();
+	entry->cancelled = true;
+	_mutex.unlock();
+
+	_retired.push_back(entry);
+	_stats.cancelled++;
+}
+
+void CubeFaceCache::reapRetired(bool wait) {
+	for (uint i = 0; i < _retired.size(); ) {
+		Entry *entry = _retired[i];
+		if (wait || isDecoded(entry)) {
+			finishDecoding(entry);
+			freeEntry(entry);
+			_retired.remove_at(i);
+		} else {
+			i++;
+		}
+	}
+}
+
+uint32 CubeFaceCache::getResidentSize() const {
+	uint32 size = 0;
+	for (uint i = 0; i < _entries.size(); i++) {
+		size += _entries[i]->group ? _entrySizeEstimate : _entries[i]->size;
+	}
+	return size;
+}
+
+bool CubeFaceCache::makeRoom(const Common::Array<uint16> &keep) {
+	for (uint i = 0; i < _entries.size(); i++) {
+		if (_entries[i]->group && isDecoded(_entries[i]))
+			finishDecoding(_entries[i]);
+	}
+
+	uint i = 0;
+	while (getResidentSize() + _entrySizeEstimate > _budget) {
+		// Evict the least recently requested node that is not wanted anymore
+		while (i < _entries.size() && (_entries[i]->group || Common::find(keep.begin(), keep.end(), _entries[i]->nodeID) != keep.end()))
+			i++;
+
+		if (i == _entries.size())
+			return false;
+
+		freeEntry(_entries[i]);
+		_entries.remove_at(i);
+		_stats.evictions++;
+	}
+
+	return true;
+}
+
+void CubeFaceCache::loadFaces(uint16 nodeID, Graphics::Surface *faces[6]) {
+	reapRetired(false);
+
+	Common::String room = getCurrentRoom();
+
+	Entry *entry;
+	int index = findEntry(room, nodeID);
+	if (index >= 0) {
+		entry = _entries[index];
+		_entries.remove_at(index);
+
+		if (!entry->group || isDecoded(entry))
+			_stats.hits++;
+		else
+			_stats.stalls++;
+	} else {
+		_stats.misses++;
+
+		// The faces of the other prefetched nodes are queued ahead of the
+		// ones of this node. Give up on those not done yet, they are not
+		// what the player went for.
+		for (int i = _entries.size() - 1; i >= 0; i--) {
+			if (_entries[i]->group && !isDecoded(_entries[i]))
+				cancelEntry(i);
+		}
+
+		entry = startDecoding(room, nodeID);
+		if (!entry)
+			error("Face %d does not exist", nodeID);
+	}
+
+	finishDecoding(entry);
+
+	debugC(kDebugNode, "Cube faces of node %s %d: %d hits, %d stalls, %d misses", room.c_str(), nodeID,
+	       _stats.hits, _stats.stalls, _stats.misses);
+
+	for (uint i = 0; i < 6; i++) {
+		faces[i] = entry->faces[i];
+		entry->faces[i] = nullptr;
+	}
+
+	freeEntry(entry);
+}
+
+void CubeFaceCache::prefetch(const Common::Array<uint16> &nodeIDs) {
+	reapRetired(false);
+
+	// Without worker threads, decoding ahead would just block the game
+	if (Common::ThreadPool::instance().getNumWorkers() == 0 || _budget == 0)
+		return;
+
+	Common::String room = getCurrentRoom();
+
+	// Stop decoding the nodes that are no longer reachable. The decoded
+	// ones are kept while there is room, in case the player comes back.
+	for (int i = _entries.size() - 1; i >= 0; i--) {
+		Entry *entry = _entries[i];
+		bool wanted = Common::find(nodeIDs.begin(), nodeIDs.end(), entry->nodeID) != nodeIDs.end();
+		if (entry->room != room || (!wanted && entry->group))
+			cancelEntry(i);
+	}
+
+	for (uint i = 0; i < nodeIDs.size(); i++) {
+		int index = findEntry(room, nodeIDs[i]);
+		if (index >= 0) {
+			// Already there, mark it as recently requested
+			Entry *entry = _entries[index];
+			_entries.remove_at(index);
+			_entries.push_back(entry);
+			continue;
+		}
+
+		if (!makeRoom(nodeIDs))
+			break;
+
+		Entry *entry = startDecoding(room, nodeIDs[i]);
+		if (!entry)
+			continue; // Not a cube node
+
+		_entries.push_back(entry);
+		_stats.prefetches++;
+	}
+}
+
+} // End of namespace Myst3
@@ -0,0 +1,132 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef FACECACHE_H_
+#define FACECACHE_H_
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/str.h"
+
+namespace Common {
+class JobGroup;
+class SeekableReadStream;
+}
+
+namespace Graphics {
+struct Surface;
+}
+
+namespace Myst3 {
+
+class Myst3Engine;
+
+/**
+ * Decodes the six JPEG faces of cube nodes on the worker threads.
+ *
+ * Besides decoding the faces of the node being entered all at once, the
+ * cache can decode the faces of the nodes the player is likely to go to
+ * next in the background, within a memory budget. The archives are only
+ * read from the main thread, the worker threads decode data already in
+ * memory.
+ */
+class CubeFaceCache {
+public:
+	struct Stats {
+		uint32 hits;        // the faces were ready when entering the node
+		uint32 stalls;      // entering the node had to wait for a prefetch
+		uint32 misses;      // the node had not been prefetched
+		uint32 prefetches;  // nodes queued for decoding in the background
+		uint32 evictions;   // prefetched nodes dropped to stay in the budget
+		uint32 cancelled;   // prefetched nodes no longer needed before use
+	};
+
+	CubeFaceCache(Myst3Engine *vm);
+	~CubeFaceCache();
+
+	/**
+	 * Decode the faces of a node of the current room. The caller takes
+	 * ownership of the surfaces.
+	 */
+	void loadFaces(uint16 nodeID, Graphics::Surface *faces[6]);
+
+	/**
+	 * Start decoding the faces of the listed nodes of the current room in
+	 * the background, dropping prefetched nodes that are not listed.
+	 * Nodes that are not cube nodes are ignored. Does nothing if there are
+	 * no worker threads.
+	 */
+	void prefetch(const Common::Array<uint16> &nodeIDs);
+
+	const Stats &getStats() const { return _stats; }
+	uint32 getBudget() const { return _budget; }
+	uint32 getResidentSize() const;
+	uint getNodeCount() const { return _entries.size(); }
+
+private:
+	struct Entry;
+
+	struct FaceJob {
+		CubeFaceCache *cache;
+		Entry *entry;
+		uint face;
+		Common::SeekableReadStream *jpegStream;
+	};
+
+	struct Entry {
+		Common::String room;
+		uint16 nodeID;
+		uint32 size;                   // bytes used by the faces, once decoded
+		Graphics::Surface *faces[6];
+		FaceJob jobs[6];
+		Common::JobGroup *group;       // null once the decoding is finished
+		uint pendingFaces;             // guarded by _mutex
+		bool cancelled;                // guarded by _mutex
+	};
+
+	Myst3Engine *_vm;
+
+	// Prefetched nodes, least recently requested first
+	Common::Array<Entry *> _entries;
+	// Cancelled prefetches waiting for their jobs to be done
+	Common::Array<Entry *> _retired;
+	Common::Mutex _mutex;
+
+	uint32 _budget;
+	uint32 _entrySizeEstimate;
+	Stats _stats;
+
+	Common::String getCurrentRoom() const;
+	int findEntry(const Common::String &room, uint16 nodeID) const;
+	Entry *startDecoding(const Common::String &room, uint16 nodeID);
+	bool isDecoded(Entry *entry);
+	void finishDecoding(Entry *entry);
+	void freeEntry(Entry *entry);
+	void cancelEntry(uint index);
+	void reapRetired(bool wait);
+	bool makeRoom(const Common::Array<uint16> &keep);
+
+	static void decodeFaceProc(void *data);
+};
+
+} // End of namespace Myst3
+
+#endif
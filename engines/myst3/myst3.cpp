@@ -50,6 +50,7 @@
 #include "engines/myst3/sound.h"
 #include "engines/myst3/ambient.h"
 #include "engines/myst3/transition.h"
+#include "engines/myst3/facecache.h"
 
 #include "image/jpeg.h"
 
@@ -66,7 +67,7 @@ Myst3Engine::Myst3Engine(OSystem *syst, const Myst3GameDescription *version) :
 		_db(nullptr), _scriptEngine(nullptr),
 		_state(nullptr), _node(nullptr), _scene(nullptr), _archiveNode(nullptr),
 		_cursor(nullptr), _inventory(nullptr), _gfx(nullptr), _menu(nullptr),
-		_rnd(nullptr), _sound(nullptr), _ambient(nullptr),
+		_rnd(nullptr), _sound(nullptr), _ambient(nullptr), _faceCache(nullptr),
 		_inputSpacePressed(false), _inputEnterPressed(false),
 		_inputEscapePressed(false), _inputTildePressed(false),
 		_inputEscapePressedNotConsumed(false),
@@ -108,6 +109,7 @@ Myst3Engine::Myst3Engine(OSystem *syst, const Myst3GameDescription *version) :
 Myst3Engine::~Myst3Engine() {
 	closeArchives();
 
+	delete _faceCache;
 	delete _menu;
 	delete _inventory;
 	delete _cursor;
@@ -178,6 +180,8 @@ Common::Error Myst3Engine::run() {
 	syncSoundSettings();
 	openArchives();
 
+	_faceCache = new CubeFaceCache(this);
+
 	_cursor = new Cursor(this);
 	_inventory = new Inventory(this);
 
@@ -875,6 +879,31 @@ void Myst3Engine::loadNode(uint16 nodeID, uint32 roomID, uint32 ageID) {
 	// Releeshan to the player when he is trapped between both shields.
 	if (nodeID == 9 && roomID == kRoomNarayan)
 		_state->setVar(39, 0);
+
+	if (_state->getViewType() == kCube)
+		prefetchNeighbourNodes();
+}
+
+void Myst3Engine::prefetchNeighbourNodes() {
+	uint16 nodeID = _state->getLocationNode();
+	NodePtr nodeData = _db->getNodeData(nodeID, _state->getLocationRoom(), _state->getLocationAge());
+	if (!nodeData)
+		return;
+
+	// The nodes the hotspots lead to are the likely next ones
+	Common::Array<uint16> neighbours;
+	for (uint i = 0; i < nodeData->hotspots.size(); i++) {
+		_scriptEngine->listNodeDestinations(nodeData->hotspots[i].script, neighbours);
+	}
+
+	for (uint i = 0; i < neighbours.size(); i++) {
+		if (neighbours[i] == nodeID) {
+			neighbours.remove_at(i);
+			break;
+		}
+	}
+
+	_faceCache->prefetch(neighbours);
 }
 
 void Myst3Engine::unloadNode() {
@@ -1393,13 +1422,18 @@ Graphics::Surface *Myst3Engine::loadTexture(uint16 id) {
 
 Graphics::Surface *Myst3Engine::decodeJpeg(const ResourceDescription *jpegDesc) {
 	Common::SeekableReadStream *jpegStream = jpegDesc->getData();
+	Graphics::Surface *surface = decodeJpeg(*jpegStream);
+	delete jpegStream;
+
+	return surface;
+}
 
+Graphics::Surface *Myst3Engine::decodeJpeg(Common::SeekableReadStream &jpegStream) {
 	Image::JPEGDecoder jpeg;
 	jpeg.setOutputPixelFormat(Texture::getRGBAPixelFormat());
 
-	if (!jpeg.loadStream(*jpegStream))
+	if (!jpeg.loadStream(jpegStream))
 		error("Could not decode Myst III JPEG");
-	delete jpegStream;
 
 	const Graphics::Surface *bitmap = jpeg.getSurface();
 	assert(bitmap->format == Texture::getRGBAPixelFormat());
@@ -1849,6 +1883,7 @@ void Myst3Engine::settingsInitDefaults() {
 	ConfMan.registerDefault("zip_mode", false);
 	ConfMan.registerDefault("subtitles", false);
 	ConfMan.registerDefault("vibrations", true); // Xbox specific
+	ConfMan.registerDefault("cube_face_cache_size", 64); // In megabytes
 }
 
 void Myst3Engine::settingsLoadToVars() {
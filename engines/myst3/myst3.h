@@ -79,6 +79,7 @@ class ScriptedMovie;
 class ShakeEffect;
 class RotationEffect;
 class Transition;
+class CubeFaceCache;
 struct NodeData;
 struct Myst3GameDescription;
 
@@ -102,6 +103,7 @@ public:
 	Database *_db;
 	Sound *_sound;
 	Ambient *_ambient;
+	CubeFaceCache *_faceCache;
 
 	Common::RandomSource *_rnd;
 
@@ -132,6 +134,7 @@ public:
 
 	Graphics::Surface *loadTexture(uint16 id);
 	static Graphics::Surface *decodeJpeg(const ResourceDescription *jpegDesc);
+	static Graphics::Surface *decodeJpeg(Common::SeekableReadStream &jpegStream);
 
 	void goToNode(uint16 nodeID, TransitionType transition);
 	void loadNode(uint16 nodeID, uint32 roomID = 0, uint32 ageID = 0);
@@ -233,6 +236,8 @@ private:
 	 */
 	bool _inventoryManualHide;
 
+	void prefetchNeighbourNodes();
+
 	HotSpot *getHoveredHotspot(NodePtr nodeData, uint16 var = 0);
 	void updateCursor();
 
@@ -19,7 +19,7 @@
  *
  */
 
-#include "engines/myst3/archive.h"
+#include "engines/myst3/facecache.h"
 #include "engines/myst3/nodecube.h"
 #include "engines/myst3/myst3.h"
 
@@ -31,14 +31,13 @@ NodeCube::NodeCube(Myst3Engine *vm, uint16 id) :
 		Node(vm, id) {
 	_is3D = true;
 
-	for (int i = 0; i < 6; i++) {
-		ResourceDescription jpegDesc = _vm->getFileDescription("", id, i + 1, Archive::kCubeFace);
-
-		if (!jpegDesc.isValid())
-			error("Face %d does not exist", id);
+	// The faces are decoded in parallel, or were prefetched
+	Graphics::Surface *bitmaps[6];
+	_vm->_faceCache->loadFaces(id, bitmaps);
 
+	for (int i = 0; i < 6; i++) {
 		_faces[i] = new Face(_vm, true);
-		_faces[i]->setTextureFromJPEG(&jpegDesc);
+		_faces[i]->setTextureFromBitmap(bitmaps[i]);
 	}
 }
 
@@ -32,6 +32,7 @@
 #include "engines/myst3/sound.h"
 #include "engines/myst3/state.h"
 
+#include "common/algorithm.h"
 #include "common/events.h"
 
 namespace Myst3 {
@@ -333,6 +334,36 @@ const Script::Command &Script::findCommandByProc(CommandProc proc) {
 	return findCommand(0);
 }
 
+void Script::listNodeDestinations(const Common::Array<Opcode> &script, Common::Array<uint16> &nodes) {
+	uint32 room = _vm->_state->getLocationRoom();
+	uint32 age = _vm->_state->getLocationAge();
+
+	for (uint i = 0; i < script.size(); i++) {
+		const Opcode &op = script[i];
+		CommandProc proc = findCommand(op.op).proc;
+
+		const int16 *node = nullptr;
+		if (proc == &Script::changeNode && op.args.size() >= 1) {
+			node = &op.args[0];
+		} else if (proc == &Script::changeNodeRoom && op.args.size() >= 2) {
+			if (_vm->_state->valueOrVarValue(op.args[0]) == (int32)room)
+				node = &op.args[1];
+		} else if (proc == &Script::changeNodeRoomAge && op.args.size() >= 3) {
+			if (_vm->_state->valueOrVarValue(op.args[0]) == (int32)age && _vm->_state->valueOrVarValue(op.args[1]) == (int32)room)
+				node = &op.args[2];
+		} else if ((proc == &Script::moviePlayChangeNode || proc == &Script::moviePlayChangeNodeTrans) && op.args.size() >= 1) {
+			node = &op.args[0];
+		}
+
+		if (!node)
+			continue;
+
+		uint16 nodeID = _vm->_state->valueOrVarValue(*node);
+		if (nodeID && Common::find(nodes.begin(), nodes.end(), nodeID) == nodes.end())
+			nodes.push_back(nodeID);
+	}
+}
+
 void Script::shiftCommands(uint16 base, int32 value) {
 	for (uint16 i = 0; i < _commands.size(); i++)
 		if (_commands[i].op >= base)
@@ -42,6 +42,12 @@ public:
 
 	const Common::String describeOpcode(const Opcode &opcode);
 
+	/**
+	 * Append to @p nodes the nodes of the current room a script can go to,
+	 * without duplicates.
+	 */
+	void listNodeDestinations(const Common::Array<Opcode> &script, Common::Array<uint16> &nodes);
+
 private:
 	struct Context {
 		bool endScript;
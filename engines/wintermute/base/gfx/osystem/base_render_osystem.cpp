@@ -33,13 +33,22 @@
 #include "engines/wintermute/math/math_util.h"
 #include "engines/wintermute/base/base_game.h"
 #include "engines/wintermute/base/base_sprite.h"
+#include "engines/wintermute/wintermute.h"
 #include "engines/util.h"
 
+#include "common/algorithm.h"
+#include "common/debug.h"
 #include "common/system.h"
 #include "common/queue.h"
 #include "common/config-manager.h"
 
-#define DIRTY_RECT_LIMIT 800
+// Past this many disjoint dirty rects, they are collapsed into their bounding box.
+#define DIRTY_RECT_LIMIT 64
+// With more dirty rects than this, tickets are looked up through a grid
+// instead of being tested against each dirty rect.
+#define DIRTY_RECT_GRID_THRESHOLD 2
+#define TICKET_GRID_CELL_SIZE 64
+#define NO_TICKET 0xFFFFFFFF
 
 namespace Wintermute {
 
@@ -57,7 +66,9 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
-	_dirtyRect = nullptr;
+	_currentStamp = 0;
+	_gridColumns = _gridRows = 0;
+	_gridValid = false;
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
@@ -75,8 +86,6 @@ BaseRenderOSystem::~BaseRenderOSystem() {
 		delete ticket;
 	}
 
-	delete _dirtyRect;
-
 	_renderSurface->free();
 	delete _renderSurface;
 	_blankSurface->free();
@@ -158,8 +167,7 @@ bool BaseRenderOSystem::forcedFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.resize(0);
 		g_system->updateScreen();
 		_needsFlip = false;
 
@@ -169,6 +177,8 @@ bool BaseRenderOSystem::flip() {
 		for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
 			(*it)->_wantsDraw = false;
 		}
+		rebuildTicketIndex();
+		_frameStats.reset();
 
 		addDirtyRect(_renderRect);
 		return true;
@@ -198,13 +208,21 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects || screenChanged) {
 			g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		//  g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.resize(0);
 		_needsFlip = false;
 	}
 	_lastFrameIter = _renderQueue.end();
 
+	if (!_disableDirtyRects) {
+		rebuildTicketIndex();
+
+		debugC(kWintermuteDebugRender, "Frame: %u tickets, %u matched (%u reordered), %u new, %u dirty rects (%u px), %u blits (%u px)",
+		       _frameStats.tickets, _frameStats.matched, _frameStats.reordered, _frameStats.created,
+		       _frameStats.dirtyRects, _frameStats.dirtyPixels, _frameStats.drawCalls, _frameStats.drawnPixels);
+		_lastFrameStats = _frameStats;
+		_frameStats.reset();
+	}
+
 	g_system->updateScreen();
 
 	return STATUS_OK;
@@ -302,25 +320,15 @@ void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::S
 
 	if (owner) { // Fade-tickets are owner-less
 		RenderTicket compare(owner, nullptr, srcRect, dstRect, transform);
-		RenderQueueIterator it = _lastFrameIter;
-		++it;
-		// Avoid calling end() and operator* every time, when potentially going through
-		// LOTS of tickets.
-		RenderQueueIterator endIterator = _renderQueue.end();
-		RenderTicket *compareTicket = nullptr;
-		for (; it != endIterator; ++it) {
-			compareTicket = *it;
-			if (*(compareTicket) == compare && compareTicket->_isValid) {
-				if (_disableDirtyRects) {
-					drawFromSurface(compareTicket);
-				} else {
-					drawFromQueuedTicket(it);
-				}
-				return;
-			}
+		RenderQueueIterator it = findQueuedTicket(compare);
+		if (it != _renderQueue.end()) {
+			_frameStats.matched++;
+			drawFromQueuedTicket(it);
+			return;
 		}
 	}
 	RenderTicket *ticket = new RenderTicket(owner, surf, srcRect, dstRect, transform);
+	_frameStats.created++;
 	if (!_disableDirtyRects) {
 		drawFromTicket(ticket);
 	} else {
@@ -330,6 +338,56 @@ void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::S
 	}
 }
 
+void BaseRenderOSystem::rebuildTicketIndex() {
+	_ticketIndex.clear();
+	_ticketIndexEntries.resize(0);
+
+	for (RenderQueueIterator it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+		TicketIndexEntry entry;
+		entry.ticket = *it;
+		entry.pos = it;
+		entry.next = NO_TICKET;
+		_ticketIndexEntries.push_back(entry);
+	}
+	_frameStats.tickets = _ticketIndexEntries.size();
+
+	// Link the chains back to front, so that each one is in queue order.
+	for (uint32 i = _ticketIndexEntries.size(); i-- > 0;) {
+		const RenderTicket *ticket = _ticketIndexEntries[i].ticket;
+		if (!ticket->_owner) {
+			continue;
+		}
+		_ticketIndexEntries[i].next = _ticketIndex.getValOrDefault(ticket->getMatchHash(), NO_TICKET);
+		_ticketIndex.setVal(ticket->getMatchHash(), i);
+	}
+}
+
+BaseRenderOSystem::RenderQueueIterator BaseRenderOSystem::findQueuedTicket(const RenderTicket &compare) {
+	Common::FlatHashMap<uint32, uint32>::iterator head = _ticketIndex.find(compare.getMatchHash());
+	if (head == _ticketIndex.end()) {
+		return _renderQueue.end();
+	}
+
+	// Everything that has not been drawn yet this frame is still behind
+	// _lastFrameIter, in the same order as the chain. Tickets that were drawn
+	// or invalidated can't match again until the index is rebuilt, so they are
+	// dropped from the front of the chain. Note that their pos may be stale,
+	// as drawFromQueuedTicket() can move them in the queue.
+	uint32 i = head->_value;
+	while (i != NO_TICKET && (_ticketIndexEntries[i].ticket->_wantsDraw || !_ticketIndexEntries[i].ticket->_isValid)) {
+		i = _ticketIndexEntries[i].next;
+	}
+	head->_value = i;
+
+	for (; i != NO_TICKET; i = _ticketIndexEntries[i].next) {
+		const TicketIndexEntry &entry = _ticketIndexEntries[i];
+		if (!entry.ticket->_wantsDraw && entry.ticket->_isValid && *entry.ticket == compare) {
+			return entry.pos;
+		}
+	}
+	return _renderQueue.end();
+}
+
 void BaseRenderOSystem::invalidateTicket(RenderTicket *renderTicket) {
 	addDirtyRect(renderTicket->_dstRect);
 	renderTicket->_isValid = false;
@@ -372,6 +430,7 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 	++_lastFrameIter;
 	// Not in the same order?
 	if (*_lastFrameIter != renderTicket) {
+		_frameStats.reordered++;
 		--_lastFrameIter;
 		// Remove the ticket from the list
 		assert(*_lastFrameIter != renderTicket);
@@ -382,12 +441,153 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 }
 
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
-	} else {
-		_dirtyRect->extend(rect);
+	Common::Rect dirtyRect(rect);
+	dirtyRect.clip(_renderRect);
+	if (dirtyRect.isEmpty()) {
+		return;
+	}
+
+	// Absorb every dirty rect that overlaps this one, or that tiles exactly
+	// with it. The grown rect may then reach others, so start over each time.
+	uint i = 0;
+	while (i < _dirtyRects.size()) {
+		const Common::Rect &other = _dirtyRects[i];
+		bool merge = other.intersects(dirtyRect);
+		if (!merge) {
+			Common::Rect bounds(dirtyRect);
+			bounds.extend(other);
+			merge = bounds.width() * bounds.height() == dirtyRect.width() * dirtyRect.height() + other.width() * other.height();
+		}
+		if (merge) {
+			dirtyRect.extend(other);
+			_dirtyRects[i] = _dirtyRects.back();
+			_dirtyRects.pop_back();
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	if (_dirtyRects.size() >= DIRTY_RECT_LIMIT) {
+		for (i = 0; i < _dirtyRects.size(); i++) {
+			dirtyRect.extend(_dirtyRects[i]);
+		}
+		_dirtyRects.resize(0);
+	}
+	_dirtyRects.push_back(dirtyRect);
+}
+
+void BaseRenderOSystem::buildTicketGrid() {
+	_gridColumns = (_renderSurface->w + TICKET_GRID_CELL_SIZE - 1) / TICKET_GRID_CELL_SIZE;
+	_gridRows = (_renderSurface->h + TICKET_GRID_CELL_SIZE - 1) / TICKET_GRID_CELL_SIZE;
+	const uint numCells = _gridColumns * _gridRows;
+	const Common::Rect bounds(_renderSurface->w, _renderSurface->h);
+
+	_ticketStamps.resize(0);
+	_ticketStamps.resize(_drawList.size(), 0);
+	_currentStamp = 0;
+
+	// Count the tickets per cell first, then turn the counts into offsets and
+	// place the tickets. Each cell ends up listing its tickets in draw order.
+	_gridCellStart.resize(0);
+	_gridCellStart.resize(numCells + 1, 0);
+	for (uint pass = 0; pass < 2; pass++) {
+		for (uint32 i = 0; i < _drawList.size(); i++) {
+			Common::Rect area(_drawList[i]->_dstRect);
+			area.clip(bounds);
+			if (area.isEmpty()) {
+				continue;
+			}
+			const int x0 = area.left / TICKET_GRID_CELL_SIZE;
+			const int x1 = (area.right - 1) / TICKET_GRID_CELL_SIZE;
+			const int y0 = area.top / TICKET_GRID_CELL_SIZE;
+			const int y1 = (area.bottom - 1) / TICKET_GRID_CELL_SIZE;
+			for (int y = y0; y <= y1; y++) {
+				for (int x = x0; x <= x1; x++) {
+					const uint cell = y * _gridColumns + x;
+					if (pass == 0) {
+						_gridCellStart[cell + 1]++;
+					} else {
+						_gridTickets[_gridCellStart[cell]++] = i;
+					}
+				}
+			}
+		}
+
+		if (pass == 0) {
+			for (uint cell = 1; cell <= numCells; cell++) {
+				_gridCellStart[cell] += _gridCellStart[cell - 1];
+			}
+			_gridTickets.resize(_gridCellStart[numCells]);
+		} else {
+			// Placing the tickets advanced each offset to the start of the next cell.
+			for (uint cell = numCells; cell > 0; cell--) {
+				_gridCellStart[cell] = _gridCellStart[cell - 1];
+			}
+			_gridCellStart[0] = 0;
+		}
 	}
-	_dirtyRect->clip(_renderRect);
+}
+
+void BaseRenderOSystem::collectTickets(const Common::Rect &rect) {
+	_visibleTickets.resize(0);
+
+	if (!_gridValid) {
+		for (uint32 i = 0; i < _drawList.size(); i++) {
+			if (_drawList[i]->_dstRect.intersects(rect)) {
+				_visibleTickets.push_back(i);
+			}
+		}
+		return;
+	}
+
+	Common::Rect area(rect);
+	area.clip(Common::Rect(_renderSurface->w, _renderSurface->h));
+	if (area.isEmpty()) {
+		return;
+	}
+
+	// Tickets spanning several cells are seen once per cell.
+	_currentStamp++;
+	const int x0 = area.left / TICKET_GRID_CELL_SIZE;
+	const int x1 = (area.right - 1) / TICKET_GRID_CELL_SIZE;
+	const int y0 = area.top / TICKET_GRID_CELL_SIZE;
+	const int y1 = (area.bottom - 1) / TICKET_GRID_CELL_SIZE;
+	for (int y = y0; y <= y1; y++) {
+		for (int x = x0; x <= x1; x++) {
+			const uint cell = y * _gridColumns + x;
+			for (uint32 j = _gridCellStart[cell]; j < _gridCellStart[cell + 1]; j++) {
+				const uint32 i = _gridTickets[j];
+				if (_ticketStamps[i] == _currentStamp) {
+					continue;
+				}
+				_ticketStamps[i] = _currentStamp;
+				if (_drawList[i]->_dstRect.intersects(rect)) {
+					_visibleTickets.push_back(i);
+				}
+			}
+		}
+	}
+	Common::sort(_visibleTickets.begin(), _visibleTickets.end());
+}
+
+void BaseRenderOSystem::drawTicketClipped(RenderTicket *ticket, const Common::Rect &dirtyRect) {
+	// dstClip is the area we want redrawn.
+	Common::Rect dstClip(ticket->_dstRect);
+	// reduce it to the dirty rect
+	dstClip.clip(dirtyRect);
+	// we need to keep track of the position to redraw the dirty rect
+	Common::Rect pos(dstClip);
+	int16 offsetX = ticket->_dstRect.left;
+	int16 offsetY = ticket->_dstRect.top;
+	// convert from screen-coords to surface-coords.
+	dstClip.translate(-offsetX, -offsetY);
+
+	drawFromSurface(ticket, &pos, &dstClip);
+	_needsFlip = true;
+
+	_frameStats.drawCalls++;
+	_frameStats.drawnPixels += pos.width() * pos.height();
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -406,7 +606,7 @@ void BaseRenderOSystem::drawTickets() {
 			++it;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
+	if (_dirtyRects.empty()) {
 		it = _renderQueue.begin();
 		while (it != _renderQueue.end()) {
 			RenderTicket *ticket = *it;
@@ -416,43 +616,49 @@ void BaseRenderOSystem::drawTickets() {
 		return;
 	}
 
-	it = _renderQueue.begin();
 	_lastFrameIter = _renderQueue.end();
+	_drawList.resize(0);
+	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+		_drawList.push_back(*it);
+	}
+
 	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
 	// the background color. Typical use-case: Fullscreen FMVs.
 	// Caveat: The FPS-counter will invalidate this.
-	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
+	const RenderTicket *opaqueTicket = nullptr;
+	if (_drawList.size() == 1 && _drawList[0]->_transform._alphaDisable == true) {
+		opaqueTicket = _drawList[0];
+	}
+
+	_gridValid = _dirtyRects.size() > DIRTY_RECT_GRID_THRESHOLD;
+	if (_gridValid) {
+		buildTicketGrid();
+	}
+
+	// The dirty rects are disjoint, so each one can be repainted on its own.
+	for (uint i = 0; i < _dirtyRects.size(); i++) {
+		const Common::Rect &dirtyRect = _dirtyRects[i];
 		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
+		if (!opaqueTicket || dirtyRect != opaqueTicket->_dstRect) {
 			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
+			_renderSurface->fillRect(dirtyRect, _clearColor);
 		}
-		// Otherwise Do NOT fill.
-	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
-	}
-	for (; it != _renderQueue.end(); ++it) {
-		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
-			// dstClip is the area we want redrawn.
-			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
-			Common::Rect pos(dstClip);
-			int16 offsetX = ticket->_dstRect.left;
-			int16 offsetY = ticket->_dstRect.top;
-			// convert from screen-coords to surface-coords.
-			dstClip.translate(-offsetX, -offsetY);
-
-			drawFromSurface(ticket, &pos, &dstClip);
-			_needsFlip = true;
+
+		collectTickets(dirtyRect);
+		for (uint j = 0; j < _visibleTickets.size(); j++) {
+			drawTicketClipped(_drawList[_visibleTickets[j]], dirtyRect);
 		}
-		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
-		ticket->_wantsDraw = false;
+
+		g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(dirtyRect.left, dirtyRect.top), _renderSurface->pitch, dirtyRect.left, dirtyRect.top, dirtyRect.width(), dirtyRect.height());
+		_frameStats.dirtyPixels += dirtyRect.width() * dirtyRect.height();
+	}
+	_frameStats.dirtyRects = _dirtyRects.size();
+
+	// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
+	for (uint i = 0; i < _drawList.size(); i++) {
+		_drawList[i]->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
+	_drawList.resize(0);
 
 	it = _renderQueue.begin();
 	// Clean out the old tickets
@@ -588,6 +794,8 @@ void BaseRenderOSystem::endSaveLoad() {
 		it = _renderQueue.erase(it);
 		delete ticket;
 	}
+	_ticketIndex.clear();
+	_ticketIndexEntries.resize(0);
 	// HACK: After a save the buffer will be drawn before the scripts get to update it,
 	// so just skip this single frame.
 	_skipThisFrame = true;
@@ -30,6 +30,8 @@
 
 #include "engines/wintermute/base/gfx/base_renderer.h"
 
+#include "common/array.h"
+#include "common/flat-hashmap.h"
 #include "common/rect.h"
 #include "common/list.h"
 
@@ -54,6 +56,10 @@ class RenderTicket;
  * being equal, this information is then used to check whether the draw order changed,
  * which will then create a need for redrawing, as we draw with an alpha-channel here.
  *
+ * Tickets from the previous frame are found through a hash index keyed on the
+ * draw arguments, and the screen is repainted as a set of disjoint dirty rects,
+ * using a coarse grid over the screen to find the tickets overlapping each rect.
+ *
  * There is also a draw path that draws without tickets, for debugging purposes,
  * as well as to accommodate situations with large enough amounts of draw calls,
  * that there will be too much overhead involved with comparing the generated tickets.
@@ -65,6 +71,30 @@ public:
 
 	typedef Common::List<RenderTicket *>::iterator RenderQueueIterator;
 
+	/**
+	 * Ticket and redraw counters for a single frame, printed on the
+	 * "render" debug channel at every flip().
+	 */
+	struct FrameStats {
+		uint32 tickets;       ///< Tickets in the queue after the frame
+		uint32 matched;       ///< Draw calls served by a ticket from the previous frame
+		uint32 reordered;     ///< ...of which had to be moved in the queue
+		uint32 created;       ///< Draw calls that needed a new ticket
+		uint32 dirtyRects;    ///< Disjoint dirty rects repainted
+		uint32 dirtyPixels;   ///< Total area of the dirty rects
+		uint32 drawCalls;     ///< Clipped ticket blits
+		uint32 drawnPixels;   ///< Total area of the clipped ticket blits
+
+		FrameStats() { reset(); }
+		void reset() {
+			tickets = matched = reordered = created = 0;
+			dirtyRects = dirtyPixels = drawCalls = drawnPixels = 0;
+		}
+	};
+
+	/** Statistics of the last completed frame. */
+	const FrameStats &getLastFrameStats() const { return _lastFrameStats; }
+
 	Common::String getName() const override;
 
 	bool initRenderer(int width, int height, bool windowed) override;
@@ -118,7 +148,8 @@ public:
 	BaseSurface *createSurface() override;
 private:
 	/**
-	 * Mark a specified rect of the screen as dirty.
+	 * Mark a specified rect of the screen as dirty. Overlapping dirty rects
+	 * are merged, so that the dirty rects stay disjoint.
 	 * @param rect the region to be marked as dirty
 	 */
 	void addDirtyRect(const Common::Rect &rect);
@@ -126,13 +157,62 @@ private:
 	 * Traverse the tickets that are dirty, and draw them
 	 */
 	void drawTickets();
+	/**
+	 * Redraw the part of a ticket that falls inside a dirty rect.
+	 */
+	void drawTicketClipped(RenderTicket *ticket, const Common::Rect &dirtyRect);
 	// Non-dirty-rects:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
+
+	/**
+	 * Index the tickets of the frame that was just flipped by their match hash,
+	 * for drawSurface() to look them up during the next frame.
+	 */
+	void rebuildTicketIndex();
+	/**
+	 * Find the first ticket from the previous frame that is equal to @p compare
+	 * and has neither been drawn this frame nor been invalidated.
+	 * @return an iterator to the ticket, or _renderQueue.end() if there is none.
+	 */
+	RenderQueueIterator findQueuedTicket(const RenderTicket &compare);
+
+	/**
+	 * Bucket the tickets in _drawList into the cells of a coarse grid covering
+	 * the render surface.
+	 */
+	void buildTicketGrid();
+	/**
+	 * Collect the indices into _drawList of all tickets that intersect @p rect,
+	 * in draw order, into _visibleTickets.
+	 */
+	void collectTickets(const Common::Rect &rect);
+
+	Common::Array<Common::Rect> _dirtyRects;
 	Common::List<RenderTicket *> _renderQueue;
 
+	struct TicketIndexEntry {
+		RenderTicket *ticket;
+		RenderQueueIterator pos;
+		uint32 next;          ///< Next entry with the same hash, in queue order
+	};
+	Common::Array<TicketIndexEntry> _ticketIndexEntries;
+	Common::FlatHashMap<uint32, uint32> _ticketIndex; ///< Match hash -> first entry
+
+	Common::Array<RenderTicket *> _drawList;  ///< The queue in draw order, while drawing
+	Common::Array<uint32> _gridCellStart;     ///< Offsets into _gridTickets, one per cell plus one
+	Common::Array<uint32> _gridTickets;       ///< _drawList indices, grouped by cell
+	Common::Array<uint32> _ticketStamps;      ///< Per-ticket marker to skip duplicates in collectTickets()
+	Common::Array<uint32> _visibleTickets;
+	uint32 _currentStamp;
+	int _gridColumns;
+	int _gridRows;
+	bool _gridValid;
+
+	FrameStats _frameStats;
+	FrameStats _lastFrameStats;
+
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
 	Common::Rect _renderRect;
@@ -36,6 +36,30 @@
 
 namespace Wintermute {
 
+static inline uint32 combineHash(uint32 hash, uint32 value) {
+	return hash ^ (value + 0x9e3779b9 + (hash << 6) + (hash >> 2));
+}
+
+static inline uint32 hashRect(uint32 hash, const Common::Rect &rect) {
+	hash = combineHash(hash, (uint16)rect.left | ((uint32)(uint16)rect.top << 16));
+	return combineHash(hash, (uint16)rect.right | ((uint32)(uint16)rect.bottom << 16));
+}
+
+static uint32 computeMatchHash(const BaseSurfaceOSystem *owner, const Common::Rect &srcRect, const Common::Rect &dstRect,
+                               const Graphics::TransformStruct &transform) {
+	uint64 ownerBits = (uint64)(uintptr)owner;
+	uint32 hash = combineHash((uint32)ownerBits, (uint32)(ownerBits >> 32));
+	hash = hashRect(hash, srcRect);
+	hash = hashRect(hash, dstRect);
+	hash = combineHash(hash, (uint32)transform._angle);
+	hash = combineHash(hash, (uint16)transform._zoom.x | ((uint32)(uint16)transform._zoom.y << 16));
+	hash = combineHash(hash, (uint16)transform._offset.x | ((uint32)(uint16)transform._offset.y << 16));
+	hash = combineHash(hash, transform._rgbaMod);
+	hash = combineHash(hash, transform._flip | (transform._alphaDisable ? 0x100 : 0) | ((uint32)transform._blendMode << 16));
+	hash = combineHash(hash, (uint32)transform._numTimesX | ((uint32)transform._numTimesY << 16));
+	return hash;
+}
+
 RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf,
                            Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct transform) :
 	        _owner(owner),
@@ -44,6 +68,7 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 	        _isValid(true),
 	        _wantsDraw(true),
 	        _transform(transform) {
+	_matchHash = computeMatchHash(owner, _srcRect, _dstRect, _transform);
 	if (surf) {
 		_surface = new Graphics::Surface();
 		_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
@@ -51,7 +51,7 @@ class BaseSurfaceOSystem;
 class RenderTicket {
 public:
 	RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRest, Graphics::TransformStruct transform);
-	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()) {}
+	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()), _matchHash(0) {}
 	~RenderTicket();
 	const Graphics::Surface *getSurface() const { return _surface; }
 	// Non-dirty-rects:
@@ -68,10 +68,16 @@ public:
 
 	BaseSurfaceOSystem *_owner;
 	bool operator==(const RenderTicket &a) const;
+	/**
+	 * Hash of all the fields compared by operator==, so that equal tickets
+	 * always share the same hash.
+	 */
+	uint32 getMatchHash() const { return _matchHash; }
 	const Common::Rect *getSrcRect() const { return &_srcRect; }
 private:
 	Graphics::Surface *_surface;
 	Common::Rect _srcRect;
+	uint32 _matchHash;
 };
 
 } // End of namespace Wintermute
@@ -36,6 +36,8 @@
 #include "engines/wintermute/base/base_engine.h"
 #include "engines/wintermute/math/math_util.h"
 
+#include "common/threadpool.h"
+
 namespace Wintermute {
 
 XMesh::XMesh(Wintermute::BaseGame *inGame) : BaseNamedObject(inGame) {
@@ -80,7 +82,7 @@ bool XMesh::findBones(FrameNode *rootFrame) {
 	if (!_skinnedMesh) {
 		return true;
 	}
-	auto skinWeightsList = _skinMesh->_mesh->_skinWeightsList;
+	const BaseArray<SkinWeights> &skinWeightsList = _skinMesh->_mesh->_skinWeightsList;
 
 	_boneMatrices.resize(skinWeightsList.size());
 
@@ -94,9 +96,51 @@ bool XMesh::findBones(FrameNode *rootFrame) {
 		}
 	}
 
+	buildSkinInfluences();
+
 	return true;
 }
 
+//////////////////////////////////////////////////////////////////////////
+void XMesh::buildSkinInfluences() {
+	const BaseArray<SkinWeights> &skinWeightsList = _skinMesh->_mesh->_skinWeightsList;
+	uint32 vertexCount = _skinMesh->_mesh->_vertexCount;
+
+	// Count the influences per vertex, turn the counts into offsets and then
+	// place the influences. Going through the bones in order keeps the
+	// summation order of the bone-major loop this replaces.
+	_influenceStart.clear();
+	_influenceStart.resize(vertexCount + 1, 0);
+	for (uint boneIndex = 0; boneIndex < skinWeightsList.size(); ++boneIndex) {
+		const BaseArray<uint32> &vertexIndices = skinWeightsList[boneIndex]._vertexIndices;
+		for (uint i = 0; i < vertexIndices.size(); ++i) {
+			if (vertexIndices[i] < vertexCount) {
+				_influenceStart[vertexIndices[i] + 1]++;
+			}
+		}
+	}
+	for (uint32 i = 0; i < vertexCount; ++i) {
+		_influenceStart[i + 1] += _influenceStart[i];
+	}
+
+	_influenceBones.resize(_influenceStart[vertexCount]);
+	_influenceWeights.resize(_influenceStart[vertexCount]);
+
+	Common::Array<uint32> next(_influenceStart.begin(), vertexCount);
+	for (uint boneIndex = 0; boneIndex < skinWeightsList.size(); ++boneIndex) {
+		const BaseArray<uint32> &vertexIndices = skinWeightsList[boneIndex]._vertexIndices;
+		for (uint i = 0; i < vertexIndices.size(); ++i) {
+			if (vertexIndices[i] < vertexCount) {
+				uint32 slot = next[vertexIndices[i]]++;
+				_influenceBones[slot] = boneIndex;
+				_influenceWeights[slot] = skinWeightsList[boneIndex]._vertexWeights[i];
+			}
+		}
+	}
+
+	_skinningBones.resize(skinWeightsList.size());
+}
+
 //////////////////////////////////////////////////////////////////////////
 bool XMesh::update(FrameNode *parentFrame) {
 	float *vertexData = _skinMesh->_mesh->_vertexData;
@@ -107,69 +151,50 @@ bool XMesh::update(FrameNode *parentFrame) {
 	float *vertexPositionData = _skinMesh->_mesh->_vertexPositionData;
 	float *vertexNormalData = _skinMesh->_mesh->_vertexNormalData;
 	uint32 vertexCount = _skinMesh->_mesh->_vertexCount;
-	auto skinWeightsList = _skinMesh->_mesh->_skinWeightsList;
+	const BaseArray<SkinWeights> &skinWeightsList = _skinMesh->_mesh->_skinWeightsList;
 
 	// update skinned mesh
 	if (_skinnedMesh) {
-		BaseArray<Math::Matrix4> finalBoneMatrices;
-		finalBoneMatrices.resize(_boneMatrices.size());
-
-		for (uint i = 0; i < skinWeightsList.size(); ++i) {
-			finalBoneMatrices[i] = *_boneMatrices[i] * skinWeightsList[i]._offsetMatrix;
+		if (_influenceStart.size() != vertexCount + 1) {
+			buildSkinInfluences();
 		}
 
 		// the new vertex coordinates are the weighted sum of the product
-		// of the combined bone transformation matrices and the static pose coordinates
-		// to be able too add the weighted summands together, we reset everything to zero first
-		for (uint32 i = 0; i < vertexCount; ++i) {
-			for (int j = 0; j < 3; ++j) {
-				vertexData[i * XSkinMeshLoader::kVertexComponentCount + XSkinMeshLoader::kPositionOffset + j] = 0.0f;
-			}
-		}
-
-		for (uint boneIndex = 0; boneIndex < skinWeightsList.size(); ++boneIndex) {
-			// to every vertex which is affected by the bone, we add the product
-			// of the bone transformation with the coordinates of the static pose,
-			// weighted by the weight for the particular vertex
-			// repeating this procedure for all bones gives the new pose
-			for (uint i = 0; i < skinWeightsList[boneIndex]._vertexIndices.size(); ++i) {
-				uint32 vertexIndex = skinWeightsList[boneIndex]._vertexIndices[i];
-				Math::Vector3d pos;
-				pos.setData(vertexPositionData + vertexIndex * 3);
-				finalBoneMatrices[boneIndex].transform(&pos, true);
-				pos *= skinWeightsList[boneIndex]._vertexWeights[i];
-
-				for (uint j = 0; j < 3; ++j) {
-					vertexData[vertexIndex * XSkinMeshLoader::kVertexComponentCount + XSkinMeshLoader::kPositionOffset + j] += pos.getData()[j];
-				}
-			}
-		}
-
-		// now we have to update the vertex normals as well, so prepare the bone transformations
+		// of the combined bone transformation matrices and the static pose coordinates.
+		// Normals are transformed by the inverse transpose of the rotation part,
+		// which is worked out once per bone here
 		for (uint i = 0; i < skinWeightsList.size(); ++i) {
-			finalBoneMatrices[i].transpose();
-			finalBoneMatrices[i].inverse();
+			Math::Matrix4 finalBoneMatrix = *_boneMatrices[i] * skinWeightsList[i]._offsetMatrix;
+			packSkinningBone(finalBoneMatrix, _skinningBones[i]);
 		}
 
-		// reset so we can form the weighted sums
-		for (uint32 i = 0; i < vertexCount; ++i) {
-			for (int j = 0; j < 3; ++j) {
-				vertexData[i * XSkinMeshLoader::kVertexComponentCount + XSkinMeshLoader::kNormalOffset + j] = 0.0f;
-			}
-		}
-
-		for (uint boneIndex = 0; boneIndex < skinWeightsList.size(); ++boneIndex) {
-			for (uint i = 0; i < skinWeightsList[boneIndex]._vertexIndices.size(); ++i) {
-				uint32 vertexIndex = skinWeightsList[boneIndex]._vertexIndices[i];
-				Math::Vector3d pos;
-				pos.setData(vertexNormalData + vertexIndex * 3);
-				finalBoneMatrices[boneIndex].transform(&pos, true);
-				pos *= skinWeightsList[boneIndex]._vertexWeights[i];
-
-				for (uint j = 0; j < 3; ++j) {
-					vertexData[vertexIndex * XSkinMeshLoader::kVertexComponentCount + XSkinMeshLoader::kNormalOffset + j] += pos.getData()[j];
-				}
-			}
+		SkinningJob job;
+		job._bones = _skinningBones.begin();
+		job._influenceStart = _influenceStart.begin();
+		job._influenceBones = _influenceBones.begin();
+		job._influenceWeights = _influenceWeights.begin();
+		job._positions = vertexPositionData;
+		job._normals = vertexNormalData;
+		job._vertexData = vertexData;
+		job._vertexStride = XSkinMeshLoader::kVertexComponentCount;
+		job._positionOffset = XSkinMeshLoader::kPositionOffset;
+		job._normalOffset = XSkinMeshLoader::kNormalOffset;
+		job._begin = 0;
+		job._end = vertexCount;
+
+		SkinVerticesProc skinVertices = getSkinVerticesProc();
+		Common::ThreadPool &pool = Common::ThreadPool::instance();
+		if (vertexCount >= kParallelSkinningVertices && pool.getNumWorkers() > 0) {
+			// Every vertex is written by exactly one job, so large meshes can be
+			// split across the worker threads.
+			pool.parallelFor(0, vertexCount, kParallelSkinningVertices / 2, [&job, skinVertices](uint begin, uint end) {
+				SkinningJob range = job;
+				range._begin = begin;
+				range._end = end;
+				skinVertices(range);
+			});
+		} else {
+			skinVertices(job);
 		}
 
 	//updateNormals();
@@ -30,6 +30,7 @@
 
 #include "engines/wintermute/base/base_named_object.h"
 #include "engines/wintermute/base/gfx/xmodel.h"
+#include "engines/wintermute/base/gfx/xskinning.h"
 #include "engines/wintermute/coll_templ.h"
 
 #include "math/matrix4.h"
@@ -70,8 +71,11 @@ public:
 	bool restoreDeviceObjects();
 
 protected:
+	// Skinned meshes with at least this many vertices are split across worker threads
+	static const uint32 kParallelSkinningVertices = 4096;
 
 	void updateBoundingBox();
+	void buildSkinInfluences();
 
 	uint32 _numAttrs;
 
@@ -84,6 +88,14 @@ protected:
 
 	BaseArray<Math::Matrix4 *> _boneMatrices;
 
+	// The skin weights regrouped per vertex for update(), so that every
+	// vertex is written once: the influences of vertex i are
+	// [_influenceStart[i], _influenceStart[i + 1])
+	Common::Array<uint32> _influenceStart;
+	Common::Array<uint16> _influenceBones;
+	Common::Array<float> _influenceWeights;
+	Common::Array<SkinningBone> _skinningBones;
+
 	Common::Array<uint32> _adjacency;
 
 	BaseArray<Material *> _materials;
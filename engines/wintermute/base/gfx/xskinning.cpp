@@ -0,0 +1,110 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "engines/wintermute/base/gfx/xskinning.h"
+
+#include "common/system.h"
+
+namespace Wintermute {
+
+void packSkinningBone(const Math::Matrix4 &matrix, SkinningBone &bone) {
+	for (int col = 0; col < 4; col++) {
+		for (int row = 0; row < 3; row++) {
+			bone._position[col][row] = matrix.getValue(row, col);
+		}
+		bone._position[col][3] = 0.0f;
+	}
+
+	// Only the upper 3x3 part matters for normals, so its inverse transpose
+	// is the cofactor matrix divided by the determinant.
+	const float m00 = matrix.getValue(0, 0), m01 = matrix.getValue(0, 1), m02 = matrix.getValue(0, 2);
+	const float m10 = matrix.getValue(1, 0), m11 = matrix.getValue(1, 1), m12 = matrix.getValue(1, 2);
+	const float m20 = matrix.getValue(2, 0), m21 = matrix.getValue(2, 1), m22 = matrix.getValue(2, 2);
+
+	float cofactor[3][3];
+	cofactor[0][0] = m11 * m22 - m12 * m21;
+	cofactor[0][1] = m12 * m20 - m10 * m22;
+	cofactor[0][2] = m10 * m21 - m11 * m20;
+	cofactor[1][0] = m02 * m21 - m01 * m22;
+	cofactor[1][1] = m00 * m22 - m02 * m20;
+	cofactor[1][2] = m01 * m20 - m00 * m21;
+	cofactor[2][0] = m01 * m12 - m02 * m11;
+	cofactor[2][1] = m02 * m10 - m00 * m12;
+	cofactor[2][2] = m00 * m11 - m01 * m10;
+
+	const float det = m00 * cofactor[0][0] + m01 * cofactor[0][1] + m02 * cofactor[0][2];
+	// A degenerate bone still gets normals pointing the right way.
+	const float scale = (det != 0.0f) ? 1.0f / det : 1.0f;
+
+	for (int col = 0; col < 3; col++) {
+		for (int row = 0; row < 3; row++) {
+			bone._normal[col][row] = cofactor[row][col] * scale;
+		}
+		bone._normal[col][3] = 0.0f;
+	}
+}
+
+void skinVerticesGeneric(const SkinningJob &job) {
+	for (uint32 v = job._begin; v < job._end; v++) {
+		const float *pos = job._positions + v * 3;
+		const float *normal = job._normals + v * 3;
+		float skinnedPos[3] = { 0.0f, 0.0f, 0.0f };
+		float skinnedNormal[3] = { 0.0f, 0.0f, 0.0f };
+
+		for (uint32 i = job._influenceStart[v]; i < job._influenceStart[v + 1]; i++) {
+			const SkinningBone &bone = job._bones[job._influenceBones[i]];
+			const float weight = job._influenceWeights[i];
+
+			for (int j = 0; j < 3; j++) {
+				skinnedPos[j] += weight * (bone._position[0][j] * pos[0] + bone._position[1][j] * pos[1] +
+				                           bone._position[2][j] * pos[2] + bone._position[3][j]);
+				skinnedNormal[j] += weight * (bone._normal[0][j] * normal[0] + bone._normal[1][j] * normal[1] +
+				                              bone._normal[2][j] * normal[2]);
+			}
+		}
+
+		float *out = job._vertexData + v * job._vertexStride;
+		for (int j = 0; j < 3; j++) {
+			out[job._positionOffset + j] = skinnedPos[j];
+			out[job._normalOffset + j] = skinnedNormal[j];
+		}
+	}
+}
+
+SkinVerticesProc getSkinVerticesProc() {
+	static SkinVerticesProc proc = nullptr;
+
+	if (!proc) {
+		proc = skinVerticesGeneric;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			proc = skinVerticesNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			proc = skinVerticesSSE2;
+#endif
+	}
+
+	return proc;
+}
+
+} // End of namespace Wintermute
@@ -0,0 +1,84 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef WINTERMUTE_XSKINNING_H
+#define WINTERMUTE_XSKINNING_H
+
+#include "common/scummsys.h"
+
+#include "math/matrix4.h"
+
+namespace Wintermute {
+
+/**
+ * The transforms of one bone for the current frame, stored as padded
+ * matrix columns so the skinning kernels can load them as vectors.
+ * The position transform includes the translation in its last column,
+ * the normal transform is the inverse transpose of its upper 3x3 part.
+ */
+struct SkinningBone {
+	float _position[4][4];
+	float _normal[3][4];
+};
+
+/**
+ * Fill @p bone from the combined bone matrix of a mesh.
+ */
+void packSkinningBone(const Math::Matrix4 &matrix, SkinningBone &bone);
+
+/**
+ * The vertices [_begin, _end) of a skinned mesh to transform. The
+ * influences of vertex i are [_influenceStart[i], _influenceStart[i + 1])
+ * in _influenceBones and _influenceWeights.
+ */
+struct SkinningJob {
+	const SkinningBone *_bones;
+	const uint32 *_influenceStart;
+	const uint16 *_influenceBones;
+	const float *_influenceWeights;
+	const float *_positions;      ///< Bind pose positions, three floats per vertex
+	const float *_normals;        ///< Bind pose normals, three floats per vertex
+	float *_vertexData;           ///< Interleaved output vertices
+	uint32 _vertexStride;
+	uint32 _positionOffset;
+	uint32 _normalOffset;
+	uint32 _begin;
+	uint32 _end;
+};
+
+typedef void (*SkinVerticesProc)(const SkinningJob &job);
+
+void skinVerticesGeneric(const SkinningJob &job);
+#ifdef SCUMMVM_SSE2
+void skinVerticesSSE2(const SkinningJob &job);
+#endif
+#ifdef SCUMMVM_NEON
+void skinVerticesNEON(const SkinningJob &job);
+#endif
+
+/**
+ * Return the fastest skinning kernel supported by the CPU.
+ */
+SkinVerticesProc getSkinVerticesProc();
+
+} // End of namespace Wintermute
+
+#endif
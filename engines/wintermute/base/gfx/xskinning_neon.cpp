@@ -0,0 +1,80 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "engines/wintermute/base/gfx/xskinning.h"
+
+#include <arm_neon.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#if !defined(__aarch64__)
+#pragma GCC target("fpu=neon")
+#endif // !defined(__aarch64__)
+
+#endif // __GNUC__
+
+namespace Wintermute {
+
+void skinVerticesNEON(const SkinningJob &job) {
+	for (uint32 v = job._begin; v < job._end; v++) {
+		const float *pos = job._positions + v * 3;
+		const float *normal = job._normals + v * 3;
+		float32x4_t skinnedPos = vdupq_n_f32(0.0f);
+		float32x4_t skinnedNormal = vdupq_n_f32(0.0f);
+
+		for (uint32 i = job._influenceStart[v]; i < job._influenceStart[v + 1]; i++) {
+			const SkinningBone &bone = job._bones[job._influenceBones[i]];
+			const float weight = job._influenceWeights[i];
+
+			float32x4_t p = vld1q_f32(bone._position[3]);
+			p = vmlaq_n_f32(p, vld1q_f32(bone._position[0]), pos[0]);
+			p = vmlaq_n_f32(p, vld1q_f32(bone._position[1]), pos[1]);
+			p = vmlaq_n_f32(p, vld1q_f32(bone._position[2]), pos[2]);
+			skinnedPos = vmlaq_n_f32(skinnedPos, p, weight);
+
+			float32x4_t n = vmulq_n_f32(vld1q_f32(bone._normal[0]), normal[0]);
+			n = vmlaq_n_f32(n, vld1q_f32(bone._normal[1]), normal[1]);
+			n = vmlaq_n_f32(n, vld1q_f32(bone._normal[2]), normal[2]);
+			skinnedNormal = vmlaq_n_f32(skinnedNormal, n, weight);
+		}
+
+		// The fourth lane would overwrite the next vertex attribute, so only
+		// three components are stored.
+		float *out = job._vertexData + v * job._vertexStride;
+		vst1_f32(out + job._positionOffset, vget_low_f32(skinnedPos));
+		vst1q_lane_f32(out + job._positionOffset + 2, skinnedPos, 2);
+		vst1_f32(out + job._normalOffset, vget_low_f32(skinnedNormal));
+		vst1q_lane_f32(out + job._normalOffset + 2, skinnedNormal, 2);
+	}
+}
+
+} // End of namespace Wintermute
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif // __GNUC__
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,89 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_SSE2
+
+#include "engines/wintermute/base/gfx/xskinning.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace Wintermute {
+
+void skinVerticesSSE2(const SkinningJob &job) {
+	for (uint32 v = job._begin; v < job._end; v++) {
+		const float *pos = job._positions + v * 3;
+		const float *normal = job._normals + v * 3;
+		const __m128 px = _mm_set1_ps(pos[0]);
+		const __m128 py = _mm_set1_ps(pos[1]);
+		const __m128 pz = _mm_set1_ps(pos[2]);
+		const __m128 nx = _mm_set1_ps(normal[0]);
+		const __m128 ny = _mm_set1_ps(normal[1]);
+		const __m128 nz = _mm_set1_ps(normal[2]);
+		__m128 skinnedPos = _mm_setzero_ps();
+		__m128 skinnedNormal = _mm_setzero_ps();
+
+		for (uint32 i = job._influenceStart[v]; i < job._influenceStart[v + 1]; i++) {
+			const SkinningBone &bone = job._bones[job._influenceBones[i]];
+			const __m128 weight = _mm_set1_ps(job._influenceWeights[i]);
+
+			__m128 p = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(bone._position[0]), px), _mm_mul_ps(_mm_loadu_ps(bone._position[1]), py));
+			p = _mm_add_ps(p, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(bone._position[2]), pz), _mm_loadu_ps(bone._position[3])));
+			skinnedPos = _mm_add_ps(skinnedPos, _mm_mul_ps(p, weight));
+
+			__m128 n = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(bone._normal[0]), nx), _mm_mul_ps(_mm_loadu_ps(bone._normal[1]), ny));
+			n = _mm_add_ps(n, _mm_mul_ps(_mm_loadu_ps(bone._normal[2]), nz));
+			skinnedNormal = _mm_add_ps(skinnedNormal, _mm_mul_ps(n, weight));
+		}
+
+		// The fourth lane would overwrite the next vertex attribute, so only
+		// three components are stored.
+		float result[8];
+		_mm_storeu_ps(result, skinnedPos);
+		_mm_storeu_ps(result + 4, skinnedNormal);
+
+		float *out = job._vertexData + v * job._vertexStride;
+		out[job._positionOffset + 0] = result[0];
+		out[job._positionOffset + 1] = result[1];
+		out[job._positionOffset + 2] = result[2];
+		out[job._normalOffset + 0] = result[4];
+		out[job._normalOffset + 1] = result[5];
+		out[job._normalOffset + 2] = result[6];
+	}
+}
+
+} // End of namespace Wintermute
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif // __GNUC__
+
+#endif // SCUMMVM_SSE2
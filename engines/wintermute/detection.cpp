@@ -39,6 +39,7 @@ static const DebugChannelDef debugFlagList[] = {
 	{Wintermute::kWintermuteDebugFileAccess, "file-access", "Non-critical problems like missing files"},
 	{Wintermute::kWintermuteDebugAudio, "audio", "audio-playback-related issues"},
 	{Wintermute::kWintermuteDebugGeneral, "general", "various issues not covered by any of the above"},
+	{Wintermute::kWintermuteDebugRender, "render", "Per-frame render queue statistics"},
 	DEBUG_CHANNEL_END
 };
 
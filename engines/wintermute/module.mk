@@ -177,6 +177,7 @@ MODULE_OBJS += \
 	base/gfx/xmesh.o \
 	base/gfx/xmodel.o \
 	base/gfx/xskinmesh_loader.o \
+	base/gfx/xskinning.o \
 	base/gfx/opengl/base_surface_opengl3d.o \
 	base/gfx/opengl/base_render_opengl3d.o \
 	base/gfx/opengl/base_render_opengl3d_shader.o \
@@ -187,6 +188,16 @@ MODULE_OBJS += \
 	base/gfx/opengl/shadow_volume_opengl.o \
 	base/gfx/opengl/shadow_volume_opengl_shader.o \
 	base/base_animation_transition_time.o
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	base/gfx/xskinning_neon.o
+$(MODULE)/base/gfx/xskinning_neon.o: CXXFLAGS += $(NEON_CXXFLAGS)
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	base/gfx/xskinning_sse2.o
+endif
 endif
 
 MODULE_DIRS += \
@@ -46,6 +46,7 @@ struct ZVisionGameDescription {
 #define GAMEOPTION_ENABLE_VENUS               GUIO_GAMEOPTIONS3
 #define GAMEOPTION_DISABLE_ANIM_WHILE_TURNING GUIO_GAMEOPTIONS4
 #define GAMEOPTION_USE_HIRES_MPEG_MOVIES      GUIO_GAMEOPTIONS5
+#define GAMEOPTION_BILINEAR_PANORAMA          GUIO_GAMEOPTIONS6
 
 } // End of namespace ZVision
 
@@ -20,21 +20,31 @@
  */
 
 #include "zvision/graphics/render_table.h"
+#include "zvision/graphics/warp_kernels.h"
 
 #include "common/math.h"
 #include "common/rect.h"
 #include "common/scummsys.h"
+#include "common/system.h"
+#include "common/threadpool.h"
 
 namespace ZVision {
 
 RenderTable::RenderTable(uint numColumns, uint numRows)
 	: _numRows(numRows),
 	  _numColumns(numColumns),
-	  _renderState(FLAT) {
+	  _renderState(FLAT),
+	  _bilinearFiltering(false) {
 	assert(numRows != 0 && numColumns != 0);
 
 	_internalBuffer = new Common::Point[numRows * numColumns];
 
+	_sourceOffsets.resize(numRows * numColumns);
+	_subPixelOffsets.resize(numRows * numColumns, 0);
+	for (uint32 i = 0; i < _sourceOffsets.size(); i++) {
+		_sourceOffsets[i] = i;
+	}
+
 	memset(&_panoramaOptions, 0, sizeof(_panoramaOptions));
 	memset(&_tiltOptions, 0, sizeof(_tiltOptions));
 }
@@ -87,41 +97,101 @@ void RenderTable::mutateImage(uint16 *sourceBuffer, uint16 *destBuffer, uint32 d
 	uint32 destOffset = 0;
 
 	for (int16 y = subRect.top; y < subRect.bottom; ++y) {
-		uint32 sourceOffset = y * _numColumns;
+		const uint32 *sourceOffsets = &_sourceOffsets[y * _numColumns];
 
 		for (int16 x = subRect.left; x < subRect.right; ++x) {
-			uint32 normalizedX = x - subRect.left;
-			uint32 index = sourceOffset + x;
-
-			// RenderTable only stores offsets from the original coordinates
-			uint32 sourceYIndex = y + _internalBuffer[index].y;
-			uint32 sourceXIndex = x + _internalBuffer[index].x;
-
-			destBuffer[destOffset + normalizedX] = sourceBuffer[sourceYIndex * _numColumns + sourceXIndex];
+			destBuffer[destOffset + x - subRect.left] = sourceBuffer[sourceOffsets[x]];
 		}
 
 		destOffset += destWidth;
 	}
 }
 
+// Warp kernels, picked once for the host CPU
+static WarpRowsProc s_warpNearest = nullptr;
+static WarpRowsProc s_warpBilinear = nullptr;
+
+static void selectWarpKernels() {
+	s_warpNearest = warpNearestGeneric;
+	s_warpBilinear = warpBilinearGeneric;
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		s_warpBilinear = warpBilinearSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		s_warpNearest = warpNearestAVX2;
+#endif
+}
+
 void RenderTable::mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf) {
-	uint32 destOffset = 0;
+	assert(srcBuf->format.bytesPerPixel == 2 && dstBuf->format.bytesPerPixel == 2);
+	assert((uint)srcBuf->w <= _numColumns && (uint)srcBuf->h <= _numRows);
 
-	uint16 *sourceBuffer = (uint16 *)srcBuf->getPixels();
-	uint16 *destBuffer = (uint16 *)dstBuf->getPixels();
+	if (!s_warpNearest) {
+		selectWarpKernels();
+	}
 
-	for (int16 y = 0; y < srcBuf->h; ++y) {
-		uint32 sourceOffset = y * _numColumns;
+	WarpJob job;
+	job._src = (const uint16 *)srcBuf->getPixels();
+	job._dst = (uint16 *)dstBuf->getPixels();
+	job._dstPitch = dstBuf->pitch / 2;
+	job._srcPitch = _numColumns;
+	job._width = srcBuf->w;
+	job._srcPixelCount = _numColumns * srcBuf->h;
+	job._sourceOffsets = _sourceOffsets.begin();
+	job._subPixelOffsets = _subPixelOffsets.begin();
+
+	const Graphics::PixelFormat &format = srcBuf->format;
+	job._channelShift[0] = format.rShift;
+	job._channelShift[1] = format.gShift;
+	job._channelShift[2] = format.bShift;
+	job._channelMask[0] = 0xFF >> format.rLoss;
+	job._channelMask[1] = 0xFF >> format.gLoss;
+	job._channelMask[2] = 0xFF >> format.bLoss;
+
+	// The bilinear kernels keep intermediate sums in 16 bits, which leaves
+	// room for channels of up to 6 bits.
+	bool bilinear = _bilinearFiltering && format.rLoss >= 2 && format.gLoss >= 2 && format.bLoss >= 2;
+	WarpRowsProc warpRows = bilinear ? s_warpBilinear : s_warpNearest;
+
+	// Every destination row only depends on the source, so the rows are
+	// split across the worker threads, in bands large enough to be worth it.
+	const uint rows = srcBuf->h;
+	Common::ThreadPool &pool = Common::ThreadPool::instance();
+	if (pool.getNumWorkers() > 0 && rows >= 2 * kWarpRowsPerJob) {
+		pool.parallelFor(0, rows, kWarpRowsPerJob, [&job, warpRows](uint begin, uint end) {
+			warpRows(job, begin, end);
+		});
+	} else {
+		warpRows(job, 0, rows);
+	}
+}
 
-		for (int16 x = 0; x < srcBuf->w; ++x) {
-			uint32 index = sourceOffset + x;
+void warpNearestGeneric(const WarpJob &job, uint firstRow, uint lastRow) {
+	for (uint y = firstRow; y < lastRow; y++) {
+		const uint32 *offsets = job._sourceOffsets + y * job._srcPitch;
+		uint16 *dst = job._dst + y * job._dstPitch;
 
-			// RenderTable only stores offsets from the original coordinates
-			uint32 sourceYIndex = y + _internalBuffer[index].y;
-			uint32 sourceXIndex = x + _internalBuffer[index].x;
+		for (uint x = 0; x < job._width; x++) {
+			dst[x] = job._src[offsets[x]];
+		}
+	}
+}
 
-			destBuffer[destOffset] = sourceBuffer[sourceYIndex * _numColumns + sourceXIndex];
-			destOffset++;
+void warpBilinearGeneric(const WarpJob &job, uint firstRow, uint lastRow) {
+	for (uint y = firstRow; y < lastRow; y++) {
+		const uint32 *offsets = job._sourceOffsets + y * job._srcPitch;
+		const uint16 *subPixel = job._subPixelOffsets + y * job._srcPitch;
+		uint16 *dst = job._dst + y * job._dstPitch;
+
+		for (uint x = 0; x < job._width; x++) {
+			const uint32 offset = offsets[x];
+			const uint16 sub = subPixel[x];
+			const uint32 right = (sub & RenderTable::kSubPixelRight) ? 1 : 0;
+			const uint32 down = (sub & RenderTable::kSubPixelDown) ? job._srcPitch : 0;
+			dst[x] = blendBilinear(job, job._src[offset], job._src[offset + right], job._src[offset + down], job._src[offset + down + right],
+			                       sub & RenderTable::kSubPixelFracMask, (sub >> RenderTable::kSubPixelFracBits) & RenderTable::kSubPixelFracMask);
 		}
 	}
 }
@@ -142,15 +212,30 @@ void RenderTable::generateRenderTable() {
 	}
 }
 
-void RenderTable::generatePanoramaLookupTable() {
-	for (uint y = 0; y < _numRows; y++) {
-		for (uint x = 0; x < _numColumns; x++) {
-			uint32 index = y * _numColumns + x;
-			_internalBuffer[index].x = 0;
-			_internalBuffer[index].y = 0;
-		}
+void RenderTable::setSourcePosition(uint x, uint y, float sourceX, float sourceY, int32 sourceXIndex, int32 sourceYIndex) {
+	uint32 index = y * _numColumns + x;
+
+	// Only store the (x,y) offsets instead of the absolute positions
+	_internalBuffer[index].x = sourceXIndex - x;
+	_internalBuffer[index].y = sourceYIndex - y;
+
+	_sourceOffsets[index] = sourceYIndex * _numColumns + sourceXIndex;
+
+	// Keep the sub-pixel part for bilinear filtering. Without a neighbour
+	// to blend with, the weight goes to the pixel itself.
+	uint16 subPixel = 0;
+	if (sourceXIndex + 1 < (int32)_numColumns) {
+		subPixel |= CLIP<int32>(int32((sourceX - sourceXIndex) * (kSubPixelFracMask + 1)), 0, kSubPixelFracMask);
+		subPixel |= kSubPixelRight;
 	}
+	if (sourceYIndex + 1 < (int32)_numRows) {
+		subPixel |= CLIP<int32>(int32((sourceY - sourceYIndex) * (kSubPixelFracMask + 1)), 0, kSubPixelFracMask) << kSubPixelFracBits;
+		subPixel |= kSubPixelDown;
+	}
+	_subPixelOffsets[index] = subPixel;
+}
 
+void RenderTable::generatePanoramaLookupTable() {
 	float halfWidth = (float)_numColumns / 2.0f;
 	float halfHeight = (float)_numRows / 2.0f;
 
@@ -164,20 +249,18 @@ void RenderTable::generatePanoramaLookupTable() {
 
 		// To get x in cylinder coordinates, we just need to calculate the arc length
 		// We also scale it by _panoramaOptions.linearScale
-		int32 xInCylinderCoords = int32(floor((cylinderRadius * _panoramaOptions.linearScale * alpha) + halfWidth));
+		float xInCylinder = (cylinderRadius * _panoramaOptions.linearScale * alpha) + halfWidth;
+		int32 xInCylinderCoords = int32(floor(xInCylinder));
 
 		float cosAlpha = cos(alpha);
 
 		for (uint y = 0; y < _numRows; ++y) {
 			// To calculate y in cylinder coordinates, we can do similar triangles comparison,
 			// comparing the triangle from the center to the screen and from the center to the edge of the cylinder
-			int32 yInCylinderCoords = int32(floor(halfHeight + ((float)y - halfHeight) * cosAlpha));
+			float yInCylinder = halfHeight + ((float)y - halfHeight) * cosAlpha;
+			int32 yInCylinderCoords = int32(floor(yInCylinder));
 
-			uint32 index = y * _numColumns + x;
-
-			// Only store the (x,y) offsets instead of the absolute positions
-			_internalBuffer[index].x = xInCylinderCoords - x;
-			_internalBuffer[index].y = yInCylinderCoords - y;
+			setSourcePosition(x, y, xInCylinder, yInCylinder, xInCylinderCoords, yInCylinderCoords);
 		}
 	}
 }
@@ -198,21 +281,18 @@ void RenderTable::generateTiltLookupTable() {
 
 		// To get y in cylinder coordinates, we just need to calculate the arc length
 		// We also scale it by _tiltOptions.linearScale
-		int32 yInCylinderCoords = int32(floor((cylinderRadius * _tiltOptions.linearScale * alpha) + halfHeight));
+		float yInCylinder = (cylinderRadius * _tiltOptions.linearScale * alpha) + halfHeight;
+		int32 yInCylinderCoords = int32(floor(yInCylinder));
 
 		float cosAlpha = cos(alpha);
-		uint32 columnIndex = y * _numColumns;
 
 		for (uint x = 0; x < _numColumns; ++x) {
 			// To calculate x in cylinder coordinates, we can do similar triangles comparison,
 			// comparing the triangle from the center to the screen and from the center to the edge of the cylinder
-			int32 xInCylinderCoords = int32(floor(halfWidth + ((float)x - halfWidth) * cosAlpha));
-
-			uint32 index = columnIndex + x;
+			float xInCylinder = halfWidth + ((float)x - halfWidth) * cosAlpha;
+			int32 xInCylinderCoords = int32(floor(xInCylinder));
 
-			// Only store the (x,y) offsets instead of the absolute positions
-			_internalBuffer[index].x = xInCylinderCoords - x;
-			_internalBuffer[index].y = yInCylinderCoords - y;
+			setSourcePosition(x, y, xInCylinder, yInCylinder, xInCylinderCoords, yInCylinderCoords);
 		}
 	}
 }
@@ -22,6 +22,7 @@
 #ifndef ZVISION_RENDER_TABLE_H
 #define ZVISION_RENDER_TABLE_H
 
+#include "common/array.h"
 #include "common/rect.h"
 #include "graphics/surface.h"
 
@@ -39,10 +40,29 @@ public:
 		FLAT
 	};
 
+	/**
+	 * Layout of the sub-pixel table entries used for bilinear filtering:
+	 * the horizontal and vertical fractions of the source position in
+	 * 1/32 pixel, and whether the right and lower neighbour exist.
+	 */
+	enum SubPixelBits {
+		kSubPixelFracBits = 5,
+		kSubPixelFracMask = (1 << kSubPixelFracBits) - 1,
+		kSubPixelRight = 1 << (2 * kSubPixelFracBits),
+		kSubPixelDown = 1 << (2 * kSubPixelFracBits + 1)
+	};
+
 private:
+	// Destination rows per job when warping on several threads
+	static const uint kWarpRowsPerJob = 32;
+
 	uint _numColumns, _numRows;
 	Common::Point *_internalBuffer;
+	// The same mapping as _internalBuffer, as absolute source pixel indices
+	Common::Array<uint32> _sourceOffsets;
+	Common::Array<uint16> _subPixelOffsets;
 	RenderState _renderState;
+	bool _bilinearFiltering;
 
 	struct {
 		float fieldOfView;
@@ -71,6 +91,10 @@ public:
 	void mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf);
 	void generateRenderTable();
 
+	/** Blend the four nearest source pixels instead of picking the closest one. */
+	void setBilinearFiltering(bool enable) { _bilinearFiltering = enable; }
+	bool getBilinearFiltering() const { return _bilinearFiltering; }
+
 	void setPanoramaFoV(float fov);
 	void setPanoramaScale(float scale);
 	void setPanoramaReverse(bool reverse);
@@ -89,6 +113,7 @@ public:
 private:
 	void generatePanoramaLookupTable();
 	void generateTiltLookupTable();
+	void setSourcePosition(uint x, uint y, float sourceX, float sourceY, int32 sourceXIndex, int32 sourceYIndex);
 };
 
 } // End of namespace ZVision
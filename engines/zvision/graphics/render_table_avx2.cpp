@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "zvision/graphics/warp_kernels.h"
+
+#include <immintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace ZVision {
+
+void warpNearestAVX2(const WarpJob &job, uint firstRow, uint lastRow) {
+	// A gather reads 32 bits per lane, i.e. one pixel past the requested
+	// one. Blocks that would read past the end of the source use the
+	// scalar loop instead.
+	const __m256i lastSafeOffset = _mm256_set1_epi32((int32)job._srcPixelCount - 2);
+	const __m256i lowWord = _mm256_set1_epi32(0xFFFF);
+
+	for (uint y = firstRow; y < lastRow; y++) {
+		const uint32 *offsets = job._sourceOffsets + y * job._srcPitch;
+		uint16 *dst = job._dst + y * job._dstPitch;
+
+		uint x = 0;
+		for (; x + 8 <= job._width; x += 8) {
+			// Start fetching the source of the next row while this one is copied
+			if ((x & 31) == 0 && y + 1 < lastRow) {
+				_mm_prefetch((const char *)(job._src + offsets[x + job._srcPitch]), _MM_HINT_T0);
+			}
+
+			const __m256i index = _mm256_loadu_si256((const __m256i *)(offsets + x));
+			if (_mm256_movemask_epi8(_mm256_cmpgt_epi32(index, lastSafeOffset))) {
+				for (int i = 0; i < 8; i++) {
+					dst[x + i] = job._src[offsets[x + i]];
+				}
+				continue;
+			}
+
+			__m256i pixels = _mm256_i32gather_epi32((const int *)job._src, index, 2);
+			pixels = _mm256_and_si256(pixels, lowWord);
+			const __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(pixels), _mm256_extracti128_si256(pixels, 1));
+			_mm_storeu_si128((__m128i *)(dst + x), packed);
+		}
+
+		for (; x < job._width; x++) {
+			dst[x] = job._src[offsets[x]];
+		}
+	}
+}
+
+} // End of namespace ZVision
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,114 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "zvision/graphics/render_table.h"
+#include "zvision/graphics/warp_kernels.h"
+
+#include <emmintrin.h>
+
+#ifdef __GNUC__
+#pragma GCC push_options
+
+#ifndef __x86_64__
+#pragma GCC target("sse2")
+#endif
+
+#endif
+
+namespace ZVision {
+
+static inline __m128i bilinearChannel(__m128i p00, __m128i p01, __m128i p10, __m128i p11,
+                                      __m128i fracX, __m128i invFracX, __m128i fracY, __m128i invFracY,
+                                      int shift, __m128i mask) {
+	const __m128i shiftCount = _mm_cvtsi32_si128(shift);
+	__m128i top = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srl_epi16(p00, shiftCount), mask), invFracX),
+	                            _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi16(p01, shiftCount), mask), fracX));
+	__m128i bottom = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srl_epi16(p10, shiftCount), mask), invFracX),
+	                               _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi16(p11, shiftCount), mask), fracX));
+	// At most 63 * 32 * 32, which still fits an unsigned 16-bit lane
+	__m128i sum = _mm_add_epi16(_mm_mullo_epi16(top, invFracY), _mm_mullo_epi16(bottom, fracY));
+	return _mm_sll_epi16(_mm_srli_epi16(sum, 10), shiftCount);
+}
+
+void warpBilinearSSE2(const WarpJob &job, uint firstRow, uint lastRow) {
+	const __m128i fracMask = _mm_set1_epi16(RenderTable::kSubPixelFracMask);
+	const __m128i one = _mm_set1_epi16(32);
+
+	for (uint y = firstRow; y < lastRow; y++) {
+		const uint32 *offsets = job._sourceOffsets + y * job._srcPitch;
+		const uint16 *subPixel = job._subPixelOffsets + y * job._srcPitch;
+		uint16 *dst = job._dst + y * job._dstPitch;
+
+		uint x = 0;
+		for (; x + 8 <= job._width; x += 8) {
+			// Start fetching the source of the next row while this one is blended
+			if ((x & 31) == 0 && y + 1 < lastRow) {
+				_mm_prefetch((const char *)(job._src + offsets[x + job._srcPitch]), _MM_HINT_T0);
+			}
+
+			uint16 p[4][8];
+			for (int i = 0; i < 8; i++) {
+				const uint32 offset = offsets[x + i];
+				const uint16 sub = subPixel[x + i];
+				const uint32 right = (sub & RenderTable::kSubPixelRight) ? 1 : 0;
+				const uint32 down = (sub & RenderTable::kSubPixelDown) ? job._srcPitch : 0;
+				p[0][i] = job._src[offset];
+				p[1][i] = job._src[offset + right];
+				p[2][i] = job._src[offset + down];
+				p[3][i] = job._src[offset + down + right];
+			}
+			const __m128i p00 = _mm_loadu_si128((const __m128i *)p[0]);
+			const __m128i p01 = _mm_loadu_si128((const __m128i *)p[1]);
+			const __m128i p10 = _mm_loadu_si128((const __m128i *)p[2]);
+			const __m128i p11 = _mm_loadu_si128((const __m128i *)p[3]);
+
+			const __m128i sub = _mm_loadu_si128((const __m128i *)(subPixel + x));
+			const __m128i fracX = _mm_and_si128(sub, fracMask);
+			const __m128i fracY = _mm_and_si128(_mm_srli_epi16(sub, RenderTable::kSubPixelFracBits), fracMask);
+			const __m128i invFracX = _mm_sub_epi16(one, fracX);
+			const __m128i invFracY = _mm_sub_epi16(one, fracY);
+
+			__m128i result = _mm_setzero_si128();
+			for (int c = 0; c < 3; c++) {
+				result = _mm_or_si128(result, bilinearChannel(p00, p01, p10, p11, fracX, invFracX, fracY, invFracY,
+				                                              job._channelShift[c], _mm_set1_epi16(job._channelMask[c])));
+			}
+			_mm_storeu_si128((__m128i *)(dst + x), result);
+		}
+
+		for (; x < job._width; x++) {
+			const uint32 offset = offsets[x];
+			const uint16 sub = subPixel[x];
+			const uint32 right = (sub & RenderTable::kSubPixelRight) ? 1 : 0;
+			const uint32 down = (sub & RenderTable::kSubPixelDown) ? job._srcPitch : 0;
+			dst[x] = blendBilinear(job, job._src[offset], job._src[offset + right], job._src[offset + down], job._src[offset + down + right],
+			                       sub & RenderTable::kSubPixelFracMask, (sub >> RenderTable::kSubPixelFracBits) & RenderTable::kSubPixelFracMask);
+		}
+	}
+}
+
+} // End of namespace ZVision
+
+#ifdef __GNUC__
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,77 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ZVISION_WARP_KERNELS_H
+#define ZVISION_WARP_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace ZVision {
+
+/**
+ * Everything a warp kernel needs to resample rows of a panorama or tilt
+ * image through a RenderTable.
+ */
+struct WarpJob {
+	const uint16 *_src;
+	uint16 *_dst;
+	uint32 _dstPitch;               ///< In pixels
+	uint32 _srcPitch;               ///< In pixels, also the width of the tables
+	uint32 _width;
+	uint32 _srcPixelCount;
+	const uint32 *_sourceOffsets;   ///< Source pixel for every table entry
+	const uint16 *_subPixelOffsets; ///< Bilinear weights, see RenderTable::SubPixelBits
+	uint8 _channelShift[3];         ///< Bilinear mode: position of the color channels
+	uint8 _channelMask[3];          ///< Bilinear mode: channel value masks, at most 6 bits
+};
+
+/** Resample the destination rows [firstRow, lastRow). */
+typedef void (*WarpRowsProc)(const WarpJob &job, uint firstRow, uint lastRow);
+
+void warpNearestGeneric(const WarpJob &job, uint firstRow, uint lastRow);
+void warpBilinearGeneric(const WarpJob &job, uint firstRow, uint lastRow);
+#ifdef SCUMMVM_SSE2
+void warpBilinearSSE2(const WarpJob &job, uint firstRow, uint lastRow);
+#endif
+#ifdef SCUMMVM_AVX2
+void warpNearestAVX2(const WarpJob &job, uint firstRow, uint lastRow);
+#endif
+
+/**
+ * Blend four 16-bit pixels with 5-bit fixed point weights. Shared by the
+ * generic kernel and the tails of the SIMD kernels, so that all of them
+ * produce the same result.
+ */
+inline uint16 blendBilinear(const WarpJob &job, uint16 p00, uint16 p01, uint16 p10, uint16 p11, uint fracX, uint fracY) {
+	uint16 result = 0;
+	for (int c = 0; c < 3; c++) {
+		const uint shift = job._channelShift[c];
+		const uint mask = job._channelMask[c];
+		const uint top = ((p00 >> shift) & mask) * (32 - fracX) + ((p01 >> shift) & mask) * fracX;
+		const uint bottom = ((p10 >> shift) & mask) * (32 - fracX) + ((p11 >> shift) & mask) * fracX;
+		result |= ((top * (32 - fracY) + bottom * fracY) >> 10) << shift;
+	}
+	return result;
+}
+
+} // End of namespace ZVision
+
+#endif
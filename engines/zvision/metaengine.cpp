@@ -100,6 +100,18 @@ static const ADExtraGuiOptionsMap optionsList[] = {
 		}
 	},
 
+	{
+		GAMEOPTION_BILINEAR_PANORAMA,
+		{
+			_s("Smooth panoramas"),
+			_s("Use bilinear filtering when warping panorama and tilt views"),
+			"bilinearpanorama",
+			false,
+			0,
+			0
+		}
+	},
+
 	AD_EXTRA_GUI_OPTIONS_TERMINATOR
 };
 
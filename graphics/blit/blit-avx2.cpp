@@ -305,6 +305,57 @@ void BlendBlit::blitAVX2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_AVX2>(args, blendMode, alphaType);
 }
 
+template<typename Color>
+static void keyBlitLogicAVX2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+							 const uint w, const uint h, const uint32 key) {
+	__m256i keyVec;
+	if (sizeof(Color) == 1)
+		keyVec = _mm256_set1_epi8((char)key);
+	else if (sizeof(Color) == 2)
+		keyVec = _mm256_set1_epi16((short)key);
+	else
+		keyVec = _mm256_set1_epi32((int)key);
+
+	const uint simdWidth = w & ~(32 / sizeof(Color) - 1);
+
+	for (uint y = 0; y < h; ++y) {
+		const Color *in = (const Color *)src;
+		Color *out = (Color *)dst;
+
+		// Keep the destination where the source has the key color
+		for (uint x = 0; x < simdWidth; x += 32 / sizeof(Color)) {
+			__m256i s = _mm256_loadu_si256((const __m256i *)(in + x));
+			__m256i d = _mm256_loadu_si256((const __m256i *)(out + x));
+			__m256i isKey;
+			if (sizeof(Color) == 1)
+				isKey = _mm256_cmpeq_epi8(s, keyVec);
+			else if (sizeof(Color) == 2)
+				isKey = _mm256_cmpeq_epi16(s, keyVec);
+			else
+				isKey = _mm256_cmpeq_epi32(s, keyVec);
+			_mm256_storeu_si256((__m256i *)(out + x), _mm256_blendv_epi8(s, d, isKey));
+		}
+
+		for (uint x = simdWidth; x < w; ++x) {
+			if (in[x] != (Color)key)
+				out[x] = in[x];
+		}
+
+		src += srcPitch;
+		dst += dstPitch;
+	}
+}
+
+void keyBlitAVX2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+				 const uint w, const uint h, const uint bytesPerPixel, const uint32 key) {
+	if (bytesPerPixel == 1)
+		keyBlitLogicAVX2<uint8>(dst, src, dstPitch, srcPitch, w, h, key);
+	else if (bytesPerPixel == 2)
+		keyBlitLogicAVX2<uint16>(dst, src, dstPitch, srcPitch, w, h, key);
+	else
+		keyBlitLogicAVX2<uint32>(dst, src, dstPitch, srcPitch, w, h, key);
+}
+
 } // End of namespace Graphics
 
 #ifdef __GNUC__
@@ -311,6 +311,57 @@ void BlendBlit::blitSSE2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_SSE2>(args, blendMode, alphaType);
 }
 
+template<typename Color>
+static void keyBlitLogicSSE2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+							 const uint w, const uint h, const uint32 key) {
+	__m128i keyVec;
+	if (sizeof(Color) == 1)
+		keyVec = _mm_set1_epi8((char)key);
+	else if (sizeof(Color) == 2)
+		keyVec = _mm_set1_epi16((short)key);
+	else
+		keyVec = _mm_set1_epi32((int)key);
+
+	const uint simdWidth = w & ~(16 / sizeof(Color) - 1);
+
+	for (uint y = 0; y < h; ++y) {
+		const Color *in = (const Color *)src;
+		Color *out = (Color *)dst;
+
+		// Keep the destination where the source has the key color
+		for (uint x = 0; x < simdWidth; x += 16 / sizeof(Color)) {
+			__m128i s = _mm_loadu_si128((const __m128i *)(in + x));
+			__m128i d = _mm_loadu_si128((const __m128i *)(out + x));
+			__m128i isKey;
+			if (sizeof(Color) == 1)
+				isKey = _mm_cmpeq_epi8(s, keyVec);
+			else if (sizeof(Color) == 2)
+				isKey = _mm_cmpeq_epi16(s, keyVec);
+			else
+				isKey = _mm_cmpeq_epi32(s, keyVec);
+			_mm_storeu_si128((__m128i *)(out + x), _mm_or_si128(_mm_and_si128(isKey, d), _mm_andnot_si128(isKey, s)));
+		}
+
+		for (uint x = simdWidth; x < w; ++x) {
+			if (in[x] != (Color)key)
+				out[x] = in[x];
+		}
+
+		src += srcPitch;
+		dst += dstPitch;
+	}
+}
+
+void keyBlitSSE2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+				 const uint w, const uint h, const uint bytesPerPixel, const uint32 key) {
+	if (bytesPerPixel == 1)
+		keyBlitLogicSSE2<uint8>(dst, src, dstPitch, srcPitch, w, h, key);
+	else if (bytesPerPixel == 2)
+		keyBlitLogicSSE2<uint16>(dst, src, dstPitch, srcPitch, w, h, key);
+	else
+		keyBlitLogicSSE2<uint32>(dst, src, dstPitch, srcPitch, w, h, key);
+}
+
 } // End of namespace Graphics
 
 #ifdef __GNUC__
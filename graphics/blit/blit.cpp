@@ -22,6 +22,7 @@
 #include "graphics/blit.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
+#include "common/system.h"
 
 namespace Graphics {
 
@@ -78,8 +79,51 @@ inline void keyBlitLogic(byte *dst, const byte *src, const uint w, const uint h,
 	}
 }
 
+typedef void (*KeyBlitFunc)(byte *dst, const byte *src,
+							const uint dstPitch, const uint srcPitch,
+							const uint w, const uint h,
+							const uint bytesPerPixel, const uint32 key);
+
+void keyBlitGeneric(byte *dst, const byte *src,
+					const uint dstPitch, const uint srcPitch,
+					const uint w, const uint h,
+					const uint bytesPerPixel, const uint32 key) {
+	const uint srcDelta = (srcPitch - w * bytesPerPixel);
+	const uint dstDelta = (dstPitch - w * bytesPerPixel);
+
+	if (bytesPerPixel == 1)
+		keyBlitLogic<uint8, 1>(dst, src, w, h, srcDelta, dstDelta, key);
+	else if (bytesPerPixel == 2)
+		keyBlitLogic<uint16, 2>(dst, src, w, h, srcDelta, dstDelta, key);
+	else
+		keyBlitLogic<uint32, 4>(dst, src, w, h, srcDelta, dstDelta, key);
+}
+
 } // End of anonymous namespace
 
+#ifdef SCUMMVM_SSE2
+void keyBlitSSE2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+				 const uint w, const uint h, const uint bytesPerPixel, const uint32 key);
+#endif
+#ifdef SCUMMVM_AVX2
+void keyBlitAVX2(byte *dst, const byte *src, const uint dstPitch, const uint srcPitch,
+				 const uint w, const uint h, const uint bytesPerPixel, const uint32 key);
+#endif
+
+// Select the widest implementation the CPU supports
+static KeyBlitFunc selectKeyBlitFunc() {
+	KeyBlitFunc func = keyBlitGeneric;
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		func = keyBlitSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		func = keyBlitAVX2;
+#endif
+	return func;
+}
+
 // Function to blit a rect with a transparent color key
 bool keyBlit(byte *dst, const byte *src,
 			   const uint dstPitch, const uint srcPitch,
@@ -88,22 +132,19 @@ bool keyBlit(byte *dst, const byte *src,
 	if (dst == src)
 		return true;
 
-	// Faster, but larger, to provide optimized handling for each case.
-	const uint srcDelta = (srcPitch - w * bytesPerPixel);
-	const uint dstDelta = (dstPitch - w * bytesPerPixel);
+	if (bytesPerPixel == 3) {
+		const uint srcDelta = (srcPitch - w * bytesPerPixel);
+		const uint dstDelta = (dstPitch - w * bytesPerPixel);
 
-	if (bytesPerPixel == 1) {
-		keyBlitLogic<uint8, 1>(dst, src, w, h, srcDelta, dstDelta, key);
-	} else if (bytesPerPixel == 2) {
-		keyBlitLogic<uint16, 2>(dst, src, w, h, srcDelta, dstDelta, key);
-	} else if (bytesPerPixel == 3) {
 		keyBlitLogic<uint8, 3>(dst, src, w, h, srcDelta, dstDelta, key);
-	} else if (bytesPerPixel == 4) {
-		keyBlitLogic<uint32, 4>(dst, src, w, h, srcDelta, dstDelta, key);
-	} else {
+		return true;
+	} else if (bytesPerPixel != 1 && bytesPerPixel != 2 && bytesPerPixel != 4) {
 		return false;
 	}
 
+	// Initialized on first use, which is thread safe for a local static
+	static const KeyBlitFunc keyBlitFunc = selectKeyBlitFunc();
+	keyBlitFunc(dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, key);
 	return true;
 }
 
@@ -507,15 +507,17 @@ void ManagedSurface::transBlitFrom(const ManagedSurface &src, const Common::Rect
 		srcAlpha, srcPalette, dstPalette, mask, maskOnly);
 }
 
-static byte *createPaletteLookup(const Palette *srcPalette, const Palette *dstPalette) {
-	if (srcPalette->size() == 0 || dstPalette->size() == 0)
-		return nullptr;
-
-	byte *lookup = new byte[srcPalette->size()];
+/**
+ * Fill in the lookup from the colors of srcPalette to the closest ones of dstPalette.
+ * Returns true if every color maps to itself.
+ */
+static bool createPaletteLookup(byte *lookup, const Palette *srcPalette, const Palette *dstPalette) {
+	const uint size = MIN<uint>(srcPalette->size(), 256);
 	byte rSrc, gSrc, bSrc;
 	byte rDst, gDst, bDst;
+	bool identity = true;
 
-	for (uint i = 0; i < srcPalette->size(); i++) {
+	for (uint i = 0; i < size; i++) {
 		srcPalette->get(i, rSrc, gSrc, bSrc);
 		if (i < dstPalette->size()) {
 			dstPalette->get(i, rDst, gDst, bDst);
@@ -526,11 +528,121 @@ static byte *createPaletteLookup(const Palette *srcPalette, const Palette *dstPa
 		}
 
 		lookup[i] = dstPalette->findBestColor(rSrc, gSrc, bSrc);
+		identity &= (lookup[i] == i);
 	}
 
-	return lookup;
+	for (uint i = size; i < 256; i++)
+		lookup[i] = i;
+
+	return identity;
+}
+
+namespace {
+
+/**
+ * The most recently used palette lookups. Sprites are usually drawn many
+ * times between palette changes, so the lookups are kept and matched by the
+ * palette contents instead of being recomputed on every blit.
+ *
+ * Surfaces may be drawn from several threads. The lookup is copied out while
+ * the cache is held, and a thread that finds the cache busy builds its lookup
+ * without it instead of waiting.
+ */
+struct PaletteLookupCache {
+	static const uint kNumEntries = 4;
+
+	struct Entry {
+		byte srcColors[256 * 3];
+		byte dstColors[256 * 3];
+		uint srcSize, dstSize;
+		uint32 lastUse;
+		bool identity;
+		byte lookup[256];
+	};
+
+	Entry _entries[kNumEntries];
+	uint32 _useCounter;
+	bool _busy;
+
+	bool tryLock();
+	void unlock();
+
+	/**
+	 * Fill in the lookup from the colors of srcPalette to dstPalette.
+	 * Returns false if no lookup is needed.
+	 */
+	bool get(byte *lookup, const Palette *srcPalette, const Palette *dstPalette);
+};
+
+#if defined(__GCC_ATOMIC_BOOL_LOCK_FREE) && __GCC_ATOMIC_BOOL_LOCK_FREE == 2
+bool PaletteLookupCache::tryLock() {
+	return !__atomic_test_and_set(&_busy, __ATOMIC_ACQUIRE);
+}
+
+void PaletteLookupCache::unlock() {
+	__atomic_clear(&_busy, __ATOMIC_RELEASE);
+}
+#else
+bool PaletteLookupCache::tryLock() {
+	if (_busy)
+		return false;
+	_busy = true;
+	return true;
 }
 
+void PaletteLookupCache::unlock() {
+	_busy = false;
+}
+#endif
+
+bool PaletteLookupCache::get(byte *lookup, const Palette *srcPalette, const Palette *dstPalette) {
+	if (srcPalette->size() == 0 || dstPalette->size() == 0)
+		return false;
+
+	// Only the first 256 source colors can be indexed by the pixels
+	const uint srcSize = MIN<uint>(srcPalette->size(), 256);
+	const uint dstSize = dstPalette->size();
+	if (dstSize > 256 || !tryLock())
+		return !createPaletteLookup(lookup, srcPalette, dstPalette);
+
+	_useCounter++;
+
+	Entry *victim = &_entries[0];
+	for (uint i = 0; i < kNumEntries; i++) {
+		Entry &entry = _entries[i];
+		if (entry.srcSize == srcSize && entry.dstSize == dstSize &&
+				!memcmp(entry.srcColors, srcPalette->data(), srcSize * 3) &&
+				!memcmp(entry.dstColors, dstPalette->data(), dstSize * 3)) {
+			entry.lastUse = _useCounter;
+			victim = &entry;
+			break;
+		}
+
+		if (entry.lastUse < victim->lastUse)
+			victim = &entry;
+	}
+
+	if (victim->lastUse != _useCounter) {
+		memcpy(victim->srcColors, srcPalette->data(), srcSize * 3);
+		memcpy(victim->dstColors, dstPalette->data(), dstSize * 3);
+		victim->srcSize = srcSize;
+		victim->dstSize = dstSize;
+		victim->lastUse = _useCounter;
+		victim->identity = createPaletteLookup(victim->lookup, srcPalette, dstPalette);
+	}
+
+	const bool identity = victim->identity;
+	if (!identity)
+		memcpy(lookup, victim->lookup, sizeof(victim->lookup));
+	unlock();
+
+	return !identity;
+}
+
+PaletteLookupCache paletteLookups;
+
+} // End of anonymous namespace
+
 template<typename TSRC, typename TDEST>
 void transBlitPixel(TSRC srcVal, TDEST &destVal, const Graphics::PixelFormat &srcFormat, const Graphics::PixelFormat &destFormat,
 		uint32 overrideColor, uint32 srcAlpha, const Palette *srcPalette, const byte *lookup) {
@@ -598,9 +710,12 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 	byte rst = 0, gst = 0, bst = 0, rdt = 0, gdt = 0, bdt = 0;
 	byte r = 0, g = 0, b = 0;
 
-	byte *lookup = nullptr;
-	if (srcPalette && dstPalette)
-		lookup = createPaletteLookup(srcPalette, dstPalette);
+	// Only blits between paletted surfaces map the colors through a lookup
+	byte lookupColors[256];
+	const byte *lookup = nullptr;
+	if (sizeof(TSRC) == 1 && sizeof(TDEST) == 1 && srcPalette && dstPalette &&
+			paletteLookups.get(lookupColors, srcPalette, dstPalette))
+		lookup = lookupColors;
 
 	// If we're dealing with a 32-bit source surface, we need to split up the RGB,
 	// since we'll want to find matching RGB pixels irrespective of the alpha
@@ -608,15 +723,19 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 	if (isSrcTrans32) {
 		src.format.colorToRGB(transColor, rst, gst, bst);
 	}
-	bool isDestTrans32 = dest.format.aBits() != 0 && dest.hasTransparentColor();
+	const bool hasDestTrans = dest.hasTransparentColor();
+	const uint32 destTransColor = hasDestTrans ? dest.getTransparentColor() : 0;
+	bool isDestTrans32 = dest.format.aBits() != 0 && hasDestTrans;
 	if (isDestTrans32) {
-		dest.format.colorToRGB(dest.getTransparentColor(), rdt, gdt, bdt);
+		dest.format.colorToRGB(destTransColor, rdt, gdt, bdt);
 	}
 
+	// Clip the drawn rows and columns to the destination up front
+	const int startX = MAX<int>(destRect.left, 0), endX = MIN<int>(destRect.right, dest.w);
+	const int startY = MAX<int>(destRect.top, 0), endY = MIN<int>(destRect.bottom, dest.h);
+
 	// Loop through drawing output lines
-	for (int destY = destRect.top, scaleYCtr = 0; destY < destRect.bottom; ++destY, scaleYCtr += scaleY) {
-		if (destY < 0 || destY >= dest.h)
-			continue;
+	for (int destY = startY, scaleYCtr = (startY - destRect.top) * scaleY; destY < endY; ++destY, scaleYCtr += scaleY) {
 		const TSRC *srcLine = (const TSRC *)src.getBasePtr(srcRect.left, scaleYCtr / SCALE_THRESHOLD + srcRect.top);
 		const TSRC *mskLine = nullptr;
 
@@ -626,23 +745,18 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 		TDEST *destLine = (TDEST *)dest.getBasePtr(destRect.left, destY);
 
 		// Loop through drawing the pixels of the row
-		for (int destX = destRect.left, xCtr = 0, scaleXCtr = 0; destX < destRect.right; ++destX, ++xCtr, scaleXCtr += scaleX) {
-			if (destX < 0 || destX >= dest.w)
-				continue;
-
+		for (int destX = startX, xCtr = startX - destRect.left, scaleXCtr = xCtr * scaleX; destX < endX; ++destX, ++xCtr, scaleXCtr += scaleX) {
 			TSRC srcVal = srcLine[flipped ? src.w - scaleXCtr / SCALE_THRESHOLD - 1 : scaleXCtr / SCALE_THRESHOLD];
 			TDEST &destVal = destLine[xCtr];
 
-			dest.format.colorToRGB(destVal, r, g, b);
-
 			// Check if dest pixel is transparent
 			bool isDestPixelTrans = false;
 			if (isDestTrans32) {
 				dest.format.colorToRGB(destVal, r, g, b);
 				if (rdt == r && gdt == g && bdt == b)
 					isDestPixelTrans = true;
-			} else if (dest.hasTransparentColor()) {
-				isDestPixelTrans = destVal == dest.getTransparentColor();
+			} else if (hasDestTrans) {
+				isDestPixelTrans = destVal == destTransColor;
 			}
 
 			if (isSrcTrans32 && !maskOnly) {
@@ -672,8 +786,36 @@ void transBlit(const Surface &src, const Common::Rect &srcRect, ManagedSurface &
 			}
 		}
 	}
+}
 
-	delete[] lookup;
+/**
+ * Draw an unscaled blit of opaque pixels with a color key, which is what
+ * most sprites need, without going through the per-pixel conversions.
+ */
+static void keyBlitFrom(const Surface &src, const Common::Rect &srcRect, ManagedSurface &dest,
+		const Common::Rect &destRect, uint32 transColor, const byte *lookup) {
+	Common::Rect clipped(destRect);
+	clipped.clip(Common::Rect(dest.w, dest.h));
+	if (clipped.isEmpty())
+		return;
+
+	const byte *srcP = (const byte *)src.getBasePtr(srcRect.left + clipped.left - destRect.left,
+		srcRect.top + clipped.top - destRect.top);
+	byte *destP = (byte *)dest.getBasePtr(clipped.left, clipped.top);
+	const uint bytesPerPixel = dest.format.bytesPerPixel;
+
+	if (!lookup) {
+		const uint32 key = bytesPerPixel == 1 ? (uint8)transColor : bytesPerPixel == 2 ? (uint16)transColor : transColor;
+		keyBlit(destP, srcP, dest.pitch, src.pitch, clipped.width(), clipped.height(), bytesPerPixel, key);
+		return;
+	}
+
+	for (int y = 0; y < clipped.height(); y++, srcP += src.pitch, destP += dest.pitch) {
+		for (int x = 0; x < clipped.width(); x++) {
+			if (srcP[x] != (uint8)transColor)
+				destP[x] = lookup[srcP[x]];
+		}
+	}
 }
 
 #define HANDLE_BLIT(SRC_BYTES, DEST_BYTES, SRC_TYPE, DEST_TYPE) \
@@ -692,6 +834,23 @@ void ManagedSurface::transBlitFromInner(const Surface &src, const Common::Rect &
 			error("Surface::transBlitFrom: mask dimensions do not match src");
 	}
 
+	if (!mask && !maskOnly && !flipped && srcRect.width() == destRect.width() && srcRect.height() == destRect.height()) {
+		// Paletted pixels are copied as they are, or through the palette lookup,
+		// and direct color pixels without alpha are always opaque
+		if (src.format.bytesPerPixel == 1 && format.bytesPerPixel == 1 && overrideColor == 0 && srcAlpha != 0) {
+			byte lookup[256];
+			const bool mapColors = srcPalette && dstPalette && paletteLookups.get(lookup, srcPalette, dstPalette);
+			keyBlitFrom(src, srcRect, *this, destRect, transColor, mapColors ? lookup : nullptr);
+			addDirtyRect(destRect);
+			return;
+		} else if ((format.bytesPerPixel == 2 || format.bytesPerPixel == 4) && src.format == format &&
+				format.aBits() == 0 && srcAlpha == 0xff) {
+			keyBlitFrom(src, srcRect, *this, destRect, transColor, nullptr);
+			addDirtyRect(destRect);
+			return;
+		}
+	}
+
 	HANDLE_BLIT(1, 1, uint8,  uint8)
 	HANDLE_BLIT(1, 2, uint8,  uint16)
 	HANDLE_BLIT(1, 4, uint8,  uint32)
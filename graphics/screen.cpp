@@ -26,36 +26,54 @@
 
 namespace Graphics {
 
-Screen::Screen(): ManagedSurface() {
+Screen::Screen(): ManagedSurface(),
+		_dirtyTracking(kDirtyRectList), _tileSize(16), _tileColumns(0), _tileRows(0),
+		_tileRowWords(0), _anyTileDirty(false) {
 	create(g_system->getWidth(), g_system->getHeight(), g_system->getScreenFormat());
 }
 
-Screen::Screen(int width, int height): ManagedSurface() {
+Screen::Screen(int width, int height): ManagedSurface(),
+		_dirtyTracking(kDirtyRectList), _tileSize(16), _tileColumns(0), _tileRows(0),
+		_tileRowWords(0), _anyTileDirty(false) {
 	create(width, height);
 }
 
-Screen::Screen(int width, int height, PixelFormat pixelFormat): ManagedSurface() {
+Screen::Screen(int width, int height, PixelFormat pixelFormat): ManagedSurface(),
+		_dirtyTracking(kDirtyRectList), _tileSize(16), _tileColumns(0), _tileRows(0),
+		_tileRowWords(0), _anyTileDirty(false) {
 	create(width, height, pixelFormat);
 }
 
 void Screen::update() {
-	// Merge the dirty rects
-	mergeDirtyRects();
+	_dirtyStats.updateCount++;
+
+	if (_dirtyTracking == kDirtyTiles) {
+		// Turn the dirty tiles into rects, which never overlap
+		flushDirtyTiles();
+	} else {
+		// Merge the dirty rects
+		mergeDirtyRects();
+	}
 
 	// Loop through copying dirty areas to the physical screen
 	Common::List<Common::Rect>::iterator i;
-	for (i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i) {
-		const Common::Rect &r = *i;
-		const byte *srcP = (const byte *)getBasePtr(r.left, r.top);
-		g_system->copyRectToScreen(srcP, pitch, r.left, r.top,
-			r.width(), r.height());
-	}
+	for (i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i)
+		copyRectToScreen(*i);
 
 	// Signal the physical screen to update
 	updateScreen();
 	_dirtyRects.clear();
 }
 
+void Screen::copyRectToScreen(const Common::Rect &r) {
+	_dirtyStats.uploadedArea += r.width() * r.height();
+	_dirtyStats.uploadCount++;
+
+	const byte *srcP = (const byte *)getBasePtr(r.left, r.top);
+	g_system->copyRectToScreen(srcP, pitch, r.left, r.top,
+		r.width(), r.height());
+}
+
 void Screen::updateScreen() {
 	// Update the screen
 	g_system->updateScreen();
@@ -66,10 +84,136 @@ void Screen::addDirtyRect(const Common::Rect &r) {
 	bounds.clip(getBounds());
 	bounds.translate(getOffsetFromOwner().x, getOffsetFromOwner().y);
 
-	if (bounds.width() > 0 && bounds.height() > 0)
+	if (bounds.width() <= 0 || bounds.height() <= 0)
+		return;
+
+	_dirtyStats.dirtiedArea += bounds.width() * bounds.height();
+
+	if (_dirtyTracking == kDirtyTiles)
+		markDirtyTiles(bounds);
+	else
 		_dirtyRects.push_back(bounds);
 }
 
+void Screen::clearDirtyRects() {
+	_dirtyRects.clear();
+
+	if (_anyTileDirty) {
+		Common::fill(_dirtyTiles.begin(), _dirtyTiles.end(), 0);
+		_anyTileDirty = false;
+	}
+}
+
+void Screen::setDirtyTracking(DirtyTracking tracking, int tileSize) {
+	assert(tileSize > 0);
+
+	// Keep any pending areas, turning the tiles into rects first
+	flushDirtyTiles();
+
+	_dirtyTracking = tracking;
+	if (_tileSize != tileSize) {
+		_tileSize = tileSize;
+		_tileColumns = _tileRows = 0;
+	}
+
+	if (tracking == kDirtyTiles) {
+		Common::List<Common::Rect>::iterator i;
+		for (i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i)
+			markDirtyTiles(*i);
+		_dirtyRects.clear();
+	}
+}
+
+void Screen::resizeDirtyTiles() {
+	_tileColumns = (this->w + _tileSize - 1) / _tileSize;
+	_tileRows = (this->h + _tileSize - 1) / _tileSize;
+	_tileRowWords = (_tileColumns + 31) / 32;
+
+	_dirtyTiles.clear();
+	_dirtyTiles.resize(_tileRows * _tileRowWords);
+	Common::fill(_dirtyTiles.begin(), _dirtyTiles.end(), 0);
+	_anyTileDirty = false;
+}
+
+void Screen::markDirtyTiles(const Common::Rect &r) {
+	if (_tileColumns != (this->w + _tileSize - 1) / _tileSize || _tileRows != (this->h + _tileSize - 1) / _tileSize)
+		resizeDirtyTiles();
+
+	Common::Rect bounds = r;
+	bounds.clip(getBounds());
+	if (bounds.isEmpty())
+		return;
+
+	// Set the bits of the touched tiles, a word at a time
+	const int left = bounds.left / _tileSize, right = (bounds.right - 1) / _tileSize;
+	const int top = bounds.top / _tileSize, bottom = (bounds.bottom - 1) / _tileSize;
+	for (int word = left / 32; word <= right / 32; word++) {
+		uint32 mask = 0xFFFFFFFF;
+		if (word == left / 32)
+			mask &= 0xFFFFFFFF << (left % 32);
+		if (word == right / 32)
+			mask &= 0xFFFFFFFF >> (31 - right % 32);
+
+		for (int row = top; row <= bottom; row++)
+			_dirtyTiles[row * _tileRowWords + word] |= mask;
+	}
+
+	_anyTileDirty = true;
+}
+
+void Screen::flushDirtyTiles() {
+	if (!_anyTileDirty)
+		return;
+
+	// Runs of dirty tiles from the rows above, which may still grow downwards
+	Common::Array<Common::Rect> open, runs;
+
+	for (int row = 0; row <= _tileRows; row++) {
+		runs.clear();
+
+		if (row < _tileRows) {
+			const uint32 *bits = &_dirtyTiles[row * _tileRowWords];
+			const int16 top = row * _tileSize, bottom = MIN<int>((row + 1) * _tileSize, this->h);
+
+			for (int col = 0; col < _tileColumns;) {
+				if (!bits[col / 32]) {
+					// Skip a whole word of clean tiles
+					col = (col / 32 + 1) * 32;
+					continue;
+				}
+				if (!(bits[col / 32] & (1u << (col % 32)))) {
+					col++;
+					continue;
+				}
+
+				const int start = col;
+				while (col < _tileColumns && (bits[col / 32] & (1u << (col % 32))))
+					col++;
+
+				runs.push_back(Common::Rect(start * _tileSize, top, MIN<int>(col * _tileSize, this->w), bottom));
+			}
+		}
+
+		// Runs spanning the same columns as a run in the row above extend it,
+		// while runs of the row above that did not continue are finished
+		uint run = 0;
+		for (uint i = 0; i < open.size(); i++) {
+			while (run < runs.size() && runs[run].left < open[i].left)
+				run++;
+
+			if (run < runs.size() && runs[run].left == open[i].left && runs[run].right == open[i].right)
+				runs[run].top = open[i].top;
+			else
+				_dirtyRects.push_back(open[i]);
+		}
+
+		open.swap(runs);
+	}
+
+	Common::fill(_dirtyTiles.begin(), _dirtyTiles.end(), 0);
+	_anyTileDirty = false;
+}
+
 void Screen::makeAllDirty() {
 	_dirtyRects.clear();
 	addDirtyRect(Common::Rect(0, 0, this->w, this->h));
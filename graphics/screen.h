@@ -24,6 +24,7 @@
 
 #include "graphics/managed_surface.h"
 #include "graphics/pixelformat.h"
+#include "common/array.h"
 #include "common/list.h"
 #include "common/rect.h"
 
@@ -48,17 +49,79 @@ namespace Graphics {
  * areas to the physical screen
  */
 class Screen : public ManagedSurface {
+public:
+	/**
+	 * How the affected areas of the screen are recorded
+	 */
+	enum DirtyTracking {
+		/**
+		 * Keep a list of rectangles, merged where they overlap on update.
+		 * Suits a few large areas per frame.
+		 */
+		kDirtyRectList,
+
+		/**
+		 * Mark the fixed size tiles the areas touch, and copy runs of dirty
+		 * tiles on update. Suits many small areas per frame.
+		 */
+		kDirtyTiles
+	};
+
+	/**
+	 * Counters comparing the areas marked dirty with the areas copied to the
+	 * physical screen. Areas marked more than once are counted each time.
+	 */
+	struct DirtyStats {
+		uint64 dirtiedArea;  ///< Pixels passed to addDirtyRect
+		uint64 uploadedArea; ///< Pixels copied to the physical screen
+		uint32 uploadCount;  ///< Calls to copyRectToScreen
+		uint32 updateCount;  ///< Calls to update
+
+		DirtyStats() : dirtiedArea(0), uploadedArea(0), uploadCount(0), updateCount(0) {}
+	};
 protected:
 	/**
 	 * List of affected areas of the screen
 	 */
 	Common::List<Common::Rect> _dirtyRects;
+
+	DirtyTracking _dirtyTracking;
+	DirtyStats _dirtyStats;
+
+	/**
+	 * Bitmap of the dirty tiles, with each row of tiles starting on a new word
+	 */
+	Common::Array<uint32> _dirtyTiles;
+	int _tileSize;
+	int _tileColumns, _tileRows, _tileRowWords;
+	bool _anyTileDirty;
 protected:
 	/**
 	 * Merges together overlapping dirty areas of the screen
 	 */
 	void mergeDirtyRects();
 
+	/**
+	 * Sizes the dirty tile bitmap for the current screen size
+	 */
+	void resizeDirtyTiles();
+
+	/**
+	 * Marks the tiles touched by an area of the screen as dirty
+	 */
+	void markDirtyTiles(const Common::Rect &r);
+
+	/**
+	 * Moves the dirty tiles to the dirty rect list, coalescing runs of dirty
+	 * tiles in a row, and identical runs in consecutive rows, into single rects
+	 */
+	void flushDirtyTiles();
+
+	/**
+	 * Copies an area of the screen to the physical screen
+	 */
+	virtual void copyRectToScreen(const Common::Rect &r);
+
 	/**
 	 * Returns the union of two dirty area rectangles
 	 */
@@ -71,7 +134,31 @@ public:
 	/**
 	 * Returns true if there are any pending screen updates (dirty areas)
 	 */
-	bool isDirty() const { return !_dirtyRects.empty(); }
+	bool isDirty() const { return !_dirtyRects.empty() || _anyTileDirty; }
+
+	/**
+	 * Selects how the affected areas of the screen are recorded. Any pending
+	 * dirty areas are kept.
+	 *
+	 * @param tracking	The tracking method
+	 * @param tileSize	The width and height of the tiles for kDirtyTiles
+	 */
+	void setDirtyTracking(DirtyTracking tracking, int tileSize = 16);
+
+	/**
+	 * Returns how the affected areas of the screen are recorded
+	 */
+	DirtyTracking getDirtyTracking() const { return _dirtyTracking; }
+
+	/**
+	 * Returns the counters of dirtied and uploaded areas since the last reset
+	 */
+	const DirtyStats &getDirtyStats() const { return _dirtyStats; }
+
+	/**
+	 * Resets the counters of dirtied and uploaded areas
+	 */
+	void resetDirtyStats() { _dirtyStats = DirtyStats(); }
 
 	/**
 	 * Marks the whole screen as dirty. This forces the next call to update
@@ -82,7 +169,7 @@ public:
 	/**
 	 * Clear the current dirty rects list
 	 */
-	virtual void clearDirtyRects() { _dirtyRects.clear(); }
+	virtual void clearDirtyRects();
 
 	/**
 	 * Adds a rectangle to the list of modified areas of the screen during the
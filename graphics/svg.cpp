@@ -20,6 +20,7 @@
 
 #include "graphics/svg.h"
 
+#include "common/crc.h"
 #include "common/endian.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
@@ -37,35 +38,203 @@
 
 namespace Graphics {
 
-SVGBitmap::SVGBitmap(Common::SeekableReadStream *in, int dw, int dh)
-	: ManagedSurface(dw, dh, PIXELFORMAT) {
-	if (dw == 0 || dh == 0)
-		return;
+#define SVG_BITMAPCACHE_TAG MKTAG('S', 'V', 'G', 'C')
+#define SVG_BITMAPCACHE_VERSION 1
 
-	int64 size = in->size();
+static char *readSVGData(Common::SeekableReadStream *in, int64 &size) {
+	size = in->size();
 	char *data = new char[size + 1];
 
 	in->read(data, size);
 	data[size] = '\0';
+	return data;
+}
 
+static void rasterizeSVG(char *data, Surface &dst) {
 	NSVGimage *svg = nsvgParse(data, "px", 96);
 	if (svg == NULL)
 		error("Cannot parse SVG image");
 
-	delete[] data;
-	data = nullptr;
-
 	// Maintain aspect ratio
-	float xRatio = 1.0f * dw / svg->width;
-	float yRatio = 1.0f * dh / svg->height;
+	float xRatio = 1.0f * dst.w / svg->width;
+	float yRatio = 1.0f * dst.h / svg->height;
 	float ratio = xRatio < yRatio ? xRatio : yRatio;
 
 	NSVGrasterizer *rasterizer = nsvgCreateRasterizer();
 
-	nsvgRasterize(rasterizer, svg, 0, 0, ratio, (byte *)getPixels(), dw, dh, pitch);
+	nsvgRasterize(rasterizer, svg, 0, 0, ratio, (byte *)dst.getPixels(), dst.w, dst.h, dst.pitch);
 
 	nsvgDeleteRasterizer(rasterizer);
 	nsvgDelete(svg);
 }
 
+SVGBitmap::SVGBitmap(Common::SeekableReadStream *in, int dw, int dh)
+	: ManagedSurface(dw, dh, PIXELFORMAT) {
+	if (dw == 0 || dh == 0)
+		return;
+
+	int64 size;
+	char *data = readSVGData(in, size);
+	rasterizeSVG(data, *surfacePtr());
+	delete[] data;
+}
+
+SVGBitmapCache::SVGBitmapCache(uint32 key) : _key(key), _modified(false) {
+}
+
+SVGBitmapCache::~SVGBitmapCache() {
+	clear();
+}
+
+void SVGBitmapCache::clear() {
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		i->_value->surface.free();
+		delete i->_value;
+	}
+	_entries.clear();
+	_modified = false;
+}
+
+static void writePixelFormat(Common::WriteStream &stream, const PixelFormat &format) {
+	stream.writeByte(format.bytesPerPixel);
+	stream.writeByte(format.rLoss);
+	stream.writeByte(format.gLoss);
+	stream.writeByte(format.bLoss);
+	stream.writeByte(format.aLoss);
+	stream.writeByte(format.rShift);
+	stream.writeByte(format.gShift);
+	stream.writeByte(format.bShift);
+	stream.writeByte(format.aShift);
+}
+
+static PixelFormat readPixelFormat(Common::SeekableReadStream &stream) {
+	PixelFormat format;
+	format.bytesPerPixel = stream.readByte();
+	format.rLoss = stream.readByte();
+	format.gLoss = stream.readByte();
+	format.bLoss = stream.readByte();
+	format.aLoss = stream.readByte();
+	format.rShift = stream.readByte();
+	format.gShift = stream.readByte();
+	format.bShift = stream.readByte();
+	format.aShift = stream.readByte();
+	return format;
+}
+
+bool SVGBitmapCache::load(Common::SeekableReadStream &stream) {
+	clear();
+
+	if (stream.readUint32BE() != SVG_BITMAPCACHE_TAG)
+		return false;
+	if (stream.readUint32BE() != SVG_BITMAPCACHE_VERSION)
+		return false;
+	if (stream.readUint32BE() != _key)
+		return false;
+	if (readPixelFormat(stream) != PIXELFORMAT)
+		return false;
+
+	const uint32 count = stream.readUint32BE();
+
+	for (uint32 i = 0; i < count; ++i) {
+		const uint16 nameLength = stream.readUint16BE();
+		Common::String name = stream.readString(0, nameLength);
+
+		Entry *entry = new Entry;
+		entry->checksum = stream.readUint32BE();
+		entry->used = false;
+		const uint16 w = stream.readUint16BE();
+		const uint16 h = stream.readUint16BE();
+
+		if (stream.err() || stream.eos() || name.size() != nameLength ||
+				(int64)w * h * PIXELFORMAT.bytesPerPixel > stream.size() - stream.pos()) {
+			delete entry;
+			clear();
+			return false;
+		}
+
+		entry->surface.create(w, h, PIXELFORMAT);
+		for (int y = 0; y < h; ++y)
+			stream.read(entry->surface.getBasePtr(0, y), w * PIXELFORMAT.bytesPerPixel);
+
+		delete _entries.getValOrDefault(name);
+		_entries[name] = entry;
+	}
+
+	if (stream.err() || stream.eos()) {
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool SVGBitmapCache::save(Common::WriteStream &stream) {
+	// Drop the entries which were loaded but not used since, like the images
+	// of icons the theme no longer has, so the file does not keep growing
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (!i->_value->used) {
+			i->_value->surface.free();
+			delete i->_value;
+			_entries.erase(i);
+		}
+	}
+
+	stream.writeUint32BE(SVG_BITMAPCACHE_TAG);
+	stream.writeUint32BE(SVG_BITMAPCACHE_VERSION);
+	stream.writeUint32BE(_key);
+	writePixelFormat(stream, PIXELFORMAT);
+	stream.writeUint32BE(_entries.size());
+
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		const Surface &surface = i->_value->surface;
+
+		stream.writeUint16BE(i->_key.size());
+		stream.writeString(i->_key);
+		stream.writeUint32BE(i->_value->checksum);
+		stream.writeUint16BE(surface.w);
+		stream.writeUint16BE(surface.h);
+		for (int y = 0; y < surface.h; ++y)
+			stream.write(surface.getBasePtr(0, y), surface.w * surface.format.bytesPerPixel);
+	}
+
+	if (!stream.flush() || stream.err())
+		return false;
+
+	_modified = false;
+	return true;
+}
+
+ManagedSurface *SVGBitmapCache::createBitmap(const Common::String &name, Common::SeekableReadStream *in, int dw, int dh) {
+	if (dw == 0 || dh == 0)
+		return new ManagedSurface(dw, dh, PIXELFORMAT);
+
+	int64 size;
+	char *data = readSVGData(in, size);
+
+	Common::CRC32 crc;
+	const uint32 checksum = crc.crcFast((const byte *)data, size);
+
+	const Common::String key = Common::String::format("%s@%dx%d", name.c_str(), dw, dh);
+	Entry *entry = _entries.getValOrDefault(key);
+
+	if (!entry || entry->checksum != checksum) {
+		if (!entry) {
+			entry = new Entry;
+			_entries[key] = entry;
+		}
+
+		entry->checksum = checksum;
+		entry->surface.create(dw, dh, PIXELFORMAT);
+		rasterizeSVG(data, entry->surface);
+		_modified = true;
+	}
+
+	entry->used = true;
+	delete[] data;
+
+	ManagedSurface *surf = new ManagedSurface();
+	surf->copyFrom(entry->surface);
+	return surf;
+}
+
 } // end of namespace Graphics
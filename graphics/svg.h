@@ -21,10 +21,13 @@
 #ifndef GRAPHICS_SVG_H
 #define GRAPHICS_SVG_H
 
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "graphics/managed_surface.h"
 
 namespace Common {
 class SeekableReadStream;
+class WriteStream;
 }
 
 namespace Graphics {
@@ -37,6 +40,61 @@ public:
 	SVGBitmap(Common::SeekableReadStream *in, int dw, int dh);
 };
 
+/**
+ * A cache of rasterized SVG images, which can be stored in a file so the
+ * images do not have to be rasterized again the next time they are needed.
+ *
+ * Entries are looked up by name and size, and are only used as long as the
+ * SVG data has the same checksum as when the entry was rasterized. The
+ * file contains a caller provided key and the pixel format of the images,
+ * a file with a different key or format is rejected as a whole.
+ */
+class SVGBitmapCache {
+public:
+	SVGBitmapCache(uint32 key);
+	~SVGBitmapCache();
+
+	void clear();
+	uint size() const { return _entries.size(); }
+
+	/** Returns true if entries have been added since the cache was loaded or saved. */
+	bool isModified() const { return _modified; }
+
+	/**
+	 * Loads the entries stored by save().
+	 *
+	 * Returns false, leaving the cache empty, if the stream does not
+	 * contain a valid cache for the key and pixel format.
+	 */
+	bool load(Common::SeekableReadStream &stream);
+
+	/**
+	 * Stores the entries in a stream. Loaded entries which were not used by
+	 * createBitmap() since are dropped first.
+	 */
+	bool save(Common::WriteStream &stream);
+
+	/**
+	 * Returns a new surface with the SVG image from @p in rendered at the
+	 * given size. The image is rasterized and added to the cache, unless
+	 * the cache already contains it.
+	 */
+	ManagedSurface *createBitmap(const Common::String &name, Common::SeekableReadStream *in, int dw, int dh);
+
+private:
+	struct Entry {
+		uint32 checksum;
+		bool used;
+		Surface surface;
+	};
+
+	typedef Common::HashMap<Common::String, Entry *> EntryMap;
+
+	uint32 _key;
+	EntryMap _entries;
+	bool _modified;
+};
+
 } // end of namespace Graphics
 
 #endif // GRAPHICS_SVG_H
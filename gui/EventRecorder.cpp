@@ -33,6 +33,7 @@ DECLARE_SINGLETON(GUI::EventRecorder);
 #include "backends/mixer/mixer.h"
 #include "common/config-manager.h"
 #include "common/md5.h"
+#include "common/algorithm.h"
 #include "gui/gui-manager.h"
 #include "gui/widget.h"
 #include "gui/onscreendialog.h"
@@ -49,6 +50,20 @@ namespace GUI {
 const int kMaxRecordsNames = 0x64;
 const int kDefaultScreenshotPeriod = 60000;
 
+/**
+ * Real time in microseconds. The regular OSystem clock is replaced by the
+ * recorded one during playback, so benchmark timings have to bypass it.
+ */
+static uint64 getRealMicros() {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+	const uint64 counter = SDL_GetPerformanceCounter();
+	const uint64 frequency = SDL_GetPerformanceFrequency();
+	return (counter / frequency) * 1000000 + (counter % frequency) * 1000000 / frequency;
+#else
+	return (uint64)SDL_GetTicks() * 1000;
+#endif
+}
+
 EventRecorder::EventRecorder() {
 	_timerManager = nullptr;
 	_recordMode = kPassthrough;
@@ -78,6 +93,8 @@ EventRecorder::EventRecorder() {
 	_screenshotPeriod = 0;
 	_playbackFile = nullptr;
 	_recordFile = nullptr;
+	_benchmark = false;
+	resetBenchmarkStats();
 }
 
 EventRecorder::~EventRecorder() {
@@ -96,6 +113,11 @@ void EventRecorder::deinit() {
 	_fakeMixerManager = nullptr;
 	_controlPanel->close();
 	delete _controlPanel;
+	if (_benchmark) {
+		printBenchmarkReport();
+		_benchmark = false;
+		_fastPlayback = false;
+	}
 	debugC(1, kDebugLevelEventRec, "playback:action=stopplayback");
 	Common::EventDispatcher *eventDispatcher = g_system->getEventManager()->getEventDispatcher();
 	eventDispatcher->unregisterSource(this);
@@ -256,6 +278,9 @@ void EventRecorder::processScreenUpdate() {
 		break;
 	case kRecorderUpdate: // fallthrough
 	case kRecorderPlayback:
+		if (_benchmark) {
+			benchmarkFrame();
+		}
 		// if the next event isn't a screen update, fast forward until we find one.
 		if (_nextEvent.recordedtype != Common::kRecorderEventTypeScreenUpdate) {
 			int numSkipped = 0;
@@ -380,7 +405,7 @@ Common::String EventRecorder::generateRecordFileName(const Common::String &targe
 }
 
 
-void EventRecorder::init(const Common::String &recordFileName, RecordMode mode) {
+void EventRecorder::init(const Common::String &recordFileName, RecordMode mode, bool benchmark) {
 	_fakeMixerManager = new NullMixerManager();
 	_fakeMixerManager->init();
 	_fakeMixerManager->suspendAudio();
@@ -393,6 +418,14 @@ void EventRecorder::init(const Common::String &recordFileName, RecordMode mode)
 		DebugMan.enableDebugChannel("EventRec");
 		gDebugLevel = 1;
 	}
+	_benchmark = benchmark && (_recordMode == kRecorderPlayback);
+	if (_benchmark) {
+		// Replay headless and without any real-time waits
+		_fastPlayback = true;
+		ConfMan.setBool("disable_display", true, ConfMan.kTransientDomain);
+		resetBenchmarkStats();
+		debugC(1, kDebugLevelEventRec, "playback:action=\"Start benchmark\" filename=%s", recordFileName.c_str());
+	}
 	if ((_recordMode == kRecorderPlayback) || (_recordMode == kRecorderUpdate)) {
 		debugC(1, kDebugLevelEventRec, "playback:action=\"Load file\" filename=%s", recordFileName.c_str());
 		Common::EventDispatcher *eventDispatcher = g_system->getEventManager()->getEventDispatcher();
@@ -571,7 +604,13 @@ void EventRecorder::updateSubsystems() {
 	}
 	RecordMode oldRecordMode = _recordMode;
 	_recordMode = kPassthrough;
-	_fakeMixerManager->update();
+	if (_benchmark) {
+		const uint64 audioStart = getRealMicros();
+		_fakeMixerManager->update();
+		_benchmarkStats.frameAudioTime += getRealMicros() - audioStart;
+	} else {
+		_fakeMixerManager->update();
+	}
 	_recordMode = oldRecordMode;
 }
 
@@ -645,6 +684,78 @@ void EventRecorder::processGameDescription(const ADGameDescription *desc) {
 	}
 }
 
+void EventRecorder::processPlaybackEnd() {
+	if (!_benchmark) {
+		return;
+	}
+	printBenchmarkReport();
+	if (_playbackFile->getMismatchedScreenshotsCount() != 0) {
+		// Let CI runs notice that the replay diverged from the recording
+		g_system->fatalError();
+	}
+}
+
+void EventRecorder::resetBenchmarkStats() {
+	_benchmarkStats.frameTimes.clear();
+	_benchmarkStats.frameStart = 0;
+	_benchmarkStats.graphicsStart = 0;
+	_benchmarkStats.frameGraphicsTime = 0;
+	_benchmarkStats.frameAudioTime = 0;
+	_benchmarkStats.engineTime = 0;
+	_benchmarkStats.graphicsTime = 0;
+	_benchmarkStats.audioTime = 0;
+	_benchmarkStats.reported = false;
+}
+
+void EventRecorder::benchmarkFrame() {
+	const uint64 now = getRealMicros();
+	// The first interval covers engine startup, so it is not counted as a frame
+	if (_benchmarkStats.frameStart != 0) {
+		const uint64 frameTime = now - _benchmarkStats.frameStart;
+		const uint64 subsystemsTime = _benchmarkStats.frameGraphicsTime + _benchmarkStats.frameAudioTime;
+		_benchmarkStats.frameTimes.push_back((uint32)MIN<uint64>(frameTime, 0xFFFFFFFF));
+		_benchmarkStats.graphicsTime += _benchmarkStats.frameGraphicsTime;
+		_benchmarkStats.audioTime += _benchmarkStats.frameAudioTime;
+		if (frameTime > subsystemsTime) {
+			_benchmarkStats.engineTime += frameTime - subsystemsTime;
+		}
+	}
+	_benchmarkStats.frameGraphicsTime = 0;
+	_benchmarkStats.frameAudioTime = 0;
+	_benchmarkStats.frameStart = now;
+}
+
+static uint32 getPercentile(const Common::Array<uint32> &sorted, uint percent) {
+	return sorted[MIN<uint>(sorted.size() - 1, sorted.size() * percent / 100)];
+}
+
+void EventRecorder::printBenchmarkReport() {
+	if (_benchmarkStats.reported) {
+		return;
+	}
+	_benchmarkStats.reported = true;
+
+	const uint checked = _playbackFile ? _playbackFile->getCheckedScreenshotsCount() : 0;
+	const uint mismatched = _playbackFile ? _playbackFile->getMismatchedScreenshotsCount() : 0;
+	debug("benchmark:checksums checked=%u mismatched=%u result=%s", checked, mismatched, mismatched ? "fail" : "success");
+
+	if (_benchmarkStats.frameTimes.empty()) {
+		warning("benchmark: no frames were replayed");
+		return;
+	}
+
+	Common::Array<uint32> sorted = _benchmarkStats.frameTimes;
+	Common::sort(sorted.begin(), sorted.end());
+	const uint64 totalTime = _benchmarkStats.engineTime + _benchmarkStats.graphicsTime + _benchmarkStats.audioTime;
+	debug("benchmark:frames count=%u recorded_ms=%u", sorted.size(), (uint32)_fakeTimer);
+	debug("benchmark:frametime_us p50=%u p90=%u p95=%u p99=%u max=%u",
+	      getPercentile(sorted, 50), getPercentile(sorted, 90), getPercentile(sorted, 95),
+	      getPercentile(sorted, 99), sorted.back());
+	debug("benchmark:time_ms total=%.3f engine=%.3f graphics=%.3f audio=%.3f",
+	      totalTime / 1000.0, _benchmarkStats.engineTime / 1000.0,
+	      _benchmarkStats.graphicsTime / 1000.0, _benchmarkStats.audioTime / 1000.0);
+}
+
 void EventRecorder::deleteRecord(const Common::String& fileName) {
 	g_system->getSavefileManager()->removeSavefile(fileName);
 }
@@ -699,6 +810,13 @@ Common::SaveFileManager *EventRecorder::getSaveManager(Common::SaveFileManager *
 }
 
 void EventRecorder::preDrawOverlayGui() {
+	if (_benchmark) {
+		// No on-screen controls while benchmarking, only time the backend update
+		if (_initialized) {
+			_benchmarkStats.graphicsStart = getRealMicros();
+		}
+		return;
+	}
 	if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -716,6 +834,13 @@ void EventRecorder::preDrawOverlayGui() {
 }
 
 void EventRecorder::postDrawOverlayGui() {
+	if (_benchmark) {
+		if (_initialized && _benchmarkStats.graphicsStart != 0) {
+			_benchmarkStats.frameGraphicsTime += getRealMicros() - _benchmarkStats.graphicsStart;
+			_benchmarkStats.graphicsStart = 0;
+		}
+		return;
+	}
 	if ((_initialized) || (_needRedraw)) {
 		RecordMode oldMode = _recordMode;
 		_recordMode = kPassthrough;
@@ -77,7 +77,7 @@ public:
 		kRecorderUpdate = 4			/**< kRecorderUpdate, playback existing recording and update all hashes */
 	};
 
-	void init(const Common::String &recordFileName, RecordMode mode);
+	void init(const Common::String &recordFileName, RecordMode mode, bool benchmark = false);
 	void deinit();
 	bool processDelayMillis();
 	uint32 getRandomSeed(const Common::String &name);
@@ -85,6 +85,7 @@ public:
 	void processMillis(uint32 &millis, bool skipRecord);
 	void processScreenUpdate();
 	void processGameDescription(const ADGameDescription *desc);
+	void processPlaybackEnd();
 	bool processAutosave();
 	Common::SeekableReadStream *processSaveStream(const Common::String & fileName);
 
@@ -173,6 +174,11 @@ public:
 		return _recordMode;
 	}
 
+	/** Whether the current playback is a headless, time-accelerated benchmark run */
+	bool isBenchmark() const {
+		return _benchmark;
+	}
+
 	Common::StringArray listSaveFiles(const Common::String &pattern);
 	Common::String generateRecordFileName(const Common::String &target);
 
@@ -249,6 +255,29 @@ private:
 	bool _fastPlayback;
 	bool _needRedraw;
 	bool _processingMillis;
+
+	/**
+	 * Timings gathered while replaying a recording in benchmark mode.
+	 * All values are in microseconds of real (not recorded) time.
+	 */
+	struct BenchmarkStats {
+		Common::Array<uint32> frameTimes;
+		uint64 frameStart;
+		uint64 graphicsStart;
+		uint64 frameGraphicsTime;
+		uint64 frameAudioTime;
+		uint64 engineTime;
+		uint64 graphicsTime;
+		uint64 audioTime;
+		bool reported;
+	};
+
+	bool _benchmark;
+	BenchmarkStats _benchmarkStats;
+
+	void resetBenchmarkStats();
+	void benchmarkFrame();
+	void printBenchmarkReport();
 };
 
 } // End of namespace GUI
@@ -21,6 +21,7 @@
 
 #include "common/system.h"
 #include "common/config-manager.h"
+#include "common/crc.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/compression/unzip.h"
@@ -189,7 +190,7 @@ ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(nullptr), _vectorRenderer(nullptr),
 	_layerToDraw(kDrawLayerBackground), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
 	_font(nullptr), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
-	_cursor(nullptr), _scaleFactor(1.0f) {
+	_cursor(nullptr), _scaleFactor(1.0f), _bitmapCache(nullptr) {
 
 	_baseWidth = 640;	// Default sane values
 	_baseHeight = 480;
@@ -652,7 +653,10 @@ bool ThemeEngine::addBitmap(const Common::String &filename, const Common::String
 		for (Common::ArchiveMemberList::const_iterator i = members.begin(), end = members.end(); i != end; ++i) {
 			Common::SeekableReadStream *stream = (*i)->createReadStream();
 			if (stream) {
-				_bitmaps[filename] = new Graphics::SVGBitmap(stream, width * _scaleFactor, height * _scaleFactor);
+				if (_bitmapCache)
+					_bitmaps[filename] = _bitmapCache->createBitmap(scalablefile, stream, width * _scaleFactor, height * _scaleFactor);
+				else
+					_bitmaps[filename] = new Graphics::SVGBitmap(stream, width * _scaleFactor, height * _scaleFactor);
 				delete stream;
 				return true;
 			}
@@ -878,27 +882,69 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 		return false;
 	}
 
+	// Reuse the SVG images rasterized the last time this theme was loaded at
+	// this scale. The cache is kept next to the icons rather than with the
+	// saves, so it is neither synced to the cloud nor listed with the saves.
+	// There is one file per scale factor, and each only holds the images of
+	// the last load, so switching scales back and forth stays warm.
+	Common::FSNode cacheNode;
+	Common::Path iconsPath = ConfMan.getPath("iconspath");
+	if (!iconsPath.empty()) {
+		Common::String cacheKey = themeId + stxHeader;
+		Common::CRC32 crc;
+		_bitmapCache = new Graphics::SVGBitmapCache(crc.crcFast((const byte *)cacheKey.c_str(), cacheKey.size()));
+
+		Common::String cacheFilename = Common::String::format("scummvm-theme-%s-%d.cache", _themeId.c_str(), (int)(_scaleFactor * 100 + 0.5f));
+		cacheNode = Common::FSNode(iconsPath).getChild(cacheFilename);
+		Common::SeekableReadStream *cacheFile = cacheNode.exists() ? cacheNode.createReadStream() : nullptr;
+		if (cacheFile) {
+			if (!_bitmapCache->load(*cacheFile))
+				debug(6, "Discarding outdated theme cache '%s'", cacheFilename.c_str());
+			delete cacheFile;
+		}
+	}
+
 	//
 	// Loop over all STX files, load and parse them
 	//
+	bool result = true;
 	for (Common::ArchiveMemberList::iterator i = members.begin(); i != members.end(); ++i) {
 		assert((*i)->getName().hasSuffix(".stx"));
 
 		if (_parser->loadStream((*i)->createReadStream()) == false) {
 			warning("Failed to load STX file '%s'", (*i)->getName().c_str());
 			_parser->close();
-			return false;
+			result = false;
+			break;
 		}
 
 		if (_parser->parse() == false) {
 			warning("Failed to parse STX file '%s'", (*i)->getName().c_str());
 			_parser->close();
-			return false;
+			result = false;
+			break;
 		}
 
 		_parser->close();
 	}
 
+	if (result && _bitmapCache && _bitmapCache->isModified()) {
+		Common::SeekableWriteStream *cacheFile = cacheNode.createWriteStream(true);
+		if (cacheFile) {
+			_bitmapCache->save(*cacheFile);
+			cacheFile->finalize();
+			if (cacheFile->err())
+				warning("Couldn't write theme cache '%s'", cacheNode.getPath().toString(Common::Path::kNativeSeparator).c_str());
+			delete cacheFile;
+		}
+	}
+
+	delete _bitmapCache;
+	_bitmapCache = nullptr;
+
+	if (!result)
+		return false;
+
 	assert(!_themeName.empty());
 	return true;
 }
@@ -42,6 +42,7 @@ class OSystem;
 
 namespace Graphics {
 struct DrawStep;
+class SVGBitmapCache;
 class VectorRenderer;
 }
 
@@ -800,6 +801,8 @@ protected:
 	Common::Array<LangExtraFont> _langExtraFonts;
 
 	ImagesMap _bitmaps;
+	/** Rasterized SVG images of the theme, only available while the theme is loaded. */
+	Graphics::SVGBitmapCache *_bitmapCache;
 	Graphics::PixelFormat _overlayFormat;
 	Graphics::PixelFormat _cursorFormat;
 
@@ -26,6 +26,7 @@
 #include "common/debug.h"
 #include "common/debug-channels.h"
 #include "common/system.h"
+#include "common/timer.h"
 
 #ifndef DISABLE_MD5
 #include "common/md5.h"
@@ -76,6 +77,7 @@ Debugger::Debugger() {
 	registerCmd("clear",			WRAP_METHOD(Debugger, cmdClearLog));
 	registerCmd("cls",			WRAP_METHOD(Debugger, cmdClearLog)); // alias
 	registerCmd("exec",				WRAP_METHOD(Debugger, cmdExecFile));
+	registerCmd("timers",			WRAP_METHOD(Debugger, cmdTimers));
 
 	registerCmd("debuglevel",		WRAP_METHOD(Debugger, cmdDebugLevel));
 	registerCmd("debugflag_list",		WRAP_METHOD(Debugger, cmdDebugFlagsList));
@@ -796,6 +798,33 @@ bool Debugger::cmdDebugFlagsList(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmdTimers(int argc, const char **argv) {
+	Common::Array<Common::TimerManager::TimerStats> timers;
+	g_system->getTimerManager()->getTimerStats(timers);
+
+	if (timers.empty()) {
+		debugPrintf("No timer statistics\n");
+		return true;
+	}
+
+	debugPrintf("Timer lateness, in invocations up to the given microseconds:\n");
+	for (uint i = 0; i < timers.size(); i++) {
+		const Common::TimerManager::TimerStats &timer = timers[i];
+		debugPrintf("%s: every %d us, %u calls, average %u us, max %u us\n", timer.id.c_str(), timer.interval, timer.invocations,
+				timer.invocations ? (uint)(timer.totalLateness / timer.invocations) : 0, timer.maxLateness);
+
+		Common::String histogram;
+		for (int j = 0; j < Common::TimerManager::kLatenessBuckets; j++) {
+			if (j < Common::TimerManager::kLatenessBuckets - 1)
+				histogram += Common::String::format(" <=%u: %u", Common::TimerManager::getLatenessBucketLimit(j), timer.latenessHistogram[j]);
+			else
+				histogram += Common::String::format(" more: %u", timer.latenessHistogram[j]);
+		}
+		debugPrintf(" %s\n", histogram.c_str());
+	}
+	return true;
+}
+
 bool Debugger::cmdDebugFlagEnable(int argc, const char **argv) {
 	if (argc < 2) {
 		debugPrintf("debugflag_enable [<flag> | all]\n");
@@ -0,0 +1,223 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "gui/filterindex.h"
+
+#include "common/tokenizer.h"
+
+namespace GUI {
+
+FilterIndex::FilterIndex() : _fieldGetter(nullptr), _fieldGetterArg(nullptr), _lastQueryValid(false) {
+}
+
+void FilterIndex::clear() {
+	_texts.clear();
+	_fields.clear();
+	_lastQueryValid = false;
+	_matches.clear();
+}
+
+void FilterIndex::setEntries(const Common::U32StringArray &texts) {
+	clear();
+
+	_texts.reserve(texts.size());
+	for (uint i = 0; i < texts.size(); ++i)
+		addEntry(texts[i]);
+}
+
+void FilterIndex::addEntry(const Common::U32String &text) {
+	Common::U32String lowered(text);
+	lowered.toLowercase();
+	_texts.push_back(lowered);
+
+	// The new entry was not part of the previous result
+	_lastQueryValid = false;
+}
+
+void FilterIndex::setFieldGetter(FieldGetter getter, void *arg, const Common::StringArray &fieldNames) {
+	_fieldGetter = getter;
+	_fieldGetterArg = arg;
+	_fieldNames = fieldNames;
+	invalidateFields();
+}
+
+void FilterIndex::invalidateFields() {
+	_fields.clear();
+	_lastQueryValid = false;
+}
+
+Common::String FilterIndex::expandKey(const Common::String &key) const {
+	if (key.empty())
+		return key;
+
+	for (uint i = 0; i < _fieldNames.size(); ++i) {
+		if (_fieldNames[i].hasPrefix(key))
+			return _fieldNames[i];
+	}
+
+	return key;
+}
+
+void FilterIndex::compile(const Common::U32String &query, Query &tokens) const {
+	Common::U32StringTokenizer tok(query);
+
+	tokens.clear();
+	while (!tok.empty()) {
+		Token token;
+		token.text = tok.nextToken();
+
+		if (_fieldGetter) {
+			while (token.text.size() && token.text[0] == '!') {
+				token.text = token.text.substr(1);
+				token.invert = !token.invert;
+			}
+
+			Common::String text8 = token.text;
+			size_t pos = text8.findFirstOf(":=~");
+			if (pos != text8.npos) {
+				if (text8[pos] == ':')
+					token.type = kTokenContains;
+				else if (text8[pos] == '=')
+					token.type = kTokenEquals;
+				else
+					token.type = kTokenMatches;
+
+				token.key = expandKey(text8.substr(0, pos));
+				token.value = text8.substr(pos + 1);
+			}
+		}
+
+		tokens.push_back(token);
+	}
+}
+
+const Common::StringArray &FilterIndex::getFieldValues(const Common::String &key) {
+	Common::StringArray &values = _fields[key];
+
+	// Entries may have been added since the field was last used
+	values.reserve(_texts.size());
+	for (uint idx = values.size(); idx < _texts.size(); ++idx) {
+		Common::String value = _fieldGetter(_fieldGetterArg, idx, key);
+		value.toLowercase();
+		values.push_back(value);
+	}
+
+	return values;
+}
+
+bool FilterIndex::matches(uint idx, const Query &query) const {
+	for (uint i = 0; i < query.size(); ++i) {
+		const Token &token = query[i];
+		bool result = false;
+
+		switch (token.type) {
+		case kTokenText:
+			result = _texts[idx].contains(token.text);
+			break;
+		case kTokenContains:
+			result = (*token.fieldValues)[idx].contains(token.value);
+			break;
+		case kTokenEquals:
+			result = (*token.fieldValues)[idx] == token.value;
+			break;
+		case kTokenMatches:
+			result = (*token.fieldValues)[idx].matchString(token.value);
+			break;
+		}
+
+		if (result == token.invert)
+			return false;
+	}
+
+	return true;
+}
+
+bool FilterIndex::isNarrowing(const Query &oldQuery, const Query &newQuery) {
+	// Additional tokens can only remove entries
+	if (newQuery.size() < oldQuery.size())
+		return false;
+
+	for (uint i = 0; i < oldQuery.size(); ++i) {
+		const Token &oldToken = oldQuery[i];
+		const Token &newToken = newQuery[i];
+
+		if (oldToken.type != newToken.type || oldToken.invert != newToken.invert || oldToken.key != newToken.key)
+			return false;
+
+		if (oldToken.type == kTokenText ? oldToken.text == newToken.text : oldToken.value == newToken.value)
+			continue;
+
+		// A substring search for a longer string only matches a subset of
+		// the entries, as long as the token is not inverted. Only the token
+		// being typed can change that way.
+		if (oldToken.invert || i != oldQuery.size() - 1)
+			return false;
+
+		if (oldToken.type == kTokenText && newToken.text.contains(oldToken.text))
+			continue;
+		if (oldToken.type == kTokenContains && newToken.value.contains(oldToken.value))
+			continue;
+
+		return false;
+	}
+
+	return true;
+}
+
+const Common::Array<int> &FilterIndex::filter(const Common::U32String &query) {
+	Common::U32String lowered(query);
+	lowered.toLowercase();
+
+	Query tokens;
+	compile(lowered, tokens);
+
+	// Fetch all the fields first, the value arrays do not move afterwards
+	for (uint i = 0; i < tokens.size(); ++i) {
+		if (tokens[i].type != kTokenText)
+			getFieldValues(tokens[i].key);
+	}
+	for (uint i = 0; i < tokens.size(); ++i) {
+		if (tokens[i].type != kTokenText)
+			tokens[i].fieldValues = &_fields[tokens[i].key];
+	}
+
+	if (_lastQueryValid && isNarrowing(_lastQuery, tokens)) {
+		uint count = 0;
+		for (uint i = 0; i < _matches.size(); ++i) {
+			if (matches(_matches[i], tokens))
+				_matches[count++] = _matches[i];
+		}
+		_matches.resize(count);
+	} else {
+		_matches.clear();
+		for (uint idx = 0; idx < _texts.size(); ++idx) {
+			if (matches(idx, tokens))
+				_matches.push_back(idx);
+		}
+	}
+
+	_lastQuery = tokens;
+	_lastQueryValid = true;
+
+	return _matches;
+}
+
+} // End of namespace GUI
@@ -0,0 +1,117 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GUI_FILTERINDEX_H
+#define GUI_FILTERINDEX_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+#include "common/str-array.h"
+#include "common/ustr.h"
+
+namespace GUI {
+
+/**
+ * Search index used by the list and grid widgets to filter their entries.
+ *
+ * The entries are lowercased once when they are added, so filtering only
+ * has to compare the tokens of the query. A query is a list of whitespace
+ * separated tokens which all have to match. Plain tokens are searched in
+ * the entry text.
+ *
+ * When a field getter is set, tokens may also have the form "key:value"
+ * (contains), "key=value" (equals) or "key~pattern" (wildcard match), and
+ * a leading '!' inverts a token. Keys are expanded from any prefix of one
+ * of the field names. The field values are fetched from the getter the
+ * first time a key is used, and cached until invalidateFields() is called.
+ *
+ * While the user keeps typing, each query usually only restricts the
+ * previous one further. In that case only the previous matches are
+ * checked again instead of the whole index.
+ */
+class FilterIndex {
+public:
+	/**
+	 * Returns the value of the field @p key for the entry @p idx.
+	 */
+	typedef Common::String (*FieldGetter)(void *arg, int idx, const Common::String &key);
+
+	FilterIndex();
+
+	void clear();
+	void setEntries(const Common::U32StringArray &texts);
+	void addEntry(const Common::U32String &text);
+	uint size() const { return _texts.size(); }
+
+	void setFieldGetter(FieldGetter getter, void *arg, const Common::StringArray &fieldNames);
+	void invalidateFields();
+
+	/**
+	 * Returns the indices of all entries matching @p query, in ascending
+	 * order. The result stays valid until the next call modifying the index.
+	 */
+	const Common::Array<int> &filter(const Common::U32String &query);
+
+private:
+	enum TokenType {
+		kTokenText,
+		kTokenContains,
+		kTokenEquals,
+		kTokenMatches
+	};
+
+	struct Token {
+		TokenType type;
+		bool invert;
+		Common::U32String text;
+		Common::String key;
+		Common::String value;
+		const Common::StringArray *fieldValues;
+
+		Token() : type(kTokenText), invert(false), fieldValues(nullptr) {}
+	};
+
+	typedef Common::Array<Token> Query;
+	typedef Common::HashMap<Common::String, Common::StringArray> FieldMap;
+
+	void compile(const Common::U32String &query, Query &tokens) const;
+	Common::String expandKey(const Common::String &key) const;
+	const Common::StringArray &getFieldValues(const Common::String &key);
+	bool matches(uint idx, const Query &query) const;
+	static bool isNarrowing(const Query &oldQuery, const Query &newQuery);
+
+	Common::U32StringArray _texts;
+
+	FieldGetter _fieldGetter;
+	void *_fieldGetterArg;
+	Common::StringArray _fieldNames;
+	FieldMap _fields;
+
+	Query _lastQuery;
+	bool _lastQueryValid;
+	Common::Array<int> _matches;
+};
+
+} // End of namespace GUI
+
+#endif
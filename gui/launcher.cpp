@@ -126,54 +126,14 @@ static Common::String buildQualifiedGameName(const Common::String &engineId, con
 	return Common::String::format("%s:%s", engineId.c_str(), gameId.c_str());
 }
 
-bool LauncherFilterMatcher(void *boss, int idx, const Common::U32String &item, const Common::U32String &token_) {
-	bool invert = false;
-	Common::U32String token(token_);
-
-	while (token.size() && token[0] == '!') {
-		token = token.substr(1);
-		invert = !invert;
-	}
-
-	bool result = false;
-	Common::String token8 = token;
-	size_t pos = token8.findFirstOf(":=~");
-	if (pos != token8.npos) {
-		Common::String key = token8.substr(0, token8.findFirstOf(token8[pos]));
-		Common::String filter = token8.substr(token8.findFirstOf(token8[pos]) + 1);
-
-		if (key.size()) {
-			if (Common::String("description").hasPrefix(key)) {
-				key = "description";
-			} else if (Common::String("engineid").hasPrefix(key)) {
-				key = "engineid";
-			} else if (Common::String("gameid").hasPrefix(key)) {
-				key = "gameid";
-			} else if (Common::String("language").hasPrefix(key)) {
-				key = "language";
-			} else if (Common::String("path").hasPrefix(key)) {
-				key = "path";
-			} else if (Common::String("platform").hasPrefix(key)) {
-				key = "platform";
-			}
-		}
-
-		LauncherDialog *launcher = (LauncherDialog *)(boss);
-		Common::String data = launcher->getGameConfig(idx, key);
-		data.toLowercase();
-
-		if (token8[pos] == ':') {
-			result = data.contains(filter);
-		} else if (token8[pos] == '=') {
-			result = data == filter;
-		} else if (token8[pos] == '~') {
-			result = data.matchString(filter);
-		}
-	} else {
-		result = item.contains(token);
-	}
+// Fields which can be searched with "key:value" tokens in the filter
+static Common::StringArray launcherFilterFields() {
+	return Common::StringArray({"description", "engineid", "gameid", "language", "path", "platform"});
+}
 
-	return invert ? !result : result;
+static Common::String launcherFilterField(void *boss, int idx, const Common::String &key) {
+	LauncherDialog *launcher = (LauncherDialog *)(boss);
+	return launcher->getGameConfig(idx, key);
 }
 
 LauncherDialog::LauncherDialog(const Common::String &dialogName)
@@ -1104,7 +1064,7 @@ void LauncherSimple::build() {
 	_list->setEditable(false);
 	_list->enableDictionarySelect(true);
 	_list->setNumberingMode(kListNumberingOff);
-	_list->setFilterMatcher(LauncherFilterMatcher, this);
+	_list->setFilterFields(launcherFilterField, this, launcherFilterFields());
 
 	// Populate the list
 	updateListing();
@@ -1630,6 +1590,7 @@ void LauncherGrid::build() {
 
 	// Add list with game titles
 	_grid = new GridWidget(this, "LauncherGrid.IconArea");
+	_grid->setFilterFields(launcherFilterField, this, launcherFilterFields());
 	// Populate the list
 	updateListing();
 
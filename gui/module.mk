@@ -12,6 +12,7 @@ MODULE_OBJS := \
 	error.o \
 	EventRecorder.o \
 	filebrowser-dialog.o \
+	filterindex.o \
 	gui-manager.o \
 	helpdialog.o \
 	imagealbum-dialog.o \
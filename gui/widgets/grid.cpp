@@ -493,9 +493,15 @@ void GridWidget::setEntryList(Common::Array<GridItemInfo> *list) {
 	_isGridInvalid = true;
 	_selectedEntry = nullptr;
 
+	Common::U32StringArray titles;
+	titles.reserve(list->size());
+
 	for (Common::Array<GridItemInfo>::iterator entryIter = list->begin(); entryIter != list->end(); ++entryIter) {
 		_dataEntryList.push_back(*entryIter);
+		titles.push_back(Common::U32String(entryIter->title));
 	}
+
+	_filterIndex.setEntries(titles);
 	// TODO: Remove this below, add drawWidget(), that should do the drawing
 	if (!_gridItems.empty()) {
 		reflowLayout();
@@ -569,31 +575,11 @@ void GridWidget::sortGroups() {
 		}
 	} else {
 		// With filter don't display any group header
-		// Restrict the list to everything which contains all words in _filter
-		// as substrings, ignoring case.
-
-		Common::U32StringTokenizer tok(_filter);
-		Common::U32String tmp;
-		int n = 0;
-
-		_sortedEntryList.clear();
-
-		for (GridItemInfo *i = _dataEntryList.begin(); i != _dataEntryList.end(); ++i, ++n) {
-			tmp = i->title;
-			tmp.toLowercase();
-			bool matches = true;
-			tok.reset();
-			while (!tok.empty()) {
-				if (!tmp.contains(tok.nextToken())) {
-					matches = false;
-					break;
-				}
-			}
+		// Restrict the list to everything which matches all tokens in _filter, ignoring case.
+		const Common::Array<int> &matches = _filterIndex.filter(_filter);
 
-			if (matches) {
-				_sortedEntryList.push_back(i);
-			}
-		}
+		for (uint i = 0; i < matches.size(); ++i)
+			_sortedEntryList.push_back(&_dataEntryList[matches[i]]);
 	}
 
 	calcEntrySizes();
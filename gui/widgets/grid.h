@@ -23,6 +23,7 @@
 #define GUI_WIDGETS_GRID_H
 
 #include "gui/dialog.h"
+#include "gui/filterindex.h"
 #include "gui/widgets/scrollbar.h"
 #include "common/str.h"
 
@@ -164,6 +165,7 @@ public:
 	GridItemInfo	*_selectedEntry;
 
 	Common::U32String	_filter;
+	FilterIndex		_filterIndex;
 
 	GridWidget(GuiObject *boss, const Common::String &name);
 	~GridWidget();
@@ -223,6 +225,7 @@ public:
 
 	void setSelected(int id);
 	void setFilter(const Common::U32String &filter);
+	void setFilterFields(FilterIndex::FieldGetter getter, void *arg, const Common::StringArray &fieldNames) { _filterIndex.setFieldGetter(getter, arg, fieldNames); }
 };
 
 /* GridItemWidget */
@@ -401,33 +401,14 @@ void GroupedListWidget::setFilter(const Common::U32String &filter, bool redraw)
 		// No filter -> display everything
 		sortGroups();
 	} else {
-		// Restrict the list to everything which contains all words in _filter
-		// as substrings, ignoring case.
-
-		Common::U32StringTokenizer tok(_filter);
-		Common::U32String tmp;
-		int n = 0;
+		// Restrict the list to everything which matches all tokens in _filter, ignoring case.
+		const Common::Array<int> &matches = _filterIndex.filter(_filter);
 
 		_list.clear();
-		_listIndex.clear();
-
-		for (auto i = _dataList.begin(); i != _dataList.end(); ++i, ++n) {
-			tmp = i->clean;
-			tmp.toLowercase();
-			bool matches = true;
-			tok.reset();
-			while (!tok.empty()) {
-				if (!_filterMatcher(_filterMatcherArg, n, tmp, tok.nextToken())) {
-					matches = false;
-					break;
-				}
-			}
+		_listIndex = matches;
 
-			if (matches) {
-				_list.push_back(i->orig);
-				_listIndex.push_back(n);
-			}
-		}
+		for (uint i = 0; i < matches.size(); ++i)
+			_list.push_back(_dataList[matches[i]].orig);
 	}
 
 	_currentPos = 0;
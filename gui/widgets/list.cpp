@@ -21,7 +21,6 @@
 
 #include "common/system.h"
 #include "common/frac.h"
-#include "common/tokenizer.h"
 
 #include "gui/widgets/list.h"
 #include "gui/widgets/scrollbar.h"
@@ -32,10 +31,6 @@
 
 namespace GUI {
 
-bool ListWidgetDefaultMatcher(void *, int, const Common::U32String &item, const Common::U32String &token) {
-	return item.contains(token);
-}
-
 ListWidget::ListWidget(Dialog *boss, const Common::String &name, const Common::U32String &tooltip, uint32 cmd)
 	: EditableWidget(boss, name, tooltip), _cmd(cmd) {
 
@@ -68,9 +63,6 @@ ListWidget::ListWidget(Dialog *boss, const Common::String &name, const Common::U
 	_editColor = ThemeEngine::kFontColorNormal;
 	_dictionarySelect = false;
 
-	_filterMatcher = ListWidgetDefaultMatcher;
-	_filterMatcherArg = nullptr;
-
 	_lastRead = -1;
 
 	_hlLeftPadding = _hlRightPadding = 0;
@@ -110,9 +102,6 @@ ListWidget::ListWidget(Dialog *boss, int x, int y, int w, int h, bool scale, con
 	_editColor = ThemeEngine::kFontColorNormal;
 	_dictionarySelect = false;
 
-	_filterMatcher = ListWidgetDefaultMatcher;
-	_filterMatcherArg = nullptr;
-
 	_lastRead = -1;
 
 	_hlLeftPadding = _hlRightPadding = 0;
@@ -138,6 +127,8 @@ void ListWidget::copyListData(const Common::U32StringArray &list) {
 		_dataList.push_back(ListData(list[i], stripped));
 		_cleanedList.push_back(stripped);
 	}
+
+	_filterIndex.setEntries(_cleanedList);
 }
 
 
@@ -214,6 +205,7 @@ void ListWidget::append(const Common::String &s) {
 	Common::U32String stripped = stripGUIformatting(s);
 	_dataList.push_back(ListData(s, stripped));
 	_cleanedList.push_back(stripped);
+	_filterIndex.addEntry(stripped);
 	_list.push_back(s);
 
 	setFilter(_filter, false);
@@ -763,31 +755,13 @@ void ListWidget::setFilter(const Common::U32String &filter, bool redraw) {
 		_listIndex.clear();
 	} else {
 		// Restrict the list to everything which matches all tokens in _filter, ignoring case.
-
-		Common::U32StringTokenizer tok(_filter);
-		Common::U32String tmp;
-		int n = 0;
+		const Common::Array<int> &matches = _filterIndex.filter(_filter);
 
 		_list.clear();
-		_listIndex.clear();
-
-		for (auto i = _dataList.begin(); i != _dataList.end(); ++i, ++n) {
-			tmp = i->clean;
-			tmp.toLowercase();
-			bool matches = true;
-			tok.reset();
-			while (!tok.empty()) {
-				if (!_filterMatcher(_filterMatcherArg, n, tmp, tok.nextToken())) {
-					matches = false;
-					break;
-				}
-			}
+		_listIndex = matches;
 
-			if (matches) {
-				_list.push_back(i->orig);
-				_listIndex.push_back(n);
-			}
-		}
+		for (uint i = 0; i < matches.size(); ++i)
+			_list.push_back(_dataList[matches[i]].orig);
 	}
 
 	_currentPos = 0;
@@ -23,6 +23,7 @@
 #define GUI_WIDGETS_LIST_H
 
 #include "gui/widgets/editable.h"
+#include "gui/filterindex.h"
 #include "common/str.h"
 
 #include "gui/ThemeEngine.h"
@@ -48,8 +49,6 @@ enum {
 /* ListWidget */
 class ListWidget : public EditableWidget {
 public:
-	typedef bool (*FilterMatcher)(void *arg, int idx, const Common::U32String &item, const Common::U32String &token);
-
 	struct ListData {
 		Common::U32String orig;
 		Common::U32String clean;
@@ -94,8 +93,7 @@ protected:
 
 	int				_lastRead;
 
-	FilterMatcher	_filterMatcher;
-	void			*_filterMatcherArg;
+	FilterIndex		_filterIndex;
 
 public:
 	ListWidget(Dialog *boss, const Common::String &name, const Common::U32String &tooltip = Common::U32String(), uint32 cmd = 0);
@@ -129,7 +127,7 @@ public:
 	bool isEditable() const						{ return _editable; }
 	void setEditable(bool editable)				{ _editable = editable; }
 	void setEditColor(ThemeEngine::FontColor color) { _editColor = color; }
-	void setFilterMatcher(FilterMatcher matcher, void *arg) { _filterMatcher = matcher; _filterMatcherArg = arg; }
+	void setFilterFields(FilterIndex::FieldGetter getter, void *arg, const Common::StringArray &fieldNames) { _filterIndex.setFieldGetter(getter, arg, fieldNames); }
 
 	// Made startEditMode/endEditMode for SaveLoadChooser
 	void startEditMode() override;
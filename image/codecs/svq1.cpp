@@ -99,7 +99,8 @@ SVQ1Decoder::~SVQ1Decoder() {
 const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &stream) {
 	debug(1, "SVQ1Decoder::decodeImage()");
 
-	Common::BitStream32BEMSB frameData(stream);
+	// Decode from memory, which is a lot faster to read bits from
+	Common::BitStreamMemory32BEMSB frameData(Common::BitStreamMemoryStream::createFromStream(stream, stream.size() - stream.pos()), DisposeAfterUse::YES);
 
 	uint32 frameCode = frameData.getBits<22>();
 	debug(1, " frameCode: %d", frameCode);
@@ -287,7 +288,7 @@ const Graphics::Surface *SVQ1Decoder::decodeFrame(Common::SeekableReadStream &st
 	return _surface;
 }
 
-bool SVQ1Decoder::svq1DecodeBlockIntra(Common::BitStream32BEMSB *s, byte *pixels, int pitch) {
+bool SVQ1Decoder::svq1DecodeBlockIntra(Common::BitStreamMemory32BEMSB *s, byte *pixels, int pitch) {
 	// initialize list for breadth first processing of vectors
 	byte *list[63];
 	list[0] = pixels;
@@ -388,7 +389,7 @@ bool SVQ1Decoder::svq1DecodeBlockIntra(Common::BitStream32BEMSB *s, byte *pixels
 	return true;
 }
 
-bool SVQ1Decoder::svq1DecodeBlockNonIntra(Common::BitStream32BEMSB *s, byte *pixels, int pitch) {
+bool SVQ1Decoder::svq1DecodeBlockNonIntra(Common::BitStreamMemory32BEMSB *s, byte *pixels, int pitch) {
 	// initialize list for breadth first processing of vectors
 	byte *list[63];
 	list[0] = pixels;
@@ -502,7 +503,7 @@ static inline int midPred(int a, int b, int c) {
 	return b;
 }
 
-bool SVQ1Decoder::svq1DecodeMotionVector(Common::BitStream32BEMSB *s, Common::Point *mv, Common::Point **pmv) {
+bool SVQ1Decoder::svq1DecodeMotionVector(Common::BitStreamMemory32BEMSB *s, Common::Point *mv, Common::Point **pmv) {
 	for (int i = 0; i < 2; i++) {
 		// get motion code
 		int diff = _motionComponent->getSymbol(*s);
@@ -616,7 +617,7 @@ void SVQ1Decoder::putPixels16XY2C(byte *block, const byte *pixels, int lineSize,
 	putPixels8XY2C(block + 8, pixels + 8, lineSize, h);
 }
 
-bool SVQ1Decoder::svq1MotionInterBlock(Common::BitStream32BEMSB *ss, byte *current, byte *previous, int pitch,
+bool SVQ1Decoder::svq1MotionInterBlock(Common::BitStreamMemory32BEMSB *ss, byte *current, byte *previous, int pitch,
 		Common::Point *motion, int x, int y) {
 
 	// predict and decode motion vector
@@ -669,7 +670,7 @@ bool SVQ1Decoder::svq1MotionInterBlock(Common::BitStream32BEMSB *ss, byte *curre
 	return true;
 }
 
-bool SVQ1Decoder::svq1MotionInter4vBlock(Common::BitStream32BEMSB *ss, byte *current, byte *previous, int pitch,
+bool SVQ1Decoder::svq1MotionInter4vBlock(Common::BitStreamMemory32BEMSB *ss, byte *current, byte *previous, int pitch,
 		Common::Point *motion, int x, int y) {
 	// predict and decode motion vector (0)
 	Common::Point *pmv[4];
@@ -758,7 +759,7 @@ bool SVQ1Decoder::svq1MotionInter4vBlock(Common::BitStream32BEMSB *ss, byte *cur
 	return true;
 }
 
-bool SVQ1Decoder::svq1DecodeDeltaBlock(Common::BitStream32BEMSB *ss, byte *current, byte *previous, int pitch,
+bool SVQ1Decoder::svq1DecodeDeltaBlock(Common::BitStreamMemory32BEMSB *ss, byte *current, byte *previous, int pitch,
 		Common::Point *motion, int x, int y) {
 	// get block type
 	uint32 blockType = _blockType->getSymbol(*ss);
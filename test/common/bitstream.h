@@ -1,7 +1,18 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/bitstream.h"
+#include "common/bufferedstream.h"
+#include "common/debug.h"
 #include "common/memstream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
 
 class BitStreamTestSuite : public CxxTest::TestSuite
 {
@@ -255,4 +266,149 @@ public:
 		tmpl_align_16<Common::MemoryReadStream, Common::BitStream16BELSB>();
 		tmpl_align_16<Common::BitStreamMemoryStream, Common::BitStreamMemory16BELSB>();
 	}
+
+private:
+	template<class BS, class BSM>
+	void tmpl_memory_matches_stream() {
+		// Random reads over a buffer that does not end on a data value
+		// boundary, running past the end, must give the same results
+		// with both stream types.
+		byte contents[77];
+		uint32 seed = 1;
+		for (uint i = 0; i < sizeof(contents); i++) {
+			seed = seed * 1103515245 + 12345;
+			contents[i] = seed >> 16;
+		}
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStreamMemoryStream bms(contents, sizeof(contents));
+		BS bs(ms);
+		BSM bsm(bms);
+
+		TS_ASSERT_EQUALS(bs.size(), bsm.size());
+
+		bool same = true;
+		while (bs.pos() < bs.size() + 40) {
+			seed = seed * 1103515245 + 12345;
+			const uint n = (seed >> 16) % 33;
+			switch ((seed >> 24) & 3) {
+			case 0:
+				same &= bs.getBits(n) == bsm.getBits(n);
+				break;
+			case 1:
+				same &= bs.peekBits(n) == bsm.peekBits(n);
+				bs.skip(n);
+				bsm.skip(n);
+				break;
+			case 2:
+				same &= bs.getBit() == bsm.getBit();
+				break;
+			default:
+				bs.align();
+				bsm.align();
+				break;
+			}
+			same &= bs.pos() == bsm.pos();
+			same &= bs.eos() == bsm.eos();
+		}
+		TS_ASSERT(same);
+	}
+public:
+	void test_memory_matches_stream() {
+		tmpl_memory_matches_stream<Common::BitStream8MSB, Common::BitStreamMemory8MSB>();
+		tmpl_memory_matches_stream<Common::BitStream8LSB, Common::BitStreamMemory8LSB>();
+		tmpl_memory_matches_stream<Common::BitStream16LEMSB, Common::BitStreamMemory16LEMSB>();
+		tmpl_memory_matches_stream<Common::BitStream16LELSB, Common::BitStreamMemory16LELSB>();
+		tmpl_memory_matches_stream<Common::BitStream16BEMSB, Common::BitStreamMemory16BEMSB>();
+		tmpl_memory_matches_stream<Common::BitStream16BELSB, Common::BitStreamMemory16BELSB>();
+		tmpl_memory_matches_stream<Common::BitStream32LEMSB, Common::BitStreamMemory32LEMSB>();
+		tmpl_memory_matches_stream<Common::BitStream32LELSB, Common::BitStreamMemory32LELSB>();
+		tmpl_memory_matches_stream<Common::BitStream32BEMSB, Common::BitStreamMemory32BEMSB>();
+		tmpl_memory_matches_stream<Common::BitStream32BELSB, Common::BitStreamMemory32BELSB>();
+	}
+
+	void test_memory_stream_read_uint16_be() {
+		// BitStreamMemoryStream used to read little-endian values here
+		byte contents[] = { 0x12, 0x34, 0x56 };
+		Common::BitStreamMemoryStream bms(contents, sizeof(contents));
+		TS_ASSERT_EQUALS(bms.readUint16BE(), 0x1234u);
+		TS_ASSERT(!bms.eos());
+		TS_ASSERT_EQUALS(bms.readUint16BE(), 0x5600u);
+		TS_ASSERT(bms.eos());
+	}
+
+	void test_memory_stream_from_stream() {
+		byte contents[] = { 0x12, 0x34, 0x56, 0x78 };
+
+		// Memory streams lend their data
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		ms.seek(1);
+		Common::BitStreamMemoryStream *bms = Common::BitStreamMemoryStream::createFromStream(ms, 2);
+		TS_ASSERT_EQUALS(bms->getData(), contents + 1);
+		TS_ASSERT_EQUALS(bms->size(), 2u);
+		TS_ASSERT_EQUALS(bms->readUint16BE(), 0x3456u);
+		TS_ASSERT_EQUALS(ms.pos(), 3);
+		delete bms;
+
+		// Other streams are copied, padded with zeros at the end
+		Common::SeekableReadStream *buffered = Common::wrapBufferedSeekableReadStream(
+			new Common::MemoryReadStream(contents, sizeof(contents)), 2, DisposeAfterUse::YES);
+		buffered->seek(2);
+		bms = Common::BitStreamMemoryStream::createFromStream(*buffered, 3);
+		TS_ASSERT_DIFFERS(bms->getData(), contents + 2);
+		TS_ASSERT_EQUALS(bms->size(), 3u);
+		TS_ASSERT_EQUALS(bms->readUint16BE(), 0x5678u);
+		TS_ASSERT_EQUALS(bms->readByte(), 0u);
+		TS_ASSERT(buffered->eos());
+		delete bms;
+		delete buffered;
+	}
+
+private:
+	template<class MS, class BS>
+	void benchmarkReads(const char *name, const byte *data, uint32 size, int rounds) {
+		uint32 sum = 0;
+		uint64 bits = 0;
+
+		uint32 start = g_system->getMillis();
+		for (int r = 0; r < rounds; r++) {
+			MS ms(data, size);
+			BS bs(ms);
+
+			// A mix of short reads, as done by Huffman and VLC decoders
+			uint n = 1;
+			while (bs.pos() < bs.size()) {
+				sum += bs.getBits(n);
+				bits += n;
+				n = (n * 7 + 3) % 17 + 1;
+			}
+		}
+		uint32 time = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		debug("%s: %u Mbit/s (%u)", name, (uint32)(bits / 1000 / time), sum);
+	}
+public:
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int rounds = 200;
+#else
+		const int rounds = 10;
+#endif
+
+		const uint32 size = 256 * 1024;
+		byte *data = new byte[size];
+		for (uint32 i = 0; i < size; i++)
+			data[i] = (i * 2654435761U) >> 24;
+
+		benchmarkReads<Common::MemoryReadStream, Common::BitStream32LELSB>("BitStream32LELSB", data, size, rounds);
+		benchmarkReads<Common::BitStreamMemoryStream, Common::BitStreamMemory32LELSB>("BitStreamMemory32LELSB", data, size, rounds);
+		benchmarkReads<Common::MemoryReadStream, Common::BitStream8MSB>("BitStream8MSB", data, size, rounds);
+		benchmarkReads<Common::BitStreamMemoryStream, Common::BitStreamMemory8MSB>("BitStreamMemory8MSB", data, size, rounds);
+
+		delete[] data;
+#endif
+	}
 };
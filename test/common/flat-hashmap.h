@@ -0,0 +1,221 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flat-hashmap.h"
+#include "common/array.h"
+#include "common/hash-str.h"
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		Common::FlatHashMap<Common::String, Common::String> container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		TS_ASSERT(!container2.contains("foo"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		container.erase(1);
+		container.erase(2);
+		container.erase(container.find(3));
+		TS_ASSERT(!container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+		container.erase(4);
+		TS_ASSERT(container.empty());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getVal(1), -1);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getValOrDefault(17, -10), -10);
+
+		int val = 0;
+		TS_ASSERT(containerRef.tryGetVal(0, val));
+		TS_ASSERT_EQUALS(val, 17);
+		TS_ASSERT(!containerRef.tryGetVal(2, val));
+		TS_ASSERT(containerRef.find(2) == containerRef.end());
+		TS_ASSERT_EQUALS(container.size(), 2u);
+	}
+
+	void test_copy() {
+		Common::FlatHashMap<Common::String, Common::String> map1, map2;
+		for (int i = 0; i < 100; i++)
+			map1[Common::String::format("key%d", i)] = Common::String::format("value%d", i);
+		for (int i = 0; i < 100; i += 2)
+			map1.erase(Common::String::format("key%d", i));
+
+		map2 = map1;
+		Common::FlatHashMap<Common::String, Common::String> map3(map2);
+		map1.clear();
+
+		TS_ASSERT_EQUALS(map3.size(), 50u);
+		for (int i = 0; i < 100; i++) {
+			Common::String key = Common::String::format("key%d", i);
+			TS_ASSERT_EQUALS(map3.contains(key), (i & 1) != 0);
+			if (i & 1)
+				TS_ASSERT_EQUALS(map3[key], Common::String::format("value%d", i));
+		}
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		container.erase(1);
+		container[1] = 42;
+		container.erase(0);
+		container.erase(1);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::const_iterator j;
+		for (j = container.begin(); j != container.end(); ++j) {
+			int key = j->_key;
+			TS_ASSERT(key >= 0 && key <= 4);
+			TS_ASSERT(!(found & (1 << key)));
+			found |= 1 << key;
+		}
+		TS_ASSERT(found == 16+8+4);
+
+		// Erasing through an iterator must not disturb the iteration
+		for (Common::FlatHashMap<int, int>::iterator i = container.begin(); i != container.end(); ++i) {
+			if (i->_key == 3)
+				container.erase(i);
+		}
+		TS_ASSERT(!container.contains(3));
+		TS_ASSERT_EQUALS(container.size(), 2u);
+	}
+
+	void test_matches_hashmap() {
+		// Run the same random sequence of operations on a HashMap and
+		// a FlatHashMap, with heavy churn to exercise erased slots.
+		Common::HashMap<uint, uint> reference;
+		Common::FlatHashMap<uint, uint> flat;
+		uint32 seed = 12345;
+
+		for (int i = 0; i < 20000; i++) {
+			seed = seed * 1103515245 + 12345;
+			const uint key = (seed >> 8) % 1000;
+			if ((seed >> 28) < 6) {
+				reference.erase(key);
+				flat.erase(key);
+			} else {
+				reference[key] = i;
+				flat[key] = i;
+			}
+		}
+
+		TS_ASSERT_EQUALS(reference.size(), flat.size());
+		for (uint key = 0; key < 1000; key++) {
+			TS_ASSERT_EQUALS(reference.contains(key), flat.contains(key));
+			if (reference.contains(key))
+				TS_ASSERT_EQUALS(reference[key], flat[key]);
+		}
+
+		uint count = 0;
+		for (Common::FlatHashMap<uint, uint>::const_iterator i = flat.begin(); i != flat.end(); ++i) {
+			TS_ASSERT_EQUALS(reference.getValOrDefault(i->_key, (uint)-1), i->_value);
+			count++;
+		}
+		TS_ASSERT_EQUALS(count, flat.size());
+	}
+
+	template<class Map>
+	void benchmarkMap(const char *name, const Common::Array<Common::String> &keys, int rounds) {
+		uint32 start = g_system->getMillis();
+		for (int r = 0; r < rounds; r++) {
+			Map map;
+			for (uint i = 0; i < keys.size(); i++)
+				map[keys[i]] = i;
+		}
+		uint32 insertTime = g_system->getMillis() - start;
+
+		Map map;
+		for (uint i = 0; i < keys.size(); i++)
+			map[keys[i]] = i;
+
+		uint sum = 0;
+		start = g_system->getMillis();
+		for (int r = 0; r < rounds; r++) {
+			for (uint i = 0; i < keys.size(); i++)
+				sum += map.getVal(keys[i]);
+		}
+		uint32 lookupTime = g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		for (int r = 0; r < rounds * 10; r++) {
+			for (typename Map::const_iterator i = map.begin(); i != map.end(); ++i)
+				sum += i->_value;
+		}
+		uint32 iterateTime = g_system->getMillis() - start;
+
+		debug("%s: insert %u ms, lookup %u ms, iterate %u ms (%u)", name, insertTime, lookupTime, iterateTime, sum);
+	}
+
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int numKeys = 100000;
+		const int rounds = 50;
+#else
+		const int numKeys = 10000;
+		const int rounds = 5;
+#endif
+
+		Common::Array<Common::String> keys;
+		keys.reserve(numKeys);
+		for (int i = 0; i < numKeys; i++)
+			keys.push_back(Common::String::format("data/resource%05d.bin", i));
+
+		benchmarkMap<Common::HashMap<Common::String, uint> >("HashMap", keys, rounds);
+		benchmarkMap<Common::FlatHashMap<Common::String, uint> >("FlatHashMap", keys, rounds);
+#endif
+	}
+};
@@ -0,0 +1,83 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/compression/deflate.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+class GZipReadStreamTestSuite : public CxxTest::TestSuite {
+	// Big enough for the stream to store several seek checkpoints
+	static const uint32 kDataSize = 5 * 1024 * 1024 + 123;
+
+	static byte expectedByte(uint32 pos) {
+		// Repetitive enough to compress, varied enough to catch bad offsets
+		return (byte)((pos * 7) ^ (pos >> 11) ^ (pos >> 19));
+	}
+
+	Common::SeekableReadStream *createCompressedStream() {
+		Common::MemoryWriteStreamDynamic *compressed = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(compressed);
+
+		byte chunk[4096];
+		for (uint32 pos = 0; pos < kDataSize; pos += sizeof(chunk)) {
+			uint32 len = MIN<uint32>(sizeof(chunk), kDataSize - pos);
+			for (uint32 i = 0; i < len; i++)
+				chunk[i] = expectedByte(pos + i);
+			gzip->write(chunk, len);
+		}
+		gzip->finalize();
+
+		byte *data = compressed->getData();
+		uint32 size = compressed->size();
+		// Also deletes the wrapped stream, which does not own the data
+		delete gzip;
+
+		return Common::wrapCompressedReadStream(new Common::MemoryReadStream(data, size, DisposeAfterUse::YES));
+	}
+
+public:
+	void test_sequential_read() {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(createCompressedStream());
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(stream->size(), (int64)kDataSize);
+
+		byte chunk[10000];
+		uint32 pos = 0;
+		bool ok = true;
+		while (pos < kDataSize) {
+			uint32 len = stream->read(chunk, sizeof(chunk));
+			for (uint32 i = 0; i < len; i++)
+				ok = ok && chunk[i] == expectedByte(pos + i);
+			pos += len;
+			if (len == 0)
+				break;
+		}
+		TS_ASSERT(ok);
+		TS_ASSERT_EQUALS(pos, kDataSize);
+		TS_ASSERT(!stream->err());
+	}
+
+	void test_seek() {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(createCompressedStream());
+		TS_ASSERT(stream);
+
+		// Jump around, backward as well as forward, across checkpoints
+		const uint32 positions[] = {
+			kDataSize - 10, 17, 3 * 1024 * 1024 + 5, 1024 * 1024 - 1,
+			1024 * 1024, 4 * 1024 * 1024 + 99, 0, 2 * 1024 * 1024 + 77
+		};
+		for (uint i = 0; i < ARRAYSIZE(positions); i++) {
+			TS_ASSERT(stream->seek(positions[i]));
+			TS_ASSERT_EQUALS(stream->pos(), (int64)positions[i]);
+
+			byte buf[8];
+			uint32 len = stream->read(buf, sizeof(buf));
+			TS_ASSERT_EQUALS(len, MIN<uint32>(sizeof(buf), kDataSize - positions[i]));
+			for (uint32 j = 0; j < len; j++)
+				TS_ASSERT_EQUALS(buf[j], expectedByte(positions[i] + j));
+		}
+
+		TS_ASSERT(stream->seek(-4, SEEK_END));
+		TS_ASSERT_EQUALS(stream->readByte(), expectedByte(kDataSize - 4));
+		TS_ASSERT(!stream->err());
+	}
+};
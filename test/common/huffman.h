@@ -2,6 +2,17 @@
 #include "common/huffman.h"
 #include "common/bitstream.h"
 #include "common/memstream.h"
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
 
 /**
 * A test suite for the Huffman decoder in common/huffman.h
@@ -10,6 +21,114 @@
 * TODO: It could be improved by generating one at runtime.
 */
 class HuffmanTestSuite : public CxxTest::TestSuite {
+	/**
+	 * A canonical Huffman codebook, with the code lengths computed
+	 * from the symbol weights.
+	 */
+	struct Codebook {
+		Common::Array<uint32> codes;
+		Common::Array<uint8> lengths;
+
+		Codebook(const Common::Array<uint64> &weights) {
+			const uint count = weights.size();
+
+			// Merge the two lightest nodes until only the root is left
+			Common::Array<uint64> nodeWeights(weights);
+			Common::Array<int> parents(count, -1);
+			Common::Array<bool> merged(count, false);
+			for (uint n = 1; n < count; n++) {
+				int lightest[2] = { -1, -1 };
+				for (uint i = 0; i < nodeWeights.size(); i++) {
+					if (merged[i])
+						continue;
+					if (lightest[0] < 0 || nodeWeights[i] < nodeWeights[lightest[0]]) {
+						lightest[1] = lightest[0];
+						lightest[0] = i;
+					} else if (lightest[1] < 0 || nodeWeights[i] < nodeWeights[lightest[1]]) {
+						lightest[1] = i;
+					}
+				}
+
+				merged[lightest[0]] = merged[lightest[1]] = true;
+				parents[lightest[0]] = parents[lightest[1]] = nodeWeights.size();
+				nodeWeights.push_back(nodeWeights[lightest[0]] + nodeWeights[lightest[1]]);
+				parents.push_back(-1);
+				merged.push_back(false);
+			}
+
+			lengths.resize(count);
+			for (uint i = 0; i < count; i++) {
+				lengths[i] = 0;
+				for (int node = parents[i]; node >= 0; node = parents[node])
+					lengths[i]++;
+			}
+
+			// Assign the codes in order of length
+			codes.resize(count);
+			uint32 code = 0;
+			for (uint8 length = 1; length <= 32; length++) {
+				for (uint i = 0; i < count; i++) {
+					if (lengths[i] == length)
+						codes[i] = code++;
+				}
+				code <<= 1;
+			}
+		}
+	};
+
+	/** Write the codes of the symbols, packing the bits from the MSB or the LSB of each byte. */
+	static Common::Array<byte> encode(const Codebook &book, const Common::Array<uint32> &symbols, bool msb) {
+		Common::Array<byte> data;
+		uint32 pos = 0;
+		for (uint i = 0; i < symbols.size(); i++) {
+			const uint8 length = book.lengths[symbols[i]];
+			for (int bit = length - 1; bit >= 0; bit--, pos++) {
+				if ((pos >> 3) >= data.size())
+					data.push_back(0);
+				if ((book.codes[symbols[i]] >> bit) & 1)
+					data[pos >> 3] |= msb ? (0x80 >> (pos & 7)) : (1 << (pos & 7));
+			}
+		}
+
+		// Room for peeking past the last code
+		for (int i = 0; i < 8; i++)
+			data.push_back(0);
+		return data;
+	}
+
+	template<class BITSTREAM, class STREAM>
+	void checkDecode(const Codebook &book, const Common::Array<uint32> &symbols, bool msb) {
+		Common::Huffman<BITSTREAM> h(0, book.codes.size(), book.codes.begin(), book.lengths.begin());
+
+		Common::Array<byte> data = encode(book, symbols, msb);
+		STREAM stream(data.begin(), data.size());
+		BITSTREAM bits(stream);
+
+		uint mismatches = 0;
+		for (uint i = 0; i < symbols.size(); i++) {
+			if (h.getSymbol(bits) != symbols[i])
+				mismatches++;
+		}
+		TS_ASSERT_EQUALS(mismatches, 0u);
+	}
+
+	static Common::Array<uint64> zipfWeights(uint count) {
+		Common::Array<uint64> weights;
+		for (uint i = 0; i < count; i++)
+			weights.push_back(1 + (uint64)1000000000 / ((uint64)(i + 1) * (i + 1)));
+		return weights;
+	}
+
+	static Common::Array<uint32> randomSymbols(uint symbolCount, uint count) {
+		Common::Array<uint32> symbols;
+		uint32 seed = 12345;
+		for (uint i = 0; i < count; i++) {
+			seed = seed * 1103515245 + 12345;
+			symbols.push_back((seed >> 8) % symbolCount);
+		}
+		return symbols;
+	}
+
 	public:
 	void test_get_with_full_symbols() {
 
@@ -94,4 +213,77 @@ class HuffmanTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[5]);
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[6]);
 	}
+
+	void test_long_codes() {
+		// Halving weights give codes of every length up to 31 bits,
+		// which need all the sub table levels
+		Common::Array<uint64> weights;
+		for (int i = 0; i < 32; i++)
+			weights.push_back((uint64)1 << (31 - MIN(i, 30)));
+		Codebook geometric(weights);
+		TS_ASSERT_EQUALS(geometric.lengths[31], 31);
+
+		Common::Array<uint32> symbols = randomSymbols(weights.size(), 2000);
+		checkDecode<Common::BitStream8MSB, Common::MemoryReadStream>(geometric, symbols, true);
+		checkDecode<Common::BitStream8LSB, Common::MemoryReadStream>(geometric, symbols, false);
+		checkDecode<Common::BitStreamMemory32BEMSB, Common::BitStreamMemoryStream>(geometric, symbols, true);
+		checkDecode<Common::BitStreamMemory32LELSB, Common::BitStreamMemoryStream>(geometric, symbols, false);
+
+		// A long-tailed alphabet, as found in audio and video codecs
+		Codebook zipf(zipfWeights(1024));
+		symbols = randomSymbols(1024, 20000);
+		checkDecode<Common::BitStream8MSB, Common::MemoryReadStream>(zipf, symbols, true);
+		checkDecode<Common::BitStream8LSB, Common::MemoryReadStream>(zipf, symbols, false);
+		checkDecode<Common::BitStreamMemory32BEMSB, Common::BitStreamMemoryStream>(zipf, symbols, true);
+		checkDecode<Common::BitStreamMemory32LELSB, Common::BitStreamMemoryStream>(zipf, symbols, false);
+	}
+
+	template<class BITSTREAM, class STREAM>
+	void benchmarkDecode(const char *name, const Codebook &book, const Common::Array<byte> &data, int rounds) {
+		Common::Huffman<BITSTREAM> h(0, book.codes.size(), book.codes.begin(), book.lengths.begin());
+
+		// The codebook is complete, so any bit sequence decodes, with each
+		// symbol appearing as often as its code length predicts
+		uint64 count = 0;
+		uint32 sum = 0;
+		uint32 start = g_system->getMillis();
+		for (int r = 0; r < rounds; r++) {
+			STREAM stream(data.begin(), data.size());
+			BITSTREAM bits(stream);
+			const uint32 end = bits.size() - 64;
+			while (bits.pos() < end) {
+				sum += h.getSymbol(bits);
+				count++;
+			}
+		}
+		uint32 time = MAX<uint32>(g_system->getMillis() - start, 1);
+
+		debug("%s: %u ms, %.1f Msymbols/s (%u)", name, time, count / (time * 1000.0), sum);
+	}
+
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int rounds = 100;
+#else
+		const int rounds = 5;
+#endif
+
+		Common::Array<byte> data(1 << 20);
+		uint32 seed = 54321;
+		for (uint i = 0; i < data.size(); i++) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = seed >> 24;
+		}
+
+		Codebook zipf(zipfWeights(1024));
+		benchmarkDecode<Common::BitStream8MSB, Common::MemoryReadStream>("Huffman, 1024 symbols, BitStream8MSB", zipf, data, rounds);
+		benchmarkDecode<Common::BitStreamMemory32LELSB, Common::BitStreamMemoryStream>("Huffman, 1024 symbols, BitStreamMemory32LELSB", zipf, data, rounds);
+
+		Codebook small(zipfWeights(64));
+		benchmarkDecode<Common::BitStreamMemory32LELSB, Common::BitStreamMemoryStream>("Huffman, 64 symbols, BitStreamMemory32LELSB", small, data, rounds);
+#endif
+	}
 };
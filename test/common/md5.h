@@ -1,7 +1,19 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/md5.h"
-#include "common/stream.h"
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/str-array.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
 
 /*
  * those are the standard RFC 1321 test vectors
@@ -47,4 +59,96 @@ class MD5TestSuite : public CxxTest::TestSuite {
 		}
 	}
 
+	void checkStreamsMD5(uint32 length) {
+		// Lengths around the block and chunk sizes, and a few large streams
+		// so that the lanes finish at different times
+		Common::Array<uint32> sizes;
+		for (uint32 i = 0; i < 200; i++)
+			sizes.push_back(i);
+		sizes.push_back(16383);
+		sizes.push_back(16384);
+		sizes.push_back(16385);
+		sizes.push_back(100000);
+		sizes.push_back(250007);
+
+		Common::Array<byte> data(250007 + 256);
+		for (uint i = 0; i < data.size(); i++)
+			data[i] = (byte)(i * 7 + (i >> 8));
+
+		Common::Array<Common::ReadStream *> streams;
+		Common::StringArray expected;
+		for (uint i = 0; i < sizes.size(); i++) {
+			Common::MemoryReadStream stream(data.begin() + i, sizes[i]);
+			expected.push_back(Common::computeStreamMD5AsString(stream, length));
+			streams.push_back(new Common::MemoryReadStream(data.begin() + i, sizes[i]));
+		}
+
+		// Missing files are passed as null
+		streams.push_back(nullptr);
+		expected.push_back(Common::String());
+
+		Common::StringArray md5s(streams.size());
+		Common::computeStreamsMD5AsString(streams.begin(), md5s.begin(), streams.size(), length);
+
+		for (uint i = 0; i < streams.size(); i++) {
+			TS_ASSERT_EQUALS(md5s[i], expected[i]);
+			delete streams[i];
+		}
+	}
+
+	void test_computeStreamsMD5() {
+		checkStreamsMD5(0);
+		checkStreamsMD5(5000);
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// With a backend, the SIMD kernels and the thread pool are used
+		Common::install_null_g_system();
+		checkStreamsMD5(0);
+		checkStreamsMD5(5000);
+#endif
+	}
+
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const uint numStreams = 64;
+		const uint streamSize = 4 * 1024 * 1024;
+#else
+		const uint numStreams = 16;
+		const uint streamSize = 256 * 1024;
+#endif
+
+		Common::Array<byte> data(streamSize);
+		for (uint i = 0; i < streamSize; i++)
+			data[i] = (byte)(i * 13);
+
+		uint8 digest[16];
+		uint32 start = g_system->getMillis();
+		for (uint i = 0; i < numStreams; i++) {
+			Common::MemoryReadStream stream(data.begin(), streamSize);
+			Common::computeStreamMD5(stream, digest);
+		}
+		uint32 serialTime = g_system->getMillis() - start;
+
+		Common::Array<Common::ReadStream *> streams;
+		for (uint i = 0; i < numStreams; i++)
+			streams.push_back(new Common::MemoryReadStream(data.begin(), streamSize));
+
+		Common::Array<uint8> digests(numStreams * 16);
+		start = g_system->getMillis();
+		Common::computeStreamsMD5(streams.begin(), (uint8 (*)[16])digests.begin(), numStreams);
+		uint32 batchTime = g_system->getMillis() - start;
+
+		const double megabytes = (double)numStreams * streamSize / (1024 * 1024);
+		debug("MD5: %u streams of %u bytes, computeStreamMD5 %u ms (%.0f MB/s), computeStreamsMD5 %u ms (%.0f MB/s)",
+			numStreams, streamSize, serialTime, megabytes * 1000 / MAX<uint32>(serialTime, 1),
+			batchTime, megabytes * 1000 / MAX<uint32>(batchTime, 1));
+
+		for (uint i = 0; i < numStreams; i++)
+			delete streams[i];
+#endif
+	}
+
 };
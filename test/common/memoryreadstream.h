@@ -104,4 +104,21 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_borrow_data() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		// Borrowing does not depend on nor move the stream position
+		ms.seek(5, SEEK_SET);
+		TS_ASSERT_EQUALS(ms.borrowData(0, 7), contents);
+		TS_ASSERT_EQUALS(ms.borrowData(2, 3), contents + 2);
+		TS_ASSERT_EQUALS(ms.borrowData(7, 0), contents + 7);
+		TS_ASSERT_EQUALS(ms.pos(), 5);
+
+		// Ranges outside of the stream can't be borrowed
+		TS_ASSERT(ms.borrowData(4, 4) == nullptr);
+		TS_ASSERT(ms.borrowData(8, 0) == nullptr);
+		TS_ASSERT(ms.borrowData(-1, 1) == nullptr);
+	}
 };
@@ -0,0 +1,123 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/ptr.h"
+
+#include "../null_osystem.h"
+
+#if defined(POSIX) && defined(HAS_MMAP)
+#include "backends/fs/posix/posix-iostream.h"
+#endif
+
+class PosixMmapStreamTestSuite : public CxxTest::TestSuite {
+#if defined(POSIX) && defined(HAS_MMAP)
+	static const uint32 kDataSize = 10000;
+
+	static byte expectedByte(uint32 pos) {
+		return (byte)(pos * 13 + (pos >> 8));
+	}
+
+	static void writeFile(const char *path, uint32 size) {
+		Common::ScopedPtr<PosixIoStream> out(PosixIoStream::makeFromPath(path, true));
+		TS_ASSERT(out);
+		for (uint32 i = 0; i < size; i++)
+			out->writeByte(expectedByte(i));
+	}
+#endif
+
+public:
+	void test_read_and_seek() {
+#if defined(POSIX) && defined(HAS_MMAP)
+		const char *path = "test/mmapstream.tmp";
+		writeFile(path, kDataSize);
+
+		// Files below the minimum size are left to stdio
+		TS_ASSERT(!PosixMmapStream::makeFromPath(path, kDataSize + 1));
+
+		Common::ScopedPtr<PosixMmapStream> stream(PosixMmapStream::makeFromPath(path));
+		remove(path);
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+		TS_ASSERT_EQUALS(stream->size(), (int64)kDataSize);
+
+		TS_ASSERT(!stream->seek(-1));
+		TS_ASSERT(!stream->seek(kDataSize + 1));
+		TS_ASSERT(!stream->seek(1, SEEK_END));
+		TS_ASSERT(stream->seek(0, SEEK_END));
+		TS_ASSERT_EQUALS(stream->pos(), (int64)kDataSize);
+		TS_ASSERT(stream->seek(-10, SEEK_CUR));
+		TS_ASSERT_EQUALS(stream->pos(), (int64)kDataSize - 10);
+
+		// Reads across the end stop there
+		byte buffer[20];
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), 10u);
+		TS_ASSERT(stream->eos());
+		for (uint32 i = 0; i < 10; i++)
+			TS_ASSERT_EQUALS(buffer[i], expectedByte(kDataSize - 10 + i));
+		TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), 0u);
+
+		// Seeking clears eos
+		TS_ASSERT(stream->seek(0));
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(stream->readByte(), expectedByte(0));
+#endif
+	}
+
+	void test_borrow_data() {
+#if defined(POSIX) && defined(HAS_MMAP)
+		const char *path = "test/mmapstream.tmp";
+		writeFile(path, kDataSize);
+		Common::ScopedPtr<PosixMmapStream> stream(PosixMmapStream::makeFromPath(path));
+		remove(path);
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		const byte *data = stream->borrowData(0, kDataSize);
+		TS_ASSERT(data);
+		if (data)
+			TS_ASSERT_EQUALS(data[kDataSize - 1], expectedByte(kDataSize - 1));
+		TS_ASSERT(stream->borrowData(kDataSize, 0));
+		TS_ASSERT(!stream->borrowData(-1, 1));
+		TS_ASSERT(!stream->borrowData(kDataSize - 1, 2));
+		TS_ASSERT(!stream->borrowData(kDataSize + 1, 0));
+		TS_ASSERT(!stream->borrowData(1, 0xFFFFFFFF));
+
+		// Sub-streams share the mapping and outlive the stream
+		TS_ASSERT(stream->seek(kDataSize - 100));
+		Common::ScopedPtr<Common::SeekableReadStream> sub(stream->readStream(200));
+		TS_ASSERT(stream->eos());
+		stream.reset();
+
+		TS_ASSERT_EQUALS(sub->size(), 100);
+		TS_ASSERT(!sub->borrowData(0, 101));
+		data = sub->borrowData(0, 100);
+		TS_ASSERT(data);
+		if (data)
+			TS_ASSERT_EQUALS(data[99], expectedByte(kDataSize - 1));
+		TS_ASSERT(sub->seek(50));
+		TS_ASSERT_EQUALS(sub->readByte(), expectedByte(kDataSize - 50));
+#endif
+	}
+
+	void test_empty_file() {
+#if defined(POSIX) && defined(HAS_MMAP) && NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		const char *path = "test/mmapstream-empty.tmp";
+		writeFile(path, 0);
+
+		// Empty files cannot be mapped, the file system node opens them with stdio
+		TS_ASSERT(!PosixMmapStream::makeFromPath(path));
+		Common::ScopedPtr<Common::SeekableReadStream> stream(Common::FSNode(path).createReadStream());
+		remove(path);
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+		TS_ASSERT_EQUALS(stream->size(), 0);
+		TS_ASSERT_EQUALS(stream->readByte(), 0);
+		TS_ASSERT(stream->eos());
+#endif
+	}
+};
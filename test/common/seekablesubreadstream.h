@@ -70,4 +70,38 @@ class SeekableSubReadStreamTestSuite : public CxxTest::TestSuite {
 		b = ssrs.readByte();
 		TS_ASSERT_EQUALS(b, 1);
 	}
+
+	void test_borrow_data() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableSubReadStream ssrs(&ms, 1, 9);
+
+		TS_ASSERT_EQUALS(ssrs.borrowData(0, 8), contents + 1);
+		TS_ASSERT_EQUALS(ssrs.borrowData(3, 2), contents + 4);
+		TS_ASSERT(ssrs.borrowData(5, 4) == nullptr);
+	}
+
+	void test_read_stream() {
+		byte contents[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+		Common::MemoryReadStream ms(contents, 10);
+
+		Common::SeekableSubReadStream ssrs(&ms, 1, 9);
+		ssrs.seek(2);
+
+		Common::SeekableReadStream *s = ssrs.readStream(4);
+		TS_ASSERT_EQUALS(s->size(), 4);
+		TS_ASSERT_EQUALS(s->readByte(), 3);
+		TS_ASSERT_EQUALS(ssrs.pos(), 6);
+		TS_ASSERT_EQUALS(ssrs.readByte(), 7);
+		delete s;
+
+		// Requests past the end are cut off at the end of the sub stream
+		ssrs.seek(6);
+		s = ssrs.readStream(10);
+		TS_ASSERT_EQUALS(s->size(), 2);
+		TS_ASSERT_EQUALS(ssrs.pos(), 8);
+		TS_ASSERT(ssrs.eos());
+		delete s;
+	}
 };
@@ -5,6 +5,18 @@
 
 #include "test/common/str-helper.h"
 
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
 class StringTestSuite : public CxxTest::TestSuite
 {
 	public:
@@ -745,4 +757,33 @@ class StringTestSuite : public CxxTest::TestSuite
 		TS_ASSERT(a > c);
 		TS_ASSERT(c < a);
 	}
+
+	void test_string_churn_speed() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int iters = 5000000;
+#else
+		const int iters = 1000;
+#endif
+		// Long enough to live on the heap and use the refcount
+		const Common::String longString("A string which does not fit into the builtin storage");
+		Common::Array<Common::String> results(64);
+
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < iters; i++) {
+			Common::String shared(longString);
+			Common::String unique = longString + "!";
+			results[i & 63] = unique;
+			shared.setChar('a', 0);
+			results[(i + 32) & 63] = shared;
+		}
+		uint32 time = g_system->getMillis() - start;
+
+		// Copy-on-write must have left the original alone
+		TS_ASSERT_EQUALS(longString[0], 'A');
+		debug("String churn: %d iterations in %u ms", iters, time);
+#endif
+	}
 };
@@ -1,7 +1,40 @@
 #include <cxxtest/TestSuite.h>
 
 #include "common/memstream.h"
+#include "common/mutex.h"
 #include "common/substream.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+
+#include "../null_osystem.h"
+
+// Gives the other reader time to move the parent between seek() and read()
+class SlowMemoryReadStream : public Common::MemoryReadStream {
+public:
+	SlowMemoryReadStream(const byte *dataPtr, uint32 dataSize) : Common::MemoryReadStream(dataPtr, dataSize) {}
+
+	uint32 read(void *dataPtr, uint32 dataSize) override {
+		g_system->delayMillis(1);
+		return Common::MemoryReadStream::read(dataPtr, dataSize);
+	}
+};
+
+struct MutexedMemberReader {
+	Common::SeekableReadStream *member;
+	byte expected;
+	uint32 mismatches;
+};
+
+// Read the member one byte at a time, so the readers keep moving the parent
+static void readMutexedMember(void *data) {
+	MutexedMemberReader *reader = (MutexedMemberReader *)data;
+	while (reader->member->pos() < reader->member->size()) {
+		Common::SeekableReadStream *stream = reader->member->readStream(1);
+		if (stream->readByte() != reader->expected)
+			reader->mismatches++;
+		delete stream;
+	}
+}
 
 class SubReadStreamTestSuite : public CxxTest::TestSuite {
 	public:
@@ -44,4 +77,37 @@ class SubReadStreamTestSuite : public CxxTest::TestSuite {
 		// eos should not be set for the second sub stream
 		TS_ASSERT(!ssrs2.eos());
 	}
+
+	void test_mutexed_read_stream_threads() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Two members of one archive, read from two threads
+		const uint32 memberSize = 200;
+		byte contents[memberSize * 2];
+		memset(contents, 1, memberSize);
+		memset(contents + memberSize, 2, memberSize);
+		SlowMemoryReadStream ms(contents, sizeof(contents));
+
+		Common::Mutex mutex;
+		Common::SafeMutexedSeekableSubReadStream member1(&ms, 0, memberSize, DisposeAfterUse::NO, mutex);
+		Common::SafeMutexedSeekableSubReadStream member2(&ms, memberSize, memberSize * 2, DisposeAfterUse::NO, mutex);
+
+		MutexedMemberReader readers[2] = {
+			{ &member1, 1, 0 },
+			{ &member2, 2, 0 }
+		};
+
+		Common::ThreadPool pool(2);
+		Common::JobGroup group(pool);
+		group.add(readMutexedMember, &readers[0]);
+		group.add(readMutexedMember, &readers[1]);
+		group.wait();
+
+		TS_ASSERT_EQUALS(readers[0].mismatches, 0u);
+		TS_ASSERT_EQUALS(readers[1].mismatches, 0u);
+		TS_ASSERT(member1.pos() == member1.size());
+		TS_ASSERT(member2.pos() == member2.size());
+#endif
+	}
 };
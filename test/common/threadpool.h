@@ -0,0 +1,188 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/threadpool.h"
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+static void incrementJob(void *data) {
+	(*(int *)data)++;
+}
+
+struct NestedJobData {
+	Common::ThreadPool *pool;
+	int results[8];
+};
+
+static void nestedJob(void *data) {
+	NestedJobData *nested = (NestedJobData *)data;
+	Common::JobGroup group(*nested->pool);
+	for (int i = 0; i < 8; i++)
+		group.add(incrementJob, &nested->results[i]);
+	group.wait();
+}
+
+class ThreadPoolTestSuite : public CxxTest::TestSuite {
+public:
+	void checkParallelFor(Common::ThreadPool &pool, uint count, uint grainSize) {
+		Common::Array<int> visits;
+		visits.resize(count);
+		for (uint i = 0; i < count; i++)
+			visits[i] = 0;
+
+		pool.parallelFor(0, count, grainSize, [&visits](uint begin, uint end) {
+			for (uint i = begin; i < end; i++)
+				visits[i]++;
+		});
+
+		for (uint i = 0; i < count; i++)
+			TS_ASSERT_EQUALS(visits[i], 1);
+	}
+
+	void test_parallel_for() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::ThreadPool pool(3);
+		checkParallelFor(pool, 0, 0);
+		checkParallelFor(pool, 1, 0);
+		checkParallelFor(pool, 7, 0);
+		checkParallelFor(pool, 1000, 0);
+		checkParallelFor(pool, 1000, 300);
+		checkParallelFor(pool, 100003, 1);
+#endif
+	}
+
+	void test_serial_fallback() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::ThreadPool pool(0);
+		TS_ASSERT_EQUALS(pool.getNumWorkers(), 0u);
+		TS_ASSERT_EQUALS(pool.getConcurrency(), 1u);
+		checkParallelFor(pool, 1000, 0);
+
+		int counter = 0;
+		Common::JobGroup group(pool);
+		group.add(incrementJob, &counter);
+		group.add(incrementJob, &counter);
+		group.wait();
+		TS_ASSERT_EQUALS(counter, 2);
+#endif
+	}
+
+	void test_wait_runs_own_jobs_only() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Without workers, jobs only run when their own group is waited on
+		Common::ThreadPool pool(0);
+		int counterA = 0, counterB = 0;
+		Common::JobGroup groupA(pool), groupB(pool);
+		groupB.add(incrementJob, &counterB);
+		groupA.add(incrementJob, &counterA);
+		groupB.add(incrementJob, &counterB);
+
+		groupA.wait();
+		TS_ASSERT_EQUALS(counterA, 1);
+		TS_ASSERT_EQUALS(counterB, 0);
+
+		groupB.wait();
+		TS_ASSERT_EQUALS(counterB, 2);
+#endif
+	}
+
+	void test_job_groups() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		Common::ThreadPool pool(2);
+		int results[256];
+		{
+			Common::JobGroup group(pool);
+			for (int i = 0; i < 256; i++) {
+				results[i] = i;
+				group.add(incrementJob, &results[i]);
+			}
+			// The destructor waits for the jobs
+		}
+		for (int i = 0; i < 256; i++)
+			TS_ASSERT_EQUALS(results[i], i + 1);
+
+		// Groups can be reused after waiting
+		int counter = 0;
+		Common::JobGroup group(pool);
+		group.add(incrementJob, &counter);
+		group.wait();
+		group.wait();
+		TS_ASSERT_EQUALS(counter, 1);
+#endif
+	}
+
+	void test_nested_groups() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		// Jobs waiting on their own groups must not starve the pool,
+		// even with fewer workers than outer jobs.
+		Common::ThreadPool pool(1);
+		NestedJobData nested[16];
+		Common::JobGroup group(pool);
+		for (int i = 0; i < 16; i++) {
+			nested[i].pool = &pool;
+			for (int j = 0; j < 8; j++)
+				nested[i].results[j] = 0;
+			group.add(nestedJob, &nested[i]);
+		}
+		group.wait();
+
+		for (int i = 0; i < 16; i++)
+			for (int j = 0; j < 8; j++)
+				TS_ASSERT_EQUALS(nested[i].results[j], 1);
+#endif
+	}
+
+	void test_scaling_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const uint count = 1 << 22;
+#else
+		const uint count = 1 << 18;
+#endif
+
+		Common::Array<uint32> output;
+		output.resize(count);
+
+		uint maxWorkers = g_system->getCPUCount() - 1;
+		for (uint workers = 0; ; workers = workers ? workers * 2 : 1) {
+			workers = MIN(workers, maxWorkers);
+			Common::ThreadPool pool(workers);
+
+			uint32 start = g_system->getMillis();
+			pool.parallelFor(0, count, 1024, [&output](uint begin, uint end) {
+				for (uint i = begin; i < end; i++) {
+					uint32 x = i;
+					for (int j = 0; j < 64; j++)
+						x = x * 1664525 + 1013904223;
+					output[i] = x;
+				}
+			});
+			uint32 time = g_system->getMillis() - start;
+
+			debug("ThreadPool: %u threads: %u ms", pool.getConcurrency(), time);
+			if (workers >= maxWorkers)
+				break;
+		}
+#endif
+	}
+};
@@ -0,0 +1,125 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/compression/unzip.h"
+#include "common/crc.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
+
+class ZipArchiveTestSuite : public CxxTest::TestSuite {
+	// Big enough for the member to be streamed instead of read into memory
+	static const uint32 kDataSize = 1024 * 1024 + 123;
+
+	static byte expectedByte(uint32 pos) {
+		return (byte)((pos * 7) ^ (pos >> 11));
+	}
+
+	static void writeName(Common::WriteStream &out) {
+		out.writeString("big.bin");
+	}
+
+	// Build a ZIP file holding a single stored member
+	Common::SeekableReadStream *createArchiveStream(bool corruptCrc) {
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::NO);
+
+		byte *data = new byte[kDataSize];
+		for (uint32 i = 0; i < kDataSize; i++)
+			data[i] = expectedByte(i);
+		uint32 crc = Common::CRC32().crcFast(data, kDataSize);
+		if (corruptCrc)
+			crc ^= 1;
+
+		// Local file header
+		out.writeUint32LE(0x04034b50);
+		out.writeUint16LE(10);		// Version needed
+		out.writeUint16LE(0);		// Flags
+		out.writeUint16LE(0);		// Stored
+		out.writeUint32LE(0);		// Date and time
+		out.writeUint32LE(crc);
+		out.writeUint32LE(kDataSize);
+		out.writeUint32LE(kDataSize);
+		out.writeUint16LE(7);		// Name length
+		out.writeUint16LE(0);		// Extra field length
+		writeName(out);
+		out.write(data, kDataSize);
+		delete[] data;
+
+		// Central directory
+		uint32 centralDirOffset = out.pos();
+		out.writeUint32LE(0x02014b50);
+		out.writeUint16LE(10);		// Version made by
+		out.writeUint16LE(10);		// Version needed
+		out.writeUint16LE(0);		// Flags
+		out.writeUint16LE(0);		// Stored
+		out.writeUint32LE(0);		// Date and time
+		out.writeUint32LE(crc);
+		out.writeUint32LE(kDataSize);
+		out.writeUint32LE(kDataSize);
+		out.writeUint16LE(7);		// Name length
+		out.writeUint16LE(0);		// Extra field length
+		out.writeUint16LE(0);		// Comment length
+		out.writeUint16LE(0);		// Disk number
+		out.writeUint16LE(0);		// Internal attributes
+		out.writeUint32LE(0);		// External attributes
+		out.writeUint32LE(0);		// Local header offset
+		writeName(out);
+		uint32 centralDirSize = out.pos() - centralDirOffset;
+
+		// End of central directory
+		out.writeUint32LE(0x06054b50);
+		out.writeUint16LE(0);
+		out.writeUint16LE(0);
+		out.writeUint16LE(1);
+		out.writeUint16LE(1);
+		out.writeUint32LE(centralDirSize);
+		out.writeUint32LE(centralDirOffset);
+		out.writeUint16LE(0);
+
+		return new Common::MemoryReadStream(out.getData(), out.size(), DisposeAfterUse::YES);
+	}
+
+	Common::SeekableReadStream *openMember(bool corruptCrc) {
+		Common::ScopedPtr<Common::Archive> archive(Common::makeZipArchive(createArchiveStream(corruptCrc)));
+		TS_ASSERT(archive);
+		if (!archive)
+			return nullptr;
+
+		// The member stays readable after the archive is gone
+		return archive->createReadStreamForMember("big.bin");
+	}
+
+public:
+	void test_streamed_member_outlives_archive() {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(openMember(false));
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+		TS_ASSERT_EQUALS(stream->size(), (int64)kDataSize);
+
+		byte chunk[4096];
+		uint32 mismatches = 0;
+		for (uint32 pos = 0; pos < kDataSize; pos += sizeof(chunk)) {
+			uint32 len = stream->read(chunk, sizeof(chunk));
+			TS_ASSERT_EQUALS(len, MIN<uint32>(sizeof(chunk), kDataSize - pos));
+			for (uint32 i = 0; i < len; i++)
+				mismatches += chunk[i] != expectedByte(pos + i);
+		}
+		TS_ASSERT_EQUALS(mismatches, 0u);
+		TS_ASSERT(!stream->err());
+	}
+
+	void test_streamed_member_crc_mismatch() {
+		Common::ScopedPtr<Common::SeekableReadStream> stream(openMember(true));
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		byte chunk[4096];
+		// Rereading part of the data must not disturb the check
+		stream->read(chunk, sizeof(chunk));
+		stream->seek(100);
+		while (!stream->eos() && !stream->err())
+			stream->read(chunk, sizeof(chunk));
+		TS_ASSERT(stream->err());
+	}
+};
@@ -0,0 +1,73 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/grim/lua/lua.h"
+#include "engines/grim/lua/lgc.h"
+
+// Only the Lua interpreter is linked in, the tasks never run here
+namespace Grim {
+class GrimEngine;
+GrimEngine *g_grim = nullptr;
+}
+
+class GrimLuaGCTestSuite : public CxxTest::TestSuite {
+public:
+	void test_incremental_keeps_reachable() {
+		Grim::lua_open();
+
+		Grim::lua_dostring("keep = {} n = 0");
+		for (int i = 0; i < 200; i++) {
+			// Every batch leaves one reachable and one garbage table per iteration
+			Grim::lua_dostring("local i = 0 while i < 20 do n = n + 1 keep[n] = { v = n } local g = { v = -n } i = i + 1 end");
+			Grim::lua_stepgarbage(i % 50 == 0);
+		}
+
+		const Grim::GCStats &stats = Grim::luaC_getstats();
+		TS_ASSERT(stats.cycles > 0);
+		TS_ASSERT(stats.steps > stats.cycles);
+
+		Grim::lua_dostring("ok = 1 local i = 1 while i <= n do if keep[i].v ~= i then ok = nil end i = i + 1 end");
+		TS_ASSERT_EQUALS(Grim::lua_getnumber(Grim::lua_getglobal("n")), 4000);
+		TS_ASSERT(!Grim::lua_isnil(Grim::lua_getglobal("ok")));
+
+		// A full collection in the middle of a cycle must not lose anything either
+		Grim::lua_stepgarbage(true);
+		TS_ASSERT(Grim::lua_collectgarbage(0) > 0);
+		TS_ASSERT_EQUALS(Grim::luaC_getstats().phase, Grim::GCSpause);
+		Grim::lua_dostring("keep = nil");
+		TS_ASSERT(Grim::lua_collectgarbage(0) > 0);
+
+		Grim::lua_close();
+	}
+
+	static void stepUntil(Grim::GCPhase phase) {
+		while (Grim::luaC_getstats().phase != phase)
+			Grim::lua_stepgarbage(false);
+	}
+
+	void test_objects_created_while_sweeping() {
+		Grim::lua_open();
+
+		// Enough garbage for the sweep to take several steps, without any
+		// collection running before
+		Grim::lua_collectgarbage(1000000);
+		Grim::lua_dostring("local i = 0 while i < 5000 do local t = { v = i } i = i + 1 end");
+		Grim::lua_stepgarbage(true);
+		stepUntil(Grim::GCSsweep);
+
+		// New prototypes and closures, with and without upvalues
+		Grim::lua_dostring("function f() return 42 end function mk(x) return function() return %x + 1 end end g = mk(6)");
+		stepUntil(Grim::GCSpause);
+
+		// Anything freed by mistake is likely to be reused by these
+		for (int i = 0; i < 50; i++)
+			Grim::lua_dostring("function h() return 0 end junk = {} local i = 0 while i < 20 do junk[i] = mk(i) i = i + 1 end");
+		Grim::lua_collectgarbage(0);
+
+		Grim::lua_dostring("a = f() b = g() c = mk(1)()");
+		TS_ASSERT_EQUALS(Grim::lua_getnumber(Grim::lua_getglobal("a")), 42);
+		TS_ASSERT_EQUALS(Grim::lua_getnumber(Grim::lua_getglobal("b")), 7);
+		TS_ASSERT_EQUALS(Grim::lua_getnumber(Grim::lua_getglobal("c")), 2);
+
+		Grim::lua_close();
+	}
+};
@@ -0,0 +1,139 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/hpl1/engine/libraries/newton/Newton.h"
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/system.h"
+#include "common/threadpool.h"
+
+#include "../../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class Hpl1NewtonTestSuite : public CxxTest::TestSuite {
+	static void applyGravity(NewtonBody *const body, dFloat, int32) {
+		dFloat mass, ixx, iyy, izz;
+		NewtonBodyGetMassMatrix(body, &mass, &ixx, &iyy, &izz);
+		const dFloat force[3] = { 0.0f, -9.81f * mass, 0.0f };
+		NewtonBodyAddForce(body, force);
+	}
+
+	/**
+	 * Create a floor with @p stacks x @p stacks towers of boxes, each tower
+	 * is a separate island for the solver.
+	 */
+	static NewtonWorld *createScene(int threads, int stacks, int height, Common::Array<NewtonBody *> &bodies) {
+		NewtonWorld *world = NewtonCreate();
+		NewtonSetDeterministicThreading(world, 1);
+		NewtonSetThreadsCount(world, threads);
+
+		const dFloat worldMin[3] = { -100.0f, -10.0f, -100.0f };
+		const dFloat worldMax[3] = { 100.0f, 100.0f, 100.0f };
+		NewtonSetWorldSize(world, worldMin, worldMax);
+
+		dFloat matrix[16] = {
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			0.0f, -0.5f, 0.0f, 1.0f
+		};
+
+		NewtonCollision *floor = NewtonCreateBox(world, 180.0f, 1.0f, 180.0f, 0, nullptr);
+		NewtonCreateBody(world, floor, matrix);
+		NewtonReleaseCollision(world, floor);
+
+		NewtonCollision *box = NewtonCreateBox(world, 1.0f, 1.0f, 1.0f, 0, nullptr);
+		for (int x = 0; x < stacks; x++) {
+			for (int z = 0; z < stacks; z++) {
+				for (int y = 0; y < height; y++) {
+					// Offset the boxes a little so that the towers sway
+					matrix[12] = (x - stacks / 2) * 3.0f + y * 0.05f;
+					matrix[13] = 0.5f + y * 1.01f;
+					matrix[14] = (z - stacks / 2) * 3.0f - y * 0.03f;
+
+					NewtonBody *body = NewtonCreateBody(world, box, matrix);
+					NewtonBodySetMassMatrix(body, 1.0f, 1.0f / 6.0f, 1.0f / 6.0f, 1.0f / 6.0f);
+					NewtonBodySetForceAndTorqueCallback(body, applyGravity);
+					bodies.push_back(body);
+				}
+			}
+		}
+		NewtonReleaseCollision(world, box);
+
+		return world;
+	}
+
+	static void simulate(NewtonWorld *world, int steps) {
+		for (int i = 0; i < steps; i++)
+			NewtonUpdate(world, 1.0f / 60.0f);
+	}
+
+	static int getThreadCount() {
+		return MAX<int>(2, Common::ThreadPool::instance().getConcurrency());
+	}
+
+public:
+	void test_deterministic_threading() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+		NewtonInitGlobals();
+
+		Common::Array<NewtonBody *> serialBodies, threadedBodies;
+		NewtonWorld *serial = createScene(1, 4, 6, serialBodies);
+		NewtonWorld *threaded = createScene(getThreadCount(), 4, 6, threadedBodies);
+
+		simulate(serial, 120);
+		simulate(threaded, 120);
+
+		// The same scene has to give the same results, however many
+		// threads were used to step it
+		TS_ASSERT_EQUALS(serialBodies.size(), threadedBodies.size());
+		bool moved = false;
+		for (uint i = 0; i < serialBodies.size(); i++) {
+			dFloat matrixA[16], matrixB[16];
+			NewtonBodyGetMatrix(serialBodies[i], matrixA);
+			NewtonBodyGetMatrix(threadedBodies[i], matrixB);
+			TS_ASSERT_EQUALS(memcmp(matrixA, matrixB, sizeof(matrixA)), 0);
+			moved |= (matrixA[13] != 0.5f + (i % 6) * 1.01f);
+		}
+		TS_ASSERT(moved);
+
+		NewtonDestroy(serial);
+		NewtonDestroy(threaded);
+		NewtonDestroyGlobals();
+#endif
+	}
+
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+		NewtonInitGlobals();
+
+#ifdef SLOW_TESTS
+		const int steps = 600;
+#else
+		const int steps = 30;
+#endif
+
+		const int threadCounts[2] = { 1, getThreadCount() };
+		for (int i = 0; i < 2; i++) {
+			Common::Array<NewtonBody *> bodies;
+			NewtonWorld *world = createScene(threadCounts[i], 6, 8, bodies);
+
+			uint32 start = g_system->getMillis();
+			simulate(world, steps);
+			uint32 time = g_system->getMillis() - start;
+
+			debug("Newton: %u bodies, %d steps, %d threads: %u ms", bodies.size(), steps, NewtonGetThreadsCount(world), time);
+			NewtonDestroy(world);
+		}
+
+		NewtonDestroyGlobals();
+#endif
+	}
+};
@@ -0,0 +1,154 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/zvision/graphics/render_table.h"
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "graphics/surface.h"
+
+#include "../../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class ZVisionRenderTableTestSuite : public CxxTest::TestSuite {
+	static const int kWidth = 640;
+	static const int kHeight = 344;
+
+	static const Graphics::PixelFormat rgb555() {
+		return Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0);
+	}
+
+	void fillPattern(Graphics::Surface &surface) {
+		for (int y = 0; y < surface.h; y++) {
+			uint16 *row = (uint16 *)surface.getBasePtr(0, y);
+			for (int x = 0; x < surface.w; x++)
+				row[x] = ((x * 7 + y) & 0x1F) << 10 | ((x ^ y) & 0x1F) << 5 | ((x + y * 3) & 0x1F);
+		}
+	}
+
+public:
+	void test_flat_is_identity() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		ZVision::RenderTable table(kWidth, kHeight);
+		Graphics::Surface src, dst;
+		src.create(kWidth, kHeight, rgb555());
+		dst.create(kWidth, kHeight, rgb555());
+		fillPattern(src);
+
+		table.mutateImage(&dst, &src);
+		TS_ASSERT_EQUALS(memcmp(src.getPixels(), dst.getPixels(), kWidth * kHeight * 2), 0);
+
+		// Without any sub-pixel offsets, filtering must not change anything
+		table.setBilinearFiltering(true);
+		table.mutateImage(&dst, &src);
+		TS_ASSERT_EQUALS(memcmp(src.getPixels(), dst.getPixels(), kWidth * kHeight * 2), 0);
+
+		src.free();
+		dst.free();
+#endif
+	}
+
+	void test_panorama_matches_rect_path() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		ZVision::RenderTable table(kWidth, kHeight);
+		table.setRenderState(ZVision::RenderTable::PANORAMA);
+		table.generateRenderTable();
+
+		Graphics::Surface src, dst;
+		src.create(kWidth, kHeight, rgb555());
+		dst.create(kWidth, kHeight, rgb555());
+		fillPattern(src);
+
+		// The whole-surface kernels and the per-rect path must pick the same pixels
+		Common::Array<uint16> expected(kWidth * kHeight);
+		table.mutateImage((uint16 *)src.getPixels(), expected.begin(), kWidth, Common::Rect(kWidth, kHeight));
+		table.mutateImage(&dst, &src);
+		TS_ASSERT_EQUALS(memcmp(expected.begin(), dst.getPixels(), kWidth * kHeight * 2), 0);
+
+		src.free();
+		dst.free();
+#endif
+	}
+
+	void test_bilinear_keeps_flat_color() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+
+		ZVision::RenderTable table(kWidth, kHeight);
+		table.setRenderState(ZVision::RenderTable::TILT);
+		table.generateRenderTable();
+		table.setBilinearFiltering(true);
+
+		Graphics::Surface src, dst;
+		src.create(kWidth, kHeight, rgb555());
+		dst.create(kWidth, kHeight, rgb555());
+		const uint16 color = rgb555().RGBToColor(0x88, 0x40, 0xF8);
+		src.fillRect(Common::Rect(kWidth, kHeight), color);
+
+		table.mutateImage(&dst, &src);
+		bool allSame = true;
+		for (int y = 0; y < kHeight; y++) {
+			const uint16 *row = (const uint16 *)dst.getBasePtr(0, y);
+			for (int x = 0; x < kWidth; x++)
+				allSame &= (row[x] == color);
+		}
+		TS_ASSERT(allSame);
+
+		src.free();
+		dst.free();
+#endif
+	}
+
+	void benchmarkWarp(ZVision::RenderTable &table, const char *name, Graphics::Surface &dst, Graphics::Surface &src, int frames) {
+		table.setBilinearFiltering(false);
+		uint32 start = g_system->getMillis();
+		for (int i = 0; i < frames; i++)
+			table.mutateImage(&dst, &src);
+		uint32 nearestTime = g_system->getMillis() - start;
+
+		table.setBilinearFiltering(true);
+		start = g_system->getMillis();
+		for (int i = 0; i < frames; i++)
+			table.mutateImage(&dst, &src);
+		uint32 bilinearTime = g_system->getMillis() - start;
+
+		debug("%s: %d frames, nearest %u ms, bilinear %u ms", name, frames, nearestTime, bilinearTime);
+	}
+
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int frames = 1000;
+#else
+		const int frames = 50;
+#endif
+
+		Graphics::Surface src, dst;
+		src.create(kWidth, kHeight, rgb555());
+		dst.create(kWidth, kHeight, rgb555());
+		fillPattern(src);
+
+		ZVision::RenderTable table(kWidth, kHeight);
+		table.setRenderState(ZVision::RenderTable::PANORAMA);
+		table.generateRenderTable();
+		benchmarkWarp(table, "Panorama warp", dst, src, frames);
+
+		table.setRenderState(ZVision::RenderTable::TILT);
+		table.generateRenderTable();
+		benchmarkWarp(table, "Tilt warp", dst, src, frames);
+
+		src.free();
+		dst.free();
+#endif
+	}
+};
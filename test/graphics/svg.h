@@ -0,0 +1,218 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/svg.h"
+
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+static const char *svgIcon =
+	"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"24\" height=\"24\" viewBox=\"0 0 24 24\">"
+	"<circle cx=\"12\" cy=\"12\" r=\"10\" fill=\"#ff8000\"/>"
+	"<path d=\"M4 12 C4 4 20 4 20 12 L12 20 Z\" fill=\"#0040ff\" stroke=\"#000000\" stroke-width=\"1.5\"/>"
+	"</svg>";
+
+static const char *svgIconChanged =
+	"<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"24\" height=\"24\" viewBox=\"0 0 24 24\">"
+	"<rect x=\"2\" y=\"2\" width=\"20\" height=\"20\" fill=\"#20c040\"/>"
+	"</svg>";
+
+class SVGBitmapCacheTestSuite : public CxxTest::TestSuite {
+	static bool sameImage(const Graphics::ManagedSurface &a, const Graphics::ManagedSurface &b) {
+		if (a.w != b.w || a.h != b.h || a.format != b.format)
+			return false;
+
+		for (int y = 0; y < a.h; y++) {
+			if (memcmp(a.getBasePtr(0, y), b.getBasePtr(0, y), a.w * a.format.bytesPerPixel))
+				return false;
+		}
+		return true;
+	}
+
+	static Graphics::ManagedSurface *createBitmap(Graphics::SVGBitmapCache &cache, const char *name, const char *svg, int dw, int dh) {
+		Common::MemoryReadStream stream((const byte *)svg, strlen(svg));
+		return cache.createBitmap(name, &stream, dw, dh);
+	}
+
+	static void saveCache(Graphics::SVGBitmapCache &cache, Common::MemoryWriteStreamDynamic &out) {
+		TS_ASSERT(cache.save(out));
+		TS_ASSERT(!cache.isModified());
+	}
+
+public:
+	void test_matches_svgbitmap() {
+		Common::MemoryReadStream stream((const byte *)svgIcon, strlen(svgIcon));
+		Graphics::SVGBitmap reference(&stream, 48, 48);
+
+		Graphics::SVGBitmapCache cache(1);
+		Graphics::ManagedSurface *cold = createBitmap(cache, "icon.svg", svgIcon, 48, 48);
+		TS_ASSERT(cache.isModified());
+		TS_ASSERT(sameImage(reference, *cold));
+
+		Graphics::ManagedSurface *warm = createBitmap(cache, "icon.svg", svgIcon, 48, 48);
+		TS_ASSERT_EQUALS(cache.size(), 1u);
+		TS_ASSERT(sameImage(reference, *warm));
+
+		delete cold;
+		delete warm;
+	}
+
+	void test_save_load() {
+		Graphics::SVGBitmapCache cache(1);
+		delete createBitmap(cache, "icon.svg", svgIcon, 24, 24);
+		delete createBitmap(cache, "icon.svg", svgIcon, 36, 36);
+		delete createBitmap(cache, "other.svg", svgIconChanged, 24, 24);
+		TS_ASSERT_EQUALS(cache.size(), 3u);
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		saveCache(cache, out);
+
+		Graphics::SVGBitmapCache loaded(1);
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(loaded.load(in));
+		TS_ASSERT_EQUALS(loaded.size(), 3u);
+		TS_ASSERT(!loaded.isModified());
+
+		Graphics::ManagedSurface *expected = createBitmap(cache, "icon.svg", svgIcon, 36, 36);
+		Graphics::ManagedSurface *surf = createBitmap(loaded, "icon.svg", svgIcon, 36, 36);
+		TS_ASSERT(!loaded.isModified());
+		TS_ASSERT(sameImage(*expected, *surf));
+		delete expected;
+		delete surf;
+
+		// A different size is a different entry
+		delete createBitmap(loaded, "icon.svg", svgIcon, 48, 48);
+		TS_ASSERT(loaded.isModified());
+		TS_ASSERT_EQUALS(loaded.size(), 4u);
+	}
+
+	void test_save_drops_unused_entries() {
+		Graphics::SVGBitmapCache cache(1);
+		delete createBitmap(cache, "icon.svg", svgIcon, 24, 24);
+		delete createBitmap(cache, "other.svg", svgIconChanged, 24, 24);
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		saveCache(cache, out);
+
+		Graphics::SVGBitmapCache loaded(1);
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(loaded.load(in));
+		delete createBitmap(loaded, "icon.svg", svgIcon, 48, 48);
+		delete createBitmap(loaded, "other.svg", svgIconChanged, 24, 24);
+		TS_ASSERT_EQUALS(loaded.size(), 3u);
+
+		// Only the entries used since loading are kept
+		Common::MemoryWriteStreamDynamic out2(DisposeAfterUse::YES);
+		saveCache(loaded, out2);
+		TS_ASSERT_EQUALS(loaded.size(), 2u);
+
+		Graphics::SVGBitmapCache reloaded(1);
+		Common::MemoryReadStream in2(out2.getData(), out2.size());
+		TS_ASSERT(reloaded.load(in2));
+		TS_ASSERT_EQUALS(reloaded.size(), 2u);
+		delete createBitmap(reloaded, "icon.svg", svgIcon, 48, 48);
+		delete createBitmap(reloaded, "other.svg", svgIconChanged, 24, 24);
+		TS_ASSERT(!reloaded.isModified());
+	}
+
+	void test_changed_svg() {
+		Graphics::SVGBitmapCache cache(1);
+		delete createBitmap(cache, "icon.svg", svgIcon, 24, 24);
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		saveCache(cache, out);
+
+		Graphics::SVGBitmapCache loaded(1);
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(loaded.load(in));
+
+		// The entry must not be used once the SVG data changed
+		Common::MemoryReadStream stream((const byte *)svgIconChanged, strlen(svgIconChanged));
+		Graphics::SVGBitmap reference(&stream, 24, 24);
+		Graphics::ManagedSurface *surf = createBitmap(loaded, "icon.svg", svgIconChanged, 24, 24);
+		TS_ASSERT(loaded.isModified());
+		TS_ASSERT_EQUALS(loaded.size(), 1u);
+		TS_ASSERT(sameImage(reference, *surf));
+		delete surf;
+	}
+
+	void test_invalid_cache() {
+		Graphics::SVGBitmapCache cache(1);
+		delete createBitmap(cache, "icon.svg", svgIcon, 24, 24);
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		saveCache(cache, out);
+
+		// Different key
+		Graphics::SVGBitmapCache other(2);
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(!other.load(in));
+		TS_ASSERT_EQUALS(other.size(), 0u);
+
+		// Truncated file
+		Graphics::SVGBitmapCache truncated(1);
+		Common::MemoryReadStream shortIn(out.getData(), out.size() - 1);
+		TS_ASSERT(!truncated.load(shortIn));
+		TS_ASSERT_EQUALS(truncated.size(), 0u);
+
+		// Not a cache file at all
+		Graphics::SVGBitmapCache garbage(1);
+		Common::MemoryReadStream svgIn((const byte *)svgIcon, strlen(svgIcon));
+		TS_ASSERT(!garbage.load(svgIn));
+		TS_ASSERT_EQUALS(garbage.size(), 0u);
+	}
+
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int rounds = 20;
+#else
+		const int rounds = 2;
+#endif
+		// About the number and size of the icons of a theme at 2x scale
+		const int numIcons = 40;
+		const int size = 64;
+
+		// Icons with a few hundred curve segments each
+		Common::String svg = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"32\" height=\"32\" viewBox=\"0 0 32 32\">";
+		for (int i = 0; i < 60; i++)
+			svg += Common::String::format("<path d=\"M%d 16 C%d 2 %d 2 %d 16 S%d 30 %d 16 Z\" fill=\"#%06x\" stroke=\"#000000\" stroke-width=\"0.5\" opacity=\"0.3\"/>",
+				i % 16, i % 16 + 4, i % 16 + 12, i % 16 + 16, 32 - i % 16, i % 16, (i * 0x3F1B5) & 0xFFFFFF);
+		svg += "</svg>";
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		uint32 coldTime = 0, warmTime = 0;
+
+		for (int r = 0; r < rounds; r++) {
+			uint32 start = g_system->getMillis();
+			Graphics::SVGBitmapCache cold(1);
+			for (int i = 0; i < numIcons; i++)
+				delete createBitmap(cold, Common::String::format("icon%d.svg", i).c_str(), svg.c_str(), size, size);
+			out.seek(0);
+			cold.save(out);
+			coldTime += g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			Graphics::SVGBitmapCache warm(1);
+			Common::MemoryReadStream in(out.getData(), out.size());
+			warm.load(in);
+			for (int i = 0; i < numIcons; i++)
+				delete createBitmap(warm, Common::String::format("icon%d.svg", i).c_str(), svg.c_str(), size, size);
+			TS_ASSERT(!warm.isModified());
+			warmTime += g_system->getMillis() - start;
+		}
+
+		debug("SVG theme icons: %d loads of %d icons, cold %u ms, warm %u ms", rounds, numIcons, coldTime, warmTime);
+#endif
+	}
+};
@@ -0,0 +1,149 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "graphics/screen.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+/**
+ * A screen that records the areas it would copy to the physical screen
+ */
+class RecordingScreen : public Graphics::Screen {
+public:
+	Common::Array<Common::Rect> uploads;
+
+	RecordingScreen(int width, int height) : Graphics::Screen(width, height) {
+		// Start without the initial full screen update
+		clearDirtyRects();
+	}
+
+	void copyRectToScreen(const Common::Rect &r) override {
+		Graphics::Screen::_dirtyStats.uploadedArea += r.width() * r.height();
+		Graphics::Screen::_dirtyStats.uploadCount++;
+		uploads.push_back(r);
+	}
+
+	void updateScreen() override {}
+};
+
+class ScreenTestSuite : public CxxTest::TestSuite {
+	static Common::Array<Common::Rect> randomRects(int count, int width, int height, uint32 seed) {
+		Common::Array<Common::Rect> rects;
+		for (int i = 0; i < count; i++) {
+			seed = seed * 1103515245 + 12345;
+			const int x = (seed >> 8) % width, y = (seed >> 16) % height;
+			seed = seed * 1103515245 + 12345;
+			const int w = 1 + (seed >> 8) % 24, h = 1 + (seed >> 16) % 12;
+			rects.push_back(Common::Rect(x, y, MIN(x + w, width), MIN(y + h, height)));
+		}
+		return rects;
+	}
+
+public:
+	void test_tiles_cover_dirty_areas() {
+		RecordingScreen screen(320, 200);
+		screen.setDirtyTracking(Graphics::Screen::kDirtyTiles);
+
+		Common::Array<Common::Rect> rects = randomRects(200, 320, 200, 1);
+		for (uint i = 0; i < rects.size(); i++)
+			screen.addDirtyRect(rects[i]);
+		TS_ASSERT(screen.isDirty());
+		screen.update();
+		TS_ASSERT(!screen.isDirty());
+
+		// Every dirty pixel is copied exactly once
+		Common::Array<byte> dirty(320 * 200, 0), copied(320 * 200, 0);
+		for (uint i = 0; i < rects.size(); i++)
+			for (int y = rects[i].top; y < rects[i].bottom; y++)
+				for (int x = rects[i].left; x < rects[i].right; x++)
+					dirty[y * 320 + x] = 1;
+		for (uint i = 0; i < screen.uploads.size(); i++)
+			for (int y = screen.uploads[i].top; y < screen.uploads[i].bottom; y++)
+				for (int x = screen.uploads[i].left; x < screen.uploads[i].right; x++)
+					copied[y * 320 + x]++;
+
+		bool covered = true, overlapping = false;
+		for (uint i = 0; i < dirty.size(); i++) {
+			covered &= !dirty[i] || copied[i];
+			overlapping |= copied[i] > 1;
+		}
+		TS_ASSERT(covered);
+		TS_ASSERT(!overlapping);
+		TS_ASSERT_EQUALS(screen.getDirtyStats().uploadCount, screen.uploads.size());
+	}
+
+	void test_tile_runs_coalesce() {
+		RecordingScreen screen(100, 70);
+		screen.setDirtyTracking(Graphics::Screen::kDirtyTiles);
+
+		// A block of whole tiles is a single copy, and tiles at the edges are clipped
+		screen.addDirtyRect(Common::Rect(0, 0, 64, 64));
+		screen.addDirtyRect(Common::Rect(90, 60, 100, 70));
+		screen.update();
+		TS_ASSERT_EQUALS(screen.uploads.size(), 2u);
+		TS_ASSERT(screen.uploads[0] == Common::Rect(0, 0, 64, 64));
+		TS_ASSERT(screen.uploads[1] == Common::Rect(80, 48, 100, 70));
+
+		// Runs of different widths are copied separately
+		screen.uploads.clear();
+		screen.addDirtyRect(Common::Rect(0, 0, 32, 16));
+		screen.addDirtyRect(Common::Rect(0, 16, 48, 32));
+		screen.update();
+		TS_ASSERT_EQUALS(screen.uploads.size(), 2u);
+	}
+
+	void test_switching_keeps_pending_areas() {
+		RecordingScreen screen(100, 70);
+		screen.addDirtyRect(Common::Rect(5, 5, 10, 10));
+		screen.setDirtyTracking(Graphics::Screen::kDirtyTiles);
+		screen.addDirtyRect(Common::Rect(40, 40, 41, 41));
+		screen.setDirtyTracking(Graphics::Screen::kDirtyRectList);
+		TS_ASSERT(screen.isDirty());
+
+		screen.update();
+		TS_ASSERT_EQUALS(screen.uploads.size(), 2u);
+		TS_ASSERT(screen.uploads[0] == Common::Rect(0, 0, 16, 16));
+		TS_ASSERT(screen.uploads[1] == Common::Rect(32, 32, 48, 48));
+	}
+
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int frames = 2000;
+#else
+		const int frames = 50;
+#endif
+
+		Common::Array<Common::Rect> rects = randomRects(400, 640, 480, 2);
+		const Graphics::Screen::DirtyTracking modes[] = { Graphics::Screen::kDirtyRectList, Graphics::Screen::kDirtyTiles };
+		const char *names[] = { "Rect list", "16x16 tiles" };
+
+		for (int m = 0; m < 2; m++) {
+			RecordingScreen screen(640, 480);
+			screen.setDirtyTracking(modes[m]);
+
+			uint32 start = g_system->getMillis();
+			for (int f = 0; f < frames; f++) {
+				for (uint i = 0; i < rects.size(); i++)
+					screen.addDirtyRect(rects[i]);
+				screen.uploads.clear();
+				screen.update();
+			}
+			uint32 time = g_system->getMillis() - start;
+
+			const Graphics::Screen::DirtyStats &stats = screen.getDirtyStats();
+			debug("%s: %d frames of %d rects in %u ms, %u copies, %u pixels dirtied, %u pixels copied", names[m], frames, rects.size(),
+				time, stats.uploadCount / frames, (uint)(stats.dirtiedArea / frames), (uint)(stats.uploadedArea / frames));
+		}
+#endif
+	}
+};
@@ -0,0 +1,141 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/debug.h"
+#include "common/system.h"
+#include "graphics/managed_surface.h"
+
+#include "../null_osystem.h"
+
+#if NULL_OSYSTEM_IS_AVAILABLE
+#define BENCHMARK_TIME 1
+#else
+#define BENCHMARK_TIME 0
+#endif
+
+class TransBlitTestSuite : public CxxTest::TestSuite {
+	static void fillRandom(Graphics::ManagedSurface &surf, uint32 seed, uint32 key, uint32 keyEvery) {
+		for (int y = 0; y < surf.h; y++) {
+			for (int x = 0; x < surf.w; x++) {
+				seed = seed * 1103515245 + 12345;
+				uint32 color = (seed >> 8) & (((uint64)1 << (surf.format.bytesPerPixel * 8)) - 1);
+				if ((seed >> 24) % keyEvery == 0)
+					color = key;
+				surf.setPixel(x, y, color);
+			}
+		}
+	}
+
+	/** Check a sprite blit, clipped at every edge of the destination, against a plain per-pixel copy. */
+	void checkKeyBlit(const Graphics::PixelFormat &format) {
+		const uint32 key = 0x1F;
+		Graphics::ManagedSurface sprite(37, 29, format);
+		fillRandom(sprite, 1, key, 4);
+
+		const Common::Point positions[] = {
+			Common::Point(5, 7), Common::Point(-10, -3), Common::Point(80, 50), Common::Point(-36, 60), Common::Point(20, -28)
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(positions); i++) {
+			Graphics::ManagedSurface dest(100, 70, format);
+			fillRandom(dest, 2, key, 1000);
+			Graphics::ManagedSurface expected(100, 70, format);
+			expected.blitFrom(dest);
+
+			for (int y = 0; y < sprite.h; y++) {
+				for (int x = 0; x < sprite.w; x++) {
+					const Common::Point p(positions[i].x + x, positions[i].y + y);
+					const uint32 color = sprite.getPixel(x, y);
+					if (p.x >= 0 && p.y >= 0 && p.x < dest.w && p.y < dest.h && color != key)
+						expected.setPixel(p.x, p.y, color);
+				}
+			}
+
+			dest.transBlitFrom(sprite, positions[i], key);
+			TS_ASSERT_EQUALS(memcmp(expected.getPixels(), dest.getPixels(), dest.pitch * dest.h), 0);
+		}
+	}
+
+public:
+	void test_key_blit() {
+		Common::install_null_g_system();
+
+		checkKeyBlit(Graphics::PixelFormat::createFormatCLUT8());
+		checkKeyBlit(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		checkKeyBlit(Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0));
+	}
+
+	void test_palette_lookup() {
+		Common::install_null_g_system();
+
+		// The sprite uses the destination colors in reverse order
+		byte srcColors[256 * 3], dstColors[256 * 3];
+		for (int i = 0; i < 256; i++) {
+			dstColors[i * 3 + 0] = i;
+			dstColors[i * 3 + 1] = 255 - i;
+			dstColors[i * 3 + 2] = i / 2;
+			memcpy(&srcColors[(255 - i) * 3], &dstColors[i * 3], 3);
+		}
+
+		Graphics::ManagedSurface sprite(16, 16), dest(16, 16);
+		for (int y = 0; y < 16; y++)
+			for (int x = 0; x < 16; x++)
+				sprite.setPixel(x, y, y * 16 + x);
+		sprite.setPalette(srcColors, 0, 256);
+		dest.setPalette(dstColors, 0, 256);
+
+		dest.transBlitFrom(sprite, Common::Point(0, 0), 0);
+		bool mapped = true;
+		for (int i = 1; i < 256; i++)
+			mapped &= dest.getPixel(i % 16, i / 16) == (uint32)(255 - i);
+		TS_ASSERT(mapped);
+
+		// A changed palette must not reuse the lookup of the previous one
+		sprite.setPalette(dstColors, 0, 256);
+		dest.transBlitFrom(sprite, Common::Point(0, 0), 0);
+		bool identity = true;
+		for (int i = 1; i < 256; i++)
+			identity &= dest.getPixel(i % 16, i / 16) == (uint32)i;
+		TS_ASSERT(identity);
+	}
+
+	void test_benchmark() {
+#if BENCHMARK_TIME
+		Common::install_null_g_system();
+
+#ifdef SLOW_TESTS
+		const int blits = 100000;
+#else
+		const int blits = 2000;
+#endif
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat::createFormatCLUT8(), Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)
+		};
+
+		for (uint f = 0; f < ARRAYSIZE(formats); f++) {
+			Graphics::ManagedSurface sprite(64, 64, formats[f]), dest(640, 480, formats[f]);
+			fillRandom(sprite, 1, 0, 3);
+			byte colors[256 * 3];
+			for (int i = 0; i < 256 * 3; i++)
+				colors[i] = i * 7;
+			if (formats[f].isCLUT8()) {
+				sprite.setPalette(colors, 0, 256);
+				dest.setPalette(colors, 0, 256);
+			}
+
+			uint32 start = g_system->getMillis();
+			for (int i = 0; i < blits; i++)
+				dest.transBlitFrom(sprite, Common::Point((i * 37) % 620 - 10, (i * 91) % 460 - 10), 0);
+			uint32 unscaledTime = g_system->getMillis() - start;
+
+			start = g_system->getMillis();
+			for (int i = 0; i < blits; i++)
+				dest.transBlitFrom(sprite, Common::Rect(64, 64), Common::Rect(64, 64, 160, 160), 0);
+			uint32 scaledTime = g_system->getMillis() - start;
+
+			debug("transBlitFrom %d bpp, %d blits of 64x64: unscaled %u ms, scaled %u ms",
+				formats[f].bytesPerPixel * 8, blits, unscaledTime, scaledTime);
+		}
+#endif
+	}
+};
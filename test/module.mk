@@ -5,7 +5,7 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/common/formats/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/image/*.h $(srcdir)/test/graphics/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -15,7 +15,9 @@ TEST_LIBS += test/null_osystem.o \
 	backends/fs/posix/posix-iostream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
-	backends/modular-backend.o
+	backends/modular-backend.o \
+	backends/mutex/pthread/pthread-mutex.o \
+	backends/threads/pthread/pthread-threads.o
 endif
 
 ifdef WIN32
@@ -35,6 +37,20 @@ ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TEST_LIBS += engines/wintermute/libwintermute.a
 endif
 
+ifeq ($(ENABLE_ZVISION), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/zvision/*.h
+	TEST_LIBS += engines/zvision/libzvision.a
+endif
+
+ifeq ($(ENABLE_HPL1), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/hpl1/*.h
+	TEST_LIBS += engines/hpl1/libhpl1.a
+endif
+ifeq ($(ENABLE_GRIM), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/grim/*.h
+	TEST_LIBS += $(addprefix engines/grim/lua/, lapi.o lauxlib.o lbuffer.o lbuiltin.o ldo.o lfunc.o lgc.o llex.o lmathlib.o lmem.o lobject.o lstx.o lstate.o lstring.o lstrlib.o ltable.o ltask.o ltm.o lundump.o lvm.o lzio.o) engines/grim/color.o engines/grim/debug.o
+endif
+
 ifeq ($(ENABLE_ULTIMA), STATIC_PLUGIN)
 ifdef ENABLE_ULTIMA1
 	TESTS += $(srcdir)/test/engines/ultima/shared/*/*.h
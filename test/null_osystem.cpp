@@ -5,6 +5,25 @@
 
 //#define DISPLAY_ERROR_MESSAGES
 
+/**
+ * The null backend does not probe the CPU. The tests do, so that they
+ * exercise the SIMD code paths the host supports.
+ */
+class OSystem_NULL_Test : public OSystem_NULL {
+public:
+	OSystem_NULL_Test(bool silenceLogs) : OSystem_NULL(silenceLogs) {}
+
+	bool hasFeature(Feature f) override {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		if (f == kFeatureCpuSSE2)
+			return __builtin_cpu_supports("sse2");
+		if (f == kFeatureCpuAVX2)
+			return __builtin_cpu_supports("avx2");
+#endif
+		return OSystem_NULL::hasFeature(f);
+	}
+};
+
 void Common::install_null_g_system() {
 #ifdef DISPLAY_ERROR_MESSAGES
 	const bool silenceLogs = false;
@@ -12,7 +31,7 @@ void Common::install_null_g_system() {
 	const bool silenceLogs = true;
 #endif
 
-	g_system = OSystem_NULL_create(silenceLogs);
+	g_system = new OSystem_NULL_Test(silenceLogs);
 }
 
 bool BaseBackend::setScaler(const char *name, int factor) {
@@ -30,7 +30,6 @@
 #include "common/textconsole.h"
 #include "common/math.h"
 #include "common/stream.h"
-#include "common/substream.h"
 #include "common/file.h"
 #include "common/str.h"
 #include "common/bitstream.h"
@@ -186,8 +185,7 @@ void BinkDecoder::readNextPacket() {
 			//                  Number of samples in bytes
 			audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-			audio.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					audioPacketStart + 4, audioPacketEnd), DisposeAfterUse::YES);
+			audio.bits = readPacketBits(audioPacketEnd - audioPacketStart - 4);
 
 			audioTrack->decodePacket();
 
@@ -203,8 +201,7 @@ void BinkDecoder::readNextPacket() {
 	uint32 videoPacketStart = _bink->pos();
 	uint32 videoPacketEnd   = _bink->pos() + frameSize;
 
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+	frame.bits = readPacketBits(videoPacketEnd - videoPacketStart);
 
 	videoTrack->decodePacket(frame);
 
@@ -212,6 +209,11 @@ void BinkDecoder::readNextPacket() {
 	frame.bits = 0;
 }
 
+Common::BitStreamMemory32LELSB *BinkDecoder::readPacketBits(uint32 size) {
+	// Decode from memory, which is a lot faster to read bits from
+	return new Common::BitStreamMemory32LELSB(Common::BitStreamMemoryStream::createFromStream(*_bink, size), DisposeAfterUse::YES);
+}
+
 VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
 	// Bink audio track indexes are relative to the first audio track
 	Track *track = getTrack(index + 1);
@@ -723,7 +725,7 @@ void BinkDecoder::BinkVideoTrack::deinitBundles() {
 
 void BinkDecoder::BinkVideoTrack::initHuffman() {
 	for (int i = 0; i < 16; i++)
-		_huffman[i] = new Common::Huffman<Common::BitStream32LELSB>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
+		_huffman[i] = new Common::Huffman<Common::BitStreamMemory32LELSB>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
 }
 
 byte BinkDecoder::BinkVideoTrack::getHuffmanSymbol(VideoFrame &video, Huffman &huffman) {
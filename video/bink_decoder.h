@@ -106,7 +106,7 @@ private:
 
 		uint32 sampleCount;
 
-		Common::BitStream32LELSB *bits;
+		Common::BitStreamMemory32LELSB *bits;
 
 		bool first;
 
@@ -139,7 +139,7 @@ private:
 		uint32 offset;
 		uint32 size;
 
-		Common::BitStream32LELSB *bits;
+		Common::BitStreamMemory32LELSB *bits;
 
 		VideoFrame();
 		~VideoFrame();
@@ -260,7 +260,7 @@ private:
 
 		Bundle _bundles[kSourceMAX]; ///< Bundles for decoding all data types.
 
-		Common::Huffman<Common::BitStream32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
+		Common::Huffman<Common::BitStreamMemory32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
 
 		/** Huffman codebooks to use for decoding high nibbles in color data types. */
 		Huffman _colHighHuffman[16];
@@ -377,6 +377,9 @@ private:
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
 
 	void initAudioTrack(AudioInfo &audio);
+
+	/** Read the next @p size bytes of the file into a bit stream. */
+	Common::BitStreamMemory32LELSB *readPacketBits(uint32 size);
 };
 
 } // End of namespace Video